@@ -9,6 +9,7 @@
 #include <functional>
 #include <list>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "FrontendResource.h"
@@ -107,6 +108,13 @@ private:
 
     [[nodiscard]] CallList_t::const_iterator find_call(std::string const& from, std::string const& to) const;
 
+    // calls are found case-insensitively, so the index uses the lower case endpoints as key
+    [[nodiscard]] static std::string call_key(std::string const& from, std::string const& to);
+
+    void index_call(CallList_t::iterator call_it);
+
+    void unindex_call(CallList_t::iterator call_it);
+
     // modules are named using the exact same string that gets requested,
     // i.e. we dont split namespaces like ::Project_1::Group_1::View3D_2_1 to extract the 'actual' modul name 'View3D_2_1'
     [[nodiscard]] bool add_module(ModuleInstantiationRequest_t const& request);
@@ -128,6 +136,13 @@ private:
     /** List of call that this graph owns */
     CallList_t call_list_;
 
+    // hash indices into module_list_ and call_list_ by module name and by call endpoints.
+    // std::list iterators stay valid until their element is erased, so the indices only need to be
+    // updated when modules or calls are added, deleted or renamed.
+    // several calls can connect the same endpoints, they are kept from oldest to newest.
+    std::unordered_map<std::string, ModuleList_t::iterator> module_index_;
+    std::unordered_map<std::string, std::vector<CallList_t::iterator>> call_index_;
+
     megamol::frontend_resources::FrontendResourcesLookup provided_resources_lookup;
 
     // for each View in the MegaMol graph we create a EntryPoint
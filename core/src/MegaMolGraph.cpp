@@ -123,10 +123,16 @@ bool megamol::core::MegaMolGraph::RenameModule(std::string const& old, std::stri
         log_error("error. could not rename module. module is nullptr: " + oldId);
         return false;
     }
+    if (module_index_.count(newId) > 0) {
+        log_error("error. could not rename module. a module named " + newId + " already exists: " + oldId);
+        return false;
+    }
 
     log("rename module " + module_it->request.id + " to " + newId);
+    module_index_.erase(oldId);
     module_it->request.id = newId;
     module_it->modulePtr->setName(newId.c_str());
+    module_index_.emplace(newId, module_it);
 
     const auto matches_old_prefix = [&](std::string const& call_slot) {
         auto res = call_slot.find(oldId);
@@ -139,13 +145,24 @@ bool megamol::core::MegaMolGraph::RenameModule(std::string const& old, std::stri
         log("rename call at slot " + old + " to " + name);
     };
 
-    for (auto& call : call_list_) {
-        if (matches_old_prefix(call.request.from)) {
+    // from oldest to newest, such that renamed calls connecting the same slots keep their order in call_index_
+    for (auto rit = call_list_.rbegin(); rit != call_list_.rend(); ++rit) {
+        auto call_it = std::prev(rit.base());
+        auto& call = *call_it;
+        const bool rename_from = matches_old_prefix(call.request.from);
+        const bool rename_to = matches_old_prefix(call.request.to);
+        if (!rename_from && !rename_to) {
+            continue;
+        }
+
+        unindex_call(call_it);
+        if (rename_from) {
             put_new_prefix(call.request.from);
         }
-        if (matches_old_prefix(call.request.to)) {
+        if (rename_to) {
             put_new_prefix(call.request.to);
         }
+        index_call(call_it);
     }
 
     // dont know what we are supposed to do when entry point renaming fails... how can it fail?
@@ -504,7 +521,11 @@ megamol::frontend_resources::MegaMolGraph_SubscriptionRegistry& megamol::core::M
 void megamol::core::MegaMolGraph::Clear() {
     while (!call_list_.empty()) {
         auto& call = call_list_.front().request;
-        delete_call(CallDeletionRequest_t{call.from, call.to});
+        if (!delete_call(CallDeletionRequest_t{call.from, call.to})) {
+            // drop the call anyway, otherwise this loop would never end
+            unindex_call(call_list_.begin());
+            call_list_.pop_front();
+        }
     }
     call_list_.clear();
 
@@ -513,6 +534,8 @@ void megamol::core::MegaMolGraph::Clear() {
         delete_module(ModuleDeletionRequest_t{module.id});
     }
     module_list_.clear();
+    module_index_.clear();
+    call_index_.clear();
     graph_entry_points.clear();
     module_param_changes_queue.clear();
     module_param_presentation_changes_queue.clear();
@@ -524,47 +547,66 @@ void megamol::core::MegaMolGraph::Clear() {
 
 
 megamol::core::ModuleList_t::iterator megamol::core::MegaMolGraph::find_module(std::string const& name) {
-    auto it = std::find_if(this->module_list_.begin(), this->module_list_.end(),
-        [&name](megamol::core::ModuleInstance_t const& el) { return el.request.id == name; });
+    auto it = module_index_.find(name);
 
-    return it;
+    return (it != module_index_.end()) ? it->second : this->module_list_.end();
 }
 
 megamol::core::ModuleList_t::const_iterator megamol::core::MegaMolGraph::find_module(std::string const& name) const {
 
-    auto it = std::find_if(this->module_list_.cbegin(), this->module_list_.cend(),
-        [&name](megamol::core::ModuleInstance_t const& el) { return el.request.id == name; });
+    auto it = module_index_.find(name);
 
-    return it;
+    return (it != module_index_.end()) ? ModuleList_t::const_iterator{it->second} : this->module_list_.cend();
 }
 
 megamol::core::CallList_t::iterator megamol::core::MegaMolGraph::find_call(
     std::string const& from, std::string const& to) {
-    auto it =
-        std::find_if(this->call_list_.begin(), this->call_list_.end(), [&](megamol::core::CallInstance_t const& el) {
-            // Case-insensitive comparison in Module::FindSlot() during add_call
-            return utility::string::EqualAsciiCaseInsensitive(el.request.from, from) &&
-                   utility::string::EqualAsciiCaseInsensitive(el.request.to, to);
-        });
+    // Case-insensitive comparison in Module::FindSlot() during add_call
+    auto it = call_index_.find(call_key(from, to));
 
-    return it;
+    return (it != call_index_.end()) ? it->second.back() : this->call_list_.end();
 }
 
 megamol::core::CallList_t::const_iterator megamol::core::MegaMolGraph::find_call(
     std::string const& from, std::string const& to) const {
 
-    auto it =
-        std::find_if(this->call_list_.cbegin(), this->call_list_.cend(), [&](megamol::core::CallInstance_t const& el) {
-            // Case-insensitive comparison in Module::FindSlot() during add_call
-            return utility::string::EqualAsciiCaseInsensitive(el.request.from, from) &&
-                   utility::string::EqualAsciiCaseInsensitive(el.request.to, to);
-        });
+    // Case-insensitive comparison in Module::FindSlot() during add_call
+    auto it = call_index_.find(call_key(from, to));
 
-    return it;
+    return (it != call_index_.end()) ? CallList_t::const_iterator{it->second.back()} : this->call_list_.cend();
+}
+
+std::string megamol::core::MegaMolGraph::call_key(std::string const& from, std::string const& to) {
+    // slot names never contain line breaks, so the key is unique
+    return utility::string::ToLowerAsciiCopy(from) + "\n" + utility::string::ToLowerAsciiCopy(to);
+}
+
+void megamol::core::MegaMolGraph::index_call(CallList_t::iterator call_it) {
+    // calls of different classes may connect the same slots. the newest call is found first,
+    // as the linear search through call_list_ used to do
+    call_index_[call_key(call_it->request.from, call_it->request.to)].push_back(call_it);
+}
+
+void megamol::core::MegaMolGraph::unindex_call(CallList_t::iterator call_it) {
+    auto it = call_index_.find(call_key(call_it->request.from, call_it->request.to));
+    if (it == call_index_.end()) {
+        return;
+    }
+    auto& calls = it->second;
+    calls.erase(std::remove(calls.begin(), calls.end(), call_it), calls.end());
+    if (calls.empty()) {
+        call_index_.erase(it);
+    }
 }
 
 
 bool megamol::core::MegaMolGraph::add_module(ModuleInstantiationRequest_t const& request) {
+    if (module_index_.count(request.id) > 0) {
+        log_error("error. could not create module " + request.className + ", a module named " + request.id +
+                  " already exists");
+        return false;
+    }
+
     factories::ModuleDescription::ptr module_description = this->ModuleProvider().Find(request.className.c_str());
     if (!module_description) {
         log_error("error. module factory could not find module class name: " + request.className);
@@ -601,6 +643,7 @@ bool megamol::core::MegaMolGraph::add_module(ModuleInstantiationRequest_t const&
     }
 
     this->module_list_.push_front({module_ptr, request, false, module_resource_request, module_lifetime_dependencies});
+    this->module_index_.emplace(request.id, this->module_list_.begin());
 
     module_ptr->setParent(this->dummy_namespace);
 
@@ -648,6 +691,7 @@ bool megamol::core::MegaMolGraph::add_module(ModuleInstantiationRequest_t const&
     }
 
     if (!isCreateOk) {
+        this->module_index_.erase(request.id);
         this->module_list_.pop_front();
     }
 
@@ -765,6 +809,7 @@ bool megamol::core::MegaMolGraph::add_call(CallInstantiationRequest_t const& req
 
     log("create call: " + request.from + " -> " + request.to + " (" + std::string(call_description->ClassName()) + ")");
     this->call_list_.emplace_front(CallInstance_t{call, request});
+    index_call(this->call_list_.begin());
 
     if (auto result = graph_subscribers.tell_all([&](auto& s) { return s.AddCall(this->call_list_.front()); });
         result.first == false) {
@@ -777,7 +822,7 @@ bool megamol::core::MegaMolGraph::add_call(CallInstantiationRequest_t const& req
 }
 
 static std::list<megamol::core::CallList_t::iterator> find_all_of(
-    megamol::core::CallList_t list, std::function<bool(megamol::core::CallInstance_t const&)> const& func) {
+    megamol::core::CallList_t& list, std::function<bool(megamol::core::CallInstance_t const&)> const& func) {
 
     std::list<megamol::core::CallList_t::iterator> result;
 
@@ -847,6 +892,7 @@ bool megamol::core::MegaMolGraph::delete_module(ModuleDeletionRequest_t const& r
     module_ptr->Release(module_it->lifetime_resources);
     log("release module: " + std::string(module_ptr->Name().PeekBuffer()));
 
+    this->module_index_.erase(module_it->request.id);
     this->module_list_.erase(module_it);
 
     return true;
@@ -883,30 +929,36 @@ bool megamol::core::MegaMolGraph::delete_call(CallDeletionRequest_t const& reque
     source->PerformCleanup();  // does nothing
     target->DisconnectCalls(); // does nothing
 
+    unindex_call(call_it);
     this->call_list_.erase(call_it);
 
     return true;
 }
 
-static const auto check_module_is_prefix = [](std::string const& request, auto const& module) {
-    const auto& module_name = module.request.id;
-    const auto substring = request.substr(0, module_name.size());
-    return (module_name == substring) &&         // module name is prefix of request
-           (request.size() == module_name.size() // module name matches whole request
-               || (request.size() >= module_name.size() + 2 &&
-                      request.substr(module_name.size(), 2) == "::")); // OR request has :: after module name
-};
+// find the index entry of the module whose name is a prefix of request,
+// i.e. the module name either matches the whole request or request has :: after the module name.
+// instead of testing all modules, only the prefixes of request that end before a :: are looked up.
+template<typename Index>
+static typename Index::const_iterator find_prefix_in_index(Index const& index, std::string const& request) {
+    std::string::size_type pos = 0;
+    while ((pos = request.find("::", pos + 1)) != std::string::npos) {
+        if (auto it = index.find(request.substr(0, pos)); it != index.end()) {
+            return it;
+        }
+    }
+    return index.find(request);
+}
 
 // find module where module name is prefix of request
 megamol::core::ModuleList_t::iterator megamol::core::MegaMolGraph::find_module_by_prefix(std::string const& request) {
-    return std::find_if(module_list_.begin(), module_list_.end(),
-        [&](auto const& module) { return check_module_is_prefix(request, module); });
+    auto it = find_prefix_in_index(module_index_, request);
+    return (it != module_index_.end()) ? it->second : module_list_.end();
 }
 
 megamol::core::ModuleList_t::const_iterator megamol::core::MegaMolGraph::find_module_by_prefix(
     std::string const& request) const {
-    return std::find_if(module_list_.begin(), module_list_.end(),
-        [&](auto const& module) { return check_module_is_prefix(request, module); });
+    auto it = find_prefix_in_index(module_index_, request);
+    return (it != module_index_.end()) ? ModuleList_t::const_iterator{it->second} : module_list_.cend();
 }
 
 void megamol::frontend_resources::MegaMolGraph_SubscriptionRegistry::subscribe(ModuleGraphSubscription subscriber) {
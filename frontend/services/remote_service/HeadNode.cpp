@@ -19,11 +19,10 @@ bool megamol::frontend::Remote_Service::HeadNode::send(megamol::remote::Message_
         return false;
 
     // the Remote_Service fills the message data according to the used convention
-    // we are only responsible to send the data here
+    // we are only responsible to send the data here.
+    // messages not yet picked up by the comm thread are kept, since parameter updates are sent as deltas
 
     std::lock_guard<std::mutex> guard(send_buffer_guard_);
-    send_buffer_.clear();
-    send_buffer_.reserve(data.size());
     send_buffer_.insert(send_buffer_.end(), data.begin(), data.end());
     send_buffer_has_changed_.store(true);
 
@@ -18,6 +18,7 @@ struct megamol::frontend::Remote_Service::HeadNode {
     ~HeadNode();
 
     // "Sends custom lua command to the RendernodeView"
+    // appends framed messages to the send buffer, see megamol::remote::append_message()
     bool send(megamol::remote::Message_t const& data);
 
     // "Start listening to port."
@@ -6,6 +6,8 @@
 
 #include "Remote_Service.hpp"
 
+#include <algorithm>
+
 #include <imgui.h>
 #include <imgui_stdlib.h>
 
@@ -13,10 +15,12 @@
 #include "HeadNode.hpp"
 #include "LuaApiResource.h"
 #include "MPI_Context.h"
+#include "ModuleGraphSubscription.h"
 #include "MpiNode.hpp"
 #include "RenderNode.hpp"
 #include "mmcore/LuaAPI.h"
 #include "mmcore/MegaMolGraph.h"
+#include "mmcore/param/ButtonParam.h"
 #include "mmcore/utility/log/Log.h"
 
 static const std::string service_name = "Remote_Service: ";
@@ -35,6 +39,12 @@ static void log_warning(std::string const& text) {
     megamol::core::utility::log::Log::DefaultLog.WriteWarn(msg.c_str());
 }
 
+// as FullName() prepends :: to module names, normalize multiple leading :: in parameter name path
+static std::string normalized_param_name(megamol::core::param::ParamSlot const& param_slot) {
+    auto name = std::string{param_slot.FullName()};
+    return "::" + name.substr(name.find_first_not_of(':'));
+}
+
 
 namespace megamol::frontend {
 
@@ -83,6 +93,7 @@ struct Remote_Service::PimplData {
     MpiNode mpi;
     MPI_Context mpi_context;
     megamol::remote::Message_t message;
+    uint64_t message_id = 0; // id of last message sent by head node or received by render node
 };
 #define m_head (m_pimpl->head)
 #define m_is_headnode_running (m_pimpl->is_headnode_running)
@@ -90,6 +101,7 @@ struct Remote_Service::PimplData {
 #define m_mpi (m_pimpl->mpi)
 #define m_mpi_context (m_pimpl->mpi_context)
 #define m_message (m_pimpl->message)
+#define m_message_id (m_pimpl->message_id)
 
 Remote_Service::Remote_Service() {
     // init members to default states
@@ -121,7 +133,7 @@ bool Remote_Service::init(const Config& config) {
     this->m_requestedResourcesNames = {"MegaMolGraph",
         frontend_resources::LuaAPI_Req_Name // std::function<std::tuple<bool,std::string>(std::string const&)>
         ,
-        "optional<GUIRegisterWindow>"};
+        "optional<GUIRegisterWindow>", frontend_resources::MegaMolGraph_SubscriptionRegistry_Req_Name};
 
     m_do_remote_things = std::function{[&]() {}};
 
@@ -200,6 +212,7 @@ void Remote_Service::setRequestedResources(std::vector<FrontendResource> resourc
 
     if (m_config.role == Role::HeadNode) {
         remote_control_window();
+        subscribe_to_param_changes();
     }
 }
 
@@ -233,44 +246,78 @@ void Remote_Service::do_headnode_things() {
         case HeadNodeRemoteControl::Command::SendLuaCommand:
             head_send_message(m_headnode_remote_control.lua_command);
             break;
+        case HeadNodeRemoteControl::Command::KeepSendingParams:
+        case HeadNodeRemoteControl::Command::SetParamSendingModules:
+            // render nodes may have missed earlier changes, so send the current state once before sending deltas
+            if (m_headnode_remote_control.keep_sending_params)
+                add_all_params();
+            break;
         default:
             break;
         }
     m_headnode_remote_control.commands_queue.clear();
 
-    auto split_module_names = [&](std::string const& modules_list_string, auto& module_list) {
-        if (modules_list_string.empty())
-            return;
+    // param changes are collected by our graph subscription, we only send values that changed during the last frame
+    auto& changed_params = m_headnode_remote_control.changed_params;
+    if (m_headnode_remote_control.keep_sending_params && !changed_params.empty()) {
+        head_send_param_values(changed_params);
+    }
+    changed_params.clear();
+    m_headnode_remote_control.changed_params_index.clear();
+}
+
+void Remote_Service::subscribe_to_param_changes() {
+    auto& subscription_registry = const_cast<frontend_resources::MegaMolGraph_SubscriptionRegistry&>(
+        m_requestedResourceReferences[3].getResource<frontend_resources::MegaMolGraph_SubscriptionRegistry>());
 
-        const auto delimiters = ", ";
-        size_t begin = modules_list_string.find_first_not_of(delimiters);
-        auto end = modules_list_string.find_first_of(delimiters, begin);
+    frontend_resources::ModuleGraphSubscription subscription("Remote_Service");
 
-        while (begin != std::string::npos) {
-            module_list.push_back(modules_list_string.substr(begin, end - begin));
-            begin = modules_list_string.find_first_not_of(delimiters, end);
-            end = modules_list_string.find_first_of(delimiters, begin);
+    subscription.ParameterChanged = [&](frontend_resources::ModuleGraphSubscription::ParamSlotPtr const& param_slot,
+                                        std::string const& new_value) {
+        // it seems serializing button params is illegal
+        if (m_headnode_remote_control.keep_sending_params &&
+            param_slot->Param<core::param::ButtonParam>() == nullptr) {
+            add_changed_param(normalized_param_name(*param_slot), new_value);
         }
+        return true;
     };
 
-    if (m_headnode_remote_control.keep_sending_params) {
-        static std::string send_params;
-        send_params.clear();
+    subscription_registry.subscribe(subscription);
+}
 
-        if (m_headnode_remote_control.modules_to_send_params_of == "all") {
-            send_params = const_cast<megamol::core::MegaMolGraph&>(graph).Convenience().SerializeAllParameters();
-        } else {
-            static std::vector<std::string> module_list;
-            module_list.clear();
+bool Remote_Service::is_param_sent(std::string const& param_name) const {
+    if (m_headnode_remote_control.send_params_of_all_modules)
+        return true;
 
-            split_module_names(m_headnode_remote_control.modules_to_send_params_of, module_list);
+    auto const& prefixes = m_headnode_remote_control.param_prefixes;
 
-            for (auto& module : module_list)
-                send_params +=
-                    const_cast<megamol::core::MegaMolGraph&>(graph).Convenience().SerializeModuleParameters(module);
-        }
+    return std::any_of(prefixes.begin(), prefixes.end(),
+        [&](auto const& prefix) { return param_name.compare(0, prefix.size(), prefix) == 0; });
+}
 
-        head_send_message(send_params);
+void Remote_Service::add_changed_param(std::string const& param_name, std::string const& value) {
+    if (!is_param_sent(param_name))
+        return;
+
+    auto& changed_params = m_headnode_remote_control.changed_params;
+    auto [it, inserted] = m_headnode_remote_control.changed_params_index.try_emplace(param_name, changed_params.size());
+
+    if (inserted) {
+        changed_params.emplace_back(param_name, value);
+    } else {
+        changed_params[it->second].second = value;
+    }
+}
+
+void Remote_Service::add_all_params() {
+    auto& graph = m_requestedResourceReferences[0].getResource<megamol::core::MegaMolGraph>();
+
+    for (auto& module : graph.ListModules()) {
+        for (auto& param_slot : graph.EnumerateModuleParameterSlots(module.request.id)) {
+            if (param_slot->Param<core::param::ButtonParam>() == nullptr) {
+                add_changed_param(normalized_param_name(*param_slot), param_slot->Parameter()->ValueString());
+            }
+        }
     }
 }
 
@@ -297,9 +344,29 @@ void Remote_Service::add_headnode_remote_command(HeadNodeRemoteControl::Command
     case HeadNodeRemoteControl::Command::DontSendParams:
         m_headnode_remote_control.keep_sending_params = false;
         break;
-    case HeadNodeRemoteControl::Command::SetParamSendingModules:
+    case HeadNodeRemoteControl::Command::SetParamSendingModules: {
         m_headnode_remote_control.modules_to_send_params_of = value;
-        break;
+
+        auto& prefixes = m_headnode_remote_control.param_prefixes;
+        prefixes.clear();
+
+        m_headnode_remote_control.send_params_of_all_modules = (value == "all");
+        if (value != "all") {
+            const auto delimiters = ", ";
+            size_t begin = value.find_first_not_of(delimiters);
+            auto end = value.find_first_of(delimiters, begin);
+
+            while (begin != std::string::npos) {
+                // module names may be given with or without leading ::
+                auto module = value.substr(begin, end - begin);
+                module = module.substr(std::min(module.find_first_not_of(':'), module.size()));
+                prefixes.push_back("::" + module + "::");
+
+                begin = value.find_first_not_of(delimiters, end);
+                end = value.find_first_of(delimiters, begin);
+            }
+        }
+    } break;
     case HeadNodeRemoteControl::Command::SendLuaCommand:
         m_headnode_remote_control.lua_command = value;
         break;
@@ -415,8 +482,18 @@ void Remote_Service::do_mpi_things() {
 }
 
 void Remote_Service::head_send_message(std::string const& string) {
-    m_message.resize(string.size());
-    std::memcpy(m_message.data(), string.data(), string.size());
+    m_message.clear();
+    megamol::remote::append_message(
+        m_message, megamol::remote::MessageType::LUA_CMD_MSG, ++m_message_id, string.data(), string.size());
+    m_head.send(m_message);
+}
+
+void Remote_Service::head_send_param_values(ParamValues const& values) {
+    const auto body = megamol::remote::encode_param_delta(values);
+
+    m_message.clear();
+    megamol::remote::append_message(
+        m_message, megamol::remote::MessageType::PARAM_DELTA_MSG, ++m_message_id, body.data(), body.size());
     m_head.send(m_message);
 }
 
@@ -425,14 +502,54 @@ void Remote_Service::execute_message(std::vector<char> const& message) {
         return;
 
     static std::string commands_string;
-    commands_string.resize(message.size());
-    std::memcpy(commands_string.data(), message.data(), message.size());
+    static ParamValues param_values;
+
+    const auto complete = megamol::remote::for_each_message(
+        message, [&](megamol::remote::MessageType type, uint64_t id, char const* body, uint64_t size) {
+            // the head node numbers its messages consecutively, starting over when restarted
+            if (m_message_id != 0 && id > m_message_id + 1) {
+                log_warning("missed " + std::to_string(id - m_message_id - 1) + " messages from head node");
+            }
+            m_message_id = id;
 
-    auto& luaApi = m_requestedResourceReferences[1].getResource<core::LuaAPI*>();
-    auto result = luaApi->RunString(commands_string);
+            switch (type) {
+            case megamol::remote::MessageType::LUA_CMD_MSG: {
+                commands_string.assign(body, size);
 
-    if (!result.valid()) {
-        log_error("Error executing Lua: " + luaApi->GetError(result));
+                auto& luaApi = m_requestedResourceReferences[1].getResource<core::LuaAPI*>();
+                auto result = luaApi->RunString(commands_string);
+
+                if (!result.valid()) {
+                    log_error("Error executing Lua: " + luaApi->GetError(result));
+                }
+            } break;
+            case megamol::remote::MessageType::PARAM_DELTA_MSG:
+                if (megamol::remote::decode_param_delta(body, size, param_values)) {
+                    apply_param_values(param_values);
+                } else {
+                    log_error("received malformed parameter values");
+                }
+                break;
+            default:
+                log_warning("ignoring message of unknown type " + std::to_string(static_cast<int>(type)));
+                break;
+            }
+        });
+
+    if (!complete) {
+        log_error("received incomplete message");
+    }
+}
+
+void Remote_Service::apply_param_values(ParamValues const& values) {
+    // set values directly in the graph instead of going through mmSetParamValue() in Lua
+    auto& graph = const_cast<megamol::core::MegaMolGraph&>(
+        m_requestedResourceReferences[0].getResource<megamol::core::MegaMolGraph>());
+
+    for (auto const& [name, value] : values) {
+        if (!graph.SetParameter(name, value)) {
+            log_error("could not set parameter " + name + " to " + value);
+        }
     }
 }
 
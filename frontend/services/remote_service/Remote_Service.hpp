@@ -8,6 +8,10 @@
 #undef None // on linux X.h defines None, crashing this header
 
 #include <memory> // unique_ptr
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "AbstractFrontendService.hpp"
 #include "RuntimeConfig.h"
@@ -86,8 +90,12 @@ private:
     void do_rendernode_things();
     void do_mpi_things();
 
+    using ParamValues = std::vector<std::pair<std::string, std::string>>;
+
     void head_send_message(std::string const& string);
+    void head_send_param_values(ParamValues const& values);
     void execute_message(std::vector<char> const& message);
+    void apply_param_values(ParamValues const& values);
 
     struct PimplData;
     std::unique_ptr<PimplData, std::function<void(PimplData*)>> m_pimpl;
@@ -112,9 +120,21 @@ private:
         std::string lua_command = "";
 
         std::vector<Command> commands_queue;
+
+        // "::Module::" prefixes of the params to send, unless params of all modules are sent
+        bool send_params_of_all_modules = true;
+        std::vector<std::string> param_prefixes;
+
+        // params changed since the last frame in order of their first change, holding the latest value
+        ParamValues changed_params;
+        std::unordered_map<std::string, size_t> changed_params_index;
     };
     HeadNodeRemoteControl m_headnode_remote_control;
     void add_headnode_remote_command(HeadNodeRemoteControl::Command command, std::string const& value = "");
+    void subscribe_to_param_changes();
+    bool is_param_sent(std::string const& param_name) const;
+    void add_changed_param(std::string const& param_name, std::string const& value);
+    void add_all_params();
     void remote_control_window();
 
     bool start_headnode(bool start_or_shutdown = true);
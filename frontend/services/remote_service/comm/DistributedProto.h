@@ -6,10 +6,22 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace megamol::remote {
-enum class MessageType : unsigned char { NULL_MSG = 0u, PRJ_FILE_MSG, CAM_UPD_MSG, PARAM_UPD_MSG, HEAD_DISC_MSG };
+enum class MessageType : unsigned char {
+    NULL_MSG = 0u,
+    PRJ_FILE_MSG,
+    CAM_UPD_MSG,
+    PARAM_UPD_MSG,
+    HEAD_DISC_MSG,
+    LUA_CMD_MSG,    // body is Lua code
+    PARAM_DELTA_MSG // body is a batch of parameter values, see encode_param_delta()
+};
 
 using Message_t = std::vector<char>;
 
@@ -25,6 +37,110 @@ constexpr size_t MessageSizeSize = sizeof(uint64_t);
 constexpr size_t MessageIDSize = sizeof(uint64_t);
 constexpr size_t MessageHeaderSize = MessageIDSize + MessageTypeSize + MessageSizeSize;
 
+// parameter name and new value
+using ParamValue_t = std::pair<std::string, std::string>;
+
+// appends a message consisting of header (type, body size, id) and body to the buffer.
+// a buffer may hold several messages, which are read using for_each_message()
+inline void append_message(Message_t& buffer, MessageType type, uint64_t id, char const* body, uint64_t size) {
+    const auto offset = buffer.size();
+    buffer.resize(offset + MessageHeaderSize + size);
+
+    auto ptr = buffer.data() + offset;
+    std::memcpy(ptr, &type, MessageTypeSize);
+    std::memcpy(ptr + MessageTypeSize, &size, MessageSizeSize);
+    std::memcpy(ptr + MessageTypeSize + MessageSizeSize, &id, MessageIDSize);
+    if (size > 0)
+        std::memcpy(ptr + MessageHeaderSize, body, size);
+}
+
+// calls func(type, id, body, body_size) for each message in the buffer.
+// returns false if the buffer ends with an incomplete message
+template<typename Func>
+bool for_each_message(Message_t const& buffer, Func func) {
+    size_t offset = 0;
+    while (buffer.size() - offset >= MessageHeaderSize) {
+        auto ptr = buffer.data() + offset;
+
+        MessageType type;
+        uint64_t size = 0;
+        uint64_t id = 0;
+        std::memcpy(&type, ptr, MessageTypeSize);
+        std::memcpy(&size, ptr + MessageTypeSize, MessageSizeSize);
+        std::memcpy(&id, ptr + MessageTypeSize + MessageSizeSize, MessageIDSize);
+
+        if (size > buffer.size() - offset - MessageHeaderSize)
+            return false;
+
+        func(type, id, ptr + MessageHeaderSize, size);
+        offset += MessageHeaderSize + size;
+    }
+
+    return offset == buffer.size();
+}
+
+// unsigned LEB128, so short names and values only need a single length byte
+inline void append_varint(Message_t& buffer, uint64_t value) {
+    do {
+        auto byte = static_cast<unsigned char>(value & 0x7f);
+        value >>= 7;
+        if (value != 0)
+            byte |= 0x80;
+        buffer.push_back(static_cast<char>(byte));
+    } while (value != 0);
+}
+
+inline bool read_varint(char const*& pos, char const* end, uint64_t& value) {
+    value = 0;
+    for (unsigned int shift = 0; pos != end && shift < 64; shift += 7) {
+        const auto byte = static_cast<unsigned char>(*pos++);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+// body of a PARAM_DELTA_MSG: number of values, followed by length-prefixed name and value of each parameter
+inline Message_t encode_param_delta(std::vector<ParamValue_t> const& values) {
+    Message_t body;
+    append_varint(body, values.size());
+    for (auto const& [name, value] : values) {
+        append_varint(body, name.size());
+        body.insert(body.end(), name.begin(), name.end());
+        append_varint(body, value.size());
+        body.insert(body.end(), value.begin(), value.end());
+    }
+    return body;
+}
+
+inline bool decode_param_delta(char const* body, uint64_t size, std::vector<ParamValue_t>& values) {
+    auto pos = body;
+    auto const end = body + size;
+
+    auto read_string = [&](std::string& str) {
+        uint64_t length = 0;
+        if (!read_varint(pos, end, length) || length > static_cast<uint64_t>(end - pos))
+            return false;
+        str.assign(pos, length);
+        pos += length;
+        return true;
+    };
+
+    uint64_t count = 0;
+    if (!read_varint(pos, end, count))
+        return false;
+
+    values.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        auto& [name, value] = values.emplace_back();
+        if (!read_string(name) || !read_string(value))
+            return false;
+    }
+
+    return pos == end;
+}
+
 //Message_t prepare_null_msg() {
 //    Message_t msg(MessageHeaderSize);
 //    auto const type = MessageType::NULL_MSG;
@@ -0,0 +1,154 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "geometry_calls/MultiParticleDataCall.h"
+#include "vislib/math/Cuboid.h"
+
+namespace megamol::datatools {
+
+/**
+ * Immutable kd-tree over the positions of all particles of a
+ * MultiParticleDataCall, which can be shared between modules.
+ *
+ * The particles are numbered consecutively across all lists with float
+ * positions (FLOAT_XYZ and FLOAT_XYZR), like simplePointcloud does. Lists
+ * with other position types are not indexed and contribute no particles.
+ *
+ * All queries are thread-safe. Periodic boundary conditions are evaluated
+ * per query with respect to the bounding box the index has been built for.
+ */
+class SpatialIndex {
+public:
+    /** A query result, i.e. the particle index and the squared distance. */
+    typedef std::pair<std::size_t, float> Match;
+
+    /** Selects the axes along which the domain is periodic. */
+    typedef std::array<bool, 3> Periodicity;
+
+    /**
+     * Builds the index for all particles in 'dat'. Positions are gathered
+     * and the tree is built using multiple threads.
+     *
+     * @param dat The particle data, which must already have been retrieved.
+     */
+    explicit SpatialIndex(geocalls::MultiParticleDataCall& dat);
+
+    ~SpatialIndex();
+
+    SpatialIndex(const SpatialIndex&) = delete;
+    SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+    /**
+     * Answer the number of indexed particles.
+     */
+    inline std::size_t Count() const {
+        return this->positions.size() / 3;
+    }
+
+    /**
+     * Answer the position of the particle with the given index.
+     */
+    inline const float* Position(std::size_t idx) const {
+        return this->positions.data() + 3 * idx;
+    }
+
+    /**
+     * Answer the number of particle lists of the data the index was built for.
+     */
+    inline std::size_t ListCount() const {
+        return this->listOffsets.size() - 1;
+    }
+
+    /**
+     * Answer the index of the first particle of the given list.
+     */
+    inline std::size_t ListOffset(std::size_t list) const {
+        return this->listOffsets[list];
+    }
+
+    /**
+     * Answer the number of indexed particles of the given list, which is zero
+     * if the list has no float positions.
+     */
+    inline std::size_t ListSize(std::size_t list) const {
+        return this->listOffsets[list + 1] - this->listOffsets[list];
+    }
+
+    /**
+     * Answer the list the particle with the given index belongs to.
+     */
+    std::size_t ListOf(std::size_t idx) const;
+
+    /**
+     * Answer the bounding box used as domain for periodic boundaries.
+     */
+    inline const vislib::math::Cuboid<float>& Bounds() const {
+        return this->bounds;
+    }
+
+    /**
+     * Finds all particles within 'radius' around 'pos'.
+     *
+     * If the domain is periodic, the periodic images of the query are searched
+     * as well. Each particle is reported only once with its minimum distance.
+     *
+     * @param pos      The query position.
+     * @param radius   The (not squared) search radius; the criterion is
+     *                 distance <= radius.
+     * @param matches  Receives the matches in no particular order.
+     * @param periodic The axes along which the domain is periodic.
+     *
+     * @return The number of matches.
+     */
+    std::size_t RadiusSearch(
+        const float* pos, float radius, std::vector<Match>& matches, const Periodicity& periodic = {}) const;
+
+    /**
+     * Finds the 'k' particles nearest to 'pos'.
+     *
+     * @param pos      The query position.
+     * @param k        The number of neighbours to search.
+     * @param matches  Receives up to 'k' matches in ascending order of their
+     *                 distance.
+     * @param periodic The axes along which the domain is periodic.
+     *
+     * @return The number of matches.
+     */
+    std::size_t KnnSearch(
+        const float* pos, std::size_t k, std::vector<Match>& matches, const Periodicity& periodic = {}) const;
+
+private:
+    class Tree;
+
+    /**
+     * Enumerates the query positions for the periodic images of 'pos'.
+     */
+    std::size_t periodicImages(const float* pos, const Periodicity& periodic, std::array<float, 3 * 8>& images) const;
+
+    /**
+     * Sorts the matches by index and removes duplicates found via different
+     * periodic images, retaining the minimum distance.
+     */
+    static void removeDuplicates(std::vector<Match>& matches);
+
+    vislib::math::Cuboid<float> bounds;
+
+    std::vector<std::size_t> listOffsets;
+
+    std::vector<float> positions;
+
+    std::unique_ptr<Tree> tree;
+};
+
+} // namespace megamol::datatools
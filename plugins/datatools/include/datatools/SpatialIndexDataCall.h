@@ -0,0 +1,58 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "datatools/SpatialIndex.h"
+#include "mmcore/factories/CallAutoDescription.h"
+#include "mmstd/data/AbstractGetData3DCall.h"
+
+namespace megamol::datatools {
+
+/**
+ * Call handing out a shared spatial index of the particles of a frame.
+ *
+ * Consumers keep the index alive as long as they hold the pointer, so it
+ * remains valid even if the provider moves on to another frame.
+ */
+class SpatialIndexDataCall : public core::AbstractGetData3DCall {
+public:
+    static const char* ClassName() {
+        return "SpatialIndexDataCall";
+    }
+    static const char* Description() {
+        return "Call transporting a kd-tree over the particles of a MultiParticleDataCall";
+    }
+    static unsigned int FunctionCount() {
+        return AbstractGetData3DCall::FunctionCount();
+    }
+    static const char* FunctionName(unsigned int idx) {
+        return AbstractGetData3DCall::FunctionName(idx);
+    }
+
+    SpatialIndexDataCall();
+    ~SpatialIndexDataCall() override;
+
+    /**
+     * Answer the index, which is nullptr if none is available.
+     */
+    inline std::shared_ptr<const SpatialIndex> GetIndex() const {
+        return this->index;
+    }
+
+    inline void SetIndex(std::shared_ptr<const SpatialIndex> index) {
+        this->index = std::move(index);
+    }
+
+private:
+    std::shared_ptr<const SpatialIndex> index;
+};
+
+typedef core::factories::CallAutoDescription<SpatialIndexDataCall> SpatialIndexDataCallDescription;
+
+} // namespace megamol::datatools
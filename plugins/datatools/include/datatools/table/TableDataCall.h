@@ -11,8 +11,10 @@
 #include "mmstd/data/AbstractGetDataCall.h"
 #include "vislib/String.h"
 #include "vislib/macro_utils.h"
+#include <cassert>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace megamol::datatools::table {
 
@@ -20,8 +22,20 @@ namespace megamol::datatools::table {
  * Call for passing around tabular data.
  *
  * Tabular data is composed from cells that are subdivided into columns and rows.
- * Cells are expected to be stored in a consecutive row-major format
- * (until the shitty API no longer provides unsafe pointer access).
+ * Cells are either stored in a consecutive row-major format (Set) or as
+ * one view per column (SetColumns). Consumers that only need a few columns
+ * should use GetColumn, which works for both layouts without copying.
+ * GetData materializes a row-major copy on demand if the producer only
+ * provided column views.
+ *
+ * Row filters can pass on a selection or permutation of the rows of their
+ * input instead of copying (SetSelection). The call then shares the data of
+ * the input and maps each row to a row of that data; materialization only
+ * happens if a consumer asks for the row-major data.
+ *
+ * Consumers can announce the columns they need via SetRequestedColumns
+ * before issuing the data request. Producers delivering column views may
+ * leave the views of columns that have not been requested invalid.
  */
 class TableDataCall : public core::AbstractGetDataCall {
 public:
@@ -92,6 +106,50 @@ public:
         float maxVal;
     };
 
+    /**
+     * Zero-copy view of the cells of a single column.
+     */
+    class ColumnView {
+    public:
+        inline ColumnView() : data(nullptr), indices(nullptr), count(0), stride(0) {}
+
+        inline ColumnView(const float* data, size_t count, size_t stride = 1, const size_t* indices = nullptr)
+                : data(data)
+                , indices(indices)
+                , count(count)
+                , stride(stride) {}
+
+        inline const float* Data() const {
+            return data;
+        }
+        inline size_t Count() const {
+            return count;
+        }
+        inline size_t Stride() const {
+            return stride;
+        }
+        inline const size_t* Indices() const {
+            return indices;
+        }
+        inline bool IsValid() const {
+            return data != nullptr;
+        }
+        inline bool IsContiguous() const {
+            return (stride == 1) && (indices == nullptr);
+        }
+
+        inline float operator[](size_t row) const {
+            assert(row < count);
+            return data[((indices != nullptr) ? indices[row] : row) * stride];
+        }
+
+    private:
+        const float* data;
+        const size_t* indices;
+        size_t count;
+        size_t stride;
+    };
+
     TableDataCall();
     ~TableDataCall() override;
 
@@ -107,14 +165,27 @@ public:
         return columns;
     }
 
+    /**
+     * Answer the cells in row-major order. If the producer only provided
+     * column views or a row selection, a row-major copy is created on the
+     * first access. The copy is kept as long as the producer sets the same
+     * views, frame and data hash again. Cells of columns without a valid view are
+     * NaN in this copy.
+     */
     inline const float* GetData() const {
-        return data;
+        if ((column_views == nullptr) && (row_indices == nullptr)) {
+            return data;
+        }
+        if (!rows_cached || (rows_cache_hash != DataHash()) || (rows_cache_frame != frameID)) {
+            materializeRows();
+        }
+        return rows_cache.data();
     }
 
     inline const float* GetData(size_t row) const {
         assert(row >= 0);
         assert(row < rows_count);
-        return data + row * columns_count;
+        return GetData() + row * columns_count;
     }
 
     inline float GetData(size_t col, size_t row) const {
@@ -122,7 +193,51 @@ public:
         assert(col < columns_count);
         assert(row >= 0);
         assert(row < rows_count);
-        return data[col + row * columns_count];
+        return GetColumn(col)[row];
+    }
+
+    /**
+     * Answer a view of the given column, which is valid for both layouts.
+     * The view is invalid if the producer did not provide the column, which
+     * can only happen if it has not been requested.
+     */
+    inline ColumnView GetColumn(size_t col) const {
+        assert(col < columns_count);
+        ColumnView base;
+        if (column_views != nullptr) {
+            base = column_views[col];
+            assert(base.Indices() == nullptr);
+        } else if (data != nullptr) {
+            base = ColumnView(data + col, base_rows_count, columns_count);
+        }
+        if ((row_indices == nullptr) || !base.IsValid()) {
+            return base;
+        }
+        return ColumnView(base.Data(), rows_count, base.Stride(), row_indices);
+    }
+
+    /**
+     * Answer whether the producer provided its data as column views.
+     */
+    inline bool IsColumnLayout() const {
+        return column_views != nullptr;
+    }
+
+    /**
+     * Answer the row indices into the shared data if the producer passed on a
+     * row selection, nullptr otherwise.
+     */
+    inline const size_t* GetRowIndices() const {
+        return row_indices;
+    }
+
+    /**
+     * Answer the index of the given row in the shared data. Producers must
+     * use this to build their own selections on top of this call.
+     */
+    inline size_t GetBaseRowIndex(size_t row) const {
+        assert(row < rows_count);
+        return (row_indices != nullptr) ? row_indices[row] : row;
     }
 
     inline void Set(size_t col_cnt, size_t row_cnt, const ColumnInfo* info, const float* d) {
@@ -130,8 +245,62 @@ public:
         rows_count = row_cnt;
         columns = info;
         data = d;
+        column_views = nullptr;
+        base_rows_count = row_cnt;
+        row_indices = nullptr;
+        rows_cached = false;
     }
 
+    /**
+     * Set the data as one view per column. Like the column infos, the views
+     * must remain valid until the data are set again.
+     */
+    inline void SetColumns(size_t col_cnt, size_t row_cnt, const ColumnInfo* info, const ColumnView* cols) {
+        rows_cached = rows_cached && (columns_count == col_cnt) && (rows_count == row_cnt) && (columns == info) &&
+                      (column_views == cols) && (row_indices == nullptr);
+        columns_count = col_cnt;
+        rows_count = row_cnt;
+        columns = info;
+        data = nullptr;
+        column_views = cols;
+        base_rows_count = row_cnt;
+        row_indices = nullptr;
+    }
+
+    /**
+     * Set the data as a selection of the rows of the data of 'src' without
+     * copying. The indices refer to the shared data (cf. GetBaseRowIndex) and
+     * must, like the data of 'src', remain valid until the data are set again.
+     */
+    inline void SetSelection(const TableDataCall& src, const ColumnInfo* info, size_t row_cnt, const size_t* indices) {
+        columns_count = src.columns_count;
+        rows_count = row_cnt;
+        columns = info;
+        data = src.data;
+        column_views = src.column_views;
+        base_rows_count = src.base_rows_count;
+        row_indices = indices;
+        rows_cached = false;
+    }
+
+    /**
+     * Restrict the data request to the columns with the given names. An empty
+     * list requests all columns.
+     */
+    inline void SetRequestedColumns(std::vector<std::string> names) {
+        requested_columns = std::move(names);
+    }
+
+    inline const std::vector<std::string>& GetRequestedColumns() const {
+        return requested_columns;
+    }
+
+    /**
+     * Answer whether the column with the given name has been requested. Names
+     * are compared case-insensitive.
+     */
+    bool IsColumnRequested(const std::string& name) const;
+
     inline size_t GetFirstCategoricalColumnIndex() const {
         for (size_t i = 0; i < columns_count; ++i) {
             if (columns[i].Type() == ColumnType::CATEGORICAL) {
@@ -162,7 +331,7 @@ public:
         for (int c = 0; c < columns_count; ++c) {
             const auto& column = columns[c];
             for (int r = 0; r < rows_count; ++r) {
-                float cell = data[r * columns_count + c];
+                float cell = GetData(c, r);
                 assert(cell > column.MaximumValue() && "Value beyond maximum found");
                 assert(cell < column.MinimumValue() && "Value beyond maximum found");
             }
@@ -170,10 +339,20 @@ public:
     }
 
 private:
+    void materializeRows() const;
+
     size_t columns_count;
     size_t rows_count;
     const ColumnInfo* columns;
     const float* data; // data is stored row major order, aka array of structs
+    const ColumnView* column_views;
+    size_t base_rows_count;
+    const size_t* row_indices;
+    mutable std::vector<float> rows_cache;
+    mutable bool rows_cached;
+    mutable SIZE_T rows_cache_hash;
+    mutable unsigned int rows_cache_frame;
+    std::vector<std::string> requested_columns;
     unsigned int frameCount;
     unsigned int frameID;
 };
@@ -6,20 +6,49 @@
  */
 #include "MPIParticleCollector.h"
 #include "cluster/mpi/MpiCall.h"
+#include "mmcore/param/EnumParam.h"
+#include "mmcore/param/IntParam.h"
 #include "vislib/sys/SystemInformation.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 using namespace megamol;
 
+namespace {
+
+/** The largest message sent at once, which is well below the int limit of MPI counts. */
+constexpr uint64_t MaxMessageSize = 1ull << 30;
+
+enum CollectorTag : int { TAG_COUNT = 1, TAG_VERTEX = 2, TAG_COLOR = 3 };
+
+} // namespace
+
 
 /*
  * datatools::MPIParticleCollector::MPIParticleCollector
  */
 datatools::MPIParticleCollector::MPIParticleCollector()
         : AbstractParticleManipulator("outData", "indata")
-        , callRequestMpi("requestMpi", "Requests initialisation of MPI and the communicator for the view.") {
+        , callRequestMpi("requestMpi", "Requests initialisation of MPI and the communicator for the view.")
+        , collectModeSlot("collectMode", "Gather everything at once or merge the data along a tree of ranks")
+        , fanOutSlot("fanOut", "The number of children of each rank in Tree mode")
+        , subsampleSlot("subsample", "Only each n-th particle of each rank is collected") {
 
     this->callRequestMpi.SetCompatibleCall<core::cluster::mpi::MpiCallDescription>();
     this->MakeSlotAvailable(&this->callRequestMpi);
+
+    auto* cm = new core::param::EnumParam(static_cast<int>(CollectMode::GATHER));
+    cm->SetTypePair(static_cast<int>(CollectMode::GATHER), "Gather");
+    cm->SetTypePair(static_cast<int>(CollectMode::TREE), "Tree");
+    this->collectModeSlot << cm;
+    this->MakeSlotAvailable(&this->collectModeSlot);
+
+    this->fanOutSlot << new core::param::IntParam(2, 2);
+    this->MakeSlotAvailable(&this->fanOutSlot);
+
+    this->subsampleSlot << new core::param::IntParam(1, 1);
+    this->MakeSlotAvailable(&this->subsampleSlot);
 }
 
 
@@ -43,84 +72,57 @@ bool datatools::MPIParticleCollector::manipulateData(
     inData.SetUnlocker(nullptr, false); // keep original data locked
                                         // original data will be unlocked through outData
 #ifdef MEGAMOL_USE_MPI
-    bool useMpi = initMPI();
+    if (!initMPI()) {
+        return true;
+    }
+
+    const auto mode = static_cast<CollectMode>(this->collectModeSlot.Param<core::param::EnumParam>()->Value());
+    const int fanOut = this->fanOutSlot.Param<core::param::IntParam>()->Value();
+    const uint64_t subsample = this->subsampleSlot.Param<core::param::IntParam>()->Value();
 
     unsigned int plc = outData.GetParticleListCount();
     for (unsigned int i = 0; i < plc; i++) {
         MultiParticleDataCall::Particles& p = outData.AccessParticles(i);
 
-        uint64_t cnt = p.GetCount();
-
-        const uint8_t* cd = reinterpret_cast<const uint8_t*>(p.GetColourData());
-        unsigned int cds = p.GetColourDataStride();
         MultiParticleDataCall::Particles::ColourDataType cdt = p.GetColourDataType();
         unsigned int csize = MultiParticleDataCall::Particles::ColorDataSize[cdt];
+        const uint8_t* cd = reinterpret_cast<const uint8_t*>(p.GetColourData());
+        unsigned int cds = p.GetColourDataStride() == 0 ? csize : p.GetColourDataStride();
 
-        const uint8_t* vd = reinterpret_cast<const uint8_t*>(p.GetVertexData());
-        unsigned int vds = p.GetVertexDataStride();
         MultiParticleDataCall::Particles::VertexDataType vdt = p.GetVertexDataType();
         unsigned int vsize = MultiParticleDataCall::Particles::VertexDataSize[vdt];
+        const uint8_t* vd = reinterpret_cast<const uint8_t*>(p.GetVertexData());
+        unsigned int vds = p.GetVertexDataStride() == 0 ? vsize : p.GetVertexDataStride();
 
-        //megamol::core::utility::log::Log::DefaultLog.WriteInfo("Count = %lu", cnt);
-        //megamol::core::utility::log::Log::DefaultLog.WriteInfo("csize = %u, vsize = %u", csize, vsize);
-
-        std::vector<uint64_t> counts;
-        std::vector<int32_t> vertSizes, colSizes, vertOffsets, colOffsets;
-        counts.resize(this->mpiSize);
-        vertSizes.resize(this->mpiSize);
-        colSizes.resize(this->mpiSize);
-        vertOffsets.resize(this->mpiSize);
-        vertOffsets[0] = 0;
-        colOffsets.resize(this->mpiSize);
-        colOffsets[0] = 0;
-        uint64_t allCount = 0;
-        // MPI_Reduce(&cnt, &allCount, 1, MPI_INT64_T, MPI_SUM, 0, this->comm);
-        MPI_Gather(&cnt, 1, MPI_UINT64_T, counts.data(), 1, MPI_UINT64_T, 0, this->comm);
-
-        if (this->mpiRank == 0) {
-            for (auto x = 0; x < this->mpiSize; ++x) {
-                allCount += counts[x];
-                vertSizes[x] = counts[x] * vsize;
-                colSizes[x] = counts[x] * csize;
-                if (x > 0) {
-                    vertOffsets[x] = vertOffsets[x - 1] + counts[x - 1] * vsize;
-                    colOffsets[x] = colOffsets[x - 1] + counts[x - 1] * csize;
-                }
-            }
-            //megamol::core::utility::log::Log::DefaultLog.WriteInfo("allCount = %lu", allCount);
-            if (allCount * csize > std::numeric_limits<int>::max() ||
-                allCount * vsize > std::numeric_limits<int>::max()) {
-                // this is so bad there is no way to fix it
-                megamol::core::utility::log::Log::DefaultLog.WriteError(
-                    "allCount is more powerful than MPI, kill me now. Try subsampling more aggressively", allCount);
-                abort();
-            }
-            p.SetCount(allCount);
-            allVertexData.resize(allCount * vsize);
-            allColorData.resize(allCount * csize);
-        } else {
-            p.SetCount(cnt);
-        }
+        const uint64_t cnt = (p.GetCount() + subsample - 1) / subsample;
         vertexData.resize(cnt * vsize);
         colorData.resize(cnt * csize);
 
-        megamol::core::utility::log::Log::DefaultLog.FlushLog();
-
 #pragma omp parallel for
-        for (long long idx = 0; idx < cnt; ++idx) {
-            memcpy(colorData.data() + csize * idx, cd + cds * idx, csize);
-            memcpy(vertexData.data() + vsize * idx, vd + vds * idx, vsize);
+        for (long long idx = 0; idx < static_cast<long long>(cnt); ++idx) {
+            const uint64_t src = idx * subsample;
+            memcpy(colorData.data() + csize * idx, cd + cds * src, csize);
+            memcpy(vertexData.data() + vsize * idx, vd + vds * src, vsize);
         }
 
-        MPI_Gatherv(colorData.data(), cnt * csize, MPI_BYTE, allColorData.data(), colSizes.data(), colOffsets.data(),
-            MPI_BYTE, 0, this->comm);
-        MPI_Gatherv(vertexData.data(), cnt * vsize, MPI_BYTE, allVertexData.data(), vertSizes.data(),
-            vertOffsets.data(), MPI_BYTE, 0, this->comm);
+        // the fallback only applies to the list exceeding the limits, the other lists still use the selected mode
+        CollectMode listMode = mode;
+        uint64_t allCount = 0;
+        if (listMode == CollectMode::GATHER && !this->gatherFlat(cnt, vsize, csize, allCount)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                "MPIParticleCollector: list %u exceeds the limits of MPI_Gatherv, collecting along a tree instead", i);
+            listMode = CollectMode::TREE;
+        }
+        if (listMode == CollectMode::TREE) {
+            allCount = this->gatherTree(cnt, vsize, csize, fanOut);
+        }
 
         if (this->mpiRank == 0) {
+            p.SetCount(allCount);
             p.SetColourData(cdt, allColorData.data(), csize);
             p.SetVertexData(vdt, allVertexData.data(), vsize);
         } else {
+            p.SetCount(cnt);
             p.SetColourData(cdt, colorData.data(), csize);
             p.SetVertexData(vdt, vertexData.data(), vsize);
         }
@@ -164,3 +166,135 @@ bool datatools::MPIParticleCollector::initMPI() {
 #endif /* MEGAMOL_USE_MPI */
     return retval;
 }
+
+#ifdef MEGAMOL_USE_MPI
+
+/*
+ * datatools::MPIParticleCollector::gatherFlat
+ */
+bool datatools::MPIParticleCollector::gatherFlat(
+    uint64_t cnt, unsigned int vsize, unsigned int csize, uint64_t& allCount) {
+    std::vector<uint64_t> counts(this->mpiSize);
+    std::vector<int32_t> vertSizes(this->mpiSize), colSizes(this->mpiSize);
+    std::vector<int32_t> vertOffsets(this->mpiSize, 0), colOffsets(this->mpiSize, 0);
+    MPI_Gather(&cnt, 1, MPI_UINT64_T, counts.data(), 1, MPI_UINT64_T, 0, this->comm);
+
+    // All ranks have to agree on whether the limits are exceeded.
+    int fits = 1;
+    allCount = 0;
+    if (this->mpiRank == 0) {
+        for (auto x = 0; x < this->mpiSize; ++x) {
+            allCount += counts[x];
+        }
+        const uint64_t maxCount = std::numeric_limits<int>::max() / std::max(std::max(vsize, csize), 1u);
+        fits = (allCount <= maxCount) ? 1 : 0;
+    }
+    MPI_Bcast(&fits, 1, MPI_INT, 0, this->comm);
+    if (fits == 0) {
+        allCount = 0;
+        return false;
+    }
+
+    if (this->mpiRank == 0) {
+        for (auto x = 0; x < this->mpiSize; ++x) {
+            vertSizes[x] = static_cast<int32_t>(counts[x] * vsize);
+            colSizes[x] = static_cast<int32_t>(counts[x] * csize);
+            if (x > 0) {
+                vertOffsets[x] = vertOffsets[x - 1] + vertSizes[x - 1];
+                colOffsets[x] = colOffsets[x - 1] + colSizes[x - 1];
+            }
+        }
+        allVertexData.resize(allCount * vsize);
+        allColorData.resize(allCount * csize);
+    }
+
+    MPI_Gatherv(colorData.data(), static_cast<int>(cnt * csize), MPI_BYTE, allColorData.data(), colSizes.data(),
+        colOffsets.data(), MPI_BYTE, 0, this->comm);
+    MPI_Gatherv(vertexData.data(), static_cast<int>(cnt * vsize), MPI_BYTE, allVertexData.data(), vertSizes.data(),
+        vertOffsets.data(), MPI_BYTE, 0, this->comm);
+
+    return true;
+}
+
+
+/*
+ * datatools::MPIParticleCollector::gatherTree
+ */
+uint64_t datatools::MPIParticleCollector::gatherTree(
+    uint64_t cnt, unsigned int vsize, unsigned int csize, int fanOut) {
+    // In the k-ary tree, rank r has the children r * k + 1, ..., r * k + k.
+    const int64_t first = static_cast<int64_t>(this->mpiRank) * fanOut + 1;
+    const auto firstChild = static_cast<int>(std::min<int64_t>(first, this->mpiSize));
+    const auto lastChild = static_cast<int>(std::min<int64_t>(first + fanOut, this->mpiSize));
+
+    // Leaves send their local data directly, inner ranks merge their subtree first.
+    const uint8_t* vertSrc = vertexData.data();
+    const uint8_t* colSrc = colorData.data();
+    uint64_t subtreeCount = cnt;
+
+    if (firstChild < lastChild) {
+        std::vector<uint64_t> childCounts(lastChild - firstChild);
+        for (int c = firstChild; c < lastChild; ++c) {
+            MPI_Recv(&childCounts[c - firstChild], 1, MPI_UINT64_T, c, TAG_COUNT, this->comm, MPI_STATUS_IGNORE);
+            subtreeCount += childCounts[c - firstChild];
+        }
+
+        allVertexData.resize(subtreeCount * vsize);
+        allColorData.resize(subtreeCount * csize);
+        std::copy(vertexData.begin(), vertexData.end(), allVertexData.begin());
+        std::copy(colorData.begin(), colorData.end(), allColorData.begin());
+
+        uint64_t offset = cnt;
+        for (int c = firstChild; c < lastChild; ++c) {
+            const auto childCount = childCounts[c - firstChild];
+            this->recvChunked(allVertexData.data() + offset * vsize, childCount * vsize, c, TAG_VERTEX);
+            this->recvChunked(allColorData.data() + offset * csize, childCount * csize, c, TAG_COLOR);
+            offset += childCount;
+        }
+
+        vertSrc = allVertexData.data();
+        colSrc = allColorData.data();
+    } else if (this->mpiRank == 0) {
+        allVertexData = vertexData;
+        allColorData = colorData;
+    }
+
+    if (this->mpiRank > 0) {
+        const int parent = (this->mpiRank - 1) / fanOut;
+        MPI_Send(&subtreeCount, 1, MPI_UINT64_T, parent, TAG_COUNT, this->comm);
+        this->sendChunked(vertSrc, subtreeCount * vsize, parent, TAG_VERTEX);
+        this->sendChunked(colSrc, subtreeCount * csize, parent, TAG_COLOR);
+
+        // Inner ranks only needed the merged data for forwarding it.
+        allVertexData.clear();
+        allVertexData.shrink_to_fit();
+        allColorData.clear();
+        allColorData.shrink_to_fit();
+    }
+
+    return subtreeCount;
+}
+
+
+/*
+ * datatools::MPIParticleCollector::sendChunked
+ */
+void datatools::MPIParticleCollector::sendChunked(const uint8_t* data, uint64_t size, int dest, int tag) {
+    for (uint64_t offset = 0; offset < size; offset += MaxMessageSize) {
+        const auto len = static_cast<int>(std::min(MaxMessageSize, size - offset));
+        MPI_Send(data + offset, len, MPI_BYTE, dest, tag, this->comm);
+    }
+}
+
+
+/*
+ * datatools::MPIParticleCollector::recvChunked
+ */
+void datatools::MPIParticleCollector::recvChunked(uint8_t* data, uint64_t size, int src, int tag) {
+    for (uint64_t offset = 0; offset < size; offset += MaxMessageSize) {
+        const auto len = static_cast<int>(std::min(MaxMessageSize, size - offset));
+        MPI_Recv(data + offset, len, MPI_BYTE, src, tag, this->comm, MPI_STATUS_IGNORE);
+    }
+}
+
+#endif /* MEGAMOL_USE_MPI */
@@ -17,12 +17,18 @@ namespace megamol::datatools {
 
 /**
  * Module merging object-space distributed MultiparticleDataCalls over MPI.
- * This should be used for gathering large in situ SUBSAMPLED (ParticleThinner) data sets:
- * Everything is collected at once and MPI cannot push that much data
- * at once.
+ *
+ * In "Gather" mode, everything is collected at rank 0 at once using
+ * MPI_Gatherv, which is limited to 2 GB in total by the int counts of MPI.
+ * In "Tree" mode, the data is collected along a k-ary tree over the ranks,
+ * i.e. each rank merges the data of its children before sending it to its
+ * parent, and all messages are split into chunks below the int limit. The
+ * particles can additionally be subsampled before they are sent.
  */
 class MPIParticleCollector : public AbstractParticleManipulator {
 public:
+    enum class CollectMode { GATHER, TREE };
+
     /** Return module class name */
     static const char* ClassName() {
         return "MPIParticleCollector";
@@ -64,6 +70,30 @@ protected:
 
 private:
 #ifdef MEGAMOL_USE_MPI
+    /**
+     * Collects 'vertexData' and 'colorData' of all ranks in 'allVertexData'
+     * and 'allColorData' at rank 0 using MPI_Gatherv. 'allCount' receives
+     * the number of particles collected at rank 0.
+     *
+     * @return False if the data exceeds the int limits of MPI_Gatherv, in
+     *         which case nothing has been transferred.
+     */
+    bool gatherFlat(uint64_t cnt, unsigned int vsize, unsigned int csize, uint64_t& allCount);
+
+    /**
+     * Collects 'vertexData' and 'colorData' of all ranks in 'allVertexData'
+     * and 'allColorData' at rank 0 along a tree with the given fan-out.
+     *
+     * @return The number of particles of the subtree of this rank.
+     */
+    uint64_t gatherTree(uint64_t cnt, unsigned int vsize, unsigned int csize, int fanOut);
+
+    /** Sends 'size' bytes in messages below the int limit of MPI. */
+    void sendChunked(const uint8_t* data, uint64_t size, int dest, int tag);
+
+    /** Receives 'size' bytes sent by sendChunked. */
+    void recvChunked(uint8_t* data, uint64_t size, int src, int tag);
+
     /** The communicator that the view uses. */
     MPI_Comm comm = MPI_COMM_NULL;
 #endif /* MEGAMOL_USE_MPI */
@@ -71,6 +101,15 @@ private:
     /** slot for MPIprovider */
     core::CallerSlot callRequestMpi;
 
+    /** The way the particles are collected */
+    core::param::ParamSlot collectModeSlot;
+
+    /** The number of children of each rank in "Tree" mode */
+    core::param::ParamSlot fanOutSlot;
+
+    /** Only each n-th particle is sent to rank 0 */
+    core::param::ParamSlot subsampleSlot;
+
     int mpiRank = 0;
     int mpiSize = 0;
 
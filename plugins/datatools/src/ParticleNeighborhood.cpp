@@ -5,6 +5,7 @@
  * Alle Rechte vorbehalten.
  */
 #include "ParticleNeighborhood.h"
+#include "datatools/SpatialIndexDataCall.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FloatParam.h"
@@ -13,6 +14,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cfloat>
+#include <cmath>
 #include <cstdint>
 
 using namespace megamol;
@@ -30,13 +32,12 @@ datatools::ParticleNeighborhood::ParticleNeighborhood()
         , particleNumberSlot("idx", "the particle to track")
         , outDataSlot("outData", "Provides colors based on local particle temperature")
         , inDataSlot("inData", "Takes the directional particle data")
+        , spatialIndexSlot("spatialIndex", "Optionally takes a shared spatial index of the input data")
         , datahash(0)
         , lastTime(-1)
         , newColors()
         , maxDist(0)
-        , allParts()
-        , particleTree(nullptr)
-        , myPts(nullptr) {
+        , particleIndex(nullptr) {
 
     this->cyclXSlot.SetParameter(new core::param::BoolParam(true));
     this->MakeSlotAvailable(&this->cyclXSlot);
@@ -70,6 +71,9 @@ datatools::ParticleNeighborhood::ParticleNeighborhood()
 
     this->inDataSlot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
     this->MakeSlotAvailable(&this->inDataSlot);
+
+    this->spatialIndexSlot.SetCompatibleCall<SpatialIndexDataCallDescription>();
+    this->MakeSlotAvailable(&this->spatialIndexSlot);
 }
 
 
@@ -91,7 +95,9 @@ bool datatools::ParticleNeighborhood::create() {
 /*
  * datatools::ParticleNeighborhood::release
  */
-void datatools::ParticleNeighborhood::release() {}
+void datatools::ParticleNeighborhood::release() {
+    this->particleIndex.reset();
+}
 
 bool isListOK(megamol::core::AbstractGetData3DCall* c, unsigned int i) {
     using geocalls::MultiParticleDataCall;
@@ -136,6 +142,9 @@ bool datatools::ParticleNeighborhood::assertData(
     int thePart = this->particleNumberSlot.Param<core::param::IntParam>()->Value();
 
     if (this->lastTime != time || this->datahash != in->DataHash()) {
+        // Fetch the shared index first, as its provider requests the same frame.
+        auto sharedIndex = this->getSharedIndex(time);
+
         in->SetFrameID(time, true);
 
         if (!(*in)(0)) {
@@ -158,31 +167,16 @@ bool datatools::ParticleNeighborhood::assertData(
             this->newColors.resize(totalParts);
         }
 
-        allParts.clear();
-        allParts.reserve(totalParts);
-
-        // we could now filter particles according to something. but currently we need not.
-        size_t allpartcnt = 0;
-        for (unsigned int pli = 0; pli < plc; pli++) {
-            if (!isListOK(in, pli)) {
-                continue;
-            }
-
-            UINT64 part_cnt = getListCount(in, pli);
-
-            for (int part_i = 0; part_i < part_cnt; ++part_i) {
-                allParts.push_back(allpartcnt + part_i);
+        // The index numbers the particles of all lists with float positions consecutively, like we do.
+        if ((sharedIndex != nullptr) && (sharedIndex->Count() == totalParts)) {
+            this->particleIndex = sharedIndex;
+        } else {
+            if (sharedIndex != nullptr) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "ParticleNeighborhood: shared spatial index does not match the input data, building own index");
             }
-            allpartcnt += getListCount(in, pli);
+            this->particleIndex = std::make_shared<const SpatialIndex>(*inMpdc);
         }
-
-        // allocate nanoflann data structures for border
-        assert(allpartcnt == totalParts);
-
-        this->myPts = std::make_shared<simplePointcloud>(inMpdc, allParts);
-        particleTree = std::make_shared<my_kd_tree_t>(
-            3 /* dim */, *myPts, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
-        particleTree->buildIndex();
         this->datahash = in->DataHash();
         this->lastTime = time;
         this->radiusSlot.ForceSetDirty();
@@ -204,80 +198,31 @@ bool datatools::ParticleNeighborhood::assertData(
                 }
             }
 
-            const float* vbase = myPts->get_position(thePart);
-            float theVertex[3];
+            const float* vbase = this->particleIndex->Position(thePart);
             maxDist = 0.0f;
-            std::vector<nanoflann::ResultItem<size_t, float>> ret_matches;
-            std::vector<nanoflann::ResultItem<size_t, float>> ret_localMatches;
-            std::vector<size_t> ret_index(theNumber);
-            std::vector<float> out_dist_sqr(theNumber);
-            nanoflann::KNNResultSet<float> resultSet(theNumber);
-            nanoflann::SearchParameters params;
-            params.sorted = false;
-
-            // final computation
-            bool cycl_x = this->cyclXSlot.Param<megamol::core::param::BoolParam>()->Value();
-            bool cycl_y = this->cyclYSlot.Param<megamol::core::param::BoolParam>()->Value();
-            bool cycl_z = this->cyclZSlot.Param<megamol::core::param::BoolParam>()->Value();
-            auto bbox = in->AccessBoundingBoxes().ObjectSpaceBBox();
-            //bbox.EnforcePositiveSize(); // paranoia
-            auto bbox_cntr = bbox.CalcCenter();
-
-            ret_matches.clear();
+            std::vector<SpatialIndex::Match> ret_matches;
             ret_matches.reserve(100);
 
-            for (int x_s = 0; x_s < (cycl_x ? 2 : 1); ++x_s) {
-                for (int y_s = 0; y_s < (cycl_y ? 2 : 1); ++y_s) {
-                    for (int z_s = 0; z_s < (cycl_z ? 2 : 1); ++z_s) {
-
-                        theVertex[0] = vbase[0];
-                        theVertex[1] = vbase[1];
-                        theVertex[2] = vbase[2];
-                        if (x_s > 0)
-                            theVertex[0] =
-                                theVertex[0] + ((theVertex[0] > bbox_cntr.X()) ? -bbox.Width() : bbox.Width());
-                        if (y_s > 0)
-                            theVertex[1] =
-                                theVertex[1] + ((theVertex[1] > bbox_cntr.Y()) ? -bbox.Height() : bbox.Height());
-                        if (z_s > 0)
-                            theVertex[2] =
-                                theVertex[2] + ((theVertex[2] > bbox_cntr.Z()) ? -bbox.Depth() : bbox.Depth());
-
-                        if (theSearchType == searchTypeEnum::RADIUS) {
-                            particleTree->radiusSearch(theVertex, theRadius, ret_localMatches, params);
-                            ret_matches.insert(ret_matches.end(), ret_localMatches.begin(), ret_localMatches.end());
-                        } else {
-                            resultSet.init(ret_index.data(), out_dist_sqr.data());
-                            particleTree->findNeighbors(resultSet, theVertex, params);
-                            for (size_t i = 0; i < resultSet.size(); ++i) {
-                                ret_matches.push_back(
-                                    nanoflann::ResultItem<size_t, float>(ret_index[i], out_dist_sqr[i]));
-                            }
-                        }
-                    }
-                }
-            }
+            // final computation
+            const SpatialIndex::Periodicity periodic = {
+                this->cyclXSlot.Param<megamol::core::param::BoolParam>()->Value(),
+                this->cyclYSlot.Param<megamol::core::param::BoolParam>()->Value(),
+                this->cyclZSlot.Param<megamol::core::param::BoolParam>()->Value()};
 
             size_t num_matches = 0;
 
-            // TODO this probably is not even worth it, writing something several times is probably cheaper.
-            //sort(ret_matches.begin(), ret_matches.end());
-            //ret_matches.erase(unique(ret_matches.begin(), ret_matches.end()), ret_matches.end());
-
-            // reset all colors
             if (theSearchType == searchTypeEnum::RADIUS) {
+                num_matches = this->particleIndex->RadiusSearch(
+                    vbase, this->radiusSlot.Param<core::param::FloatParam>()->Value(), ret_matches, periodic);
                 maxDist = theRadius;
-                num_matches = ret_matches.size();
             } else {
-                // find overall closest! we did search around periodic boundary conditions, so there will be huge distances!
-                sort(ret_matches.begin(), ret_matches.end(),
-                    [](const decltype(ret_matches)::value_type& left, const decltype(ret_matches)::value_type& right) {
-                        return left.second < right.second;
-                    });
+                // the matches are the overall closest ones across the periodic boundaries, closest first.
+                num_matches = this->particleIndex->KnnSearch(
+                    vbase, static_cast<size_t>(std::max(theNumber, 0)), ret_matches, periodic);
                 // the furthest is theNumber closest or the last one if fewer.
-                num_matches = ret_matches.size() >= theNumber ? theNumber : ret_matches.size();
-                maxDist = ret_matches[num_matches - 1].second;
+                maxDist = (num_matches > 0) ? ret_matches[num_matches - 1].second : 0.0f;
             }
+            // reset all colors
             std::fill(newColors.begin(), newColors.end(), maxDist);
 
             for (size_t i = 0; i < num_matches; ++i) {
@@ -323,6 +268,21 @@ bool datatools::ParticleNeighborhood::assertData(
 }
 
 
+std::shared_ptr<const datatools::SpatialIndex> datatools::ParticleNeighborhood::getSharedIndex(unsigned int time) {
+    auto sic = this->spatialIndexSlot.CallAs<SpatialIndexDataCall>();
+    if (sic == nullptr)
+        return nullptr;
+
+    sic->SetFrameID(time, true);
+    if (!(*sic)(0)) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "ParticleNeighborhood: could not get shared spatial index for frame (%u)", time);
+        return nullptr;
+    }
+    return sic->GetIndex();
+}
+
+
 bool datatools::ParticleNeighborhood::getExtentCallback(megamol::core::Call& c) {
     using geocalls::MultiParticleDataCall;
 
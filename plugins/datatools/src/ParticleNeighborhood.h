@@ -7,12 +7,12 @@
 
 #pragma once
 
-#include "datatools/PointcloudHelpers.h"
+#include "datatools/SpatialIndex.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
-#include <nanoflann.hpp>
+#include <memory>
 #include <vector>
 
 namespace megamol::datatools {
@@ -73,6 +73,12 @@ protected:
 private:
     bool assertData(megamol::core::AbstractGetData3DCall* in, megamol::core::AbstractGetData3DCall* out);
 
+    /**
+     * Answers the index provided via spatialIndexSlot for the given frame, or
+     * nullptr if the slot is not connected.
+     */
+    std::shared_ptr<const SpatialIndex> getSharedIndex(unsigned int time);
+
     core::param::ParamSlot cyclXSlot;
     core::param::ParamSlot cyclYSlot;
     core::param::ParamSlot cyclZSlot;
@@ -83,21 +89,19 @@ private:
     size_t datahash;
     int lastTime;
     std::vector<float> newColors;
-    std::vector<size_t> allParts;
     float maxDist;
 
-    typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<float, simplePointcloud>, simplePointcloud,
-        3 /* dim */, std::size_t>
-        my_kd_tree_t;
-
-    std::shared_ptr<my_kd_tree_t> particleTree;
-    std::shared_ptr<simplePointcloud> myPts;
+    /** The spatial index of the current frame, either shared or built locally */
+    std::shared_ptr<const SpatialIndex> particleIndex;
 
     /** The slot providing access to the manipulated data */
     megamol::core::CalleeSlot outDataSlot;
 
     /** The slot accessing the original data */
     megamol::core::CallerSlot inDataSlot;
+
+    /** The optional slot accessing a shared spatial index of the original data */
+    megamol::core::CallerSlot spatialIndexSlot;
 };
 
 } // namespace megamol::datatools
@@ -0,0 +1,137 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "ParticleSpatialIndex.h"
+
+#include <limits>
+
+#include "datatools/SpatialIndexDataCall.h"
+#include "geometry_calls/MultiParticleDataCall.h"
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol;
+using namespace megamol::datatools;
+
+
+/*
+ * ParticleSpatialIndex::ParticleSpatialIndex
+ */
+ParticleSpatialIndex::ParticleSpatialIndex()
+        : outIndexSlot("outIndex", "Provides the spatial index of the particles")
+        , inDataSlot("inData", "Takes the particle data")
+        , index(nullptr)
+        , datahash(0)
+        , frameID((std::numeric_limits<unsigned int>::max)()) {
+    this->outIndexSlot.SetCallback(SpatialIndexDataCall::ClassName(), SpatialIndexDataCall::FunctionName(0),
+        &ParticleSpatialIndex::getDataCallback);
+    this->outIndexSlot.SetCallback(SpatialIndexDataCall::ClassName(), SpatialIndexDataCall::FunctionName(1),
+        &ParticleSpatialIndex::getExtentCallback);
+    this->MakeSlotAvailable(&this->outIndexSlot);
+
+    this->inDataSlot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
+    this->MakeSlotAvailable(&this->inDataSlot);
+}
+
+
+/*
+ * ParticleSpatialIndex::~ParticleSpatialIndex
+ */
+ParticleSpatialIndex::~ParticleSpatialIndex() {
+    this->Release();
+}
+
+
+/*
+ * ParticleSpatialIndex::create
+ */
+bool ParticleSpatialIndex::create() {
+    return true;
+}
+
+
+/*
+ * ParticleSpatialIndex::release
+ */
+void ParticleSpatialIndex::release() {
+    this->index.reset();
+}
+
+
+/*
+ * ParticleSpatialIndex::getDataCallback
+ */
+bool ParticleSpatialIndex::getDataCallback(core::Call& c) {
+    using geocalls::MultiParticleDataCall;
+    using megamol::core::utility::log::Log;
+
+    auto out = dynamic_cast<SpatialIndexDataCall*>(&c);
+    if (out == nullptr)
+        return false;
+
+    auto in = this->inDataSlot.CallAs<MultiParticleDataCall>();
+    if (in == nullptr)
+        return false;
+
+    const auto time = out->FrameID();
+    do {
+        in->SetFrameID(time, true);
+        if (!(*in)(1)) {
+            Log::DefaultLog.WriteError("ParticleSpatialIndex: could not get frame (%u) extents", time);
+            return false;
+        }
+        if (!(*in)(0)) {
+            Log::DefaultLog.WriteError("ParticleSpatialIndex: could not get frame (%u) data", time);
+            return false;
+        }
+    } while (in->FrameID() != time);
+
+    if ((this->index == nullptr) || (this->frameID != time) || (this->datahash != in->DataHash())) {
+        // Consumers still holding the previous index keep it alive until they are done.
+        this->index = std::make_shared<const SpatialIndex>(*in);
+        this->frameID = time;
+        this->datahash = in->DataHash();
+    }
+
+    out->SetFrameID(time);
+    out->SetFrameCount(in->FrameCount());
+    out->AccessBoundingBoxes() = in->AccessBoundingBoxes();
+    out->SetDataHash(this->datahash);
+    out->SetIndex(this->index);
+    out->SetUnlocker(nullptr);
+
+    in->Unlock();
+
+    return true;
+}
+
+
+/*
+ * ParticleSpatialIndex::getExtentCallback
+ */
+bool ParticleSpatialIndex::getExtentCallback(core::Call& c) {
+    using geocalls::MultiParticleDataCall;
+
+    auto out = dynamic_cast<SpatialIndexDataCall*>(&c);
+    if (out == nullptr)
+        return false;
+
+    auto in = this->inDataSlot.CallAs<MultiParticleDataCall>();
+    if (in == nullptr)
+        return false;
+
+    in->SetFrameID(out->FrameID(), out->IsFrameForced());
+    if (!(*in)(1))
+        return false;
+
+    out->SetFrameCount(in->FrameCount());
+    out->AccessBoundingBoxes() = in->AccessBoundingBoxes();
+    out->SetDataHash(in->DataHash());
+    out->SetUnlocker(nullptr);
+
+    in->Unlock();
+
+    return true;
+}
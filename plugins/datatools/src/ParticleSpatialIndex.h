@@ -0,0 +1,71 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "datatools/SpatialIndex.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/Module.h"
+
+namespace megamol::datatools {
+
+/**
+ * Module building a kd-tree over the particles of a frame once and handing
+ * it out to all connected neighbourhood-based modules.
+ */
+class ParticleSpatialIndex : public core::Module {
+public:
+    /** Return module class name */
+    static const char* ClassName() {
+        return "ParticleSpatialIndex";
+    }
+
+    /** Return module class description */
+    static const char* Description() {
+        return "Builds a shared kd-tree over all particles of the current frame.";
+    }
+
+    /** Module is always available */
+    static bool IsAvailable() {
+        return true;
+    }
+
+    /** Ctor */
+    ParticleSpatialIndex();
+
+    /** Dtor */
+    ~ParticleSpatialIndex() override;
+
+protected:
+    bool create() override;
+
+    void release() override;
+
+private:
+    bool getDataCallback(core::Call& c);
+
+    bool getExtentCallback(core::Call& c);
+
+    /** The slot providing the index */
+    core::CalleeSlot outIndexSlot;
+
+    /** The slot accessing the particles */
+    core::CallerSlot inDataSlot;
+
+    /** The index of the last frame requested */
+    std::shared_ptr<const SpatialIndex> index;
+
+    /** The data hash of the particles the index was built for */
+    size_t datahash;
+
+    /** The frame the index was built for */
+    unsigned int frameID;
+};
+
+} // namespace megamol::datatools
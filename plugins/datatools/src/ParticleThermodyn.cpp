@@ -5,6 +5,7 @@
  * Alle Rechte vorbehalten.
  */
 #include "ParticleThermodyn.h"
+#include "datatools/SpatialIndexDataCall.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FloatParam.h"
@@ -55,8 +56,10 @@ datatools::ParticleThermodyn::ParticleThermodyn()
         , maxDist(0.0f)
         , particleTree(nullptr)
         , myPts(nullptr)
+        , sharedIndex(nullptr)
         , outDataSlot("outData", "Provides intensities based on a local particle metric")
-        , inDataSlot("inData", "Takes the directional particle data") {
+        , inDataSlot("inData", "Takes the directional particle data")
+        , spatialIndexSlot("spatialIndex", "Optionally takes a shared spatial index of the input data") {
 
     this->cyclXSlot.SetParameter(new core::param::BoolParam(true));
     this->MakeSlotAvailable(&this->cyclXSlot);
@@ -130,6 +133,9 @@ datatools::ParticleThermodyn::ParticleThermodyn()
 
     this->inDataSlot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
     this->MakeSlotAvailable(&this->inDataSlot);
+
+    this->spatialIndexSlot.SetCompatibleCall<SpatialIndexDataCallDescription>();
+    this->MakeSlotAvailable(&this->spatialIndexSlot);
 }
 
 
@@ -182,7 +188,9 @@ bool isDirOK(megamol::datatools::ParticleThermodyn::metricsEnum metric, geocalls
 /*
  * datatools::ParticleThermodyn::release
  */
-void datatools::ParticleThermodyn::release() {}
+void datatools::ParticleThermodyn::release() {
+    this->sharedIndex.reset();
+}
 
 
 bool datatools::ParticleThermodyn::assertData(
@@ -207,6 +215,9 @@ bool datatools::ParticleThermodyn::assertData(
     size_t allpartcnt = 0;
 
     if (this->lastTime != time || this->datahash != in->DataHash() || myHash == 0) {
+        // Fetch the shared index first, as its provider requests the same frame.
+        auto index = this->getSharedIndex(time);
+
         do {
             in->SetFrameID(time, true);
             if (!(*in)(1)) {
@@ -268,12 +279,23 @@ bool datatools::ParticleThermodyn::assertData(
         assert(allpartcnt == totalParts);
         this->myPts = std::make_shared<simplePointcloud>(in, allParts);
 
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-            "ParticleThermodyn: building acceleration structure for frame %u...", out->FrameID());
-        particleTree = std::make_shared<my_kd_tree_t>(
-            3 /* dim */, *myPts, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
-        particleTree->buildIndex();
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticleThermodyn: done.");
+        // The shared index numbers the particles like we do as long as we do not skip lists for lacking velocities.
+        this->sharedIndex.reset();
+        if ((index != nullptr) && (index->Count() == totalParts)) {
+            this->sharedIndex = index;
+            this->particleTree.reset();
+        } else {
+            if (index != nullptr) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "ParticleThermodyn: shared spatial index does not match the selected lists, building own index");
+            }
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                "ParticleThermodyn: building acceleration structure for frame %u...", out->FrameID());
+            particleTree = std::make_shared<my_kd_tree_t>(
+                3 /* dim */, *myPts, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
+            particleTree->buildIndex();
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticleThermodyn: done.");
+        }
 
         this->datahash = in->DataHash();
         this->lastTime = time;
@@ -288,6 +310,7 @@ bool datatools::ParticleThermodyn::assertData(
         bool cycl_x = this->cyclXSlot.Param<megamol::core::param::BoolParam>()->Value();
         bool cycl_y = this->cyclYSlot.Param<megamol::core::param::BoolParam>()->Value();
         bool cycl_z = this->cyclZSlot.Param<megamol::core::param::BoolParam>()->Value();
+        const SpatialIndex::Periodicity periodic = {cycl_x, cycl_y, cycl_z};
         auto bbox = in->AccessBoundingBoxes().ObjectSpaceBBox();
         // bbox.EnforcePositiveSize(); // paranoia
         auto bbox_cntr = bbox.CalcCenter();
@@ -334,6 +357,7 @@ bool datatools::ParticleThermodyn::assertData(
                 float theVertex[3];
                 std::vector<nanoflann::ResultItem<size_t, float>> ret_matches;
                 std::vector<nanoflann::ResultItem<size_t, float>> ret_localMatches;
+                std::vector<SpatialIndex::Match> ret_sharedMatches;
                 std::vector<size_t> ret_index(theNumber);
                 std::vector<float> out_dist_sqr(theNumber);
                 nanoflann::KNNResultSet<float> resultSet(theNumber);
@@ -352,45 +376,57 @@ bool datatools::ParticleThermodyn::assertData(
                     const float* vertexBase = this->myPts->get_position(myIndex);
                     // const float *velocityBase = this->myPts->get_velocity(myIndex);
 
-                    for (int x_s = 0; x_s < (cycl_x ? 2 : 1); ++x_s) {
-                        for (int y_s = 0; y_s < (cycl_y ? 2 : 1); ++y_s) {
-                            for (int z_s = 0; z_s < (cycl_z ? 2 : 1); ++z_s) {
-
-                                theVertex[0] = vertexBase[0];
-                                theVertex[1] = vertexBase[1];
-                                theVertex[2] = vertexBase[2];
-                                if (x_s > 0)
-                                    theVertex[0] =
-                                        theVertex[0] + ((theVertex[0] > bbox_cntr.X()) ? -bbox.Width() : bbox.Width());
-                                if (y_s > 0)
-                                    theVertex[1] = theVertex[1] +
-                                                   ((theVertex[1] > bbox_cntr.Y()) ? -bbox.Height() : bbox.Height());
-                                if (z_s > 0)
-                                    theVertex[2] =
-                                        theVertex[2] + ((theVertex[2] > bbox_cntr.Z()) ? -bbox.Depth() : bbox.Depth());
-
-                                if (theSearchType == searchTypeEnum::RADIUS) {
-                                    // the documentation says the parameter radius for L2 is squared
-                                    // caution: the criterion is < radius, not <= !!!!
-                                    particleTree->radiusSearch(
-                                        theVertex, theSquaredRadius + eps, ret_localMatches, params);
-                                    if (remove_self) {
-                                        ret_localMatches.erase(
-                                            std::remove_if(ret_localMatches.begin(), ret_localMatches.end(),
-                                                [&](decltype(ret_localMatches)::value_type& elem) {
-                                                    return elem.first == myIndex;
-                                                }),
-                                            ret_localMatches.end());
-                                    }
-                                    ret_matches.insert(
-                                        ret_matches.end(), ret_localMatches.begin(), ret_localMatches.end());
-                                } else {
-                                    resultSet.init(ret_index.data(), out_dist_sqr.data());
-                                    particleTree->findNeighbors(resultSet, theVertex, params);
-                                    for (size_t i = 0; i < resultSet.size(); ++i) {
-                                        if (!remove_self || ret_index[i] != myIndex) {
-                                            ret_matches.push_back(
-                                                nanoflann::ResultItem<size_t, float>(ret_index[i], out_dist_sqr[i]));
+                    if (this->sharedIndex != nullptr) {
+                        // the shared index already searches across the periodic boundaries.
+                        if (theSearchType == searchTypeEnum::RADIUS) {
+                            this->sharedIndex->RadiusSearch(vertexBase, theRadius, ret_sharedMatches, periodic);
+                        } else {
+                            this->sharedIndex->KnnSearch(
+                                vertexBase, static_cast<size_t>(theNumber), ret_sharedMatches, periodic);
+                        }
+                        for (auto& m : ret_sharedMatches) {
+                            if (!remove_self || m.first != myIndex) {
+                                ret_matches.push_back(nanoflann::ResultItem<size_t, float>(m.first, m.second));
+                            }
+                        }
+                    } else {
+                        for (int x_s = 0; x_s < (cycl_x ? 2 : 1); ++x_s) {
+                            for (int y_s = 0; y_s < (cycl_y ? 2 : 1); ++y_s) {
+                                for (int z_s = 0; z_s < (cycl_z ? 2 : 1); ++z_s) {
+
+                                    theVertex[0] = vertexBase[0];
+                                    theVertex[1] = vertexBase[1];
+                                    theVertex[2] = vertexBase[2];
+                                    if (x_s > 0)
+                                        theVertex[0] += (theVertex[0] > bbox_cntr.X()) ? -bbox.Width() : bbox.Width();
+                                    if (y_s > 0)
+                                        theVertex[1] += (theVertex[1] > bbox_cntr.Y()) ? -bbox.Height() : bbox.Height();
+                                    if (z_s > 0)
+                                        theVertex[2] += (theVertex[2] > bbox_cntr.Z()) ? -bbox.Depth() : bbox.Depth();
+
+                                    if (theSearchType == searchTypeEnum::RADIUS) {
+                                        // the documentation says the parameter radius for L2 is squared
+                                        // caution: the criterion is < radius, not <= !!!!
+                                        particleTree->radiusSearch(
+                                            theVertex, theSquaredRadius + eps, ret_localMatches, params);
+                                        if (remove_self) {
+                                            ret_localMatches.erase(
+                                                std::remove_if(ret_localMatches.begin(), ret_localMatches.end(),
+                                                    [&](decltype(ret_localMatches)::value_type& elem) {
+                                                        return elem.first == myIndex;
+                                                    }),
+                                                ret_localMatches.end());
+                                        }
+                                        ret_matches.insert(
+                                            ret_matches.end(), ret_localMatches.begin(), ret_localMatches.end());
+                                    } else {
+                                        resultSet.init(ret_index.data(), out_dist_sqr.data());
+                                        particleTree->findNeighbors(resultSet, theVertex, params);
+                                        for (size_t i = 0; i < resultSet.size(); ++i) {
+                                            if (!remove_self || ret_index[i] != myIndex) {
+                                                ret_matches.push_back(nanoflann::ResultItem<size_t, float>(
+                                                    ret_index[i], out_dist_sqr[i]));
+                                            }
                                         }
                                     }
                                 }
@@ -696,6 +732,21 @@ float megamol::datatools::ParticleThermodyn::computeDensity(std::vector<nanoflan
 }
 
 
+std::shared_ptr<const datatools::SpatialIndex> datatools::ParticleThermodyn::getSharedIndex(unsigned int time) {
+    auto sic = this->spatialIndexSlot.CallAs<SpatialIndexDataCall>();
+    if (sic == nullptr)
+        return nullptr;
+
+    sic->SetFrameID(time, true);
+    if (!(*sic)(0)) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "ParticleThermodyn: could not get shared spatial index for frame (%u)", time);
+        return nullptr;
+    }
+    return sic->GetIndex();
+}
+
+
 bool datatools::ParticleThermodyn::getExtentCallback(megamol::core::Call& c) {
     using geocalls::MultiParticleDataCall;
 
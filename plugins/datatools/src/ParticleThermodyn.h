@@ -8,6 +8,7 @@
 #pragma once
 
 #include "datatools/PointcloudHelpers.h"
+#include "datatools/SpatialIndex.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
@@ -88,6 +89,12 @@ protected:
 private:
     bool assertData(geocalls::MultiParticleDataCall* in, geocalls::MultiParticleDataCall* outMPDC);
 
+    /**
+     * Answers the index provided via spatialIndexSlot for the given frame, or
+     * nullptr if the slot is not connected.
+     */
+    std::shared_ptr<const SpatialIndex> getSharedIndex(unsigned int time);
+
     float computeDriftVelocity(
         std::vector<nanoflann::ResultItem<size_t, float>>& matches, size_t num_matches, float mass, float freedom);
     float computeTemperature(
@@ -130,11 +137,17 @@ private:
     std::shared_ptr<my_kd_tree_t> particleTree;
     std::shared_ptr<simplePointcloud> myPts;
 
+    /** The shared spatial index used instead of particleTree, if available */
+    std::shared_ptr<const SpatialIndex> sharedIndex;
+
     /** The slot providing access to the manipulated data */
     megamol::core::CalleeSlot outDataSlot;
 
     /** The slot accessing the original data */
     megamol::core::CallerSlot inDataSlot;
+
+    /** The optional slot accessing a shared spatial index of the original data */
+    megamol::core::CallerSlot spatialIndexSlot;
 };
 
 } // namespace megamol::datatools
@@ -9,13 +9,17 @@
 #define _USE_MATH_DEFINES
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <utility>
 #include <vector>
@@ -33,6 +37,105 @@
 
 using namespace megamol;
 
+namespace {
+
+/**
+ * Implements the Bump Function from
+ * https://en.wikipedia.org/wiki/Radial_basis_function
+ */
+inline float splatKernel(float const dist, float const epsilon) {
+    if (dist >= epsilon)
+        return 0.0f;
+    return std::exp(-1.0f / (1.0f - std::pow((1.0f / epsilon) * dist, 2.0f)));
+}
+
+/** Voxel footprint of a single particle */
+struct SplatFootprint {
+    std::array<float, 3> pos;
+    float rad;
+    std::array<int, 3> center;
+    std::array<int, 3> size;
+};
+
+/**
+ * Partitioning of the volume into bricks which are splatted independently,
+ * so that threads never write to the same voxel.
+ */
+struct BrickGrid {
+    static constexpr int BrickSize = 16;
+
+    /** Up to two (inclusive) ranges of brick indices along one axis */
+    struct Ranges {
+        int num = 0;
+        std::array<std::pair<int, int>, 2> r;
+    };
+
+    BrickGrid(int sx, int sy, int sz, bool cx, bool cy, bool cz)
+            : res{sx, sy, sz}
+            , num{(sx + BrickSize - 1) / BrickSize, (sy + BrickSize - 1) / BrickSize, (sz + BrickSize - 1) / BrickSize}
+            , cyclic{cx, cy, cz} {}
+
+    static int Wrap(int v, int s) {
+        int const m = v % s;
+        return (m < 0) ? m + s : m;
+    }
+
+    /** Answer the bricks along axis 'd' touched by the unwrapped voxel range [lo, hi] */
+    Ranges Range(int d, int lo, int hi) const {
+        Ranges ret;
+        int const s = res[d];
+        if (!cyclic[d]) {
+            lo = std::max(lo, 0);
+            hi = std::min(hi, s - 1);
+            if (lo <= hi) {
+                ret.r[ret.num++] = {lo / BrickSize, hi / BrickSize};
+            }
+        } else if (hi - lo + 1 >= s) {
+            ret.r[ret.num++] = {0, num[d] - 1};
+        } else {
+            int const wlo = Wrap(lo, s) / BrickSize;
+            int const whi = Wrap(hi, s) / BrickSize;
+            if (Wrap(lo, s) <= Wrap(hi, s)) {
+                ret.r[ret.num++] = {wlo, whi};
+            } else if (whi >= wlo) {
+                // both ends wrap into the same brick
+                ret.r[ret.num++] = {0, num[d] - 1};
+            } else {
+                ret.r[ret.num++] = {wlo, num[d] - 1};
+                ret.r[ret.num++] = {0, whi};
+            }
+        }
+        return ret;
+    }
+
+    /** Collects the voxels of the unwrapped range [lo, hi] along 'd' which fall into 'brick' */
+    void Clip(int d, int brick, int lo, int hi, std::vector<int>& unwrapped, std::vector<int>& wrapped) const {
+        unwrapped.clear();
+        wrapped.clear();
+        int const s = res[d];
+        int const b0 = brick * BrickSize;
+        int const b1 = std::min(b0 + BrickSize, s);
+        for (int h = lo; h <= hi; ++h) {
+            int w = h;
+            if (cyclic[d]) {
+                w = Wrap(h, s);
+            } else if (h < 0 || h > s - 1) {
+                continue;
+            }
+            if (w >= b0 && w < b1) {
+                unwrapped.push_back(h);
+                wrapped.push_back(w);
+            }
+        }
+    }
+
+    std::array<int, 3> res;
+    std::array<int, 3> num;
+    std::array<bool, 3> cyclic;
+};
+
+} // namespace
+
 /*
  * datatools::ParticlesToDensity::create
  */
@@ -67,6 +170,7 @@ datatools::ParticlesToDensity::ParticlesToDensity()
         , normalizeSlot("normalize", "Normalize the output volume")
         , sigmaSlot("sigma", "Sigma for Gauss in multiple of rad")
         , surfaceSlot("forSurfaceReconstruction", "Set true if this volume is used for surface reconstruction")
+        , simdKernelSlot("simdKernel", "Evaluates the kernel for whole voxel rows using SIMD instructions")
         , datahash(0)
         , time(std::numeric_limits<unsigned int>::max())
         , has_data(false)
@@ -147,6 +251,9 @@ datatools::ParticlesToDensity::ParticlesToDensity()
     this->surfaceSlot << new core::param::BoolParam(false);
     this->MakeSlotAvailable(&this->surfaceSlot);
 
+    this->simdKernelSlot << new core::param::BoolParam(true);
+    this->MakeSlotAvailable(&this->simdKernelSlot);
+
     this->inDataSlot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
     this->MakeSlotAvailable(&this->inDataSlot);
 }
@@ -398,16 +505,12 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class geocalls::MultiParticl
 
     bool const is_vector = this->aggregatorSlot.Param<core::param::EnumParam>()->Value() == 2;
 
-    vol.resize(omp_get_max_threads());
-    std::vector<std::vector<float>> weights(omp_get_max_threads());
-#pragma omp parallel for
-    for (int init = 0; init < omp_get_max_threads(); ++init) {
-        vol[init].resize(sx * sy * sz * (is_vector ? 3 : 1));
-        std::fill(vol[init].begin(), vol[init].end(), 0.0f);
+    // a single volume shared by all threads, which write disjoint bricks only
+    vol.resize(1);
+    vol[0].assign(static_cast<std::size_t>(sx) * sy * sz * (is_vector ? 3 : 1), 0.0f);
+    std::vector<float> weights(is_vector ? static_cast<std::size_t>(sx) * sy * sz : 0, 0.0f);
 
-        weights[init].resize(sx * sy * sz);
-        std::fill(weights[init].begin(), weights[init].end(), 0.0f);
-    }
+    bool const use_simd = this->simdKernelSlot.Param<core::param::BoolParam>()->Value();
 
     // TODO: the whole code is wrong since we might not have the bounding box for the actual cyclic boundary conditions.
 
@@ -433,6 +536,9 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class geocalls::MultiParticl
 
     float const maxCellSize = std::max(sliceDistX, std::max(sliceDistY, sliceDistZ));
 
+    BrickGrid const bricks(sx, sy, sz, cycl_x, cycl_y, cycl_z);
+    int const numBricks = bricks.num[0] * bricks.num[1] * bricks.num[2];
+
     this->grid.resize(sx * sy * sz * 3);
     this->infoData.resize(this->info.size() * sx * sy * sz);
     for (std::size_t z = 0; z < sz; ++z) {
@@ -467,14 +573,6 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class geocalls::MultiParticl
 
         totalParticles += parts.GetCount();
 
-        // Implements the Bump Function from
-        // https://en.wikipedia.org/wiki/Radial_basis_function
-        auto rbf = [](float const dist, float const epsilon) -> float {
-            if (dist >= epsilon)
-                return 0.0f;
-            return std::exp(-1.0f / (1.0f - std::pow((1.0f / epsilon) * dist, 2.0f)));
-        };
-
         auto const& parStore = parts.GetParticleStore();
         auto const& xAcc = parStore.GetXAcc();
         auto const& yAcc = parStore.GetYAcc();
@@ -486,145 +584,168 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class geocalls::MultiParticl
         auto const& dzAcc = parStore.GetDZAcc();
 
         auto const sigma = this->sigmaSlot.Param<core::param::FloatParam>()->Value();
+        auto const aggregator = this->aggregatorSlot.Param<core::param::EnumParam>()->Value();
+
+        // voxel footprint of a particle; the kernel is zero beyond min(rad, sigma * rad)
+        auto footprint = [&](int64_t const j, SplatFootprint& fp) -> bool {
+            fp.pos[0] = xAcc->Get_f(j);
+            fp.pos[1] = yAcc->Get_f(j);
+            fp.pos[2] = zAcc->Get_f(j);
+            fp.rad = useGlobRad ? globRad : rAcc->Get_f(j);
+            if (fp.rad == 0.0f) {
+                return false;
+            }
+            float const cutoff = std::min(fp.rad, sigma * fp.rad);
+            fp.center[0] = static_cast<int>((fp.pos[0] - minOSx) / sliceDistX);
+            fp.center[1] = static_cast<int>((fp.pos[1] - minOSy) / sliceDistY);
+            fp.center[2] = static_cast<int>((fp.pos[2] - minOSz) / sliceDistZ);
+            fp.size[0] = static_cast<int>(std::ceil(cutoff / sliceDistX));
+            fp.size[1] = static_cast<int>(std::ceil(cutoff / sliceDistY));
+            fp.size[2] = static_cast<int>(std::ceil(cutoff / sliceDistZ));
+            return true;
+        };
 
-        std::function<void(int, int, int, int, float, float)> volOp;
-        switch (this->aggregatorSlot.Param<core::param::EnumParam>()->Value()) {
-        case 2: {
-            volOp = [this, &rbf, &weights, dxAcc, dyAcc, dzAcc, sx, sy, sigma](int const pidx, int const x, int const y,
-                        int const z, float const dis, float const rad) -> void {
-                if (rad == 0.0f)
-                    return;
-
-                auto const val_x = dxAcc->Get_f(pidx);
-                auto const val_y = dyAcc->Get_f(pidx);
-                auto const val_z = dzAcc->Get_f(pidx);
-
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 0] += rbf(dis, sigma * rad) * val_x;
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 1] += rbf(dis, sigma * rad) * val_y;
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 2] += rbf(dis, sigma * rad) * val_z;
-
-                weights[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad);
-            };
-        } break;
-        case 1: {
-            volOp = [this, &rbf, iAcc, sx, sy, sigma](int const pidx, int const x, int const y, int const z,
-                        float const dis, float const rad) -> void {
-                if (rad == 0.0f)
-                    return;
-
-                auto const val = iAcc->Get_f(pidx);
-                vol[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad) * val;
-            };
-        } break;
-        default:
-        case 0: {
-            volOp = [this, &rbf, sx, sy, sigma](int const pidx, int const x, int const y, int const z, float const dis,
-                        float const rad) -> void {
-                if (rad == 0.0f)
-                    return;
-
-                vol[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad);
-            };
-        }
-        }
-
-#if 0
-#pragma omp parallel for collapse(4)
-        for (int z = 0; z < sz; ++z) {
-            for (int y = 0; y < sy; ++y) {
-                for (int x = 0; x < sx; ++x) {
-                    for (int64_t j = 0; j < parts.GetCount(); ++j) {
-                        auto const x_base = xAcc->Get_f(j);
-                        auto const y_base = yAcc->Get_f(j);
-                        auto const z_base = zAcc->Get_f(j);
-                        auto rad = globRad;
-                        if (!useGlobRad) rad = rAcc->Get_f(j);
-
-                        float x_diff = static_cast<float>(x) * sliceDistX + minOSx;
-                        x_diff = std::fabs(x_diff - x_base);
-                        if (cycl_x && x_diff > halfRangeOSx) x_diff -= rangeOSx;
-                        float y_diff = static_cast<float>(y) * sliceDistY + minOSy;
-                        y_diff = std::fabs(y_diff - y_base);
-                        if (cycl_y && y_diff > halfRangeOSy) y_diff -= rangeOSy;
-                        float z_diff = static_cast<float>(z) * sliceDistZ + minOSz;
-                        z_diff = std::fabs(z_diff - z_base);
-                        if (cycl_z && z_diff > halfRangeOSz) z_diff -= rangeOSz;
-                        float const dis = std::sqrt(x_diff * x_diff + y_diff * y_diff + z_diff * z_diff);
-
-                        volOp(j, x, y, z, dis, rad);
+        // 1. bin the particles into all bricks their footprints overlap
+        auto const pcnt = static_cast<int64_t>(parts.GetCount());
+        std::vector<uint64_t> brickOffsets(numBricks + 1, 0);
+        auto forEachBrick = [&](SplatFootprint const& fp, auto const& func) {
+            auto const bx = bricks.Range(0, fp.center[0] - fp.size[0], fp.center[0] + fp.size[0]);
+            auto const by = bricks.Range(1, fp.center[1] - fp.size[1], fp.center[1] + fp.size[1]);
+            auto const bz = bricks.Range(2, fp.center[2] - fp.size[2], fp.center[2] + fp.size[2]);
+            for (int rz = 0; rz < bz.num; ++rz) {
+                for (int kz = bz.r[rz].first; kz <= bz.r[rz].second; ++kz) {
+                    for (int ry = 0; ry < by.num; ++ry) {
+                        for (int ky = by.r[ry].first; ky <= by.r[ry].second; ++ky) {
+                            for (int rx = 0; rx < bx.num; ++rx) {
+                                for (int kx = bx.r[rx].first; kx <= bx.r[rx].second; ++kx) {
+                                    func(kx + (ky + kz * bricks.num[1]) * bricks.num[0]);
+                                }
+                            }
+                        }
                     }
                 }
             }
+        };
+#pragma omp parallel for
+        for (int64_t j = 0; j < pcnt; ++j) {
+            SplatFootprint fp;
+            if (footprint(j, fp)) {
+                forEachBrick(fp, [&brickOffsets](int const b) {
+#pragma omp atomic
+                    ++brickOffsets[b + 1];
+                });
+            }
         }
-#endif
-
+        std::partial_sum(brickOffsets.begin(), brickOffsets.end(), brickOffsets.begin());
+        std::vector<int64_t> brickParticles(brickOffsets.back());
+        {
+            std::unique_ptr<std::atomic<uint64_t>[]> cursor(new std::atomic<uint64_t>[numBricks]);
+            for (int b = 0; b < numBricks; ++b) {
+                cursor[b].store(brickOffsets[b]);
+            }
 #pragma omp parallel for
-        for (int64_t j = 0; j < parts.GetCount(); ++j) {
-            auto const x_base = xAcc->Get_f(j);
-            auto x = static_cast<int>((x_base - minOSx) / sliceDistX);
-            auto const y_base = yAcc->Get_f(j);
-            auto y = static_cast<int>((y_base - minOSy) / sliceDistY);
-            auto const z_base = zAcc->Get_f(j);
-            auto z = static_cast<int>((z_base - minOSz) / sliceDistZ);
-            auto rad = globRad;
-            if (!useGlobRad)
-                rad = rAcc->Get_f(j);
-
-            int const filterSizeX = static_cast<int>(std::ceil(rad / sliceDistX));
-            int const filterSizeY = static_cast<int>(std::ceil(rad / sliceDistY));
-            int const filterSizeZ = static_cast<int>(std::ceil(rad / sliceDistZ));
-
-            for (int hz = z - filterSizeZ; hz <= z + filterSizeZ; ++hz) {
-                for (int hy = y - filterSizeY; hy <= y + filterSizeY; ++hy) {
-                    for (int hx = x - filterSizeX; hx <= x + filterSizeX; ++hx) {
-                        auto tmp_hx = hx;
-                        auto tmp_hy = hy;
-                        auto tmp_hz = hz;
-                        if (cycl_x) {
-                            tmp_hx = (hx + 2 * sx) % sx;
-                        } else {
-                            if (hx < 0 || hx > sx - 1) {
-                                continue;
-                            }
-                        }
-                        if (cycl_y) {
-                            tmp_hy = (hy + 2 * sy) % sy;
-                        } else {
-                            if (hy < 0 || hy > sy - 1) {
-                                continue;
+            for (int64_t j = 0; j < pcnt; ++j) {
+                SplatFootprint fp;
+                if (footprint(j, fp)) {
+                    forEachBrick(fp, [&cursor, &brickParticles, j](int const b) {
+                        brickParticles[cursor[b].fetch_add(1)] = j;
+                    });
+                }
+            }
+        }
+
+        // 2. splat the particles brick by brick; every thread owns the voxels of its brick
+#pragma omp parallel
+        {
+            std::array<std::vector<int>, 3> unwrapped, wrapped;
+            std::vector<float> rowDist, rowKernel;
+
+#pragma omp for schedule(dynamic)
+            for (int b = 0; b < numBricks; ++b) {
+                auto const first = brickParticles.begin() + brickOffsets[b];
+                auto const last = brickParticles.begin() + brickOffsets[b + 1];
+                // deterministic summation order regardless of the binning race
+                std::sort(first, last);
+
+                std::array<int, 3> const brick = {
+                    b % bricks.num[0], (b / bricks.num[0]) % bricks.num[1], b / (bricks.num[0] * bricks.num[1])};
+
+                for (auto it = first; it != last; ++it) {
+                    int64_t const j = *it;
+                    SplatFootprint fp;
+                    footprint(j, fp);
+                    for (int d = 0; d < 3; ++d) {
+                        bricks.Clip(d, brick[d], fp.center[d] - fp.size[d], fp.center[d] + fp.size[d], unwrapped[d],
+                            wrapped[d]);
+                    }
+
+                    float const epsilon = sigma * fp.rad;
+                    float const rcpEpsSq = 1.0f / (epsilon * epsilon);
+                    float val[3] = {1.0f, 0.0f, 0.0f};
+                    if (aggregator == 1) {
+                        val[0] = iAcc->Get_f(j);
+                    } else if (aggregator == 2) {
+                        val[0] = dxAcc->Get_f(j);
+                        val[1] = dyAcc->Get_f(j);
+                        val[2] = dzAcc->Get_f(j);
+                    }
+
+                    auto const nx = unwrapped[0].size();
+                    rowDist.resize(nx);
+                    rowKernel.resize(nx);
+                    for (std::size_t iz = 0; iz < unwrapped[2].size(); ++iz) {
+                        float const z_diff =
+                            static_cast<float>(unwrapped[2][iz]) * sliceDistZ + minOSz - fp.pos[2];
+                        for (std::size_t iy = 0; iy < unwrapped[1].size(); ++iy) {
+                            float const y_diff =
+                                static_cast<float>(unwrapped[1][iy]) * sliceDistY + minOSy - fp.pos[1];
+                            float const yz_sq = y_diff * y_diff + z_diff * z_diff;
+                            std::size_t const rowBase =
+                                (static_cast<std::size_t>(wrapped[2][iz]) * sy + wrapped[1][iy]) * sx;
+
+                            if (use_simd) {
+                                int const* ux = unwrapped[0].data();
+                                float* dist = rowDist.data();
+                                float* kern = rowKernel.data();
+#pragma omp simd
+                                for (std::size_t ix = 0; ix < nx; ++ix) {
+                                    float const x_diff = static_cast<float>(ux[ix]) * sliceDistX + minOSx - fp.pos[0];
+                                    dist[ix] = (x_diff * x_diff + yz_sq) * rcpEpsSq;
+                                }
+#pragma omp simd
+                                for (std::size_t ix = 0; ix < nx; ++ix) {
+                                    float const q = std::min(dist[ix], 0.999999f);
+                                    kern[ix] = (dist[ix] < 1.0f) ? std::exp(-1.0f / (1.0f - q)) : 0.0f;
+                                }
+                            } else {
+                                for (std::size_t ix = 0; ix < nx; ++ix) {
+                                    float const x_diff =
+                                        static_cast<float>(unwrapped[0][ix]) * sliceDistX + minOSx - fp.pos[0];
+                                    float const dis = std::sqrt(x_diff * x_diff + yz_sq);
+                                    rowKernel[ix] = splatKernel(dis, epsilon);
+                                }
                             }
-                        }
-                        if (cycl_z) {
-                            tmp_hz = (hz + 2 * sz) % sz;
-                        } else {
-                            if (hz < 0 || hz > sz - 1) {
-                                continue;
+
+                            if (is_vector) {
+                                for (std::size_t ix = 0; ix < nx; ++ix) {
+                                    std::size_t const v = rowBase + wrapped[0][ix];
+                                    vol[0][v * 3 + 0] += rowKernel[ix] * val[0];
+                                    vol[0][v * 3 + 1] += rowKernel[ix] * val[1];
+                                    vol[0][v * 3 + 2] += rowKernel[ix] * val[2];
+                                    weights[v] += rowKernel[ix];
+                                }
+                            } else {
+                                for (std::size_t ix = 0; ix < nx; ++ix) {
+                                    vol[0][rowBase + wrapped[0][ix]] += rowKernel[ix] * val[0];
+                                }
                             }
                         }
-
-                        float x_diff = static_cast<float>(hx) * sliceDistX + minOSx;
-                        x_diff = std::fabs(x_diff - x_base);
-                        // if (x_diff > halfRangeOSx) x_diff -= rangeOSx;
-                        float y_diff = static_cast<float>(hy) * sliceDistY + minOSy;
-                        y_diff = std::fabs(y_diff - y_base);
-                        // if (y_diff > halfRangeOSy) y_diff -= rangeOSy;
-                        float z_diff = static_cast<float>(hz) * sliceDistZ + minOSz;
-                        z_diff = std::fabs(z_diff - z_base);
-                        // if (z_diff > halfRangeOSz) z_diff -= rangeOSz;
-                        float const dis = std::sqrt(x_diff * x_diff + y_diff * y_diff + z_diff * z_diff);
-
-                        volOp(j, tmp_hx, tmp_hy, tmp_hz, dis, rad);
                     }
                 }
             }
         }
     }
 
-    for (int i = 1; i < omp_get_max_threads(); ++i) {
-        std::transform(vol[i].begin(), vol[i].end(), vol[0].begin(), vol[0].begin(), std::plus<>());
-        std::transform(weights[i].begin(), weights[i].end(), weights[0].begin(), weights[0].begin(), std::plus<>());
-    }
-
     if (is_vector) {
         this->directions.resize(vol[0].size());
         this->colors.resize(vol[0].size() / 3);
@@ -632,9 +753,9 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class geocalls::MultiParticl
         maxDens = 0.0f;
         minDens = std::numeric_limits<float>::max();
         for (std::size_t i = 0; i < vol[0].size() / 3; ++i) {
-            vol[0][i * 3 + 0] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
-            vol[0][i * 3 + 1] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
-            vol[0][i * 3 + 2] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
+            vol[0][i * 3 + 0] /= weights[i] == 0.0f ? 1.0f : weights[i];
+            vol[0][i * 3 + 1] /= weights[i] == 0.0f ? 1.0f : weights[i];
+            vol[0][i * 3 + 2] /= weights[i] == 0.0f ? 1.0f : weights[i];
 
             const float density =
                 std::sqrt(vol[0][i * 3 + 0] * vol[0][i * 3 + 0] + vol[0][i * 3 + 1] * vol[0][i * 3 + 1] +
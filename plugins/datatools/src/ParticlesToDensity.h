@@ -87,7 +87,8 @@ private:
     inline bool anythingDirty() const {
         return this->aggregatorSlot.IsDirty() || this->xResSlot.IsDirty() || this->yResSlot.IsDirty() ||
                this->zResSlot.IsDirty() || this->cyclXSlot.IsDirty() || this->cyclYSlot.IsDirty() ||
-               this->cyclZSlot.IsDirty() || this->normalizeSlot.IsDirty() || this->sigmaSlot.IsDirty();
+               this->cyclZSlot.IsDirty() || this->normalizeSlot.IsDirty() || this->sigmaSlot.IsDirty() ||
+               this->simdKernelSlot.IsDirty();
     }
 
     inline void resetDirty() {
@@ -100,6 +101,7 @@ private:
         this->cyclZSlot.ResetDirty();
         this->normalizeSlot.ResetDirty();
         this->sigmaSlot.ResetDirty();
+        this->simdKernelSlot.ResetDirty();
     }
 
     core::param::ParamSlot aggregatorSlot;
@@ -118,6 +120,8 @@ private:
 
     core::param::ParamSlot surfaceSlot;
 
+    core::param::ParamSlot simdKernelSlot;
+
     std::vector<std::vector<float>> vol;
     std::vector<float> directions, colors, densities;
     std::vector<float> grid;
@@ -0,0 +1,240 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "datatools/SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include <nanoflann.hpp>
+#include <omp.h>
+
+using namespace megamol;
+using namespace megamol::datatools;
+
+
+/*
+ * SpatialIndex::Tree
+ */
+class SpatialIndex::Tree {
+public:
+    /** Adaptor exposing the contiguous positions to nanoflann. */
+    class Points {
+    public:
+        explicit Points(const std::vector<float>& positions) : positions(positions) {}
+
+        inline std::size_t kdtree_get_point_count() const {
+            return this->positions.size() / 3;
+        }
+
+        inline float kdtree_get_pt(const std::size_t idx, const std::size_t dim) const {
+            return this->positions[3 * idx + dim];
+        }
+
+        template<class BBOX>
+        bool kdtree_get_bbox(BBOX& bb) const {
+            return false;
+        }
+
+    private:
+        const std::vector<float>& positions;
+    };
+
+    typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<float, Points>, Points, 3, std::size_t>
+        kd_tree_t;
+
+    explicit Tree(const std::vector<float>& positions) : points(positions), index(3, points, makeParams()) {
+        // The constructor of the nanoflann index already builds the tree.
+    }
+
+    Points points;
+    kd_tree_t index;
+
+private:
+    static nanoflann::KDTreeSingleIndexAdaptorParams makeParams() {
+#if defined(NANOFLANN_VERSION) && (NANOFLANN_VERSION >= 0x151)
+        return nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */,
+            nanoflann::KDTreeSingleIndexAdaptorFlags::None, static_cast<unsigned int>(omp_get_max_threads()));
+#else  /* defined(NANOFLANN_VERSION) && (NANOFLANN_VERSION >= 0x151) */
+        return nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */);
+#endif /* defined(NANOFLANN_VERSION) && (NANOFLANN_VERSION >= 0x151) */
+    }
+};
+
+
+/*
+ * SpatialIndex::SpatialIndex
+ */
+SpatialIndex::SpatialIndex(geocalls::MultiParticleDataCall& dat)
+        : bounds(dat.AccessBoundingBoxes().ObjectSpaceBBox()) {
+    using geocalls::SimpleSphericalParticles;
+
+    const auto plc = dat.GetParticleListCount();
+
+    this->listOffsets.resize(plc + 1, 0);
+    for (unsigned int pli = 0; pli < plc; ++pli) {
+        auto& pl = dat.AccessParticles(pli);
+        const auto isFloat = (pl.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_FLOAT_XYZ) ||
+                             (pl.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_FLOAT_XYZR);
+        this->listOffsets[pli + 1] = this->listOffsets[pli] + (isFloat ? pl.GetCount() : 0);
+    }
+
+    // Gather the positions such that the tree is built on contiguous memory.
+    this->positions.resize(3 * this->listOffsets.back());
+    for (unsigned int pli = 0; pli < plc; ++pli) {
+        if (this->ListSize(pli) == 0) {
+            continue;
+        }
+
+        auto& pl = dat.AccessParticles(pli);
+        const auto minStride = (pl.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_FLOAT_XYZ) ? 12u : 16u;
+        const auto stride = std::max<unsigned int>(minStride, pl.GetVertexDataStride());
+        const auto vert = static_cast<const unsigned char*>(pl.GetVertexData());
+        const auto dst = this->positions.data() + 3 * this->listOffsets[pli];
+        const auto cnt = static_cast<std::int64_t>(this->ListSize(pli));
+
+#pragma omp parallel for
+        for (std::int64_t i = 0; i < cnt; ++i) {
+            const auto src = reinterpret_cast<const float*>(vert + i * stride);
+            dst[3 * i + 0] = src[0];
+            dst[3 * i + 1] = src[1];
+            dst[3 * i + 2] = src[2];
+        }
+    }
+
+    this->tree = std::make_unique<Tree>(this->positions);
+}
+
+
+/*
+ * SpatialIndex::~SpatialIndex
+ */
+SpatialIndex::~SpatialIndex() = default;
+
+
+/*
+ * SpatialIndex::ListOf
+ */
+std::size_t SpatialIndex::ListOf(std::size_t idx) const {
+    // The first offset greater than 'idx' is the one of the next list. Empty lists
+    // share their offset with the next one, which upper_bound skips.
+    auto it = std::upper_bound(this->listOffsets.begin(), this->listOffsets.end(), idx);
+    return static_cast<std::size_t>(std::distance(this->listOffsets.begin(), it)) - 1;
+}
+
+
+/*
+ * SpatialIndex::RadiusSearch
+ */
+std::size_t SpatialIndex::RadiusSearch(
+    const float* pos, float radius, std::vector<Match>& matches, const Periodicity& periodic) const {
+    thread_local std::vector<nanoflann::ResultItem<std::size_t, float>> localMatches;
+    std::array<float, 3 * 8> images;
+    const auto imgCnt = this->periodicImages(pos, periodic, images);
+
+    // nanoflann expects the squared radius and tests for "less than".
+    const auto sqRadius = std::nextafter(radius * radius, std::numeric_limits<float>::max());
+    nanoflann::SearchParameters params;
+    params.sorted = false;
+
+    matches.clear();
+    for (std::size_t i = 0; i < imgCnt; ++i) {
+        this->tree->index.radiusSearch(images.data() + 3 * i, sqRadius, localMatches, params);
+        for (auto& m : localMatches) {
+            matches.emplace_back(m.first, m.second);
+        }
+    }
+
+    if (imgCnt > 1) {
+        removeDuplicates(matches);
+    }
+
+    return matches.size();
+}
+
+
+/*
+ * SpatialIndex::KnnSearch
+ */
+std::size_t SpatialIndex::KnnSearch(
+    const float* pos, std::size_t k, std::vector<Match>& matches, const Periodicity& periodic) const {
+    thread_local std::vector<std::size_t> indices;
+    thread_local std::vector<float> distances;
+    std::array<float, 3 * 8> images;
+    const auto imgCnt = this->periodicImages(pos, periodic, images);
+
+    indices.resize(k);
+    distances.resize(k);
+
+    matches.clear();
+    for (std::size_t i = 0; i < imgCnt; ++i) {
+        const auto cnt = this->tree->index.knnSearch(images.data() + 3 * i, k, indices.data(), distances.data());
+        for (std::size_t j = 0; j < cnt; ++j) {
+            matches.emplace_back(indices[j], distances[j]);
+        }
+    }
+
+    if (imgCnt > 1) {
+        removeDuplicates(matches);
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const Match& l, const Match& r) {
+        return (l.second < r.second) || ((l.second == r.second) && (l.first < r.first));
+    });
+    if (matches.size() > k) {
+        matches.resize(k);
+    }
+
+    return matches.size();
+}
+
+
+/*
+ * SpatialIndex::periodicImages
+ */
+std::size_t SpatialIndex::periodicImages(
+    const float* pos, const Periodicity& periodic, std::array<float, 3 * 8>& images) const {
+    const auto center = this->bounds.CalcCenter();
+    const std::array<float, 3> c = {center.X(), center.Y(), center.Z()};
+    const std::array<float, 3> size = {this->bounds.Width(), this->bounds.Height(), this->bounds.Depth()};
+    std::size_t cnt = 0;
+
+    // Besides the position itself, query the images on the opposite side of every
+    // periodic axis, which covers all neighbours as long as the radius is smaller
+    // than half of the domain.
+    for (int x = 0; x < (periodic[0] ? 2 : 1); ++x) {
+        for (int y = 0; y < (periodic[1] ? 2 : 1); ++y) {
+            for (int z = 0; z < (periodic[2] ? 2 : 1); ++z) {
+                const std::array<int, 3> shift = {x, y, z};
+                for (int d = 0; d < 3; ++d) {
+                    auto v = pos[d];
+                    if (shift[d] > 0) {
+                        v += (v > c[d]) ? -size[d] : size[d];
+                    }
+                    images[3 * cnt + d] = v;
+                }
+                ++cnt;
+            }
+        }
+    }
+
+    return cnt;
+}
+
+
+/*
+ * SpatialIndex::removeDuplicates
+ */
+void SpatialIndex::removeDuplicates(std::vector<Match>& matches) {
+    std::sort(matches.begin(), matches.end(), [](const Match& l, const Match& r) {
+        return (l.first < r.first) || ((l.first == r.first) && (l.second < r.second));
+    });
+    matches.erase(std::unique(matches.begin(), matches.end(),
+                      [](const Match& l, const Match& r) { return l.first == r.first; }),
+        matches.end());
+}
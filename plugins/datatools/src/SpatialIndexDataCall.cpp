@@ -0,0 +1,18 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "datatools/SpatialIndexDataCall.h"
+
+using namespace megamol;
+using namespace megamol::datatools;
+
+SpatialIndexDataCall::SpatialIndexDataCall() : core::AbstractGetData3DCall(), index(nullptr) {
+    // intentionally empty
+}
+
+SpatialIndexDataCall::~SpatialIndexDataCall() {
+    // intentionally empty
+}
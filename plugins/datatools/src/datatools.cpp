@@ -53,6 +53,7 @@
 #include "ParticleNeighborhoodGraph.h"
 #include "ParticleRelaxationModule.h"
 #include "ParticleSortFixHack.h"
+#include "ParticleSpatialIndex.h"
 #include "ParticleThermodyn.h"
 #include "ParticleThinner.h"
 #include "ParticleTranslateRotateScale.h"
@@ -67,6 +68,7 @@
 #include "datatools/GraphDataCall.h"
 #include "datatools/MultiIndexListDataCall.h"
 #include "datatools/ParticleFilterMapDataCall.h"
+#include "datatools/SpatialIndexDataCall.h"
 #include "datatools/clustering/ParticleIColClustering.h"
 #include "datatools/table/TableDataCall.h"
 #include "io/CPERAWDataSource.h"
@@ -188,11 +190,13 @@ public:
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::TableInspector>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::ParticleListFilter>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::SiffCSplineFitter>();
+        this->module_descriptions.RegisterAutoDescription<megamol::datatools::ParticleSpatialIndex>();
         // register calls
         this->call_descriptions.RegisterAutoDescription<megamol::datatools::table::TableDataCall>();
         this->call_descriptions.RegisterAutoDescription<megamol::datatools::ParticleFilterMapDataCall>();
         this->call_descriptions.RegisterAutoDescription<megamol::datatools::GraphDataCall>();
         this->call_descriptions.RegisterAutoDescription<megamol::datatools::MultiIndexListDataCall>();
+        this->call_descriptions.RegisterAutoDescription<megamol::datatools::SpatialIndexDataCall>();
     }
 };
 } // namespace megamol::datatools
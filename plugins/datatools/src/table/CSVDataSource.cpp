@@ -15,13 +15,19 @@
 #include "mmcore/param/StringParam.h"
 
 #include "vislib/StringTokeniser.h"
-#include "vislib/sys/ASCIIFileBuffer.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <limits>
 #include <list>
 #include <map>
+#include <numeric>
 #include <omp.h>
 #include <random>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 using namespace megamol::datatools;
@@ -78,6 +84,66 @@ double parseValue(const char* tokenStart, const char* tokenEnd) {
     return NAN;
 }
 
+/** Size of the blocks in which the file head is read for format detection */
+constexpr std::size_t HeadBlockSize = 64 * 1024;
+
+/** Size of the blocks in which the data rows are streamed */
+constexpr std::size_t DataBlockSize = 64 * 1024 * 1024;
+
+std::string trimLineEnd(std::string line, char eol) {
+    // Remove the second half of two-character line breaks
+    const char other = (eol == '\n') ? '\r' : '\n';
+    while (!line.empty() && line.back() == other)
+        line.pop_back();
+    while (!line.empty() && line.front() == other)
+        line.erase(line.begin());
+    return line;
+}
+
+size_t countLines(const char* start, const char* end, char eol) {
+    size_t cnt = 0;
+    while (start < end) {
+        const void* next = std::memchr(start, eol, end - start);
+        ++cnt;
+        if (next == nullptr)
+            break;
+        start = static_cast<const char*>(next) + 1;
+    }
+    return cnt;
+}
+
+char* findSeparator(char* start, char* end, const std::string& sep) {
+    if (sep.size() == 1) {
+        // memchr is vectorized in all relevant C runtimes
+        void* pos = std::memchr(start, sep[0], end - start);
+        return (pos == nullptr) ? end : static_cast<char*>(pos);
+    }
+    char* pos = std::search(start, end, sep.begin(), sep.end());
+    return pos;
+}
+
+float parseToken(char* tokenStart, char* tokenEnd, DecimalSeparator decType) {
+    while (tokenStart != tokenEnd && std::isspace(static_cast<unsigned char>(*tokenStart)))
+        ++tokenStart;
+    while (tokenEnd != tokenStart && std::isspace(static_cast<unsigned char>(tokenEnd[-1])))
+        --tokenEnd;
+    if (decType == DecimalSeparator::DE) {
+        std::replace(tokenStart, tokenEnd, ',', '.');
+    }
+
+    // Fast path for plain numbers
+    const char* first = tokenStart;
+    if (first != tokenEnd && *first == '+')
+        ++first;
+    double number;
+    auto const result = std::from_chars(first, tokenEnd, number);
+    if (result.ec == std::errc() && result.ptr == tokenEnd) {
+        return static_cast<float>(number);
+    }
+
+    return static_cast<float>(parseValue(tokenStart, tokenEnd));
+}
+
 CSVDataSource::CSVDataSource()
         : core::Module()
         , filenameSlot("filename", "Filename to read from")
@@ -171,42 +237,73 @@ void CSVDataSource::assertData() {
     auto filename = this->filenameSlot.Param<core::param::FilePathParam>()->Value();
 
     try {
-        vislib::sys::ASCIIFileBuffer file;
+        std::ifstream file(filename, std::ios::binary);
 
-        // 1. Load the whole file into memory (FAST!)
+        // 1. Load the head of the file, which is all we need to detect the format
         //////////////////////////////////////////////////////////////////////
-        if (!file.LoadFile(filename.native().c_str(), vislib::sys::ASCIIFileBuffer::PARSING_LINES))
+        if (!file.is_open())
             throw vislib::Exception(__FILE__, __LINE__);
-        if (file.Count() < 2)
-            throw vislib::Exception("No data in CSV file", __FILE__, __LINE__);
 
-        // 2. Determine the first row, column separator, and decimal point
-        //////////////////////////////////////////////////////////////////////
         int firstHeaRow = this->skipPrefaceSlot.Param<core::param::IntParam>()->Value();
         int firstDatRow = this->skipPrefaceSlot.Param<core::param::IntParam>()->Value();
         if (headerNamesSlot.Param<core::param::BoolParam>()->Value())
             firstDatRow++;
         if (headerTypesSlot.Param<core::param::BoolParam>()->Value())
             firstDatRow++;
+        const std::string comment = this->commentPrefixSlot.Param<core::param::StringParam>()->Value();
+
+        std::string head;
+        std::vector<std::string> headLines;
+        std::vector<std::size_t> headLineEnds;
+        char eol = '\n';
+        bool fileEnd = false;
+        while (true) {
+            std::size_t const oldSize = head.size();
+            head.resize(oldSize + HeadBlockSize);
+            file.read(&head[oldSize], HeadBlockSize);
+            head.resize(oldSize + static_cast<std::size_t>(file.gcount()));
+            fileEnd = !file.good();
+
+            // Split into lines. Files without '\n' at all use old Mac line endings.
+            eol = (head.find('\n') == std::string::npos && head.find('\r') != std::string::npos) ? '\r' : '\n';
+            headLines.clear();
+            headLineEnds.clear();
+            std::size_t ls = 0;
+            for (std::size_t le = head.find(eol); le != std::string::npos; le = head.find(eol, ls)) {
+                headLines.push_back(trimLineEnd(head.substr(ls, le - ls), eol));
+                headLineEnds.push_back(le + 1);
+                ls = le + 1;
+            }
+            if (fileEnd) {
+                headLines.push_back(trimLineEnd(head.substr(ls), eol));
+                headLineEnds.push_back(head.size());
+            }
 
-        auto comment = vislib::StringA(this->commentPrefixSlot.Param<core::param::StringParam>()->Value().c_str());
-        if (!comment.IsEmpty()) {
             // Skip comments at the beginning of the file.
-            while (firstHeaRow < file.Count()) {
-                if (!vislib::StringA(file[firstHeaRow]).StartsWith(comment)) {
-                    break;
+            int commentLines = 0;
+            if (!comment.empty()) {
+                while (firstHeaRow + commentLines < static_cast<int>(headLines.size()) &&
+                       headLines[firstHeaRow + commentLines].compare(0, comment.size(), comment) == 0) {
+                    commentLines++;
                 }
-                firstHeaRow++;
-                firstDatRow++;
+            }
+            if (fileEnd || (firstDatRow + commentLines < static_cast<int>(headLines.size()))) {
+                firstHeaRow += commentLines;
+                firstDatRow += commentLines;
+                break;
             }
         }
+        if (headLines.size() < 2 || firstDatRow >= static_cast<int>(headLines.size()))
+            throw vislib::Exception("No data in CSV file", __FILE__, __LINE__);
 
+        // 2. Determine the first row, column separator, and decimal point
+        //////////////////////////////////////////////////////////////////////
         vislib::StringA colSep(this->colSepSlot.Param<core::param::StringParam>()->Value().c_str());
         if (colSep.IsEmpty()) {
             // Detect column separator
             const char ColSepCanidates[] = {'\t', ';', ',', '|'};
-            vislib::StringA l1(file[firstHeaRow]);
-            vislib::StringA l2(file[firstHeaRow]);
+            vislib::StringA l1(headLines[firstHeaRow].c_str());
+            vislib::StringA l2(headLines[firstHeaRow].c_str());
             for (int i = 0; i < sizeof(ColSepCanidates) / sizeof(char); ++i) {
                 SIZE_T c1 = l1.Count(ColSepCanidates[i]);
                 if ((c1 > 0) && (c1 == l2.Count(ColSepCanidates[i]))) {
@@ -223,7 +320,8 @@ void CSVDataSource::assertData() {
             static_cast<DecimalSeparator>(this->decSepSlot.Param<core::param::EnumParam>()->Value());
         if (decType == DecimalSeparator::Unknown) {
             // Detect decimal type
-            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(file[firstDatRow], colSep, false));
+            vislib::Array<vislib::StringA> tokens(
+                vislib::StringTokeniserA::Split(headLines[firstDatRow].c_str(), colSep, false));
             for (SIZE_T i = 0; i < tokens.Count(); i++) {
                 bool hasDot = tokens[i].Contains('.');
                 bool hasComma = tokens[i].Contains(',');
@@ -245,10 +343,10 @@ void CSVDataSource::assertData() {
         //////////////////////////////////////////////////////////////////////
         vislib::Array<vislib::StringA> dimNames;
         if (headerNamesSlot.Param<core::param::BoolParam>()->Value()) {
-            dimNames = vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false);
+            dimNames = vislib::StringTokeniserA::Split(headLines[firstHeaRow].c_str(), colSep, false);
             firstHeaRow++;
         } else {
-            dimNames = vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false);
+            dimNames = vislib::StringTokeniserA::Split(headLines[firstHeaRow].c_str(), colSep, false);
             for (SIZE_T i = 0; i < dimNames.Count(); ++i) {
                 dimNames[i].Format("Dim %d", static_cast<int>(i));
             }
@@ -258,7 +356,8 @@ void CSVDataSource::assertData() {
 
         bool hasCatDims = false;
         if (headerTypesSlot.Param<core::param::BoolParam>()->Value()) {
-            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false));
+            vislib::Array<vislib::StringA> tokens(
+                vislib::StringTokeniserA::Split(headLines[firstHeaRow].c_str(), colSep, false));
             for (SIZE_T i = 0; i < dimNames.Count(); i++) {
                 TableDataCall::ColumnType type = TableDataCall::ColumnType::QUANTITATIVE;
                 if (tokens.Count() > i && tokens[i].Equals("CATEGORICAL", true)) {
@@ -281,89 +380,137 @@ void CSVDataSource::assertData() {
             }
         }
 
-        // 4. Data format is now clear... finally parse actual data
+        // 4. Data format is now clear... finally stream and parse actual data
         //////////////////////////////////////////////////////////////////////
         size_t colCnt = static_cast<size_t>(this->columns.size());
-        size_t rowCnt = static_cast<size_t>(file.Count() - firstDatRow);
-        int colSepEnd = colSep.Length() - 1;
-
-        // Test for empty lines at the end
-        for (; rowCnt > 0; --rowCnt) {
-            const char* start = file[firstDatRow + rowCnt - 1];
-            const char* end = start;
-            size_t col = 0;
-            while ((*end != '\0') && (col < colCnt)) {
-                int colSepPos = 0;
-                while ((*end != '\0') && ((*end != colSep[colSepEnd]) || (colSepEnd != colSepPos))) {
-                    if (*end == colSep[colSepPos])
-                        colSepPos++;
-                    else
-                        colSepPos = 0;
-                    ++end;
-                }
-                col++;
-            }
-            if (col >= colCnt)
-                break; // we found the last line containing a full data set
-        }
+        size_t rowCnt = 0;
+        const std::string sep(colSep.PeekBuffer());
+        const std::size_t dataStart = (firstDatRow > 0) ? headLineEnds[firstDatRow - 1] : 0;
 
-        // Parse in parallel, assuming all lines will work
-        std::vector<std::map<std::string, float>> catMaps;
+        std::vector<char> block(head.begin() + std::min(dataStart, head.size()), head.end());
+        head.clear();
+        head.shrink_to_fit();
+        headLines.clear();
+
+        // Parse blocks in parallel, every thread taking a range of complete lines
         int thCnt = omp_get_max_threads();
-        catMaps.resize(colCnt * thCnt);
-        values.resize(colCnt * rowCnt);
-        bool hasInvalids = false;
+        std::vector<std::unordered_map<std::string, float>> catMaps(colCnt * thCnt);
+        std::vector<std::size_t> bounds(thCnt + 1);
+        std::vector<std::size_t> rowStart(thCnt + 1);
+        std::vector<long long> lastFullRow(thCnt);
+        long long lastFull = -1;
+        const std::size_t dataSize = static_cast<std::size_t>(std::filesystem::file_size(filename)) - dataStart;
+        std::size_t parsedSize = 0;
+
+        while (true) {
+            // Fill the block, keeping the incomplete last line for the next round
+            std::size_t blockLen = block.size();
+            if (!fileEnd) {
+                block.resize(blockLen + DataBlockSize);
+                file.read(block.data() + blockLen, DataBlockSize);
+                blockLen += static_cast<std::size_t>(file.gcount());
+                block.resize(blockLen);
+                fileEnd = !file.good();
+            }
+            std::size_t parseLen = blockLen;
+            if (!fileEnd) {
+                auto const lastEol = std::find(block.rbegin(), block.rend(), eol);
+                if (lastEol == block.rend())
+                    continue; // line longer than the block
+                parseLen = static_cast<std::size_t>(block.rend() - lastEol);
+            }
+
+            // Split the block into line-aligned ranges and count their lines
+            bounds[0] = 0;
+            for (int t = 1; t < thCnt; ++t) {
+                std::size_t pos = std::max(parseLen * t / thCnt, bounds[t - 1]);
+                const void* next = (pos < parseLen) ? std::memchr(block.data() + pos, eol, parseLen - pos) : nullptr;
+                bounds[t] = (next == nullptr) ? parseLen : (static_cast<const char*>(next) - block.data()) + 1;
+            }
+            bounds[thCnt] = parseLen;
 
 #pragma omp parallel for
-        for (long long idx = 0; idx < static_cast<long long>(rowCnt); ++idx) {
-            int thId = omp_get_thread_num();
-            const char* start = file[static_cast<size_t>(firstDatRow + idx)];
-            const char* end = start;
-            size_t col = 0;
-            while ((*end != '\0') && (col < colCnt)) {
-                std::map<std::string, float>& catMap = catMaps[thId + col * thCnt];
-                int colSepPos = 0;
-                while ((*end != '\0') && ((*end != colSep[colSepEnd]) || (colSepEnd != colSepPos))) {
-                    if (*end == colSep[colSepPos])
-                        colSepPos++;
-                    else
-                        colSepPos = 0;
-                    ++end;
-                }
+            for (int t = 0; t < thCnt; ++t) {
+                rowStart[t + 1] = countLines(block.data() + bounds[t], block.data() + bounds[t + 1], eol);
+            }
+            rowStart[0] = rowCnt;
+            std::partial_sum(rowStart.begin(), rowStart.end(), rowStart.begin());
+            this->values.resize(rowStart[thCnt] * colCnt);
 
-                if (this->columns[col].Type() == TableDataCall::ColumnType::QUANTITATIVE) {
-                    if (decType == DecimalSeparator::DE) {
-                        for (char* ez = const_cast<char*>(start); ez != end; ++ez)
-                            if (*ez == ',')
-                                *ez = '.';
+            // Parse straight into the table
+#pragma omp parallel for
+            for (int t = 0; t < thCnt; ++t) {
+                lastFullRow[t] = -1;
+                size_t row = rowStart[t];
+                char* ls = block.data() + bounds[t];
+                char* const rangeEnd = block.data() + bounds[t + 1];
+                while (ls < rangeEnd) {
+                    char* le = static_cast<char*>(std::memchr(ls, eol, rangeEnd - ls));
+                    char* const next = (le == nullptr) ? rangeEnd : le + 1;
+                    if (le == nullptr)
+                        le = rangeEnd;
+                    while (le != ls && (le[-1] == '\r' || le[-1] == '\n'))
+                        --le;
+
+                    float* rowValues = this->values.data() + row * colCnt;
+                    char* start = ls;
+                    size_t col = 0;
+                    while (col < colCnt) {
+                        char* end = findSeparator(start, le, sep);
+
+                        if (this->columns[col].Type() == TableDataCall::ColumnType::QUANTITATIVE) {
+                            rowValues[col] = parseToken(start, end, decType);
+                        } else if (this->columns[col].Type() == TableDataCall::ColumnType::CATEGORICAL) {
+                            assert(hasCatDims);
+                            std::unordered_map<std::string, float>& catMap = catMaps[t + col * thCnt];
+                            auto cmi = catMap.try_emplace(
+                                std::string(start, end), static_cast<float>(t + thCnt * catMap.size()));
+                            rowValues[col] = cmi.first->second;
+                        } else {
+                            assert(false);
+                        }
+
+                        col++;
+                        if (end == le)
+                            break;
+                        start = end + sep.size();
                     }
-                    double value = parseValue(start, end);
-                    values[static_cast<size_t>(idx * colCnt + col)] = static_cast<float>(value);
-                    if (std::isnan(value)) {
-                        hasInvalids = true;
+                    if (col >= colCnt) {
+                        lastFullRow[t] = static_cast<long long>(row);
                     }
-                } else if (this->columns[col].Type() == TableDataCall::ColumnType::CATEGORICAL) {
-                    assert(hasCatDims);
-                    std::map<std::string, float>::iterator cmi = catMap.find(start);
-                    if (cmi == catMap.end()) {
-                        cmi = catMap
-                                  .insert(std::pair<std::string, float>(
-                                      start, static_cast<float>(thId + thCnt * catMap.size())))
-                                  .first;
+                    for (; col < colCnt; ++col) {
+                        rowValues[col] = std::numeric_limits<float>::quiet_NaN();
                     }
-                    values[static_cast<size_t>(idx * colCnt + col)] = cmi->second;
-                } else {
-                    assert(false);
-                }
 
-                col++;
-                if (*end != '\0') {
-                    start = end + 1;
-                    end = start;
+                    ++row;
+                    ls = next;
                 }
             }
-            for (; col < colCnt; ++col) {
-                values[static_cast<size_t>(idx * colCnt + col)] = std::numeric_limits<float>::quiet_NaN();
+            for (int t = 0; t < thCnt; ++t) {
+                lastFull = std::max(lastFull, lastFullRow[t]);
+            }
+            rowCnt = rowStart[thCnt];
+
+            if (fileEnd)
+                break;
+            if (parsedSize == 0 && parseLen < dataSize) {
+                // Estimate the final table size from the bytes per row of the first block
+                this->values.reserve(static_cast<size_t>(
+                    static_cast<double>(this->values.size()) * dataSize / static_cast<double>(parseLen) * 1.05));
+            }
+            parsedSize += parseLen;
+            block.erase(block.begin(), block.begin() + parseLen);
+        }
+
+        // Drop empty or incomplete lines at the end
+        rowCnt = static_cast<size_t>(lastFull + 1);
+        this->values.resize(rowCnt * colCnt);
+        this->values.shrink_to_fit();
+
+        bool hasInvalids = false;
+#pragma omp parallel for
+        for (long long i = 0; i < static_cast<long long>(this->values.size()); ++i) {
+            if (std::isnan(this->values[i])) {
                 hasInvalids = true;
             }
         }
@@ -398,25 +545,30 @@ void CSVDataSource::assertData() {
             for (size_t c = 0; c < colCnt; ++c) {
                 if (columns[c].Type() != TableDataCall::ColumnType::CATEGORICAL)
                     continue;
-                std::map<int, int> catRemap;
+                // Keys are numbered in lexicographic order to be independent of the thread count
                 std::map<std::string, int> catMap;
                 for (int ci = static_cast<int>(c) * thCnt; ci < static_cast<int>(c + 1) * thCnt; ++ci) {
-                    for (const std::pair<std::string, float>& p : catMaps[ci]) {
-                        int vi = static_cast<int>(p.second + 0.49f);
-                        std::map<std::string, int>::iterator cmi = catMap.find(p.first);
-                        if (cmi == catMap.end()) {
-                            int nv = static_cast<int>(catMap.size());
-                            catMap[p.first] = nv;
-                            catRemap[vi] = nv;
-                        } else {
-                            catRemap[vi] = cmi->second;
-                        }
+                    for (const auto& p : catMaps[ci]) {
+                        catMap.emplace(p.first, 0);
+                    }
+                }
+                int nv = 0;
+                for (auto& p : catMap) {
+                    p.second = nv++;
+                }
+                std::unordered_map<int, int> catRemap;
+                for (int ci = static_cast<int>(c) * thCnt; ci < static_cast<int>(c + 1) * thCnt; ++ci) {
+                    for (const auto& p : catMaps[ci]) {
+                        catRemap[static_cast<int>(p.second + 0.49f)] = catMap[p.first];
                     }
                 }
 
-                for (size_t r = 0; r < rowCnt; ++r) {
+#pragma omp parallel for
+                for (long long r = 0; r < static_cast<long long>(rowCnt); ++r) {
+                    if (std::isnan(values[r * colCnt + c]))
+                        continue; // missing value
                     int vi = static_cast<int>(values[r * colCnt + c] + 0.49f);
-                    values[r * colCnt + c] = static_cast<float>(catRemap[vi]);
+                    values[r * colCnt + c] = static_cast<float>(catRemap.at(vi));
                 }
             }
         }
@@ -61,6 +61,28 @@ bool TableColumnFilter::processData(core::Call& c) {
         if (inCall == NULL)
             return false;
 
+        auto selectionString =
+            vislib::TString(this->selectionStringSlot.Param<core::param::StringParam>()->Value().c_str());
+        //selectionString.Remove(vislib::TString(" "));
+        auto st = vislib::StringTokeniserW(selectionString, vislib::TString(";"));
+        auto selectors = st.Split(selectionString, vislib::TString(";"));
+
+        if (selectors.Count() == 0) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                _T("%hs: No valid selectors have been given\n"), ModuleName.c_str());
+            return false;
+        }
+
+        // Only the selected columns are needed, so do not make the source produce the others.
+        {
+            std::vector<std::string> requested;
+            requested.reserve(selectors.Count());
+            for (size_t sel = 0; sel < selectors.Count(); sel++) {
+                requested.emplace_back(vislib::StringA(selectors[sel]).PeekBuffer());
+            }
+            inCall->SetRequestedColumns(std::move(requested));
+        }
+
         inCall->SetFrameID(outCall->GetFrameID());
         if (!(*inCall)())
             return false;
@@ -75,19 +97,6 @@ bool TableColumnFilter::processData(core::Call& c) {
             auto column_count = inCall->GetColumnsCount();
             auto column_infos = inCall->GetColumnsInfos();
             auto rows_count = inCall->GetRowsCount();
-            auto in_data = inCall->GetData();
-
-            auto selectionString =
-                vislib::TString(this->selectionStringSlot.Param<core::param::StringParam>()->Value().c_str());
-            //selectionString.Remove(vislib::TString(" "));
-            auto st = vislib::StringTokeniserW(selectionString, vislib::TString(";"));
-            auto selectors = st.Split(selectionString, vislib::TString(";"));
-
-            if (selectors.Count() == 0) {
-                megamol::core::utility::log::Log::DefaultLog.WriteError(
-                    _T("%hs: No valid selectors have been given\n"), ModuleName.c_str());
-                return false;
-            }
 
             this->columnInfos.clear();
             this->columnInfos.reserve(selectors.Count());
@@ -115,12 +124,15 @@ bool TableColumnFilter::processData(core::Call& c) {
                 return false;
             }
 
-            this->data.clear();
-            this->data.reserve(rows_count * this->columnInfos.size());
-
-            for (size_t row = 0; row < rows_count; row++) {
-                for (auto& cidx : indexMask) {
-                    this->data.push_back(in_data[cidx + row * column_count]);
+            // Copy column by column through the views, so only the selected columns are touched
+            // regardless of the layout of the source.
+            const auto out_count = indexMask.size();
+            this->data.resize(rows_count * out_count);
+            for (size_t i = 0; i < out_count; ++i) {
+                const auto column = inCall->GetColumn(indexMask[i]);
+                float* dst = this->data.data() + i;
+                for (size_t row = 0; row < rows_count; ++row, dst += out_count) {
+                    *dst = column.IsValid() ? column[row] : std::numeric_limits<float>::quiet_NaN();
                 }
             }
         }
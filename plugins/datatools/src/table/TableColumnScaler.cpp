@@ -35,7 +35,8 @@ TableColumnScaler::TableColumnScaler()
         , scalingFactorSlot("scalingFactor", "Factor by which the selected column get scaled")
         , columnSelectorSlot("columns", "Select columns to scale separated by \";\"")
         , frameID(-1)
-        , datahash((std::numeric_limits<size_t>::max)()) {
+        , datahash((std::numeric_limits<size_t>::max)())
+        , rowsCount(0) {
     this->dataInSlot.SetCompatibleCall<TableDataCallDescription>();
     this->MakeSlotAvailable(&this->dataInSlot);
 
@@ -88,17 +89,15 @@ bool TableColumnScaler::processData(core::Call& c) {
         if (inCall == NULL)
             return false;
 
+        // Scaling is column-wise, so we need exactly the columns that have been requested from us.
+        inCall->SetRequestedColumns(outCall->GetRequestedColumns());
         inCall->SetFrameID(outCall->GetFrameID());
         if (!(*inCall)())
             return false;
 
         if (this->datahash != inCall->DataHash() || this->frameID != inCall->GetFrameID()) {
-            this->datahash = inCall->DataHash();
-            this->frameID = inCall->GetFrameID();
-
             auto rows_count = inCall->GetRowsCount();
             auto column_count = inCall->GetColumnsCount();
-            auto in_data = inCall->GetData();
             auto column_infos = inCall->GetColumnsInfos();
 
             auto scalingFactor = this->scalingFactorSlot.Param<core::param::FloatParam>()->Value();
@@ -148,23 +147,48 @@ bool TableColumnScaler::processData(core::Call& c) {
                 this->columnInfos[col].SetMaximumValue(this->columnInfos[col].MaximumValue() * scalingFactor);
             }
 
-            this->data.clear();
-            this->data.resize(rows_count * column_count);
-            memcpy(this->data.data(), in_data, sizeof(float) * rows_count * column_count);
-            for (size_t row = 0; row < rows_count; row++) {
-                for (auto& col : indexMask) {
-                    this->data[col + row * column_count] *= scalingFactor;
-                }
+            // The columns are produced on demand, see below.
+            this->columnFactors.assign(column_count, 1.0f);
+            for (auto& col : indexMask) {
+                this->columnFactors[col] = scalingFactor;
+            }
+
+            this->rowsCount = rows_count;
+            this->columnData.assign(column_count, std::vector<float>());
+            this->columnViews.assign(column_count, TableDataCall::ColumnView());
+
+            this->datahash = inCall->DataHash();
+            this->frameID = inCall->GetFrameID();
+        }
+
+        // Produce the requested columns that no consumer has requested before. Every column has its own buffer, which
+        // is kept until the input changes, so the output for one request does not depend on the requests of other
+        // consumers and their views stay valid.
+        for (size_t col = 0; col < this->columnViews.size(); col++) {
+            if (this->columnViews[col].IsValid() || !outCall->IsColumnRequested(this->columnInfos[col].Name())) {
+                continue;
+            }
+
+            const auto column = inCall->GetColumn(col);
+            if (!column.IsValid()) {
+                continue;
+            }
+            const auto factor = this->columnFactors[col];
+            auto& dst = this->columnData[col];
+            dst.resize(this->rowsCount);
+            for (size_t row = 0; row < this->rowsCount; row++) {
+                dst[row] = column[row] * factor;
             }
+            this->columnViews[col] = TableDataCall::ColumnView(dst.data(), this->rowsCount);
         }
 
         outCall->SetFrameCount(inCall->GetFrameCount());
         outCall->SetFrameID(this->frameID);
         outCall->SetDataHash(this->datahash);
 
-        if (this->data.size() != 0 && this->columnInfos.size() != 0) {
-            outCall->Set(this->columnInfos.size(), this->data.size() / this->columnInfos.size(),
-                this->columnInfos.data(), this->data.data());
+        if (this->columnViews.size() != 0 && this->columnInfos.size() != 0) {
+            outCall->SetColumns(this->columnInfos.size(), this->rowsCount, this->columnInfos.data(),
+                this->columnViews.data());
         } else {
             outCall->Set(0, 0, NULL, NULL);
         }
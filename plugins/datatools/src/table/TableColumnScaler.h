@@ -91,7 +91,15 @@ private:
 
     std::vector<TableDataCall::ColumnInfo> columnInfos;
 
-    std::vector<float> data;
+    /** Factor per column, 1 for the columns not selected for scaling */
+    std::vector<float> columnFactors;
+
+    size_t rowsCount;
+
+    /** Separate buffer per column, empty until the column has been requested for the current input */
+    std::vector<std::vector<float>> columnData;
+
+    std::vector<TableDataCall::ColumnView> columnViews;
 }; /* end class TableColumnScaler */
 
 } // namespace megamol::datatools::table
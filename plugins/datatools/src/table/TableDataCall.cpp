@@ -6,6 +6,10 @@
  */
 #include "datatools/table/TableDataCall.h"
 
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
 using namespace megamol::datatools;
 using namespace megamol::datatools::table;
 using namespace megamol;
@@ -49,6 +53,12 @@ TableDataCall::TableDataCall()
         , rows_count(0)
         , columns(nullptr)
         , data(nullptr)
+        , column_views(nullptr)
+        , base_rows_count(0)
+        , row_indices(nullptr)
+        , rows_cached(false)
+        , rows_cache_hash(0)
+        , rows_cache_frame(0)
         , frameCount(0)
         , frameID(0) {
     // intentionally empty
@@ -59,4 +69,36 @@ TableDataCall::~TableDataCall() {
     rows_count = 0;    // paranoia
     columns = nullptr; // do not delete, since we do not own the memory of the objects
     data = nullptr;    // do not delete, since we do not own the memory of the objects
+    column_views = nullptr;
+    row_indices = nullptr;
+}
+
+bool TableDataCall::IsColumnRequested(const std::string& name) const {
+    if (requested_columns.empty()) {
+        return true;
+    }
+    auto equals = [](unsigned char l, unsigned char r) { return std::tolower(l) == std::tolower(r); };
+    return std::any_of(requested_columns.begin(), requested_columns.end(), [&name, &equals](const std::string& r) {
+        return std::equal(r.begin(), r.end(), name.begin(), name.end(), equals);
+    });
+}
+
+void TableDataCall::materializeRows() const {
+    rows_cache.resize(columns_count * rows_count);
+    for (size_t c = 0; c < columns_count; ++c) {
+        const auto view = GetColumn(c);
+        float* dst = rows_cache.data() + c;
+        if (view.IsValid()) {
+            for (size_t r = 0; r < rows_count; ++r, dst += columns_count) {
+                *dst = view[r];
+            }
+        } else {
+            for (size_t r = 0; r < rows_count; ++r, dst += columns_count) {
+                *dst = std::numeric_limits<float>::quiet_NaN();
+            }
+        }
+    }
+    rows_cached = true;
+    rows_cache_hash = DataHash();
+    rows_cache_frame = frameID;
 }
@@ -5,6 +5,10 @@
  */
 
 #include "TableFlagFilter.h"
+
+#include <algorithm>
+
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/utility/log/Log.h"
 #include "mmstd/flags/FlagCalls.h"
@@ -19,11 +23,16 @@ TableFlagFilter::TableFlagFilter()
         , flagStorageInSlot("readFlagStorage", "Flag storage read input")
         , tableOutSlot("getDataOut", "Float table output")
         , filterModeParam("filterMode", "filter mode")
+        , lateMaterializationParam("lateMaterialization",
+              "Pass on indices of the remaining rows together with the input data instead of copying the rows.")
         , tableInFrameCount(0)
         , tableInDataHash(0)
         , tableInColCount(0)
+        , tableInRowCount(0)
+        , flagsVersion(0)
         , dataHash(0)
-        , rowCount(0) {
+        , rowCount(0)
+        , isSelection(false) {
 
     this->tableInSlot.SetCompatibleCall<datatools::table::TableDataCallDescription>();
     this->MakeSlotAvailable(&this->tableInSlot);
@@ -42,6 +51,9 @@ TableFlagFilter::TableFlagFilter()
     fmp->SetTypePair(FilterMode::SELECTED, "Selected");
     this->filterModeParam << fmp;
     this->MakeSlotAvailable(&this->filterModeParam);
+
+    this->lateMaterializationParam << new core::param::BoolParam(false);
+    this->MakeSlotAvailable(&this->lateMaterializationParam);
 }
 
 TableFlagFilter::~TableFlagFilter() {
@@ -62,7 +74,12 @@ bool TableFlagFilter::getData(core::Call& call) {
     auto* tableOutCall = dynamic_cast<datatools::table::TableDataCall*>(&call);
     tableOutCall->SetFrameCount(this->tableInFrameCount);
     tableOutCall->SetDataHash(this->dataHash);
-    tableOutCall->Set(this->tableInColCount, this->rowCount, this->colInfos.data(), this->data.data());
+    if (this->isSelection) {
+        auto* tableInCall = this->tableInSlot.CallAs<datatools::table::TableDataCall>();
+        tableOutCall->SetSelection(*tableInCall, this->colInfos.data(), this->rowCount, this->rowIndices.data());
+    } else {
+        tableOutCall->Set(this->tableInColCount, this->rowCount, this->colInfos.data(), this->data.data());
+    }
 
     return true;
 }
@@ -103,16 +120,30 @@ bool TableFlagFilter::handleCall(core::Call& call) {
     (*tableInCall)(0);
     (*flagsInCall)(core::FlagCallRead_CPU::CallGetData);
 
-    if (this->tableInFrameCount != tableInCall->GetFrameCount() || this->tableInDataHash != tableInCall->DataHash() ||
-        flagsInCall->hasUpdate()) {
+    const bool inputChanged = this->tableInFrameCount != tableInCall->GetFrameCount() ||
+                              this->tableInDataHash != tableInCall->DataHash() ||
+                              this->lateMaterializationParam.IsDirty() || this->filterModeParam.IsDirty();
+
+    // getData() consumes the update, so it must be queried first
+    const bool flagsChanged = flagsInCall->hasUpdate();
+
+    if (!inputChanged && flagsChanged && !this->isFilterAffected(*flagsInCall->getData())) {
+        // e.g. brushing a selection while filtering by the filtered flag only
+        this->flagsVersion = flagsInCall->version();
+    } else if (inputChanged || flagsChanged) {
         // megamol::core::utility::log::Log::DefaultLog.WriteInfo( "TableFlagFilter: Filter table.");
 
         this->dataHash++;
+        this->lateMaterializationParam.ResetDirty();
+        this->filterModeParam.ResetDirty();
+        this->flagsVersion = flagsInCall->version();
+        this->isSelection = this->lateMaterializationParam.Param<core::param::BoolParam>()->Value();
 
         this->tableInFrameCount = tableInCall->GetFrameCount();
         this->tableInDataHash = tableInCall->DataHash();
         this->tableInColCount = tableInCall->GetColumnsCount();
-        size_t tableInRowCount = tableInCall->GetRowsCount();
+        this->tableInRowCount = tableInCall->GetRowsCount();
+        const size_t tableInRowCount = this->tableInRowCount;
 
         // download flags
         flagsInCall->getData()->validateFlagCount(tableInRowCount);
@@ -126,41 +157,49 @@ bool TableFlagFilter::handleCall(core::Call& call) {
             this->colInfos[i].SetMaximumValue(std::numeric_limits<float>::lowest());
         }
 
-        core::FlagStorageTypes::flag_item_type testMask = core::FlagStorageTypes::to_integral(
-            core::FlagStorageTypes::flag_bits::ENABLED | core::FlagStorageTypes::flag_bits::FILTERED);
-        core::FlagStorageTypes::flag_item_type passMask =
-            core::FlagStorageTypes::to_integral(core::FlagStorageTypes::flag_bits::ENABLED);
+        const auto [testMask, passMask] = this->getFilterMasks();
 
-        if (static_cast<FilterMode>(this->filterModeParam.Param<core::param::EnumParam>()->Value()) ==
-            FilterMode::SELECTED) {
-            testMask |= core::FlagStorageTypes::to_integral(core::FlagStorageTypes::flag_bits::SELECTED);
-            passMask |= core::FlagStorageTypes::to_integral(core::FlagStorageTypes::flag_bits::SELECTED);
+        // Determine the remaining rows first, so that the data are only touched column by column.
+        auto& selection = this->selection;
+        selection.clear();
+        selection.reserve(tableInRowCount);
+        for (size_t r = 0; r < tableInRowCount; ++r) {
+            if ((flagsData[r] & testMask) == passMask) {
+                selection.push_back(r);
+            }
         }
+        this->rowCount = selection.size();
 
-        // Resize data to size of input table. With this we only need to allocate memory once.
-        this->data.resize(this->tableInColCount * tableInRowCount);
-        this->rowCount = 0;
+        if (this->isSelection) {
+            this->data.clear();
+            this->rowIndices.resize(this->rowCount);
+            for (size_t r = 0; r < this->rowCount; ++r) {
+                this->rowIndices[r] = tableInCall->GetBaseRowIndex(selection[r]);
+            }
+        } else {
+            this->rowIndices.clear();
+            this->data.resize(this->tableInColCount * this->rowCount);
+        }
 
-        const float* tableInData = tableInCall->GetData();
-        for (size_t r = 0; r < tableInRowCount; ++r) {
-            if ((flagsData[r] & testMask) == passMask) {
-                for (size_t c = 0; c < this->tableInColCount; ++c) {
-                    float val = tableInData[this->tableInColCount * r + c];
-                    this->data[this->tableInColCount * this->rowCount + c] = val;
-                    if (val < this->colInfos[c].MinimumValue()) {
-                        this->colInfos[c].SetMinimumValue(val);
-                    }
-                    if (val > this->colInfos[c].MaximumValue()) {
-                        this->colInfos[c].SetMaximumValue(val);
-                    }
+        for (size_t c = 0; c < this->tableInColCount; ++c) {
+            const auto column = tableInCall->GetColumn(c);
+            if (!column.IsValid()) {
+                continue;
+            }
+            for (size_t r = 0; r < this->rowCount; ++r) {
+                float val = column[selection[r]];
+                if (!this->isSelection) {
+                    this->data[this->tableInColCount * r + c] = val;
+                }
+                if (val < this->colInfos[c].MinimumValue()) {
+                    this->colInfos[c].SetMinimumValue(val);
+                }
+                if (val > this->colInfos[c].MaximumValue()) {
+                    this->colInfos[c].SetMaximumValue(val);
                 }
-                this->rowCount++;
             }
         }
 
-        // delete memory of filtered rows
-        this->data.resize(this->tableInColCount * this->rowCount);
-
         // nicer output
         if (this->rowCount == 0) {
             for (size_t i = 0; i < this->tableInColCount; ++i) {
@@ -172,3 +211,49 @@ bool TableFlagFilter::handleCall(core::Call& call) {
 
     return true;
 }
+
+std::pair<core::FlagStorageTypes::flag_item_type, core::FlagStorageTypes::flag_item_type>
+TableFlagFilter::getFilterMasks() const {
+    core::FlagStorageTypes::flag_item_type testMask = core::FlagStorageTypes::to_integral(
+        core::FlagStorageTypes::flag_bits::ENABLED | core::FlagStorageTypes::flag_bits::FILTERED);
+    core::FlagStorageTypes::flag_item_type passMask =
+        core::FlagStorageTypes::to_integral(core::FlagStorageTypes::flag_bits::ENABLED);
+
+    if (static_cast<FilterMode>(this->filterModeParam.Param<core::param::EnumParam>()->Value()) ==
+        FilterMode::SELECTED) {
+        testMask |= core::FlagStorageTypes::to_integral(core::FlagStorageTypes::flag_bits::SELECTED);
+        passMask |= core::FlagStorageTypes::to_integral(core::FlagStorageTypes::flag_bits::SELECTED);
+    }
+
+    return {testMask, passMask};
+}
+
+bool TableFlagFilter::isFilterAffected(const core::FlagCollection_CPU& flags) const {
+    std::vector<core::FlagCollection_CPU::index_range> changes;
+    if (!flags.getChangesSince(this->flagsVersion, changes)) {
+        return true;
+    }
+
+    const auto [testMask, passMask] = this->getFilterMasks();
+    const auto& flagsData = *flags.flags;
+    for (const auto& [begin, end] : changes) {
+        // flags beyond the table do not matter
+        const size_t rowEnd = std::min<size_t>(end, this->tableInRowCount);
+        if (rowEnd > flagsData.size()) {
+            return true;
+        }
+        // the remaining rows are sorted, so the rows of each range are found by a single search
+        auto it = std::lower_bound(this->selection.begin(), this->selection.end(), static_cast<size_t>(begin));
+        for (size_t r = begin; r < rowEnd; ++r) {
+            const bool remaining = it != this->selection.end() && *it == r;
+            if (remaining) {
+                ++it;
+            }
+            if (((flagsData[r] & testMask) == passMask) != remaining) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
@@ -11,6 +11,7 @@
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
+#include "mmstd/flags/FlagCollection.h"
 
 namespace megamol::datatools::table {
 
@@ -54,22 +55,36 @@ protected:
 private:
     enum FilterMode { FILTERED = 0, SELECTED = 1 };
 
+    /** Answer the mask of the tested flag bits and their values for rows passing the filter */
+    std::pair<core::FlagStorageTypes::flag_item_type, core::FlagStorageTypes::flag_item_type> getFilterMasks() const;
+
+    /** Answer whether the flags modified since the last filtering change the set of remaining rows */
+    bool isFilterAffected(const core::FlagCollection_CPU& flags) const;
+
     core::CallerSlot tableInSlot;
     core::CallerSlot flagStorageInSlot;
     core::CalleeSlot tableOutSlot;
 
     core::param::ParamSlot filterModeParam;
+    core::param::ParamSlot lateMaterializationParam;
 
     // input table properties
     unsigned int tableInFrameCount;
     size_t tableInDataHash;
     size_t tableInColCount;
+    size_t tableInRowCount;
+
+    // flag storage version of the filtered table
+    uint32_t flagsVersion;
 
     // filtered table
     size_t dataHash;
     size_t rowCount;
+    std::vector<size_t> selection;
     std::vector<datatools::table::TableDataCall::ColumnInfo> colInfos;
     std::vector<float> data;
+    std::vector<size_t> rowIndices;
+    bool isSelection;
 };
 
 } // namespace megamol::datatools::table
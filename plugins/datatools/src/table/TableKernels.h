@@ -0,0 +1,222 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <omp.h>
+
+#include "datatools/table/TableDataCall.h"
+
+
+namespace megamol::datatools::table::kernels {
+
+/**
+ * Below this number of rows, the serial algorithms are faster than
+ * starting a parallel region.
+ */
+constexpr std::size_t ParallelThreshold = 1 << 16;
+
+/**
+ * Maps a float to an unsigned integer whose order matches the order of the
+ * floats, i.e. negative values are flipped entirely and positive values get
+ * their sign bit set.
+ */
+inline std::uint32_t orderedKey(const float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/**
+ * Evaluates 'pred' for all cells of 'key' and stores the indices of the
+ * rows for which it is true in 'selection' (in ascending order).
+ *
+ * Each thread evaluates the predicate for a contiguous range of rows into a
+ * mask and counts the hits; a prefix sum over the counts then yields the
+ * position at which each thread writes its part of the selection.
+ *
+ * @param key       The column the predicate is evaluated on.
+ * @param selection Receives the indices of the selected rows.
+ * @param pred      The predicate, which must be callable with a float.
+ */
+template<class Pred>
+void selectRows(const TableDataCall::ColumnView& key, std::vector<std::size_t>& selection, Pred pred) {
+    const auto cnt = key.Count();
+    selection.clear();
+
+    if (cnt < ParallelThreshold) {
+        selection.reserve(cnt);
+        for (std::size_t r = 0; r < cnt; ++r) {
+            if (pred(key[r])) {
+                selection.push_back(r);
+            }
+        }
+        return;
+    }
+
+    std::vector<std::uint8_t> mask(cnt);
+    std::vector<std::size_t> offsets(omp_get_max_threads() + 1, 0);
+
+#pragma omp parallel
+    {
+        const auto thCnt = static_cast<std::size_t>(omp_get_num_threads());
+        const auto th = static_cast<std::size_t>(omp_get_thread_num());
+        const auto begin = cnt * th / thCnt;
+        const auto end = cnt * (th + 1) / thCnt;
+        std::size_t hits = 0;
+
+        if (key.IsContiguous()) {
+            // This is the loop that benefits from vectorisation of the predicate.
+            const float* data = key.Data();
+#pragma omp simd reduction(+ : hits)
+            for (std::size_t r = begin; r < end; ++r) {
+                const std::uint8_t m = pred(data[r]) ? 1 : 0;
+                mask[r] = m;
+                hits += m;
+            }
+        } else {
+            for (std::size_t r = begin; r < end; ++r) {
+                const std::uint8_t m = pred(key[r]) ? 1 : 0;
+                mask[r] = m;
+                hits += m;
+            }
+        }
+        offsets[th + 1] = hits;
+
+#pragma omp barrier
+#pragma omp single
+        {
+            for (std::size_t t = 0; t < thCnt; ++t) {
+                offsets[t + 1] += offsets[t];
+            }
+            selection.resize(offsets[thCnt]);
+        }
+
+        auto dst = selection.data() + offsets[th];
+        for (std::size_t r = begin; r < end; ++r) {
+            if (mask[r] != 0) {
+                *dst++ = r;
+            }
+        }
+    }
+}
+
+/**
+ * Sorts 'rows' by the values of 'key' at these rows.
+ *
+ * Large inputs are sorted using a parallel LSD radix sort over the bit
+ * patterns of the floats (three passes of 11 bits), which is always stable.
+ * Passes for which all keys share the same digit are skipped. Small inputs
+ * use the standard library sort.
+ *
+ * @param key        The column providing the sort keys.
+ * @param rows       The row indices to be sorted.
+ * @param descending Sort in descending instead of ascending order.
+ * @param stable     Preserve the order of rows with equal keys.
+ */
+inline void sortRowsByKey(const TableDataCall::ColumnView& key, std::vector<std::size_t>& rows,
+    const bool descending, const bool stable) {
+    const auto cnt = rows.size();
+
+    if (cnt < ParallelThreshold) {
+        auto pred = [&key, descending](const std::size_t l, const std::size_t r) {
+            return descending ? (key[r] < key[l]) : (key[l] < key[r]);
+        };
+        if (stable) {
+            std::stable_sort(rows.begin(), rows.end(), pred);
+        } else {
+            std::sort(rows.begin(), rows.end(), pred);
+        }
+        return;
+    }
+
+    constexpr std::size_t DigitBits = 11;
+    constexpr std::size_t Buckets = 1 << DigitBits;
+    constexpr std::uint32_t DigitMask = Buckets - 1;
+
+    // Inverting all bits reverses the order, but keeps equal keys in order.
+    const std::uint32_t flip = descending ? 0xFFFFFFFFu : 0u;
+
+    std::vector<std::uint32_t> keys(cnt), keysTmp(cnt);
+    std::vector<std::size_t> rowsTmp(cnt);
+    std::vector<std::size_t> histograms(omp_get_max_threads() * Buckets);
+
+    const auto signedCnt = static_cast<std::int64_t>(cnt);
+#pragma omp parallel for
+    for (std::int64_t i = 0; i < signedCnt; ++i) {
+        keys[i] = orderedKey(key[rows[i]]) ^ flip;
+    }
+
+    auto srcKeys = &keys;
+    auto dstKeys = &keysTmp;
+    auto srcRows = &rows;
+    auto dstRows = &rowsTmp;
+
+    for (std::size_t shift = 0; shift < 32; shift += DigitBits) {
+        bool isSkipped = false;
+
+#pragma omp parallel
+        {
+            const auto thCnt = static_cast<std::size_t>(omp_get_num_threads());
+            const auto th = static_cast<std::size_t>(omp_get_thread_num());
+            const auto begin = cnt * th / thCnt;
+            const auto end = cnt * (th + 1) / thCnt;
+            auto hist = histograms.data() + th * Buckets;
+            const auto& sk = *srcKeys;
+
+            std::fill(hist, hist + Buckets, 0);
+            for (std::size_t i = begin; i < end; ++i) {
+                ++hist[(sk[i] >> shift) & DigitMask];
+            }
+
+#pragma omp barrier
+#pragma omp single
+            {
+                // Exclusive prefix sum in (digit, thread) order makes the scatter stable.
+                std::size_t sum = 0;
+                for (std::size_t d = 0; d < Buckets; ++d) {
+                    std::size_t digitCnt = 0;
+                    for (std::size_t t = 0; t < thCnt; ++t) {
+                        const auto c = histograms[t * Buckets + d];
+                        histograms[t * Buckets + d] = sum;
+                        sum += c;
+                        digitCnt += c;
+                    }
+                    if (digitCnt == cnt) {
+                        isSkipped = true;
+                    }
+                }
+            }
+
+            if (!isSkipped) {
+                auto& dk = *dstKeys;
+                auto& sr = *srcRows;
+                auto& dr = *dstRows;
+                for (std::size_t i = begin; i < end; ++i) {
+                    const auto pos = hist[(sk[i] >> shift) & DigitMask]++;
+                    dk[pos] = sk[i];
+                    dr[pos] = sr[i];
+                }
+            }
+        }
+
+        if (!isSkipped) {
+            std::swap(srcKeys, dstKeys);
+            std::swap(srcRows, dstRows);
+        }
+    }
+
+    if (srcRows != &rows) {
+        rows.swap(*srcRows);
+    }
+}
+
+} // namespace megamol::datatools::table::kernels
@@ -8,8 +8,10 @@
 #include "TableProcessorBase.h"
 
 #include <cassert>
+#include <cstdint>
 #include <limits>
 
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/utility/log/Log.h"
 
 /*
@@ -19,6 +21,9 @@ megamol::datatools::table::TableProcessorBase::TableProcessorBase()
         : frameID((std::numeric_limits<unsigned int>::max)())
         , inputHash(0)
         , localHash(0)
+        , paramLateMaterialization("lateMaterialization",
+              "Pass on indices of the selected rows together with the input data instead of copying the rows.")
+        , isSelection(false)
         , slotInput("input", "The input slot providing the unfiltered data.")
         , slotOutput("output", "The input slot for the filtered data.") {
     /* Export the calls. */
@@ -30,6 +35,55 @@ megamol::datatools::table::TableProcessorBase::TableProcessorBase()
     this->slotOutput.SetCallback(
         TableDataCall::ClassName(), TableDataCall::FunctionName(1), &TableProcessorBase::getHash);
     this->MakeSlotAvailable(&this->slotOutput);
+
+    this->paramLateMaterialization << new core::param::BoolParam(false);
+    this->MakeSlotAvailable(&this->paramLateMaterialization);
+}
+
+
+/*
+ * megamol::datatools::table::TableProcessorBase::isLateMaterialization
+ */
+bool megamol::datatools::table::TableProcessorBase::isLateMaterialization() const {
+    return this->paramLateMaterialization.Param<core::param::BoolParam>()->Value();
+}
+
+
+/*
+ * megamol::datatools::table::TableProcessorBase::applySelection
+ */
+void megamol::datatools::table::TableProcessorBase::applySelection(
+    const TableDataCall& src, const std::vector<std::size_t>& selection) {
+    this->isSelection = this->isLateMaterialization();
+
+    if (this->isSelection) {
+        // Only remember where the rows are, but map them to the data shared with 'src'.
+        this->values.clear();
+        this->rowIndices.resize(selection.size());
+        for (std::size_t r = 0; r < selection.size(); ++r) {
+            this->rowIndices[r] = src.GetBaseRowIndex(selection[r]);
+        }
+
+    } else {
+        const auto cols = src.GetColumnsCount();
+        std::vector<TableDataCall::ColumnView> columns(cols);
+        for (std::size_t c = 0; c < cols; ++c) {
+            columns[c] = src.GetColumn(c);
+        }
+
+        this->rowIndices.clear();
+        this->values.resize(selection.size() * cols);
+
+        // Gather row by row such that each thread writes a contiguous part of the output.
+        const auto rows = static_cast<std::int64_t>(selection.size());
+#pragma omp parallel for
+        for (std::int64_t r = 0; r < rows; ++r) {
+            auto dst = this->values.data() + r * cols;
+            for (std::size_t c = 0; c < cols; ++c) {
+                dst[c] = columns[c].IsValid() ? columns[c][selection[r]] : std::numeric_limits<float>::quiet_NaN();
+            }
+        }
+    }
 }
 
 
@@ -61,8 +115,12 @@ bool megamol::datatools::table::TableProcessorBase::getData(core::Call& call) {
     dst->SetFrameCount(src->GetFrameCount());
     dst->SetFrameID(this->frameID);
     dst->SetDataHash(this->getHash());
-    dst->Set(
-        this->columns.size(), this->values.size() / this->columns.size(), this->columns.data(), this->values.data());
+    if (this->isSelection) {
+        dst->SetSelection(*src, this->columns.data(), this->rowIndices.size(), this->rowIndices.data());
+    } else {
+        dst->Set(this->columns.size(), this->values.size() / this->columns.size(), this->columns.data(),
+            this->values.data());
+    }
 
     return true;
 }
@@ -49,6 +49,25 @@ protected:
         return retval;
     }
 
+    /**
+     * Answer whether the output is passed on as row selection into the input
+     * data instead of being copied.
+     *
+     * @return true if late materialization is enabled, false otherwise.
+     */
+    bool isLateMaterialization() const;
+
+    /**
+     * Makes the given rows of 'src' the output of the module. Depending on
+     * the late materialization setting, the rows are either copied into
+     * 'values' or stored as indices into the data shared with 'src'.
+     *
+     * @param src       The call providing the input data.
+     * @param selection The indices of the selected rows of 'src' in output
+     *                  order.
+     */
+    void applySelection(const TableDataCall& src, const std::vector<std::size_t>& selection);
+
     /**
      * Prepares the data requested by 'call'.
      *
@@ -71,6 +90,15 @@ protected:
     /** Holds a hash representing the current state of the processor. */
     std::size_t localHash;
 
+    /** Enables passing on row indices instead of copies of the rows. */
+    core::param::ParamSlot paramLateMaterialization;
+
+    /** Holds the selected rows of the shared input data if 'values' is not used. */
+    std::vector<std::size_t> rowIndices;
+
+    /** Determines whether the output consists of 'rowIndices' rather than 'values'. */
+    bool isSelection;
+
     /** The slot providing the input data. */
     core::CallerSlot slotInput;
 
@@ -7,6 +7,7 @@
 
 #include "TableSampler.h"
 
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/ButtonParam.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FloatParam.h"
@@ -30,11 +31,14 @@ TableSampler::TableSampler()
         , sampleNumberAbsoluteParam("sampleNumberAbsolute", "number of samples")
         , sampleNumberRelativeParam("sampleNumberRelative", "percentage of samples")
         , resampleParam("resample", "resample")
+        , lateMaterializationParam("lateMaterialization",
+              "Pass on indices of the sampled rows together with the input data instead of copying the rows.")
         , tableInFrameCount(0)
         , tableInDataHash(0)
         , tableInColCount(0)
         , dataHash(0)
         , rowCount(0)
+        , isSelection(false)
         , doResampling(false) {
 
     this->tableInSlot.SetCompatibleCall<TableDataCallDescription>();
@@ -64,6 +68,9 @@ TableSampler::TableSampler()
     this->resampleParam << new core::param::ButtonParam();
     this->resampleParam.SetUpdateCallback(this, &TableSampler::resampleCallback);
     this->MakeSlotAvailable(&resampleParam);
+
+    this->lateMaterializationParam << new core::param::BoolParam(false);
+    this->MakeSlotAvailable(&this->lateMaterializationParam);
 }
 
 TableSampler::~TableSampler() {
@@ -84,7 +91,12 @@ bool TableSampler::getData(core::Call& call) {
     auto* tableOutCall = dynamic_cast<TableDataCall*>(&call);
     tableOutCall->SetFrameCount(this->tableInFrameCount);
     tableOutCall->SetDataHash(this->dataHash);
-    tableOutCall->Set(this->tableInColCount, this->rowCount, this->colInfos.data(), this->data.data());
+    if (this->isSelection) {
+        auto* tableInCall = this->tableInSlot.CallAs<TableDataCall>();
+        tableOutCall->SetSelection(*tableInCall, this->colInfos.data(), this->rowCount, this->rowIndices.data());
+    } else {
+        tableOutCall->Set(this->tableInColCount, this->rowCount, this->colInfos.data(), this->data.data());
+    }
 
     return true;
 }
@@ -119,11 +131,13 @@ bool TableSampler::handleCall(core::Call& call) {
     (*tableInCall)(0);
 
     if (this->tableInFrameCount != tableInCall->GetFrameCount() || this->tableInDataHash != tableInCall->DataHash() ||
-        doResampling) {
+        doResampling || this->lateMaterializationParam.IsDirty()) {
         //megamol::core::utility::log::Log::DefaultLog.WriteInfo( "TableSampler: Sample table.");
 
         this->dataHash++;
         this->doResampling = false;
+        this->lateMaterializationParam.ResetDirty();
+        this->isSelection = this->lateMaterializationParam.Param<core::param::BoolParam>()->Value();
 
         this->tableInFrameCount = tableInCall->GetFrameCount();
         this->tableInDataHash = tableInCall->DataHash();
@@ -160,13 +174,27 @@ bool TableSampler::handleCall(core::Call& call) {
         this->rowCount = std::min(numberOfSamples, indexList.size());
         indexList.resize(this->rowCount);
 
-        this->data.resize(this->tableInColCount * this->rowCount);
+        if (this->isSelection) {
+            this->data.clear();
+            this->rowIndices.resize(this->rowCount);
+            for (size_t r = 0; r < this->rowCount; ++r) {
+                this->rowIndices[r] = tableInCall->GetBaseRowIndex(indexList[r]);
+            }
+        } else {
+            this->rowIndices.clear();
+            this->data.resize(this->tableInColCount * this->rowCount);
+        }
 
-        const float* tableInData = tableInCall->GetData();
-        for (size_t r = 0; r < this->rowCount; ++r) {
-            for (size_t c = 0; c < this->tableInColCount; ++c) {
-                float val = tableInData[this->tableInColCount * indexList[r] + c];
-                this->data[this->tableInColCount * r + c] = val;
+        for (size_t c = 0; c < this->tableInColCount; ++c) {
+            const auto column = tableInCall->GetColumn(c);
+            if (!column.IsValid()) {
+                continue;
+            }
+            for (size_t r = 0; r < this->rowCount; ++r) {
+                float val = column[indexList[r]];
+                if (!this->isSelection) {
+                    this->data[this->tableInColCount * r + c] = val;
+                }
                 if (val < this->colInfos[c].MinimumValue()) {
                     this->colInfos[c].SetMinimumValue(val);
                 }
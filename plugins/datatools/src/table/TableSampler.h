@@ -70,6 +70,7 @@ private:
     core::param::ParamSlot sampleNumberAbsoluteParam;
     core::param::ParamSlot sampleNumberRelativeParam;
     core::param::ParamSlot resampleParam;
+    core::param::ParamSlot lateMaterializationParam;
     // TODO control random seeding?
 
     // input table properties
@@ -82,6 +83,8 @@ private:
     size_t rowCount;
     std::vector<TableDataCall::ColumnInfo> colInfos;
     std::vector<float> data;
+    std::vector<size_t> rowIndices;
+    bool isSelection;
 
     bool doResampling;
 };
@@ -6,6 +6,7 @@
 
 #include "TableSelectionTx.h"
 
+#include <algorithm>
 #include <unordered_set>
 
 #include "mmcore/param/BoolParam.h"
@@ -27,6 +28,9 @@ TableSelectionTx::TableSelectionTx()
         , updateSelectionParam("updateSelection", "Enable selection update")
         , useColumnAsIndexParam("useColumnAsIndex", "Use column as index instead of row id")
         , indexColumnParam("indexColumn", "Numeric index of column, which is used as row index")
+        , selectedRowsValid_(false)
+        , selectedRowsFlagsVersion_(0)
+        , selectedRowsTableHash_(0)
         , senderThreadQuit_(false)
         , senderThreadNotified_(false)
         , receiverThreadQuit_(false)
@@ -174,21 +178,50 @@ bool TableSelectionTx::writeDataCallback(core::Call& call) {
     constexpr core::FlagStorageTypes::flag_item_type passMask =
         core::FlagStorageTypes::to_integral(core::FlagStorageTypes::flag_bits::ENABLED);
 
-    std::unique_lock<std::mutex> lock(selectedMutex_);
-    selected_.clear();
-    for (std::size_t i = 0; i < numberOfRows; ++i) {
-        if ((flags[i] & testMask) == passMask) {
-            if (flags[i] & core::FlagStorageTypes::to_integral(core::FlagStorageTypes::flag_bits::SELECTED)) {
-                if (useColumnAsIndex) {
-                    selected_.push_back(static_cast<uint64_t>(tableData[indexColumn + i * numberOfCols]));
-                } else {
-                    selected_.push_back(static_cast<uint64_t>(i));
+    constexpr auto selectedBit = core::FlagStorageTypes::to_integral(core::FlagStorageTypes::flag_bits::SELECTED);
+    auto isSelected = [&](std::size_t i) { return (flags[i] & testMask) == passMask && (flags[i] & selectedBit); };
+
+    std::vector<core::FlagCollection_CPU::index_range> changes;
+    // Only rescan the rows with modified flags if the storage knows them
+    const auto& flagCollection = *flagsWriteOutCall->getData();
+    if (selectedRowsValid_ && selectedRowsTableHash_ == tableInCall->DataHash() && !flagCollection.hasDirtyRanges() &&
+        flagCollection.getChangesSince(selectedRowsFlagsVersion_, changes)) {
+        for (const auto& [begin, end] : changes) {
+            const std::size_t rowBegin = std::min<std::size_t>(begin, numberOfRows);
+            const std::size_t rowEnd = std::min<std::size_t>(end, numberOfRows);
+            const auto first = std::lower_bound(selectedRows_.begin(), selectedRows_.end(), rowBegin);
+            const auto last = std::lower_bound(first, selectedRows_.end(), rowEnd);
+            std::vector<std::size_t> rows;
+            for (std::size_t i = rowBegin; i < rowEnd; ++i) {
+                if (isSelected(i)) {
+                    rows.push_back(i);
                 }
-            } else {
-                // not selected
+            }
+            const auto pos = selectedRows_.erase(first, last);
+            selectedRows_.insert(pos, rows.begin(), rows.end());
+        }
+    } else {
+        selectedRows_.clear();
+        for (std::size_t i = 0; i < numberOfRows; ++i) {
+            if (isSelected(i)) {
+                selectedRows_.push_back(i);
             }
         }
     }
+    selectedRowsValid_ = true;
+    selectedRowsFlagsVersion_ = flagsWriteOutCall->version();
+    selectedRowsTableHash_ = tableInCall->DataHash();
+
+    std::unique_lock<std::mutex> lock(selectedMutex_);
+    selected_.resize(selectedRows_.size());
+    for (std::size_t s = 0; s < selectedRows_.size(); ++s) {
+        const auto i = selectedRows_[s];
+        if (useColumnAsIndex) {
+            selected_[s] = static_cast<uint64_t>(tableData[indexColumn + i * numberOfCols]);
+        } else {
+            selected_[s] = static_cast<uint64_t>(i);
+        }
+    }
     senderThreadNotified_ = true;
     condVar_.notify_one();
     lock.unlock();
@@ -281,7 +314,14 @@ bool TableSelectionTx::validateSelectionUpdate() {
         }
     }
 
-    *flagCollection->flags = flags_data;
+    // Report only the rows whose flags actually changed, such that the readers do not need to scan all flags
+    const auto rowCount = static_cast<core::FlagStorageTypes::index_type>(numberOfRows);
+    const auto flagCount = static_cast<core::FlagStorageTypes::index_type>(flagCollection->flags->size());
+    if (flagCount > rowCount) {
+        flagCollection->markDirty(rowCount, flagCount);
+        flagCollection->flags->resize(numberOfRows);
+    }
+    flagCollection->assignAndMarkDirty(flags_data.data(), rowCount);
 
     auto* flagsWriteInCall = this->flagStorageWriteInSlot.CallAs<core::FlagCallWrite_CPU>();
     flagsWriteInCall->setData(flagCollection, version + 1);
@@ -81,6 +81,11 @@ private:
     std::thread receiverThread_;
     std::unique_ptr<zmq::context_t> context_;
     std::vector<uint64_t> selected_;
+    // sorted rows of selected_, kept to only update the rows with modified flags
+    std::vector<std::size_t> selectedRows_;
+    bool selectedRowsValid_;
+    uint32_t selectedRowsFlagsVersion_;
+    std::size_t selectedRowsTableHash_;
     std::mutex selectedMutex_;
     std::condition_variable condVar_;
     bool senderThreadQuit_;
@@ -16,6 +16,8 @@
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FlexEnumParam.h"
 
+#include "TableKernels.h"
+
 
 /*
  * megamol::datatools::table::TableSort::TableSort
@@ -69,12 +71,12 @@ bool megamol::datatools::table::TableSort::prepareData(TableDataCall& src, const
     }
 
     auto isParamsChanged = this->paramColumn.IsDirty() || this->paramColumn.IsDirty() ||
-                           this->paramIsDescending.IsDirty() || this->paramIsStable.IsDirty();
+                           this->paramIsDescending.IsDirty() || this->paramIsStable.IsDirty() ||
+                           this->paramLateMaterialization.IsDirty();
 
     /* (Re-) Generate the data. */
     if (isParamsChanged || (this->inputHash != src.DataHash()) || (this->frameID != src.GetFrameID())) {
         auto column = 0;
-        const auto data = src.GetData();
         std::vector<std::size_t> proxy(src.GetRowsCount());
 
         /* Copy the column descriptors. */
@@ -111,26 +113,14 @@ bool megamol::datatools::table::TableSort::prepareData(TableDataCall& src, const
         std::iota(proxy.begin(), proxy.end(), 0);
 
         const auto isDesc = this->paramIsDescending.Param<BoolParam>()->Value();
-        auto pred = [this, column, data, isDesc](const std::size_t l, const std::size_t r) {
-            auto lhs = data[l * this->columns.size() + column];
-            auto rhs = data[r * this->columns.size() + column];
-            return isDesc ? (rhs < lhs) : (lhs < rhs);
-        };
-
-        if (this->paramIsStable.Param<BoolParam>()->Value()) {
-            std::stable_sort(proxy.begin(), proxy.end(), pred);
-        } else {
-            std::sort(proxy.begin(), proxy.end(), pred);
+        const auto isStable = this->paramIsStable.Param<BoolParam>()->Value();
+        const auto key = (column < this->columns.size()) ? src.GetColumn(column) : TableDataCall::ColumnView();
+        if (key.IsValid()) {
+            kernels::sortRowsByKey(key, proxy, isDesc, isStable);
         }
 
-        /* Copy the data in sorted order. */
-        this->values.resize(src.GetRowsCount() * src.GetColumnsCount());
-        auto dst = this->values.data();
-
-        for (auto r : proxy) {
-            std::copy(data + r * this->columns.size(), data + (r + 1) * this->columns.size(), dst);
-            dst += this->columns.size();
-        }
+        /* Copy the data in sorted order or pass on the permutation. */
+        this->applySelection(src, proxy);
 
         /* Persist the state of the data. */
         this->frameID = frameID;
@@ -141,6 +131,7 @@ bool megamol::datatools::table::TableSort::prepareData(TableDataCall& src, const
             this->paramColumn.ResetDirty();
             this->paramIsDescending.ResetDirty();
             this->paramIsStable.ResetDirty();
+            this->paramLateMaterialization.ResetDirty();
         }
     } /* end if (selector || (this->inputHash != src->DataHash()) ... */
 
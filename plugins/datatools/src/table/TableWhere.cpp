@@ -19,6 +19,8 @@
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/StringParam.h"
 
+#include "TableKernels.h"
+
 
 /// <summary>
 /// The list of possible comparison operators.
@@ -39,6 +41,26 @@ enum Operator : int {
 };
 
 
+/// <summary>
+/// Evaluates a predicate on a column and stores the indices of the matching rows.
+/// <summary>
+typedef std::function<void(const megamol::datatools::table::TableDataCall::ColumnView&, std::vector<std::size_t>&)>
+    Selector;
+
+
+/// <summary>
+/// Wraps 'pred' such that the selection kernel is instantiated for the concrete
+/// predicate, which allows for vectorising its evaluation.
+/// <summary>
+template<class Pred>
+static Selector makeSelector(Pred pred) {
+    return [pred](const megamol::datatools::table::TableDataCall::ColumnView& key,
+               std::vector<std::size_t>& selection) {
+        megamol::datatools::table::kernels::selectRows(key, selection, pred);
+    };
+}
+
+
 /*
  * megamol::datatools::table::TableWhere::TableWhere
  */
@@ -120,14 +142,14 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
     }
 
     auto isParamsChanged = this->paramUpdateRange.IsDirty() || this->paramColumn.IsDirty() ||
-                           this->paramOperator.IsDirty() || this->paramReference.IsDirty();
+                           this->paramOperator.IsDirty() || this->paramReference.IsDirty() ||
+                           this->paramLateMaterialization.IsDirty();
 
     /* (Re-) Generate the data. */
     if (isParamsChanged || (this->inputHash != src.DataHash()) || (this->frameID != src.GetFrameID())) {
         auto column = 0;
-        const auto data = src.GetData();
         auto isSort = false;
-        std::function<bool(const float)> selector;
+        Selector selector;
 
         /* Process updates in the configuration. */
         {
@@ -159,52 +181,48 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
 
                 switch (o) {
                 case Operator::Less:
-                    selector = [r](const float v) { return (v < r); };
+                    selector = makeSelector([r](const float v) { return (v < r); });
                     break;
 
                 case Operator::LessOrEqual:
-                    selector = [r](const float v) { return (v <= r); };
+                    selector = makeSelector([r](const float v) { return (v <= r); });
                     break;
 
                 case Operator::Equal:
-                    selector = [r, e](const float v) { return (std::abs(v - r) <= e); };
+                    selector = makeSelector([r, e](const float v) { return (std::abs(v - r) <= e); });
                     break;
 
                 case Operator::GreaterOrEqual:
-                    selector = [r](const float v) { return (v >= r); };
+                    selector = makeSelector([r](const float v) { return (v >= r); });
                     break;
 
                 case Operator::Greater:
-                    selector = [r](const float v) { return (v > r); };
+                    selector = makeSelector([r](const float v) { return (v > r); });
                     break;
 
                 case Operator::NotEqual:
-                    selector = [r, e](const float v) { return (std::abs(v - r) > e); };
+                    selector = makeSelector([r, e](const float v) { return (std::abs(v - r) > e); });
                     break;
 
-                case Operator::LowerRange:
-                    selector = [r, range](const float v) {
-                        assert(range.second >= range.first);
-                        auto d = (range.second - range.first) * r;
-                        return (v <= (range.first + d));
-                    };
-                    break;
+                case Operator::LowerRange: {
+                    assert(range.second >= range.first);
+                    const auto t = range.first + (range.second - range.first) * r;
+                    selector = makeSelector([t](const float v) { return (v <= t); });
+                } break;
 
-                case Operator::MiddleRange:
-                    selector = [r, range](const float v) {
-                        assert(range.second >= range.first);
-                        auto d = 1.0f - 0.5f * (range.second - range.first) * r;
-                        return ((v >= (range.first + d)) && (v <= (range.second - d)));
-                    };
-                    break;
+                case Operator::MiddleRange: {
+                    assert(range.second >= range.first);
+                    const auto d = 1.0f - 0.5f * (range.second - range.first) * r;
+                    const auto lo = range.first + d;
+                    const auto hi = range.second - d;
+                    selector = makeSelector([lo, hi](const float v) { return ((v >= lo) && (v <= hi)); });
+                } break;
 
-                case Operator::UpperRange:
-                    selector = [r, range](const float v) {
-                        assert(range.second >= range.first);
-                        auto d = (range.second - range.first) * r;
-                        return (v >= (range.second - d));
-                    };
-                    break;
+                case Operator::UpperRange: {
+                    assert(range.second >= range.first);
+                    const auto t = range.second - (range.second - range.first) * r;
+                    selector = makeSelector([t](const float v) { return (v >= t); });
+                } break;
 
                 case Operator::LowerPercentile:
                 case Operator::MiddlePercentile:
@@ -229,17 +247,14 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
         assert(((column >= 0) && (column < this->columns.size())) || !selector);
 
         if (selector || isSort) {
+            const auto key = src.GetColumn(column);
+
             // Copy selection.
             std::vector<std::size_t> selection;
-            selection.reserve(src.GetRowsCount());
 
             if (selector) {
                 // Selection is based on predicate.
-                for (auto r = 0; r < src.GetRowsCount(); ++r) {
-                    if (selector(data[r * this->columns.size() + column])) {
-                        selection.push_back(r);
-                    }
-                }
+                selector(key, selection);
             } else {
                 // Selection requires sorting.
                 const auto o = this->paramOperator.Param<EnumParam>()->Value();
@@ -248,12 +263,7 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
                 selection.resize(src.GetRowsCount());
                 std::iota(selection.begin(), selection.end(), 0);
 
-                std::stable_sort(
-                    selection.begin(), selection.end(), [this, data, column](const std::size_t l, const std::size_t r) {
-                        auto lhs = data[l * this->columns.size() + column];
-                        auto rhs = data[r * this->columns.size() + column];
-                        return (lhs < rhs);
-                    });
+                kernels::sortRowsByKey(key, selection, false, true);
 
                 // Compute the number of elements we want to retain.
                 const auto cnt = static_cast<std::size_t>(static_cast<double>(r) * src.GetRowsCount());
@@ -265,8 +275,7 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
                     if (!selection.empty()) {
                         Log::DefaultLog.WriteWarn(_T("Selected range is ")
                                                   _T("within [%f, %f]."),
-                            data[selection.front() * this->columns.size() + column],
-                            data[selection.back() * this->columns.size() + column]);
+                            key[selection.front()], key[selection.back()]);
                     }
                     break;
 
@@ -277,8 +286,7 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
                     if (!selection.empty()) {
                         Log::DefaultLog.WriteWarn(_T("Selected range is ")
                                                   _T("within [%f, %f]."),
-                            data[selection.front() * this->columns.size() + column],
-                            data[selection.back() * this->columns.size() + column]);
+                            key[selection.front()], key[selection.back()]);
                     }
                 } break;
 
@@ -288,8 +296,7 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
                     if (!selection.empty()) {
                         Log::DefaultLog.WriteWarn(_T("Selected range is ")
                                                   _T("within [%f, %f]."),
-                            data[selection.front() * this->columns.size() + column],
-                            data[selection.back() * this->columns.size() + column]);
+                            key[selection.front()], key[selection.back()]);
                     }
                     break;
 
@@ -299,24 +306,18 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
                 }
             }
 
-            /* Copy the data. */
-            this->values.resize(selection.size() * this->columns.size());
-            auto d = this->values.data();
-            for (auto r : selection) {
-                std::copy(data + r * this->columns.size(), data + (r + 1) * this->columns.size(), d);
-                d += this->columns.size();
-            }
+            /* Copy the data or pass on the selection. */
+            this->applySelection(src, selection);
 
             /* Update the min/max range if requested. */
             if (this->paramUpdateRange.Param<BoolParam>()->Value()) {
-                const auto rows = this->values.size() / this->columns.size();
-
                 for (std::size_t c = 0; c < this->columns.size(); ++c) {
+                    const auto column = src.GetColumn(c);
                     auto minimum = (std::numeric_limits<float>::max)();
                     auto maximum = (std::numeric_limits<float>::min)();
 
-                    for (std::size_t r = 0; r < rows; ++r) {
-                        auto value = this->values[r * this->columns.size() + c];
+                    for (auto r : selection) {
+                        auto value = column.IsValid() ? column[r] : 0.0f;
                         if (value < minimum) {
                             minimum = value;
                         }
@@ -332,8 +333,15 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
 
         } else {
             // Copy everything.
-            this->values.resize(src.GetRowsCount() * this->columns.size());
-            std::copy(src.GetData(), src.GetData() + this->values.size(), this->values.begin());
+            if (this->isLateMaterialization()) {
+                std::vector<std::size_t> selection(src.GetRowsCount());
+                std::iota(selection.begin(), selection.end(), 0);
+                this->applySelection(src, selection);
+            } else {
+                this->isSelection = false;
+                this->values.resize(src.GetRowsCount() * this->columns.size());
+                std::copy(src.GetData(), src.GetData() + this->values.size(), this->values.begin());
+            }
         } /* end if (selector || isSort) */
 
         /* Persist the state of the data. */
@@ -346,6 +354,7 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
             this->paramOperator.ResetDirty();
             this->paramReference.ResetDirty();
             this->paramUpdateRange.ResetDirty();
+            this->paramLateMaterialization.ResetDirty();
         }
     } /* end if (selector || (this->inputHash != src->DataHash()) ... */
 
@@ -1,5 +1,6 @@
 #include "VolumeToTable.h"
 
+#include "mmcore/param/IntParam.h"
 #include "mmcore/utility/log/Log.h"
 
 using namespace megamol::datatools;
@@ -11,9 +12,12 @@ using namespace megamol;
 VolumeToTable::VolumeToTable()
         : Module()
         , slotTableOut("floattable", "Provides the data as table.")
-        , slotVolumeIn("particles", "Volume input call") {
+        , slotVolumeIn("particles", "Volume input call")
+        , slotLevelOfDetail("levelOfDetail", "The level of detail requested from sources providing multiple levels") {
 
     /* Register parameters. */
+    this->slotLevelOfDetail.SetParameter(new core::param::IntParam(0, 0));
+    this->MakeSlotAvailable(&this->slotLevelOfDetail);
 
     /* Register calls. */
     this->slotTableOut.SetCallback(table::TableDataCall::ClassName(), "GetData", &VolumeToTable::getTableData);
@@ -43,19 +47,34 @@ bool VolumeToTable::create() {
 
 bool VolumeToTable::assertVDC(geocalls::VolumetricDataCall* in, table::TableDataCall* tc) {
 
+    // Request the whole frame at the selected level; sources without levels
+    // of detail answer with the full resolution.
+    const auto level = static_cast<unsigned int>(this->slotLevelOfDetail.Param<core::param::IntParam>()->Value());
     in->SetFrameID(tc->GetFrameID(), true);
     do {
         if (!(*in)(geocalls::VolumetricDataCall::IDX_GET_EXTENTS))
             return false;
+        if (!geocalls::VolumetricDataCall::GetMetadata(*in))
+            return false;
+        geocalls::VolumetricDataCall::Region request;
+        request.Level = level;
+        for (int d = 0; d < 3; ++d) {
+            request.Size[d] =
+                geocalls::VolumetricDataCall::GetLevelResolution(in->GetMetadata()->Resolution[d], level);
+        }
+        in->SetRequestedRegion(request);
         if (!(*in)(geocalls::VolumetricDataCall::IDX_GET_DATA))
             return false;
     } while (in->FrameID() != tc->GetFrameID());
 
-    if (in->DataHash() != inHash || in->FrameID() != inFrameID) {
+    const auto region = in->GetRegion();
+
+    if (in->DataHash() != inHash || in->FrameID() != inFrameID || region.Level != inLevel) {
         auto meta = in->GetMetadata();
         auto res = meta->Resolution;
+        auto size = region.Size;
         auto cols = meta->Components;
-        num_voxels = res[0] * res[1] * res[2];
+        num_voxels = size[0] * size[1] * size[2];
 
         column_infos.clear();
 
@@ -77,21 +96,26 @@ bool VolumeToTable::assertVDC(geocalls::VolumetricDataCall* in, table::TableData
 
         everything.resize(num_voxels * column_infos.size());
 
-        for (auto x = 0; x < res[0]; ++x) {
-            for (auto y = 0; y < res[1]; ++y) {
-                for (auto z = 0; z < res[2]; ++z) {
-                    size_t lin_idx = (z * res[1] + y) * res[0] + x;
-                    everything[column_infos.size() * lin_idx + 0] = x;
-                    everything[column_infos.size() * lin_idx + 1] = y;
-                    everything[column_infos.size() * lin_idx + 2] = z;
+        // The coordinates in the table always refer to the full resolution.
+        for (auto z = 0; z < size[2]; ++z) {
+            for (auto y = 0; y < size[1]; ++y) {
+                for (auto x = 0; x < size[0]; ++x) {
+                    const auto rx = static_cast<uint32_t>(region.Offset[0] + x);
+                    const auto ry = static_cast<uint32_t>(region.Offset[1] + y);
+                    const auto rz = static_cast<uint32_t>(region.Offset[2] + z);
+                    size_t lin_idx = (z * size[1] + y) * size[0] + x;
+                    everything[column_infos.size() * lin_idx + 0] = static_cast<float>(rx << region.Level);
+                    everything[column_infos.size() * lin_idx + 1] = static_cast<float>(ry << region.Level);
+                    everything[column_infos.size() * lin_idx + 2] = static_cast<float>(rz << region.Level);
                     for (auto c = 0; c < cols; ++c) {
-                        everything[column_infos.size() * lin_idx + 3 + c] = in->GetAbsoluteVoxelValue(x, y, z, c);
+                        everything[column_infos.size() * lin_idx + 3 + c] = in->GetAbsoluteVoxelValue(rx, ry, rz, c);
                     }
                 }
             }
         }
         inHash = in->DataHash();
         inFrameID = in->FrameID();
+        inLevel = region.Level;
     }
     return true;
 }
@@ -3,6 +3,7 @@
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
+#include "mmcore/param/ParamSlot.h"
 
 #include "datatools/table/TableDataCall.h"
 #include "geometry_calls/VolumetricDataCall.h"
@@ -78,10 +79,14 @@ private:
     /** The data callee slot. */
     core::CallerSlot slotVolumeIn;
 
+    /** The level of detail requested from the volume. */
+    core::param::ParamSlot slotLevelOfDetail;
+
     std::vector<float> everything;
 
     SIZE_T inHash = SIZE_MAX;
     unsigned int inFrameID = std::numeric_limits<unsigned int>::max();
+    unsigned int inLevel = std::numeric_limits<unsigned int>::max();
     std::vector<table::TableDataCall::ColumnInfo> column_infos;
     std::size_t num_voxels = 0;
 };
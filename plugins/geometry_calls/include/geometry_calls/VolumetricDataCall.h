@@ -17,6 +17,13 @@ namespace megamol::geocalls {
 
 /**
  * Provides sampled volumetric data eg from the dat/raw library.
+ *
+ * By default, GetData() designates whole frames at full resolution. Callers
+ * may restrict the data to a region at a coarser level of detail using
+ * SetRequestedRegion() before invoking IDX_GET_DATA. Sources supporting this
+ * answer with the region they actually provide via SetRegion(); all other
+ * sources ignore the request and provide the whole frame, which is what
+ * GetRegion() reports in this case.
  */
 class VolumetricDataCall : public core::AbstractGetData3DCall {
 
@@ -30,6 +37,9 @@ public:
     /** Structure containing all required metadata about a data set. */
     typedef struct VolumetricMetadata_t Metadata;
 
+    /** Structure describing a box of grid points at a level of detail. */
+    typedef struct VolumetricRegion_t Region;
+
     /**
      * Answer the name of this module.
      *
@@ -77,6 +87,19 @@ public:
      */
     static bool GetMetadata(VolumetricDataCall& call);
 
+    /**
+     * Answer the resolution of a dimension at the given level of detail.
+     *
+     * @param resolution The full resolution of the dimension.
+     * @param level      The level of detail.
+     *
+     * @return The resolution at 'level', which is at least 1.
+     */
+    static inline size_t GetLevelResolution(const size_t resolution, const unsigned int level) {
+        const size_t scale = static_cast<size_t>(1) << level;
+        return (resolution > scale) ? (resolution + scale - 1) / scale : 1;
+    }
+
     /** Index of the function retrieving the data. */
     static const unsigned int IDX_GET_DATA;
 
@@ -237,6 +260,58 @@ public:
      */
     size_t GetVoxelsPerFrame() const;
 
+    /**
+     * Gets the number of levels of detail the source provides. Level 0 is
+     * always available.
+     *
+     * @return The number of levels of detail.
+     */
+    inline unsigned int GetLevels() const {
+        return this->levels;
+    }
+
+    /**
+     * Gets the region designated by GetData().
+     *
+     * If the source did not provide a region, this is the whole frame at
+     * level 0.
+     *
+     * @return The region of the data.
+     */
+    Region GetRegion() const;
+
+    /**
+     * Answer the hash of the data. If the source provided a region, the
+     * region is part of the hash, such that requesting a different region
+     * invalidates the data derived from the previous one.
+     *
+     * @return The hash of the data.
+     */
+    inline SIZE_T DataHash() const {
+        if (!this->hasRegion) {
+            return Base::DataHash();
+        }
+        SIZE_T hash = Base::DataHash();
+        auto combine = [&hash](const size_t value) {
+            hash ^= static_cast<SIZE_T>(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        };
+        for (int i = 0; i < 3; ++i) {
+            combine(this->region.Offset[i]);
+            combine(this->region.Size[i]);
+        }
+        combine(this->region.Level);
+        return hash;
+    }
+
+    /**
+     * Gets the region requested by the caller.
+     *
+     * @return The requested region or nullptr if whole frames are requested.
+     */
+    inline const Region* GetRequestedRegion() const {
+        return this->isRegionRequested ? &this->requestedRegion : nullptr;
+    }
+
     /**
      * Gets the size of a single data point in bytes.
      *
@@ -248,11 +323,17 @@ public:
 
     /**
      * Gets the voxel value relative to [min, max] from channel c.
+     *
+     * The coordinates refer to the level of GetRegion() and must be within
+     * that region.
      */
     const float GetRelativeVoxelValue(const uint32_t x, const uint32_t y, const uint32_t z, const uint32_t c = 0) const;
 
     /**
      * Gets the voxel value relative to [min, max] from channel c.
+     *
+     * The coordinates refer to the level of GetRegion() and must be within
+     * that region.
      */
     const float GetAbsoluteVoxelValue(const uint32_t x, const uint32_t y, const uint32_t z, const uint32_t c = 0) const;
 
@@ -291,6 +372,46 @@ public:
         this->vram_volume_name = texture_name;
     }
 
+    /**
+     * Sets the number of levels of detail the source provides.
+     *
+     * @param levels The number of levels, which must be at least 1.
+     */
+    inline void SetLevels(const unsigned int levels) {
+        this->levels = (levels > 0) ? levels : 1;
+    }
+
+    /**
+     * Sets the region designated by the data pointer. This is called by
+     * sources supporting region requests.
+     *
+     * @param region The region of the data.
+     */
+    inline void SetRegion(const Region& region) {
+        this->region = region;
+        this->hasRegion = true;
+    }
+
+    /**
+     * Requests only the given region at its level of detail from the
+     * source. This also resets the region provided previously.
+     *
+     * @param region The requested region.
+     */
+    inline void SetRequestedRegion(const Region& region) {
+        this->requestedRegion = region;
+        this->isRegionRequested = true;
+        this->hasRegion = false;
+    }
+
+    /**
+     * Requests whole frames at full resolution from the source again.
+     */
+    inline void ResetRequestedRegion() {
+        this->isRegionRequested = false;
+        this->hasRegion = false;
+    }
+
     /**
      * Update the metadata.
      *
@@ -312,6 +433,23 @@ private:
     /** The base class. */
     typedef AbstractGetData3DCall Base;
 
+    /**
+     * Answer the index of the first scalar of the given voxel in 'data',
+     * reading the provided region or the resolution directly, as this is
+     * called for every voxel.
+     */
+    inline uint64_t voxelIndex(const uint32_t x, const uint32_t y, const uint32_t z) const {
+        uint64_t idx;
+        if (this->hasRegion) {
+            const auto& r = this->region;
+            idx = ((z - r.Offset[2]) * r.Size[1] + (y - r.Offset[1])) * r.Size[0] + (x - r.Offset[0]);
+        } else {
+            const auto* res = this->metadata->Resolution;
+            idx = (static_cast<uint64_t>(z) * res[1] + y) * res[0] + x;
+        }
+        return idx * this->metadata->Components;
+    }
+
     /** The functions that are provided by the call. */
     static const char* FUNCTIONS[6];
 
@@ -323,6 +461,21 @@ private:
 
     /** Pointer to the metadata descriptor of the data set. */
     const Metadata* metadata;
+
+    /** The number of levels of detail the source provides. */
+    unsigned int levels;
+
+    /** The region designated by 'data' if 'hasRegion' is set. */
+    Region region;
+
+    /** Determines whether the source provided 'region'. */
+    bool hasRegion;
+
+    /** The region requested by the caller if 'isRegionRequested' is set. */
+    Region requestedRegion;
+
+    /** Determines whether the caller requested only 'requestedRegion'. */
+    bool isRegionRequested;
 };
 
 /** Call Descriptor.  */
@@ -133,4 +133,30 @@ struct VolumetricMetadata_t {
     enum MemoryLocation MemLoc;
 };
 
+/**
+ * Structure describing a box of grid points at a level of detail.
+ *
+ * Level 0 is the full resolution of the data set. The resolution of level l
+ * is the full resolution divided by 2^l in each dimension (rounded up), and
+ * offset and size are given in grid points of the respective level.
+ */
+struct VolumetricRegion_t {
+
+    /** Initialise a new instance. */
+    VolumetricRegion_t() {
+        ::memset(this->Offset, 0, sizeof(this->Offset));
+        ::memset(this->Size, 0, sizeof(this->Size));
+        Level = 0;
+    }
+
+    /** The first grid point of the region in each dimension. */
+    size_t Offset[3];
+
+    /** The number of grid points of the region in each dimension. */
+    size_t Size[3];
+
+    /** The level of detail. */
+    unsigned int Level;
+};
+
 } // namespace megamol::geocalls
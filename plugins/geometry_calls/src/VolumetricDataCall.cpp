@@ -113,7 +113,13 @@ const unsigned int VolumetricDataCall::IDX_TRY_GET_DATA = 5;
 /*
  * VolumetricDataCall::VolumetricDataCall
  */
-VolumetricDataCall::VolumetricDataCall() : data(nullptr), metadata(nullptr), vram_volume_name(0) {}
+VolumetricDataCall::VolumetricDataCall()
+        : data(nullptr)
+        , metadata(nullptr)
+        , vram_volume_name(0)
+        , levels(1)
+        , hasRegion(false)
+        , isRegionRequested(false) {}
 
 
 /*
@@ -122,7 +128,10 @@ VolumetricDataCall::VolumetricDataCall() : data(nullptr), metadata(nullptr), vra
 VolumetricDataCall::VolumetricDataCall(const VolumetricDataCall& rhs)
         : data(nullptr)
         , metadata(nullptr)
-        , vram_volume_name(0) {
+        , vram_volume_name(0)
+        , levels(1)
+        , hasRegion(false)
+        , isRegionRequested(false) {
     *this = rhs;
 }
 
@@ -157,6 +166,24 @@ VolumetricDataCall::GridType VolumetricDataCall::GetGridType() const {
 }
 
 
+/*
+ * VolumetricDataCall::GetRegion
+ */
+VolumetricDataCall::Region VolumetricDataCall::GetRegion() const {
+    if (this->hasRegion) {
+        return this->region;
+    }
+
+    Region retval;
+    if (this->metadata != nullptr) {
+        for (int i = 0; i < 3; ++i) {
+            retval.Size[i] = this->metadata->Resolution[i];
+        }
+    }
+    return retval;
+}
+
+
 /*
  * VolumetricDataCall::GetResolution
  */
@@ -221,8 +248,7 @@ const float VolumetricDataCall::GetRelativeVoxelValue(
         megamol::core::utility::log::Log::DefaultLog.WriteError("GetRelativeVoxelValue: unsupported grid!");
 
     } else {
-        uint64_t idx = (z * this->metadata->Resolution[1] + y) * this->metadata->Resolution[0] + x;
-        idx *= this->metadata->Components;
+        const uint64_t idx = this->voxelIndex(x, y, z);
         switch (this->metadata->ScalarType) {
         case UNKNOWN:
         case BITS:
@@ -265,10 +291,9 @@ const float VolumetricDataCall::GetAbsoluteVoxelValue(
         megamol::core::utility::log::Log::DefaultLog.WriteError("GetAbsoluteVoxelValue: unsupported grid!");
 
     } else {
-        uint64_t idx =
-            z * this->metadata->Resolution[0] * this->metadata->Resolution[1] + y * this->metadata->Resolution[0] + x;
-        idx *= this->metadata->Components;
-        assert(idx < metadata->Resolution[0] * metadata->Resolution[1] * metadata->Resolution[2]);
+        const uint64_t idx = this->voxelIndex(x, y, z);
+        assert(idx < this->GetRegion().Size[0] * this->GetRegion().Size[1] * this->GetRegion().Size[2] *
+                         this->metadata->Components);
         switch (this->metadata->ScalarType) {
         case UNKNOWN:
         case BITS:
@@ -322,6 +347,11 @@ VolumetricDataCall& VolumetricDataCall::operator=(const VolumetricDataCall& rhs)
         Base::operator=(rhs);
         this->data = rhs.data;
         this->metadata = rhs.metadata;
+        this->levels = rhs.levels;
+        this->region = rhs.region;
+        this->hasRegion = rhs.hasRegion;
+        this->requestedRegion = rhs.requestedRegion;
+        this->isRegionRequested = rhs.isRegionRequested;
     }
     return *this;
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <deque>
@@ -75,6 +76,15 @@ public:
 
     Job submit(Job::Func func);
 
+    /**
+     * Calls func(begin, end) for consecutive ranges covering [0, count) and returns when all calls have finished.
+     *
+     * Ranges not yet picked up by a worker are processed on the calling thread, which therefore may itself be a
+     * worker of this pool.
+     */
+    template<typename Func>
+    void forEachBlock(std::size_t count, std::size_t minBlockSize, Func func);
+
     void setThreadCount(std::size_t count);
     std::size_t getThreadCount() const;
 
@@ -95,4 +105,24 @@ private:
     std::atomic_bool running = ATOMIC_VAR_INIT(false);
 };
 
+template<typename Func>
+void WorkerThreadPool::forEachBlock(std::size_t count, std::size_t minBlockSize, Func func) {
+    const std::size_t targetBlocks = std::max<std::size_t>(1, getThreadCount() * 4);
+    const std::size_t blockSize = std::max<std::size_t>(
+        std::max<std::size_t>(minBlockSize, 1), (count + targetBlocks - 1) / targetBlocks);
+
+    std::vector<Job> jobs;
+    for (std::size_t begin = blockSize; begin < count; begin += blockSize) {
+        const std::size_t end = std::min(begin + blockSize, count);
+        jobs.push_back(submit([&func, begin, end]() { func(begin, end); }));
+    }
+
+    func(0, std::min(blockSize, count));
+
+    for (auto& job : jobs) {
+        // Either runs the job here, waits for the worker executing it, or finds it already done
+        job.execute();
+    }
+}
+
 } // namespace megamol::ImageSeries::util
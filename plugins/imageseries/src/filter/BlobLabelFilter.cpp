@@ -6,10 +6,14 @@
 
 #include "BlobLabelFilter.h"
 
+#include "../util/ConnectedComponents.h"
+
 #include "vislib/graphics/BitmapImage.h"
 
-#include <deque>
+#include <algorithm>
+#include <array>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -52,10 +56,11 @@ BlobLabelFilter::ImagePtr BlobLabelFilter::operator()() {
 
     util::PerfTimer timer("BlobLabelFilter", input.image->getMetadata().filename);
 
-    using Index = std::uint32_t;
+    using Index = util::ConnectedComponents::Index;
 
     const auto* dataIn = image->PeekDataAs<std::uint8_t>();
     auto* dataOut = result->PeekDataAs<std::uint8_t>();
+    const auto* maskIn = mask ? mask->PeekDataAs<std::uint8_t>() : nullptr;
     const auto* prevIn = prev ? prev->PeekDataAs<std::uint8_t>() : nullptr;
     const auto* diffIn = diff ? diff->PeekDataAs<std::uint8_t>() : prevIn;
     Index width = result->Width();
@@ -63,173 +68,187 @@ BlobLabelFilter::ImagePtr BlobLabelFilter::operator()() {
     Index size = width * height;
     std::int32_t threshold = input.threshold * 255;
 
-    // Apply mask, if available
-    if (mask && input.maskPriority) {
-        // Mask has priority: override pixels unconditionally
-        const auto* maskIn = mask->PeekDataAs<std::uint8_t>();
-
-        // TODO separate mask threshold/negation option?
-        for (Index i = 0; i < size; ++i) {
-            dataOut[i] = (maskIn[i] < threshold) != input.negateMask ? LabelMask : LabelBackground;
-        }
-    }
-
-    Label nextLabel = LabelFirst;
-    Label labelLimit = LabelFirst + input.blobCountLimit - 1;
-
-    std::vector<Index> pendingPixels;
-    std::vector<Index> pendingFlow;
-    std::deque<Index> queue;
-
-    // Reserve enough space to perform first pass
-    pendingPixels.reserve(input.minBlobSize + 4);
+    // TODO separate mask threshold/negation option?
+    auto testMask = [&](Index index) { return maskIn && (maskIn[index] < threshold) != input.negateMask; };
 
+    // Mask has priority: masked pixels are never labeled
     auto testPixel = [&](Index index) {
-        return dataOut[index] == LabelBackground && (dataIn[index] < threshold) != input.negateThreshold;
+        return !(input.maskPriority && testMask(index)) && (dataIn[index] < threshold) != input.negateThreshold;
     };
 
     auto testPrev = [&](Index index) { return prevIn && (prevIn[index] < threshold) != input.negateThreshold; };
     auto testDiff = [&](Index index) { return diffIn && (diffIn[index] < threshold) != input.negateThreshold; };
 
-    auto markMinimal = [&](Index index) {
-        if (testPixel(index)) {
-            if (testDiff(index)) {
-                pendingFlow.push_back(index);
-            } else {
-                dataOut[index] = LabelMinimal;
-                pendingPixels.push_back(index);
-            }
-        }
-    };
-
-    auto fillMinimal = [&](Index startIndex) {
-        pendingPixels.clear();
-        pendingFlow.clear();
-        markMinimal(startIndex);
-        Index queueIndex = 0;
+    // Blobs consist of connected pixels that are active in the current, but not in the predecessor frame.
+    // Adjacent pixels that are active in both frames form the flow interface.
+    auto testBlob = [&](Index index) { return testPixel(index) && !testPrev(index); };
+    auto testFlow = [&](Index index) { return testPixel(index) && testPrev(index); };
 
-        // Try to collect at least MinBlobSize connected pixels
-        while (queueIndex < pendingPixels.size()) {
-            Index index = pendingPixels[queueIndex++];
+    util::ConnectedComponents components(
+        width, height, testBlob, [](Index, Index) { return true; }, false);
 
-            // Pixel is not on the right boundary
-            if (index % width < width - 1) {
-                markMinimal(index + 1);
-            }
-            // Pixel is not on the left boundary
-            if (index % width > 0) {
-                markMinimal(index - 1);
-            }
-            // Pixel is not on the bottom boundary
-            if (index < size - width) {
-                markMinimal(index + width);
-            }
-            // Pixel is not on the top boundary
-            if (index >= width) {
-                markMinimal(index - width);
-            }
+    const Index componentCount = components.getComponentCount();
 
-            // Pixel threshold met
-            if ((pendingPixels.size() + pendingFlow.size()) >= input.minBlobSize) {
-                return true;
-            }
+    auto forEachNeighbor = [&](Index index, auto func) {
+        const Index x = index % width;
+        if (x < width - 1) {
+            func(index + 1);
         }
+        if (x > 0) {
+            func(index - 1);
+        }
+        if (index < size - width) {
+            func(index + width);
+        }
+        if (index >= width) {
+            func(index - width);
+        }
+    };
 
-        // Not enough pixels
-        return false;
+    // Collects the distinct blobs adjacent to a flow pixel in ascending order, counting adjacent pixels per blob
+    struct FlowNeighbors {
+        std::array<Index, 4> blobs;
+        std::array<Index, 4> pixelCounts;
+        int count = 0;
     };
 
-    auto mark = [&](Index index) {
-        if (testPixel(index)) {
-            if (testPrev(index)) {
-                dataOut[index] = LabelFlow;
-            } else {
-                dataOut[index] = nextLabel;
-                queue.push_back(index);
+    auto getFlowNeighbors = [&](Index index) {
+        FlowNeighbors neighbors;
+        forEachNeighbor(index, [&](Index neighbor) {
+            const Index blob = components[neighbor];
+            if (blob != util::ConnectedComponents::None) {
+                int i = 0;
+                while (i < neighbors.count && neighbors.blobs[i] < blob) {
+                    ++i;
+                }
+                if (i < neighbors.count && neighbors.blobs[i] == blob) {
+                    ++neighbors.pixelCounts[i];
+                } else {
+                    std::copy_backward(neighbors.blobs.begin() + i, neighbors.blobs.begin() + neighbors.count,
+                        neighbors.blobs.begin() + neighbors.count + 1);
+                    std::copy_backward(neighbors.pixelCounts.begin() + i,
+                        neighbors.pixelCounts.begin() + neighbors.count,
+                        neighbors.pixelCounts.begin() + neighbors.count + 1);
+                    neighbors.blobs[i] = blob;
+                    neighbors.pixelCounts[i] = 1;
+                    ++neighbors.count;
+                }
             }
-        }
+        });
+        return neighbors;
     };
 
-    auto fill = [&](Index startIndex) {
-        // Perform minimal first pass, checking if the blob is large enough
-        if (!fillMinimal(startIndex)) {
-            // Small blob: avoid assigning unique label ID
-            return;
-        }
-
-        queue.clear();
-
-        // Large blob: fill out all pixels with proper label ID
-        for (auto& index : pendingPixels) {
-            dataOut[index] = nextLabel;
-            queue.push_back(index);
-        }
+    // The size of a blob includes each flow pixel (set in the diff image) once per adjacent blob pixel. Like a flood
+    // fill in row-major order, blobs claim their flow pixels, which then no longer count towards blobs found later.
+    // Since the vast majority of flow pixels is adjacent to a single blob, contributions are split into those
+    // independent of any other blob and those depending on preceding blobs being small.
+    struct ConditionalContribution {
+        FlowNeighbors neighbors;
+        int position;
+    };
 
-        for (auto& index : pendingFlow) {
-            dataOut[index] = LabelFlow;
-        }
+    std::vector<std::vector<std::pair<Index, Index>>> blockContributions;
+    std::vector<std::vector<ConditionalContribution>> blockConditionals;
+    std::mutex contributionsMutex;
 
-        // Perform proper flood fill
-        while (!queue.empty()) {
-            auto index = queue.front();
-            queue.pop_front();
+    util::WorkerThreadPool::getSharedInstance().forEachBlock(size, 4096, [&](std::size_t begin, std::size_t end) {
+        std::vector<std::pair<Index, Index>> contributions;
+        std::vector<ConditionalContribution> conditionals;
 
-            // Pixel is not on the right boundary
-            if (index % width < width - 1) {
-                mark(index + 1);
-            }
-            // Pixel is not on the left boundary
-            if (index % width > 0) {
-                mark(index - 1);
+        for (Index index = begin; index < end; ++index) {
+            if (!testFlow(index) || !testDiff(index)) {
+                continue;
             }
-            // Pixel is not on the bottom boundary
-            if (index < size - width) {
-                mark(index + width);
+
+            auto neighbors = getFlowNeighbors(index);
+            if (neighbors.count > 0) {
+                contributions.emplace_back(neighbors.blobs[0], neighbors.pixelCounts[0]);
             }
-            // Pixel is not on the top boundary
-            if (index >= width) {
-                mark(index - width);
+            for (int i = 1; i < neighbors.count; ++i) {
+                conditionals.push_back(ConditionalContribution{neighbors, i});
             }
         }
 
-        // Check if label limit has been reached
-        if (nextLabel == labelLimit) {
-            // TODO clear smallest blob
-            return;
+        std::lock_guard<std::mutex> lock(contributionsMutex);
+        blockContributions.push_back(std::move(contributions));
+        blockConditionals.push_back(std::move(conditionals));
+    });
+
+    std::vector<Index> blobSizes = components.getSizes();
+    for (const auto& contributions : blockContributions) {
+        for (const auto& contribution : contributions) {
+            blobSizes[contribution.first] += contribution.second;
         }
+    }
 
-        // Increment label index
-        nextLabel++;
-    };
+    std::vector<ConditionalContribution> conditionals;
+    for (auto& blockConditional : blockConditionals) {
+        conditionals.insert(conditionals.end(), blockConditional.begin(), blockConditional.end());
+    }
+    std::sort(conditionals.begin(), conditionals.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.neighbors.blobs[lhs.position] < rhs.neighbors.blobs[rhs.position];
+    });
 
-    // Perform flood fill
-    for (Index i = 0; i < size; ++i) {
-        // Found a possible seed point: start flood filling!
-        if (testPixel(i) && !testPrev(i)) {
-            fill(i);
+    // Assign labels to large blobs in the order in which they have been found
+    Label nextLabel = LabelFirst;
+    Label labelLimit = LabelFirst + input.blobCountLimit - 1;
+
+    std::vector<Label> blobLabels(componentCount, LabelMinimal);
+    std::vector<std::uint8_t> blobLarge(componentCount, 0);
+    auto conditional = conditionals.begin();
+
+    for (Index blob = 0; blob < componentCount; ++blob) {
+        for (; conditional != conditionals.end() && conditional->neighbors.blobs[conditional->position] == blob;
+             ++conditional) {
+            const auto& blobs = conditional->neighbors.blobs;
+            if (std::all_of(blobs.begin(), blobs.begin() + conditional->position,
+                    [&](Index preceding) { return !blobLarge[preceding]; })) {
+                blobSizes[blob] += conditional->neighbors.pixelCounts[conditional->position];
+            }
         }
-    }
 
-    // Mask does not have priority: override pixels only if they haven't been otherwise colored yet
-    if (mask && !input.maskPriority) {
-        const auto* maskIn = mask->PeekDataAs<std::uint8_t>();
+        if (blobSizes[blob] >= input.minBlobSize) {
+            blobLabels[blob] = nextLabel;
+            blobLarge[blob] = 1;
 
-        // TODO separate mask threshold/negation option?
-        for (Index i = 0; i < size; ++i) {
-            if (dataOut[i] == LabelBackground && (maskIn[i] < threshold) != input.negateMask) {
-                dataOut[i] = LabelMask;
+            // Check if label limit has been reached
+            // TODO clear smallest blob
+            if (nextLabel != labelLimit) {
+                nextLabel++;
             }
         }
     }
 
-    // Mark pixels from previous frames
-    if (input.markPrevious && prev) {
-        for (Index i = 0; i < size; ++i) {
-            if (testPixel(i) && testPrev(i)) {
-                dataOut[i] = LabelMinimal;
+    // Write labels, flow interfaces of large blobs, mask and pixels from previous frames
+    util::WorkerThreadPool::getSharedInstance().forEachBlock(size, 4096, [&](std::size_t begin, std::size_t end) {
+        for (Index index = begin; index < end; ++index) {
+            const Index blob = components[index];
+            Label label = LabelBackground;
+
+            if (blob != util::ConnectedComponents::None) {
+                label = blobLabels[blob];
+            } else if (testFlow(index)) {
+                forEachNeighbor(index, [&](Index neighbor) {
+                    const Index neighborBlob = components[neighbor];
+                    if (neighborBlob != util::ConnectedComponents::None && blobLarge[neighborBlob]) {
+                        label = LabelFlow;
+                    }
+                });
             }
+
+            // Mask does not have priority: override pixels only if they haven't been otherwise colored yet
+            if (label == LabelBackground && testMask(index)) {
+                label = LabelMask;
+            }
+
+            // Mark pixels from previous frames
+            if (label == LabelBackground && input.markPrevious && testFlow(index)) {
+                label = LabelMinimal;
+            }
+
+            dataOut[index] = label;
         }
-    }
+    });
 
     return std::const_pointer_cast<const Image>(result);
 }
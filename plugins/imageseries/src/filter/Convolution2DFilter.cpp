@@ -6,76 +6,146 @@
 
 #include "Convolution2DFilter.h"
 
+#include "imageseries/util/WorkerThreadPool.h"
+
 #include "vislib/graphics/BitmapImage.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace megamol::ImageSeries::filter {
 
-Convolution2DFilter::Convolution2DFilter(Input input) : input(std::move(input)) {}
-
-Convolution2DFilter::ImagePtr Convolution2DFilter::operator()() {
-    using Image = AsyncImageData2D<>::BitmapImage;
+namespace {
 
-    // Wait for image data to be ready
-    auto image = input.image ? input.image->getImageData() : nullptr;
-
-    // Empty or too small -> return nothing
-    if (!image || image->Width() < 1 || image->Height() < 1) {
-        return nullptr;
+template<typename T>
+T convertPixel(float value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return value;
+    } else {
+        return static_cast<T>(std::clamp<float>(value, 0, std::numeric_limits<T>::max()));
     }
+}
 
-    // TODO: add compatibility with non-byte images
-    if (image->GetChannelCount() != 1 || image->GetChannelType() != Image::ChannelType::CHANNELTYPE_BYTE) {
-        return nullptr;
-    }
+/**
+ * Separable convolution of an image with interleaved channels, replicating the border pixels.
+ *
+ * Borders are resolved once per row (by padding) or once per output row (by clamping the row index), so that the
+ * inner loops run over contiguous memory without any index computations and can be vectorized by the compiler.
+ */
+template<typename T>
+void convolve(const T* dataIn, T* dataOut, std::size_t width, std::size_t height, std::size_t channels,
+    const std::vector<float>& kernelX, const std::vector<float>& kernelY) {
+    const std::size_t rowSize = width * channels;
+    const std::int64_t kernelWidth = kernelX.size();
+    const std::int64_t kernelHeight = kernelY.size();
+    const std::int64_t kernelXOff = kernelWidth / 2;
+    const std::int64_t kernelYOff = kernelHeight / 2;
 
-    // Create output image
-    auto result = std::make_shared<Image>(image->Width(), image->Height(), 1, Image::ChannelType::CHANNELTYPE_BYTE);
+    // Pixels needed left of the first and right of the last pixel of a row
+    const std::size_t padLeft = kernelWidth - 1 - kernelXOff;
+    const std::size_t padRight = kernelXOff;
 
-    const auto* dataIn = image->PeekDataAs<std::uint8_t>();
-    auto* dataOut = result->PeekDataAs<std::uint8_t>();
-    std::size_t width = result->Width();
-    std::size_t height = result->Height();
+    // Intermediate storage
+    std::vector<float> intermediate(rowSize * height);
 
-    // Create intermediate storage
-    std::vector<float> intermediate(width * height);
+    auto& pool = util::WorkerThreadPool::getSharedInstance();
 
-    auto clamp = [](int low, int value, int up) { return std::min(std::max(value, low), up); };
-    auto getIndex = [=](std::size_t x, std::size_t y) { return x + y * width; };
+    // Convolve along X-axis
+    pool.forEachBlock(height, 8, [&](std::size_t yBegin, std::size_t yEnd) {
+        std::vector<float> padded((padLeft + width + padRight) * channels);
 
-    int kernelWidth = input.kernelX.size();
-    int kernelXOff = kernelWidth / 2;
+        for (std::size_t y = yBegin; y < yEnd; ++y) {
+            const T* rowIn = dataIn + y * rowSize;
+            float* rowOut = intermediate.data() + y * rowSize;
 
-    // Convolve along X-axis
-    for (std::size_t y = 0; y < height; y++) {
-        for (std::size_t x = 0; x < width; x++) {
-            float value = 0;
-            std::size_t yi = clamp(0, y, height - 1);
-            for (int i = 0; i < kernelWidth; ++i) {
-                value += input.kernelX[i] * dataIn[getIndex(clamp(0, int(x) + kernelXOff - i, width - 1), yi)];
+            for (std::size_t x = 0; x < padLeft; ++x) {
+                std::copy(rowIn, rowIn + channels, padded.begin() + x * channels);
+            }
+            std::copy(rowIn, rowIn + rowSize, padded.begin() + padLeft * channels);
+            for (std::size_t x = 0; x < padRight; ++x) {
+                std::copy(rowIn + rowSize - channels, rowIn + rowSize,
+                    padded.begin() + (padLeft + width + x) * channels);
             }
-            intermediate[getIndex(x, y)] = value;
-        }
-    }
 
-    int kernelHeight = input.kernelY.size();
-    int kernelYOff = kernelHeight / 2;
+            std::fill(rowOut, rowOut + rowSize, 0.f);
+            for (std::int64_t i = 0; i < kernelWidth; ++i) {
+                const float weight = kernelX[i];
+                const float* src = padded.data() + (kernelWidth - 1 - i) * channels;
+                for (std::size_t j = 0; j < rowSize; ++j) {
+                    rowOut[j] += weight * src[j];
+                }
+            }
+        }
+    });
 
     // Convolve along Y-axis
-    for (std::size_t y = 0; y < height; y++) {
-        for (std::size_t x = 0; x < width; x++) {
-            float value = 0;
-            std::size_t xi = clamp(0, x, width - 1);
-            for (int i = 0; i < kernelHeight; ++i) {
-                value += input.kernelY[i] * intermediate[getIndex(xi, clamp(0, int(y) + kernelYOff - i, height - 1))];
+    pool.forEachBlock(height, 8, [&](std::size_t yBegin, std::size_t yEnd) {
+        std::vector<float> sum(rowSize);
+
+        for (std::size_t y = yBegin; y < yEnd; ++y) {
+            std::fill(sum.begin(), sum.end(), 0.f);
+            for (std::int64_t i = 0; i < kernelHeight; ++i) {
+                const float weight = kernelY[i];
+                const std::int64_t yi = std::clamp<std::int64_t>(y + kernelYOff - i, 0, height - 1);
+                const float* src = intermediate.data() + yi * rowSize;
+                for (std::size_t j = 0; j < rowSize; ++j) {
+                    sum[j] += weight * src[j];
+                }
+            }
+
+            T* rowOut = dataOut + y * rowSize;
+            for (std::size_t j = 0; j < rowSize; ++j) {
+                rowOut[j] = convertPixel<T>(sum[j]);
             }
-            dataOut[getIndex(x, y)] = clamp(0, value, 255);
         }
+    });
+}
+
+} // namespace
+
+Convolution2DFilter::Convolution2DFilter(Input input) : input(std::move(input)) {}
+
+Convolution2DFilter::ImagePtr Convolution2DFilter::operator()() {
+    using Image = AsyncImageData2D<>::BitmapImage;
+
+    // Wait for image data to be ready
+    auto image = input.image ? input.image->getImageData() : nullptr;
+
+    // Empty, too small or invalid kernel -> return nothing
+    if (!image || image->Width() < 1 || image->Height() < 1 || image->GetChannelCount() < 1 ||
+        input.kernelX.empty() || input.kernelY.empty()) {
+        return nullptr;
+    }
+
+    // Create output image of the same format
+    auto result = std::make_shared<Image>(
+        image->Width(), image->Height(), image->GetChannelCount(), image->GetChannelType());
+
+    std::size_t width = result->Width();
+    std::size_t height = result->Height();
+    std::size_t channels = result->GetChannelCount();
+
+    switch (image->GetChannelType()) {
+    case Image::ChannelType::CHANNELTYPE_BYTE:
+        convolve(image->PeekDataAs<std::uint8_t>(), result->PeekDataAs<std::uint8_t>(), width, height, channels,
+            input.kernelX, input.kernelY);
+        break;
+    case Image::ChannelType::CHANNELTYPE_WORD:
+        convolve(image->PeekDataAs<std::uint16_t>(), result->PeekDataAs<std::uint16_t>(), width, height, channels,
+            input.kernelX, input.kernelY);
+        break;
+    case Image::ChannelType::CHANNELTYPE_FLOAT:
+        convolve(image->PeekDataAs<float>(), result->PeekDataAs<float>(), width, height, channels, input.kernelX,
+            input.kernelY);
+        break;
+    default:
+        return nullptr;
     }
 
     return std::const_pointer_cast<const Image>(result);
@@ -13,6 +13,12 @@
 
 namespace megamol::ImageSeries::filter {
 
+/**
+ * Separable 2D convolution of byte, word or float images with an arbitrary number of channels.
+ *
+ * Blocks of rows are processed in parallel on the shared worker thread pool. Pixels outside of the image are
+ * replaced by the nearest border pixel.
+ */
 class Convolution2DFilter {
 public:
     using AsyncImagePtr = std::shared_ptr<const AsyncImageData2D<>>;
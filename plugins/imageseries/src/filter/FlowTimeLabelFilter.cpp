@@ -6,6 +6,7 @@
 
 #include "FlowTimeLabelFilter.h"
 
+#include "../util/ConnectedComponents.h"
 #include "../util/GraphGDFExporter.h"
 #include "../util/GraphLuaExporter.h"
 
@@ -25,9 +26,7 @@
 #include <iterator>
 #include <limits>
 #include <list>
-#include <map>
 #include <memory>
-#include <queue>
 #include <set>
 #include <sstream>
 #include <string>
@@ -96,121 +95,121 @@ std::shared_ptr<FlowTimeLabelFilter::Output> FlowTimeLabelFilter::operator()() {
         }
     }
 
-    // Calculate global velocity distribution as a measure of pixels added per frame
-    std::map<Timestamp, double> pixelsPerFrame;
-
-    for (Index index = 0; index < size; ++index) {
-        if (dataIn[index] != 0 && dataIn[index] != std::numeric_limits<Timestamp>::max()) {
-            if (pixelsPerFrame.find(dataIn[index]) == pixelsPerFrame.end()) {
-                pixelsPerFrame[dataIn[index]] = 0.0;
-            }
-
-            pixelsPerFrame.at(dataIn[index]) += 1.0;
-        }
-    }
-
     // Assign unique labels to connected areas of same time
     auto nodeGraph = std::make_shared<graph::GraphData2D>();
-    std::map<Timestamp, std::vector<graph::GraphData2D::NodeID>> nodesByTime;
 
-    for (Index index = 0; index < size; ++index) {
-        if (dataIn[index] == 0) {
-            dataOut[index] = LabelSolid;
-        } else if (dataIn[index] == std::numeric_limits<Timestamp>::max()) {
-            dataOut[index] = LabelEmpty;
-        } else {
-            dataOut[index] = LabelUnassigned;
-        }
-    }
-
-    auto floodFill = [&](const Index index, const Label label) {
-        std::queue<Index> floodQueue;
-        floodQueue.push(index);
-
-        graph::GraphData2D::Node current_region(dataIn[index], label);
-        current_region.pixels.push_back(index);
+    auto isFlow = [dataIn](Index index) {
+        return dataIn[index] != 0 && dataIn[index] != std::numeric_limits<Timestamp>::max();
+    };
 
-        dataOut[index] = label;
+    util::ConnectedComponents components(
+        width, height, isFlow, [dataIn](Index lhs, Index rhs) { return dataIn[lhs] == dataIn[rhs]; }, true);
 
-        while (!floodQueue.empty()) {
-            const auto currentIndex = floodQueue.front();
-            floodQueue.pop();
+    // Labels are assigned in the order in which a flood fill in row-major order would find the areas
+    const Index areaCount = components.getComponentCount();
 
-            const auto x = currentIndex % width;
-            const auto y = currentIndex / width;
+    if (areaCount >= LabelMaximum) {
+        core::utility::log::Log::DefaultLog.WriteError(
+            "[FlowTimeLabelFilter]: Too many labels! Consider denoising the input images.");
 
-            for (auto j = ((y > 0) ? -1 : 0); j <= ((y < height - 1) ? 1 : 0); ++j) {
-                for (auto i = ((x > 0) ? -1 : 0); i <= ((x < width - 1) ? 1 : 0); ++i) {
-                    const auto neighborIndex = (y + j) * width + (x + i);
+        // return black image and empty graph
+        auto output = std::make_shared<Output>();
+        output->image =
+            std::make_shared<Image>(image->Width(), image->Height(), 1, Image::ChannelType::CHANNELTYPE_WORD);
+        output->graph = std::make_shared<graph::GraphData2D>();
+        return output;
+    }
 
-                    if (dataOut[neighborIndex] == LabelUnassigned && dataIn[index] == dataIn[neighborIndex]) {
-                        floodQueue.push(neighborIndex);
-                        dataOut[neighborIndex] = label;
+    Label next_label = static_cast<Label>(LabelMinimum + areaCount);
 
-                        current_region.pixels.push_back(neighborIndex);
-                    } else if (dataOut[neighborIndex] == LabelSolid) {
-                        // Add current fluid index to interfaces, indicating a fluid-solid interface
-                        current_region.interfaces[LabelSolid].insert(currentIndex);
+    util::WorkerThreadPool::getSharedInstance().forEachBlock(size, 4096, [&](std::size_t begin, std::size_t end) {
+        for (Index index = begin; index < end; ++index) {
+            if (dataIn[index] == 0) {
+                dataOut[index] = LabelSolid;
+            } else if (dataIn[index] == std::numeric_limits<Timestamp>::max()) {
+                dataOut[index] = LabelEmpty;
+            } else {
+                dataOut[index] = static_cast<Label>(LabelMinimum + components[index]);
+            }
+        }
+    });
+
+    // Compute interfaces to neighboring areas
+    auto areaPixels = components.collectPixels();
+    std::vector<graph::GraphData2D::Node> areas;
+    areas.reserve(areaCount);
+    for (Index area = 0; area < areaCount; ++area) {
+        areas.emplace_back(dataIn[areaPixels[area].front()], static_cast<Label>(LabelMinimum + area));
+        areas.back().pixels = std::move(areaPixels[area]);
+    }
 
-                        if (interface_output == interface_t::full) {
-                            interfaceSolidOut[currentIndex] = interfaceOut[currentIndex] = 0;
-                        }
-                    } else if (dataIn[index] > dataIn[neighborIndex]) {
-                        // Add neighboring fluid index to interfaces, indicating a past fluid-fluid interface
-                        current_region.interfaces[dataIn[neighborIndex]].insert(neighborIndex);
-                    } else if (dataIn[index] < dataIn[neighborIndex]) {
-                        // Add current fluid index to interfaces, indicating a current fluid-fluid interface
-                        current_region.interfaces[dataIn[neighborIndex]].insert(neighborIndex);
-
-                        if (interface_output == interface_t::full) {
-                            interfaceFluidOut[neighborIndex] = interfaceOut[currentIndex] =
-                                current_region.getFrameIndex();
-                        }
-                    }
+    // Interface images are written by multiple areas, which is only deterministic in sequential order
+    const std::size_t minAreasPerJob = interface_output == interface_t::none ? 1 : areaCount;
+
+    util::WorkerThreadPool::getSharedInstance().forEachBlock(
+        areaCount, minAreasPerJob, [&](std::size_t begin, std::size_t end) {
+            for (Index area = begin; area < end; ++area) {
+                auto& current_region = areas[area];
+                const Timestamp time = current_region.getFrameIndex();
+
+                for (const auto currentIndex : current_region.pixels) {
+                    const auto x = currentIndex % width;
+                    const auto y = currentIndex / width;
+
+                    for (auto j = ((y > 0) ? -1 : 0); j <= ((y < height - 1) ? 1 : 0); ++j) {
+                        for (auto i = ((x > 0) ? -1 : 0); i <= ((x < width - 1) ? 1 : 0); ++i) {
+                            const auto neighborIndex = (y + j) * width + (x + i);
+
+                            if (dataOut[neighborIndex] == LabelSolid) {
+                                // Add current fluid index to interfaces, indicating a fluid-solid interface
+                                current_region.interfaces[LabelSolid].insert(currentIndex);
+
+                                if (interface_output == interface_t::full) {
+                                    interfaceSolidOut[currentIndex] = interfaceOut[currentIndex] = 0;
+                                }
+                            } else if (time > dataIn[neighborIndex]) {
+                                // Add neighboring fluid index to interfaces, indicating a past fluid-fluid interface
+                                current_region.interfaces[dataIn[neighborIndex]].insert(neighborIndex);
+                            } else if (time < dataIn[neighborIndex]) {
+                                // Add current fluid index to interfaces, indicating a current fluid-fluid interface
+                                current_region.interfaces[dataIn[neighborIndex]].insert(neighborIndex);
+
+                                if (interface_output == interface_t::full) {
+                                    interfaceFluidOut[neighborIndex] = interfaceOut[currentIndex] =
+                                        current_region.getFrameIndex();
+                                }
+                            }
 
-                    if (interface_output != interface_t::none) {
-                        const auto targetInterface = static_cast<Timestamp>(interface_output);
-                        if (dataIn[index] <= targetInterface && dataIn[neighborIndex] > targetInterface) {
-                            interfaceFluidOut[neighborIndex] = interfaceOut[currentIndex] = 0;
-                        }
-                        if (dataIn[index] <= targetInterface && dataIn[neighborIndex] == LabelSolid) {
-                            interfaceSolidOut[neighborIndex] = interfaceOut[currentIndex] = 0;
+                            if (interface_output != interface_t::none) {
+                                const auto targetInterface = static_cast<Timestamp>(interface_output);
+                                if (time <= targetInterface && dataIn[neighborIndex] > targetInterface) {
+                                    interfaceFluidOut[neighborIndex] = interfaceOut[currentIndex] = 0;
+                                }
+                                if (time <= targetInterface && dataIn[neighborIndex] == LabelSolid) {
+                                    interfaceSolidOut[neighborIndex] = interfaceOut[currentIndex] = 0;
+                                }
+                            }
                         }
                     }
                 }
-            }
-        }
 
-        current_region.interfaceSolid = current_region.interfaces[LabelSolid].size();
-        current_region.interfaceFluid = 0.0f;
+                current_region.interfaceSolid = current_region.interfaces[LabelSolid].size();
+                current_region.interfaceFluid = 0.0f;
 
-        for (const auto& fluid_interface : current_region.interfaces) {
-            if (fluid_interface.first != LabelSolid) {
-                current_region.interfaceFluid += fluid_interface.second.size();
+                for (const auto& fluid_interface : current_region.interfaces) {
+                    if (fluid_interface.first != LabelSolid) {
+                        current_region.interfaceFluid += fluid_interface.second.size();
+                    }
+                }
             }
-        }
-
-        nodesByTime[current_region.getFrameIndex()].push_back(nodeGraph->addNode(current_region));
-    };
-
-    Label next_label = LabelMinimum;
+        });
 
-    for (Index index = 0; index < size; ++index) {
-        if (dataOut[index] == LabelUnassigned && next_label <= LabelMaximum) {
-            floodFill(index, next_label++);
-        }
-    }
+    // Add nodes in the order of their labels, grouped by time
+    std::vector<std::vector<graph::GraphData2D::NodeID>> nodesByTime(std::numeric_limits<Timestamp>::max() + 1);
 
-    if (next_label > LabelMaximum) {
-        core::utility::log::Log::DefaultLog.WriteError(
-            "[FlowTimeLabelFilter]: Too many labels! Consider denoising the input images.");
-
-        // return black image and empty graph
-        auto output = std::make_shared<Output>();
-        output->image =
-            std::make_shared<Image>(image->Width(), image->Height(), 1, Image::ChannelType::CHANNELTYPE_WORD);
-        output->graph = std::make_shared<graph::GraphData2D>();
-        return output;
+    for (auto& area : areas) {
+        const auto time = area.getFrameIndex();
+        nodesByTime[time].push_back(nodeGraph->addNode(std::move(area)));
     }
 
     auto printNode = [&nodeGraph](graph::GraphData2D::NodeID id) {
@@ -264,7 +263,7 @@ std::shared_ptr<FlowTimeLabelFilter::Output> FlowTimeLabelFilter::operator()() {
 
     // Create edges by iterating over flow fronts with time monotonically increasing
     for (const auto& flow_fronts : nodesByTime) {
-        for (const auto flow_front_ID : flow_fronts.second) {
+        for (const auto flow_front_ID : flow_fronts) {
             const auto& flow_front = nodeGraph->getNode(flow_front_ID);
 
             // Find neighboring flow fronts and add edge if the neighboring front is (1) from the past and (2) the local maximum
@@ -520,22 +519,22 @@ std::shared_ptr<FlowTimeLabelFilter::Output> FlowTimeLabelFilter::operator()() {
 
     // Compute velocity distributions
     auto getVelocities = [](const graph::GraphData2D& graph) {
-        std::map<Timestamp, double> weightedVelocity, weight;
+        // Indexed by time, NaN for times without any node
+        std::vector<double> weightedVelocity(std::numeric_limits<Timestamp>::max() + 1, 0.0);
+        std::vector<double> weight(weightedVelocity.size(), 0.0);
+        std::vector<bool> present(weightedVelocity.size(), false);
 
         for (const auto& node : graph.getNodes()) {
             const auto time = node.second.getFrameIndex();
 
-            if (weightedVelocity.find(time) == weightedVelocity.end()) {
-                weightedVelocity[time] = 0.0;
-                weight[time] = 0.0;
-            }
-
-            weightedVelocity.at(time) += static_cast<double>(node.second.velocityMagnitude) * node.second.area;
-            weight.at(time) += node.second.area;
+            weightedVelocity[time] += static_cast<double>(node.second.velocityMagnitude) * node.second.area;
+            weight[time] += node.second.area;
+            present[time] = true;
         }
 
-        for (auto& velocity : weightedVelocity) {
-            velocity.second /= weight.at(velocity.first);
+        for (std::size_t time = 0; time < weightedVelocity.size(); ++time) {
+            weightedVelocity[time] =
+                present[time] ? weightedVelocity[time] / weight[time] : std::numeric_limits<double>::quiet_NaN();
         }
 
         return weightedVelocity;
@@ -552,15 +551,14 @@ std::shared_ptr<FlowTimeLabelFilter::Output> FlowTimeLabelFilter::operator()() {
     std::vector<std::size_t> simplifiedGraphDistribution(numTimesteps, 0uLL);
 
     for (std::size_t t = startTime; t <= endTime; ++t) {
-        if (origVelocities.find(t) != origVelocities.end()) {
-            origGraphDistribution[t - startTime] = static_cast<std::size_t>(std::floor(origVelocities.at(t)));
+        if (!std::isnan(origVelocities[t])) {
+            origGraphDistribution[t - startTime] = static_cast<std::size_t>(std::floor(origVelocities[t]));
         }
-        if (fixedVelocities.find(t) != fixedVelocities.end()) {
-            fixedGraphDistribution[t - startTime] = static_cast<std::size_t>(std::floor(fixedVelocities.at(t)));
+        if (!std::isnan(fixedVelocities[t])) {
+            fixedGraphDistribution[t - startTime] = static_cast<std::size_t>(std::floor(fixedVelocities[t]));
         }
-        if (simplifiedVelocities.find(t) != simplifiedVelocities.end()) {
-            simplifiedGraphDistribution[t - startTime] =
-                static_cast<std::size_t>(std::floor(simplifiedVelocities.at(t)));
+        if (!std::isnan(simplifiedVelocities[t])) {
+            simplifiedGraphDistribution[t - startTime] = static_cast<std::size_t>(std::floor(simplifiedVelocities[t]));
         }
     }
 
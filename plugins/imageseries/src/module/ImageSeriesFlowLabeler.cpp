@@ -168,8 +168,8 @@ ImageSeriesFlowLabeler::ImageSeriesFlowLabeler()
     outputPathParam.SetUpdateCallback(&ImageSeriesFlowLabeler::filterParametersChangedCallback);
     MakeSlotAvailable(&outputPathParam);
 
-    // Set default image cache size to 512 MB
-    imageCache.setMaximumSize(512 * 1024 * 1024);
+    MakeSlotAvailable(&cacheParams.sizeParam);
+    imageCache.setMaximumSize(cacheParams.getMaximumSize());
 }
 
 ImageSeriesFlowLabeler::~ImageSeriesFlowLabeler() {
@@ -187,6 +187,8 @@ void ImageSeriesFlowLabeler::release() {
 }
 
 bool ImageSeriesFlowLabeler::getDataCallback(core::Call& caller) {
+    cacheParams.update(imageCache, FullName().PeekBuffer());
+
     filter::FlowTimeLabelFilter::Input filterInput;
     filterInput.outputImage = static_cast<filter::FlowTimeLabelFilter::Input::image_t>(
         outputImageParam.Param<core::param::EnumParam>()->Value());
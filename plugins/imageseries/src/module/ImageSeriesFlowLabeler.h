@@ -9,6 +9,7 @@
 #include "../filter/AsyncFilterRunner.h"
 #include "../filter/FlowTimeLabelFilter.h"
 #include "../util/LRUCache.h"
+#include "../util/LRUCacheParams.h"
 
 #include "imageseries/AsyncImageData2D.h"
 #include "imageseries/ImageSeries2DCall.h"
@@ -116,6 +117,7 @@ private:
     util::LRUCache<typename AsyncImageData2D<filter::FlowTimeLabelFilter::Output>::Hash,
         AsyncImageData2D<filter::FlowTimeLabelFilter::Output>>
         imageCache;
+    util::LRUCacheParams cacheParams;
 
     std::unique_ptr<filter::AsyncFilterRunner<AsyncImageData2D<filter::FlowTimeLabelFilter::Output>>> filterRunner;
 };
@@ -78,8 +78,8 @@ ImageSeriesFlowPreprocessor::ImageSeriesFlowPreprocessor()
     segmentationNegationParam.SetUpdateCallback(&ImageSeriesFlowPreprocessor::filterParametersChangedCallback);
     MakeSlotAvailable(&segmentationNegationParam);
 
-    // Set default image cache size to 512 MB
-    imageCache.setMaximumSize(512 * 1024 * 1024);
+    MakeSlotAvailable(&cacheParams.sizeParam);
+    imageCache.setMaximumSize(cacheParams.getMaximumSize());
 }
 
 ImageSeriesFlowPreprocessor::~ImageSeriesFlowPreprocessor() {
@@ -97,6 +97,8 @@ void ImageSeriesFlowPreprocessor::release() {
 }
 
 bool ImageSeriesFlowPreprocessor::getDataCallback(core::Call& caller) {
+    cacheParams.update(imageCache, FullName().PeekBuffer());
+
     if (auto* call = dynamic_cast<ImageSeries2DCall*>(&caller)) {
         // Try to get mask
         ImageSeries2DCall::Output mask;
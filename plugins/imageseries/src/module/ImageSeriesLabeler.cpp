@@ -92,8 +92,8 @@ ImageSeriesLabeler::ImageSeriesLabeler()
     flowFrontOffsetParam.SetUpdateCallback(&ImageSeriesLabeler::filterParametersChangedCallback);
     MakeSlotAvailable(&flowFrontOffsetParam);
 
-    // Set default image cache size to 512 MB
-    imageCache.setMaximumSize(512 * 1024 * 1024);
+    MakeSlotAvailable(&cacheParams.sizeParam);
+    imageCache.setMaximumSize(cacheParams.getMaximumSize());
 }
 
 ImageSeriesLabeler::~ImageSeriesLabeler() {
@@ -111,6 +111,8 @@ void ImageSeriesLabeler::release() {
 }
 
 bool ImageSeriesLabeler::getDataCallback(core::Call& caller) {
+    cacheParams.update(imageCache, FullName().PeekBuffer());
+
     if (auto* call = dynamic_cast<ImageSeries2DCall*>(&caller)) {
         // Try to get mask
         ImageSeries2DCall::Output mask;
@@ -51,8 +51,8 @@ ImageSeriesLoader::ImageSeriesLoader()
     patternParam.SetUpdateCallback(&ImageSeriesLoader::patternChangedCallback);
     MakeSlotAvailable(&patternParam);
 
-    // Set default image cache size to 512 MB
-    imageCache.setMaximumSize(512 * 1024 * 1024);
+    MakeSlotAvailable(&cacheParams.sizeParam);
+    imageCache.setMaximumSize(cacheParams.getMaximumSize());
 }
 
 ImageSeriesLoader::~ImageSeriesLoader() {
@@ -70,6 +70,8 @@ void ImageSeriesLoader::release() {
 }
 
 bool ImageSeriesLoader::getDataCallback(core::Call& caller) {
+    cacheParams.update(imageCache, FullName().PeekBuffer());
+
     if (auto call = dynamic_cast<ImageSeries2DCall*>(&caller)) {
         // Copy base metadata fields
         auto output = outputPrototype;
@@ -8,6 +8,7 @@
 
 #include "../filter/AsyncFilterRunner.h"
 #include "../util/LRUCache.h"
+#include "../util/LRUCacheParams.h"
 
 #include "imageseries/AsyncImageData2D.h"
 #include "imageseries/ImageSeries2DCall.h"
@@ -120,6 +121,7 @@ private:
     std::vector<std::string> imageFilesFiltered;
 
     util::LRUCache<std::uint32_t, AsyncImageData2D<>> imageCache;
+    util::LRUCacheParams cacheParams;
 
     ImageMetadata metadata;
     ImageSeries2DCall::Output outputPrototype;
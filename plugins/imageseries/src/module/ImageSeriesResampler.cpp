@@ -90,8 +90,8 @@ ImageSeriesResampler::ImageSeriesResampler()
     imageRegistrationAutoParam.SetUpdateCallback(&ImageSeriesResampler::registrationCallback);
     MakeSlotAvailable(&imageRegistrationAutoParam);
 
-    // Set default image cache size to 512 MB
-    imageCache.setMaximumSize(512 * 1024 * 1024);
+    MakeSlotAvailable(&cacheParams.sizeParam);
+    imageCache.setMaximumSize(cacheParams.getMaximumSize());
 }
 
 ImageSeriesResampler::~ImageSeriesResampler() {
@@ -111,6 +111,8 @@ void ImageSeriesResampler::release() {
 }
 
 bool ImageSeriesResampler::getDataCallback(core::Call& caller) {
+    cacheParams.update(imageCache, FullName().PeekBuffer());
+
     if (suppressed) {
         updateTransformationMatrix();
         return false;
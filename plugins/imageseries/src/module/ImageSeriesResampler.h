@@ -9,6 +9,7 @@
 #include "../filter/AsyncFilterRunner.h"
 #include "../registration/AsyncImageRegistrator.h"
 #include "../util/LRUCache.h"
+#include "../util/LRUCacheParams.h"
 
 #include "imageseries/AffineTransform2DCall.h"
 #include "imageseries/AsyncImageData2D.h"
@@ -129,6 +130,7 @@ private:
     bool suppressed = false;
 
     util::LRUCache<typename AsyncImageData2D<>::Hash, AsyncImageData2D<>> imageCache;
+    util::LRUCacheParams cacheParams;
 
     std::unique_ptr<filter::AsyncFilterRunner<>> filterRunner;
 };
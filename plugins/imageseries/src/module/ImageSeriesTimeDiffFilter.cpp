@@ -50,8 +50,8 @@ ImageSeriesTimeDiffFilter::ImageSeriesTimeDiffFilter()
     frameCountParam.SetUpdateCallback(&ImageSeriesTimeDiffFilter::filterParametersChangedCallback);
     MakeSlotAvailable(&frameCountParam);
 
-    // Set default image cache size to 512 MB
-    imageCache.setMaximumSize(512 * 1024 * 1024);
+    MakeSlotAvailable(&cacheParams.sizeParam);
+    imageCache.setMaximumSize(cacheParams.getMaximumSize());
 }
 
 ImageSeriesTimeDiffFilter::~ImageSeriesTimeDiffFilter() {
@@ -69,6 +69,8 @@ void ImageSeriesTimeDiffFilter::release() {
 }
 
 bool ImageSeriesTimeDiffFilter::getDataCallback(core::Call& caller) {
+    cacheParams.update(imageCache, FullName().PeekBuffer());
+
     if (auto* call = dynamic_cast<ImageSeries2DCall*>(&caller)) {
         double timestamp = call->GetInput().time;
 
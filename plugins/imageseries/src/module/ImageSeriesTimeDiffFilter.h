@@ -8,6 +8,7 @@
 
 #include "../filter/AsyncFilterRunner.h"
 #include "../util/LRUCache.h"
+#include "../util/LRUCacheParams.h"
 
 #include "imageseries/AsyncImageData2D.h"
 #include "imageseries/ImageSeries2DCall.h"
@@ -95,6 +96,7 @@ private:
     core::param::ParamSlot frameCountParam;
 
     util::LRUCache<typename AsyncImageData2D<>::Hash, AsyncImageData2D<>> imageCache;
+    util::LRUCacheParams cacheParams;
 
     std::unique_ptr<filter::AsyncFilterRunner<>> filterRunner;
 };
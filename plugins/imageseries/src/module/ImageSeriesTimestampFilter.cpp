@@ -46,8 +46,8 @@ ImageSeriesTimestampFilter::ImageSeriesTimestampFilter()
     denoiseNeighborThreshold.SetUpdateCallback(&ImageSeriesTimestampFilter::filterParametersChangedCallback);
     MakeSlotAvailable(&denoiseNeighborThreshold);
 
-    // Set default image cache size to 512 MB
-    imageCache.setMaximumSize(512 * 1024 * 1024);
+    MakeSlotAvailable(&cacheParams.sizeParam);
+    imageCache.setMaximumSize(cacheParams.getMaximumSize());
 }
 
 ImageSeriesTimestampFilter::~ImageSeriesTimestampFilter() {
@@ -65,6 +65,8 @@ void ImageSeriesTimestampFilter::release() {
 }
 
 bool ImageSeriesTimestampFilter::getDataCallback(core::Call& caller) {
+    cacheParams.update(imageCache, FullName().PeekBuffer());
+
     if (auto* call = dynamic_cast<ImageSeries2DCall*>(&caller)) {
         auto output = requestFrame(getInputCaller, 0);
 
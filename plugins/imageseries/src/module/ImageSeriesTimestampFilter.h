@@ -8,6 +8,7 @@
 
 #include "../filter/AsyncFilterRunner.h"
 #include "../util/LRUCache.h"
+#include "../util/LRUCacheParams.h"
 
 #include "imageseries/AsyncImageData2D.h"
 #include "imageseries/ImageSeries2DCall.h"
@@ -98,6 +99,7 @@ private:
     std::unique_ptr<filter::AsyncFilterRunner<>> filterRunner;
 
     util::LRUCache<typename AsyncImageData2D<>::Hash, AsyncImageData2D<>> imageCache;
+    util::LRUCacheParams cacheParams;
 };
 
 } // namespace megamol::ImageSeries
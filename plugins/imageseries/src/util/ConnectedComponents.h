@@ -0,0 +1,335 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include "imageseries/util/WorkerThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace megamol::ImageSeries::util {
+
+/**
+ * Connected-component labeling of a 2D image using a block-parallel union-find.
+ *
+ * Blocks of rows are labeled concurrently on the shared worker thread pool, after which components crossing block
+ * borders are merged. Components receive consecutive IDs in the (row-major) order of their first pixel, which is the
+ * order in which a sequential flood fill would discover them.
+ *
+ * Images must have fewer than 2^31 pixels.
+ */
+class ConnectedComponents {
+public:
+    using Index = std::uint32_t;
+
+    /// Component ID of pixels not belonging to any component
+    static constexpr Index None = std::numeric_limits<Index>::max();
+
+    /**
+     * Labels the components of an image.
+     *
+     * @param width Image width.
+     * @param height Image height.
+     * @param isMember Answers whether the pixel with the given index belongs to any component.
+     * @param isConnected Answers whether two adjacent member pixels belong to the same component.
+     * @param diagonal If true, uses the 8-neighborhood instead of the 4-neighborhood.
+     */
+    template<typename IsMember, typename IsConnected>
+    ConnectedComponents(Index width, Index height, IsMember isMember, IsConnected isConnected, bool diagonal);
+
+    Index getComponentCount() const {
+        return static_cast<Index>(sizes.size());
+    }
+
+    /**
+     * @return ID of the component containing the given pixel, or None.
+     */
+    Index operator[](Index pixel) const {
+        return labels[pixel];
+    }
+
+    /**
+     * @return Number of pixels per component.
+     */
+    const std::vector<Index>& getSizes() const {
+        return sizes;
+    }
+
+    /**
+     * @return Pixel indices per component, in row-major order.
+     */
+    std::vector<std::vector<Index>> collectPixels() const;
+
+private:
+    /// Consecutive pixels within a block belonging to the same component
+    struct Run {
+        Index component;
+        Index count;
+    };
+
+    /// Marks entries of the label array holding the final component ID of a root
+    static constexpr Index RootFlag = Index(1) << 31;
+
+    std::pair<Index, Index> getBlockRows(std::size_t block) const {
+        const Index begin = static_cast<Index>(block * rowsPerBlock);
+        return {begin, std::min<Index>(begin + rowsPerBlock, height)};
+    }
+
+    template<typename Func>
+    void forEachBlock(Func func) const {
+        WorkerThreadPool::getSharedInstance().forEachBlock(runs.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t block = begin; block < end; ++block) {
+                func(block);
+            }
+        });
+    }
+
+    Index width = 0;
+    Index height = 0;
+    Index rowsPerBlock = 1;
+
+    /// Union-find forest during labeling, component IDs afterwards
+    std::vector<Index> labels;
+
+    std::vector<Index> sizes;
+
+    /// Run-length encoded component IDs per block
+    std::vector<std::vector<Run>> runs;
+};
+
+template<typename IsMember, typename IsConnected>
+ConnectedComponents::ConnectedComponents(
+    Index width, Index height, IsMember isMember, IsConnected isConnected, bool diagonal)
+        : width(width)
+        , height(height)
+        , labels(static_cast<std::size_t>(width) * height, None) {
+
+    const std::size_t targetBlocks = std::max<std::size_t>(1, WorkerThreadPool::getSharedInstance().getThreadCount());
+    rowsPerBlock = std::max<Index>(16, static_cast<Index>((height + targetBlocks - 1) / targetBlocks));
+    runs.resize((height + rowsPerBlock - 1) / rowsPerBlock);
+
+    // Roots are always the smallest index of their tree, such that parents precede their children
+    auto findRoot = [this](Index index) {
+        while (labels[index] != index) {
+            labels[index] = labels[labels[index]];
+            index = labels[index];
+        }
+        return index;
+    };
+
+    auto unite = [&](Index a, Index b) {
+        a = findRoot(a);
+        b = findRoot(b);
+        if (a < b) {
+            labels[b] = a;
+        } else if (b < a) {
+            labels[a] = b;
+        }
+    };
+
+    auto tryUnite = [&](Index index, Index neighbor) {
+        if (labels[neighbor] != None && isConnected(index, neighbor)) {
+            unite(index, neighbor);
+        }
+    };
+
+    auto visitUpperNeighbors = [&](Index x, Index index, auto&& visit) {
+        const Index up = index - width;
+        if (diagonal && x > 0) {
+            visit(index, up - 1);
+        }
+        visit(index, up);
+        if (diagonal && x + 1 < width) {
+            visit(index, up + 1);
+        }
+    };
+
+    // First pass: label each block independently and let all pixels point to the root of their block-local tree
+    forEachBlock([&](std::size_t block) {
+        const auto [yBegin, yEnd] = getBlockRows(block);
+
+        for (Index y = yBegin; y < yEnd; ++y) {
+            for (Index x = 0; x < width; ++x) {
+                const Index index = y * width + x;
+                if (!isMember(index)) {
+                    continue;
+                }
+
+                labels[index] = index;
+                if (x > 0) {
+                    tryUnite(index, index - 1);
+                }
+                if (y > yBegin) {
+                    visitUpperNeighbors(x, index, tryUnite);
+                }
+            }
+        }
+
+        for (Index index = yBegin * width; index < yEnd * width; ++index) {
+            if (labels[index] != None) {
+                labels[index] = labels[labels[index]];
+            }
+        }
+    });
+
+    // Merge components across block borders, remembering all modified entries
+    std::vector<Index> modified;
+
+    auto findRootRecorded = [&](Index index) {
+        while (labels[index] != index) {
+            const Index next = labels[labels[index]];
+            if (next != labels[index]) {
+                labels[index] = next;
+                modified.push_back(index);
+            }
+            index = next;
+        }
+        return index;
+    };
+
+    auto uniteRecorded = [&](Index index, Index neighbor) {
+        if (labels[neighbor] != None && isConnected(index, neighbor)) {
+            const Index a = findRootRecorded(index);
+            const Index b = findRootRecorded(neighbor);
+            if (a != b) {
+                modified.push_back(std::max(a, b));
+                labels[std::max(a, b)] = std::min(a, b);
+            }
+        }
+    };
+
+    for (std::size_t block = 1; block < runs.size(); ++block) {
+        const Index y = getBlockRows(block).first;
+        for (Index x = 0; x < width; ++x) {
+            const Index index = y * width + x;
+            if (labels[index] != None) {
+                visitUpperNeighbors(x, index, uniteRecorded);
+            }
+        }
+    }
+
+    // Modified entries only point to smaller indices, so resolving them in ascending order makes them point to roots
+    std::sort(modified.begin(), modified.end());
+    modified.erase(std::unique(modified.begin(), modified.end()), modified.end());
+    for (const Index index : modified) {
+        labels[index] = labels[labels[index]];
+    }
+
+    // Second pass: all pixels point to block-local roots, which now point to global roots. Entries of block-local
+    // roots are not modified in this pass, as they already hold their final value.
+    std::vector<Index> rootCounts(runs.size());
+
+    forEachBlock([&](std::size_t block) {
+        const auto [yBegin, yEnd] = getBlockRows(block);
+
+        for (Index index = yBegin * width; index < yEnd * width; ++index) {
+            const Index parent = labels[index];
+            if (parent == index) {
+                ++rootCounts[block];
+            } else if (parent != None && labels[parent] != parent) {
+                labels[index] = labels[parent];
+            }
+        }
+    });
+
+    // Assign IDs to roots in row-major order, then propagate them to all other pixels
+    std::vector<Index> firstIDs(runs.size() + 1, 0);
+    for (std::size_t block = 0; block < runs.size(); ++block) {
+        firstIDs[block + 1] = firstIDs[block] + rootCounts[block];
+    }
+
+    forEachBlock([&](std::size_t block) {
+        const auto [yBegin, yEnd] = getBlockRows(block);
+
+        Index id = firstIDs[block];
+        for (Index index = yBegin * width; index < yEnd * width; ++index) {
+            if (labels[index] == index) {
+                labels[index] = id++ | RootFlag;
+            }
+        }
+    });
+
+    forEachBlock([&](std::size_t block) {
+        const auto [yBegin, yEnd] = getBlockRows(block);
+
+        for (Index index = yBegin * width; index < yEnd * width; ++index) {
+            const Index parent = labels[index];
+            if (parent != None && (parent & RootFlag) == 0) {
+                labels[index] = labels[parent];
+            }
+        }
+    });
+
+    forEachBlock([&](std::size_t block) {
+        const auto [yBegin, yEnd] = getBlockRows(block);
+        auto& blockRuns = runs[block];
+
+        for (Index index = yBegin * width; index < yEnd * width; ++index) {
+            if (labels[index] != None) {
+                labels[index] &= ~RootFlag;
+                if (!blockRuns.empty() && blockRuns.back().component == labels[index]) {
+                    ++blockRuns.back().count;
+                } else {
+                    blockRuns.push_back(Run{labels[index], 1});
+                }
+            }
+        }
+    });
+
+    sizes.resize(firstIDs.back(), 0);
+    for (const auto& blockRuns : runs) {
+        for (const auto& run : blockRuns) {
+            sizes[run.component] += run.count;
+        }
+    }
+}
+
+inline std::vector<std::vector<ConnectedComponents::Index>> ConnectedComponents::collectPixels() const {
+    std::vector<std::vector<Index>> pixels(sizes.size());
+    for (std::size_t component = 0; component < sizes.size(); ++component) {
+        pixels[component].resize(sizes[component]);
+    }
+
+    // Determine where each run starts within the pixel list of its component
+    std::vector<std::vector<Index>> runOffsets(runs.size());
+    std::vector<Index> nextOffsets(sizes.size(), 0);
+    for (std::size_t block = 0; block < runs.size(); ++block) {
+        runOffsets[block].reserve(runs[block].size());
+        for (const auto& run : runs[block]) {
+            runOffsets[block].push_back(nextOffsets[run.component]);
+            nextOffsets[run.component] += run.count;
+        }
+    }
+
+    forEachBlock([&](std::size_t block) {
+        const auto [yBegin, yEnd] = getBlockRows(block);
+
+        std::size_t runIndex = 0;
+        Index remaining = 0;
+        Index* target = nullptr;
+
+        for (Index index = yBegin * width; index < yEnd * width; ++index) {
+            if (labels[index] != None) {
+                if (remaining == 0) {
+                    const auto& run = runs[block][runIndex];
+                    target = pixels[run.component].data() + runOffsets[block][runIndex];
+                    remaining = run.count;
+                    ++runIndex;
+                }
+                *(target++) = index;
+                --remaining;
+            }
+        }
+    });
+
+    return pixels;
+}
+
+} // namespace megamol::ImageSeries::util
@@ -7,8 +7,11 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <unordered_map>
 #include <utility>
@@ -16,25 +19,59 @@
 
 namespace megamol::ImageSeries::util {
 
+/**
+ * Thread-safe cache with a byte budget, which evicts the least recently used
+ * entries first.
+ *
+ * Keys are distributed over independently locked shards, each of which keeps
+ * its entries in a list ordered by recency, so that accessing entries takes
+ * constant time. The budget is shared by all shards, so that a single entry
+ * may use all of it.
+ */
 template<typename Key, typename Value>
 class LRUCache {
 public:
     using SizeGetterFunc = std::function<std::size_t(const Value&)>;
 
-    LRUCache(SizeGetterFunc sizeGetter) : sizeGetter(sizeGetter) {}
+    /**
+     * Usage statistics, which are accumulated until the cache is cleared.
+     */
+    struct Statistics {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+        std::size_t entryCount = 0;
+        std::size_t byteCount = 0;
+        std::size_t maximumSize = 0;
+    };
+
+    LRUCache(SizeGetterFunc sizeGetter, std::size_t shardCount = 8)
+            : sizeGetter(sizeGetter)
+            , shardCount(std::max<std::size_t>(shardCount, 1))
+            , shards(std::make_unique<Shard[]>(this->shardCount)) {}
 
     void clear() {
-        entries.clear();
-        accessCount = 0;
-        totalByteCount = 0;
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            byteCount -= shards[i].byteCount;
+            shards[i].entries.clear();
+            shards[i].order.clear();
+            shards[i].byteCount = 0;
+        }
+        hits = 0;
+        misses = 0;
+        evictions = 0;
     }
 
     std::shared_ptr<const Value> get(const Key& key) const {
-        auto result = entries.find(key);
-        if (result != entries.end()) {
-            result->second.lastAccess = accessCount++;
-            return result->second.value;
+        auto& shard = shardOf(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto result = shard.entries.find(key);
+        if (result != shard.entries.end()) {
+            ++hits;
+            return touch(shard, result->second);
         } else {
+            ++misses;
             return nullptr;
         }
     }
@@ -43,29 +80,58 @@ public:
         return get(key);
     }
 
+    /**
+     * Answers the cached value for 'key' or calls 'supplier' to create it.
+     *
+     * The supplier is called without holding any lock. If several threads
+     * request the same missing key concurrently, each of them creates the
+     * value, but only the first one is cached and returned to all of them.
+     */
     template<typename Func>
     std::shared_ptr<const Value> findOrCreate(const Key& key, Func supplier) {
         if (maximumSize == 0) {
+            ++misses;
             return supplier(key);
         }
 
-        auto result = entries.find(key);
-        if (result != entries.end()) {
-            result->second.lastAccess = accessCount++;
-            return result->second.value;
-        } else {
-            Entry entry;
-            entry.lastAccess = accessCount++;
-            entry.value = supplier(key);
-            entry.byteCount = entry.value != nullptr ? sizeGetter(*entry.value) : 0;
+        auto& shard = shardOf(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto result = shard.entries.find(key);
+            if (result != shard.entries.end()) {
+                ++hits;
+                return touch(shard, result->second);
+            }
+        }
 
-            totalByteCount += entry.byteCount;
-            entries.insert(std::make_pair(key, entry));
+        ++misses;
+        Entry entry;
+        entry.key = key;
+        entry.value = supplier(key);
+        entry.byteCount = entry.value != nullptr ? sizeGetter(*entry.value) : 0;
 
-            cleanUp();
+        std::shared_ptr<const Value> value;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto result = shard.entries.find(key);
+            if (result != shard.entries.end()) {
+                // Another thread has been faster.
+                return touch(shard, result->second);
+            }
 
-            return entry.value;
+            value = entry.value;
+            entry.lastUse = ++clock;
+            shard.byteCount += entry.byteCount;
+            byteCount += entry.byteCount;
+            shard.order.push_front(std::move(entry));
+            shard.entries.emplace(key, shard.order.begin());
         }
+
+        if (byteCount > maximumSize) {
+            cleanUp();
+        }
+
+        return value;
     }
 
     std::shared_ptr<const Value> find(const Key& key) {
@@ -73,18 +139,11 @@ public:
             throw std::runtime_error("Find function is not allowed if cache size is zero.");
         }
 
-        auto result = entries.find(key);
-        if (result != entries.end()) {
-            result->second.lastAccess = accessCount++;
-            return result->second.value;
-        } else {
-            return nullptr;
-        }
+        return get(key);
     }
 
     void setMaximumSize(std::size_t maximumSize) {
-        if (this->maximumSize != maximumSize) {
-            this->maximumSize = maximumSize;
+        if (this->maximumSize.exchange(maximumSize) != maximumSize) {
             cleanUp();
         }
     }
@@ -93,44 +152,111 @@ public:
         return maximumSize;
     }
 
+    Statistics getStatistics() const {
+        Statistics result;
+        result.hits = hits;
+        result.misses = misses;
+        result.evictions = evictions;
+        result.maximumSize = maximumSize;
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            result.entryCount += shards[i].entries.size();
+            result.byteCount += shards[i].byteCount;
+        }
+        return result;
+    }
+
 private:
     struct Entry {
+        Key key;
         std::shared_ptr<const Value> value;
-        mutable std::size_t lastAccess = 0;
         std::size_t byteCount = 0;
+
+        /// Time of the last access, for comparing the recency of entries in different shards
+        std::size_t lastUse = 0;
     };
 
+    using EntryList = std::list<Entry>;
+
+    struct Shard {
+        std::mutex mutex;
+
+        /// Entries ordered from the most to the least recently used one
+        EntryList order;
+
+        std::unordered_map<Key, typename EntryList::iterator> entries;
+
+        std::size_t byteCount = 0;
+    };
+
+    Shard& shardOf(const Key& key) const {
+        return shards[std::hash<Key>()(key) % shardCount];
+    }
+
+    /// Marks an entry as most recently used. The shard must be locked.
+    std::shared_ptr<const Value> touch(Shard& shard, typename EntryList::iterator entry) const {
+        entry->lastUse = ++clock;
+        shard.order.splice(shard.order.begin(), shard.order, entry);
+        return entry->value;
+    }
+
+    /// Evicts the least recently used entries of all shards until the cache fits into its budget. The most recently
+    /// used entry is kept unless the budget is zero. No shard may be locked by the caller.
     void cleanUp() {
-        if (maximumSize == 0) {
-            entries.clear();
-        } else if (totalByteCount > maximumSize) {
-            // Obtain list of entries
-            std::vector<std::pair<Key, Entry>> entryList;
-            for (auto it = entries.begin(); it != entries.end(); ++it) {
-                entryList.emplace_back(it->first, it->second);
-            }
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(shardCount);
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            locks.emplace_back(shards[i].mutex);
+        }
 
-            // Sort by last access time (oldest entries last)
-            std::sort(entryList.begin(), entryList.end(),
-                [](const auto& a, const auto& b) { return a.second.lastAccess > b.second.lastAccess; });
+        const std::size_t budget = maximumSize;
+        if (budget != 0 && byteCount <= budget) {
+            // Another thread has cleaned up in the meantime.
+            return;
+        }
 
-            // Clean up until total memory usage is below threshold
-            std::size_t cleanupThreshold = maximumSize * cleanupFactor;
-            while (totalByteCount > cleanupThreshold && !entryList.empty()) {
-                totalByteCount -= entryList.back().second.byteCount;
-                entries.erase(entryList.back().first);
-                entryList.pop_back();
+        std::size_t entryCount = 0;
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            entryCount += shards[i].entries.size();
+        }
+
+        // Clean up until memory usage is below threshold to avoid evicting on every insertion
+        const auto cleanupThreshold = static_cast<std::size_t>(budget * cleanupFactor);
+        const std::size_t keptCount = budget == 0 ? 0 : 1;
+        while ((budget == 0 || byteCount > cleanupThreshold) && entryCount > keptCount) {
+            Shard* oldest = nullptr;
+            for (std::size_t i = 0; i < shardCount; ++i) {
+                if (!shards[i].order.empty() &&
+                    (oldest == nullptr || shards[i].order.back().lastUse < oldest->order.back().lastUse)) {
+                    oldest = &shards[i];
+                }
             }
+            oldest->byteCount -= oldest->order.back().byteCount;
+            byteCount -= oldest->order.back().byteCount;
+            oldest->entries.erase(oldest->order.back().key);
+            oldest->order.pop_back();
+            --entryCount;
+            ++evictions;
         }
     }
 
     SizeGetterFunc sizeGetter;
 
-    std::unordered_map<Key, Entry> entries;
-    mutable std::size_t accessCount = 0;
-    std::size_t totalByteCount = 0;
-    std::size_t maximumSize = 0;
+    std::size_t shardCount;
+    std::unique_ptr<Shard[]> shards;
+
+    std::atomic<std::size_t> maximumSize = 0;
     float cleanupFactor = 0.9;
+
+    /// Bytes used by the entries of all shards
+    std::atomic<std::size_t> byteCount = 0;
+
+    /// Source of the access times of the entries
+    mutable std::atomic<std::size_t> clock = 0;
+
+    mutable std::atomic<std::size_t> hits = 0;
+    mutable std::atomic<std::size_t> misses = 0;
+    std::atomic<std::size_t> evictions = 0;
 };
 
 } // namespace megamol::ImageSeries::util
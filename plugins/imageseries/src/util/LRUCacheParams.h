@@ -0,0 +1,78 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include "LRUCache.h"
+
+#include "mmcore/param/IntParam.h"
+#include "mmcore/param/ParamSlot.h"
+#include "mmcore/utility/log/Log.h"
+
+#include <chrono>
+#include <cstddef>
+
+namespace megamol::ImageSeries::util {
+
+/**
+ * Parameter for configuring the size of an LRUCache, which also reports the
+ * usage statistics of the cache to the log.
+ *
+ * The owning module must make the slot available and should call update()
+ * whenever it accesses the cache. The statistics are kept out of the parameter
+ * system, as they change on every access.
+ */
+class LRUCacheParams {
+public:
+    explicit LRUCacheParams(int defaultSizeMB = 512)
+            : sizeParam("Cache size (MB)", "Maximum amount of memory used for caching images.") {
+        sizeParam << new core::param::IntParam(defaultSizeMB, 0);
+    }
+
+    /**
+     * Applies the configured size to the cache, if it has been changed, and
+     * logs the statistics at most every few seconds.
+     *
+     * @param cache The cache to update
+     * @param owner Name of the owning module, prefixed to the log message
+     */
+    template<typename Key, typename Value>
+    void update(LRUCache<Key, Value>& cache, const char* owner) {
+        // Only evicts entries if the size has actually changed
+        cache.setMaximumSize(getMaximumSize());
+        sizeParam.ResetDirty();
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastReportTime < reportInterval) {
+            return;
+        }
+        const auto stats = cache.getStatistics();
+        if (stats.hits + stats.misses == lastReportedAccesses) {
+            return;
+        }
+        lastReportTime = now;
+        lastReportedAccesses = stats.hits + stats.misses;
+        core::utility::log::Log::DefaultLog.WriteInfo(
+            "[%s] Cache: %zu hits, %zu misses, %zu evictions, %zu entries, %zu/%zu MB", owner, stats.hits,
+            stats.misses, stats.evictions, stats.entryCount, stats.byteCount >> 20, stats.maximumSize >> 20);
+    }
+
+    std::size_t getMaximumSize() const {
+        return static_cast<std::size_t>(sizeParam.Param<core::param::IntParam>()->Value()) * 1024 * 1024;
+    }
+
+    /// Maximum size of the cache in megabytes
+    core::param::ParamSlot sizeParam;
+
+private:
+    static constexpr std::chrono::seconds reportInterval{3};
+
+    std::chrono::steady_clock::time_point lastReportTime;
+
+    std::size_t lastReportedAccesses = 0;
+};
+
+} // namespace megamol::ImageSeries::util
@@ -0,0 +1,544 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "BarnesHutTSNE.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+
+#include <nanoflann.hpp>
+#include <omp.h>
+
+using namespace megamol::infovis;
+
+namespace {
+
+/** Maximum number of points in a leaf of the space-partitioning tree */
+constexpr uint32_t leafSize = 8;
+
+/** Depth at which cells are no longer split, bounds the traversal stack */
+constexpr std::size_t maxDepth = 32;
+
+/** Nanoflann adaptor for row-major tables */
+struct TableAdaptor {
+    const float* data;
+    std::size_t rows;
+    std::size_t cols;
+
+    inline std::size_t kdtree_get_point_count() const {
+        return rows;
+    }
+
+    inline float kdtree_get_pt(const std::size_t idx, const std::size_t dim) const {
+        return data[idx * cols + dim];
+    }
+
+    template<class BBOX>
+    bool kdtree_get_bbox(BBOX&) const {
+        return false;
+    }
+};
+
+using TableKDTree =
+    nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<float, TableAdaptor>, TableAdaptor, -1, uint32_t>;
+
+} // namespace
+
+bool BarnesHutTSNE::init(const float* data, std::size_t rows, std::size_t cols, const Settings& settings) {
+    if (settings.outputDims < 1 || settings.outputDims > maxDims || rows < 2 || cols < 1 ||
+        rows >= std::numeric_limits<uint32_t>::max() || settings.perplexity <= 0.0) {
+        return false;
+    }
+
+    this->settings = settings;
+    N = rows;
+    dims = settings.outputDims;
+    iter = 0;
+    learningRate = settings.learningRate > 0.0
+                       ? settings.learningRate
+                       : std::max(200.0, static_cast<double>(N) / std::max(settings.earlyExaggeration, 1.0));
+
+    computeInputSimilarities(data, cols);
+
+    // Random initialization with small gaussian noise
+    std::mt19937 rng(settings.seed < 0 ? std::random_device()() : static_cast<unsigned int>(settings.seed));
+    std::normal_distribution<double> dist(0.0, 1e-4);
+    Y.resize(N * dims);
+    for (auto& y : Y) {
+        y = dist(rng);
+    }
+    update.assign(N * dims, 0.0);
+    gains.assign(N * dims, 1.0);
+    gradient.assign(N * dims, 0.0);
+
+    treeOrder.resize(N);
+    std::iota(treeOrder.begin(), treeOrder.end(), 0);
+    treeScratch.resize(N);
+
+    return true;
+}
+
+void BarnesHutTSNE::computeInputSimilarities(const float* data, std::size_t cols) {
+    const std::size_t K = std::min(N - 1, static_cast<std::size_t>(3.0 * settings.perplexity));
+    const int64_t numRows = static_cast<int64_t>(N);
+
+    // Conditional similarities p_j|i of the k nearest neighbors, row i at [i * K, (i + 1) * K)
+    std::vector<uint32_t> neighbors(N * K);
+    std::vector<float> conditional(N * K);
+
+    {
+        TableAdaptor adaptor{data, N, cols};
+        TableKDTree tree(static_cast<int>(cols), adaptor, nanoflann::KDTreeSingleIndexAdaptorParams(10));
+
+#pragma omp parallel
+        {
+            std::vector<uint32_t> indices(K + 1);
+            std::vector<float> distances(K + 1);
+            std::vector<double> p(K);
+            std::vector<std::pair<uint32_t, float>> row(K);
+            const double targetEntropy = std::log(settings.perplexity);
+
+#pragma omp for schedule(dynamic, 256)
+            for (int64_t i = 0; i < numRows; ++i) {
+                const auto found = tree.knnSearch(data + i * cols, K + 1, indices.data(), distances.data());
+
+                // Drop the query point itself, which is not necessarily the first one in case of duplicates
+                uint32_t* rowNeighbors = neighbors.data() + i * K;
+                std::size_t n = 0;
+                double minDist = std::numeric_limits<double>::max();
+                for (std::size_t k = 0; k < found && n < K; ++k) {
+                    if (indices[k] == static_cast<uint32_t>(i)) {
+                        continue;
+                    }
+                    rowNeighbors[n] = indices[k];
+                    p[n] = distances[k];
+                    minDist = std::min(minDist, p[n]);
+                    ++n;
+                }
+
+                // Binary search for the gaussian kernel matching the perplexity. Distances are shifted by the
+                // smallest one, which cancels out in the normalization but avoids underflows for large distances.
+                double beta = 1.0;
+                double minBeta = -std::numeric_limits<double>::max();
+                double maxBeta = std::numeric_limits<double>::max();
+                float* rowP = conditional.data() + i * K;
+                for (int searchIter = 0; searchIter < 200; ++searchIter) {
+                    double sumP = 0.0;
+                    double entropy = 0.0;
+                    for (std::size_t k = 0; k < n; ++k) {
+                        const double d = p[k] - minDist;
+                        const double pk = std::exp(-beta * d);
+                        sumP += pk;
+                        entropy += beta * d * pk;
+                    }
+                    entropy = entropy / sumP + std::log(sumP);
+
+                    const double diff = entropy - targetEntropy;
+                    if (std::abs(diff) < 1e-5 || searchIter == 199) {
+                        for (std::size_t k = 0; k < n; ++k) {
+                            rowP[k] = static_cast<float>(std::exp(-beta * (p[k] - minDist)) / sumP);
+                        }
+                        break;
+                    }
+                    if (diff > 0.0) {
+                        minBeta = beta;
+                        beta = maxBeta == std::numeric_limits<double>::max() ? beta * 2.0 : (beta + maxBeta) / 2.0;
+                    } else {
+                        maxBeta = beta;
+                        beta = minBeta == -std::numeric_limits<double>::max() ? beta / 2.0 : (beta + minBeta) / 2.0;
+                    }
+                }
+
+                // Cannot happen as K < N, but keep the rows well-defined
+                for (std::size_t k = n; k < K; ++k) {
+                    rowNeighbors[k] = rowNeighbors[0];
+                    rowP[k] = 0.0f;
+                }
+
+                // Sort by neighbor index for merging with the transposed similarities
+                for (std::size_t k = 0; k < K; ++k) {
+                    row[k] = std::make_pair(rowNeighbors[k], rowP[k]);
+                }
+                std::sort(row.begin(), row.end());
+                for (std::size_t k = 0; k < K; ++k) {
+                    rowNeighbors[k] = row[k].first;
+                    rowP[k] = row[k].second;
+                }
+            }
+        }
+    }
+
+    // Transpose, the rows of the transposed similarities are sorted by construction
+    std::vector<std::size_t> transposedOffsets(N + 1, 0);
+    for (std::size_t k = 0; k < N * K; ++k) {
+        ++transposedOffsets[neighbors[k] + 1];
+    }
+    std::partial_sum(transposedOffsets.begin(), transposedOffsets.end(), transposedOffsets.begin());
+    std::vector<uint32_t> transposedIndices(N * K);
+    std::vector<float> transposedValues(N * K);
+    {
+        std::vector<std::size_t> fill(transposedOffsets.begin(), transposedOffsets.end() - 1);
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t k = i * K; k < (i + 1) * K; ++k) {
+                const auto pos = fill[neighbors[k]]++;
+                transposedIndices[pos] = static_cast<uint32_t>(i);
+                transposedValues[pos] = conditional[k];
+            }
+        }
+    }
+
+    // Symmetrize by merging both sorted rows: p_ij = (p_j|i + p_i|j) / 2N
+    auto mergeRow = [&](std::size_t i, uint32_t* outIndices, float* outValues) -> std::size_t {
+        std::size_t a = i * K;
+        const std::size_t aEnd = (i + 1) * K;
+        std::size_t b = transposedOffsets[i];
+        const std::size_t bEnd = transposedOffsets[i + 1];
+        const float norm = 1.0f / static_cast<float>(2 * N);
+        std::size_t n = 0;
+        while (a < aEnd || b < bEnd) {
+            uint32_t j;
+            float v;
+            if (b == bEnd || (a < aEnd && neighbors[a] < transposedIndices[b])) {
+                j = neighbors[a];
+                v = conditional[a++];
+            } else if (a == aEnd || transposedIndices[b] < neighbors[a]) {
+                j = transposedIndices[b];
+                v = transposedValues[b++];
+            } else {
+                j = neighbors[a];
+                v = conditional[a++] + transposedValues[b++];
+            }
+            if (outIndices != nullptr) {
+                outIndices[n] = j;
+                outValues[n] = v * norm;
+            }
+            ++n;
+        }
+        return n;
+    };
+
+    rowOffsets.assign(N + 1, 0);
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int64_t i = 0; i < numRows; ++i) {
+        rowOffsets[i + 1] = mergeRow(i, nullptr, nullptr);
+    }
+    std::partial_sum(rowOffsets.begin(), rowOffsets.end(), rowOffsets.begin());
+    colIndices.resize(rowOffsets.back());
+    values.resize(rowOffsets.back());
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int64_t i = 0; i < numRows; ++i) {
+        mergeRow(i, colIndices.data() + rowOffsets[i], values.data() + rowOffsets[i]);
+    }
+}
+
+void BarnesHutTSNE::step() {
+    const double exaggeration = iter < settings.stopLyingIter ? settings.earlyExaggeration : 1.0;
+    const double momentum = iter < settings.momentumSwitchIter ? 0.5 : 0.8;
+    const int64_t numRows = static_cast<int64_t>(N);
+    const int64_t numValues = static_cast<int64_t>(N * dims);
+
+    buildTree();
+
+    // Repulsive forces, temporarily stored in the gradient. Points are visited in tree order, such that consecutive
+    // points traverse mostly the same cells.
+    double sumQ = 0.0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+ : sumQ)
+    for (int64_t k = 0; k < numRows; ++k) {
+        const std::size_t i = treeOrder[k];
+        double force[maxDims] = {0.0};
+        sumQ += computeRepulsion(i, force);
+        for (int d = 0; d < dims; ++d) {
+            gradient[i * dims + d] = force[d];
+        }
+    }
+
+    // Attractive forces along the sparse input similarities
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int64_t i = 0; i < numRows; ++i) {
+        const double* yi = &Y[i * dims];
+        double force[maxDims] = {0.0};
+        for (auto k = rowOffsets[i]; k < rowOffsets[i + 1]; ++k) {
+            const double* yj = &Y[static_cast<std::size_t>(colIndices[k]) * dims];
+            double diff[maxDims];
+            double dist = 1.0;
+            for (int d = 0; d < dims; ++d) {
+                diff[d] = yi[d] - yj[d];
+                dist += diff[d] * diff[d];
+            }
+            const double mult = exaggeration * values[k] / dist;
+            for (int d = 0; d < dims; ++d) {
+                force[d] += mult * diff[d];
+            }
+        }
+        for (int d = 0; d < dims; ++d) {
+            gradient[i * dims + d] = force[d] - gradient[i * dims + d] / sumQ;
+        }
+    }
+
+    // Gradient descent with momentum and per-parameter gains
+#pragma omp parallel for
+    for (int64_t k = 0; k < numValues; ++k) {
+        const bool sameSign = (gradient[k] > 0.0) == (update[k] > 0.0);
+        gains[k] = std::max(sameSign ? gains[k] * 0.8 : gains[k] + 0.2, 0.01);
+        update[k] = momentum * update[k] - learningRate * gains[k] * gradient[k];
+        Y[k] += update[k];
+    }
+
+    // Keep the embedding centered
+    for (int d = 0; d < dims; ++d) {
+        double sum = 0.0;
+#pragma omp parallel for reduction(+ : sum)
+        for (int64_t i = 0; i < numRows; ++i) {
+            sum += Y[i * dims + d];
+        }
+        const double mean = sum / static_cast<double>(N);
+#pragma omp parallel for
+        for (int64_t i = 0; i < numRows; ++i) {
+            Y[i * dims + d] -= mean;
+        }
+    }
+
+    ++iter;
+}
+
+void BarnesHutTSNE::buildTree() {
+    const int64_t numRows = static_cast<int64_t>(N);
+
+    // Bounding box of the embedding. The order of the points is kept from the previous iteration, where they were
+    // already sorted spatially, which speeds up partitioning.
+    double minPos[maxDims];
+    double maxPos[maxDims];
+    std::fill(minPos, minPos + maxDims, std::numeric_limits<double>::max());
+    std::fill(maxPos, maxPos + maxDims, std::numeric_limits<double>::lowest());
+#pragma omp parallel
+    {
+        double localMin[maxDims];
+        double localMax[maxDims];
+        std::fill(localMin, localMin + maxDims, std::numeric_limits<double>::max());
+        std::fill(localMax, localMax + maxDims, std::numeric_limits<double>::lowest());
+#pragma omp for
+        for (int64_t i = 0; i < numRows; ++i) {
+            for (int d = 0; d < dims; ++d) {
+                localMin[d] = std::min(localMin[d], Y[i * dims + d]);
+                localMax[d] = std::max(localMax[d], Y[i * dims + d]);
+            }
+        }
+#pragma omp critical
+        {
+            for (int d = 0; d < dims; ++d) {
+                minPos[d] = std::min(minPos[d], localMin[d]);
+                maxPos[d] = std::max(maxPos[d], localMax[d]);
+            }
+        }
+    }
+
+    Node root{};
+    root.maxWidth = 0.0;
+    for (int d = 0; d < dims; ++d) {
+        root.center[d] = 0.5 * (minPos[d] + maxPos[d]);
+        root.halfWidth[d] = std::max(0.5 * (maxPos[d] - minPos[d]), 1e-10);
+        root.maxWidth = std::max(root.maxWidth, 2.0 * root.halfWidth[d]);
+    }
+    root.begin = 0;
+    root.end = static_cast<uint32_t>(N);
+
+    nodes.clear();
+    nodes.push_back(root);
+
+    // Split the top levels serially until there are enough independent subtrees to keep all threads busy
+    const std::size_t targetSubtrees = 16 * static_cast<std::size_t>(omp_get_max_threads());
+    std::vector<std::size_t> pending(1, 0);
+    std::size_t depth = 0;
+    for (; depth < maxDepth && !pending.empty() && pending.size() < targetSubtrees; ++depth) {
+        std::vector<std::size_t> next;
+        for (auto idx : pending) {
+            Node node = nodes[idx];
+            if (splitNode(node, nodes, depth)) {
+                for (uint32_t c = 0; c < node.numChildren; ++c) {
+                    next.push_back(node.firstChild + c);
+                }
+            }
+            nodes[idx] = node;
+        }
+        pending.swap(next);
+    }
+
+    // Build the subtrees in parallel and append them afterwards, such that children always follow their parents
+    std::vector<std::vector<Node>> subtrees(pending.size());
+    const int64_t numSubtrees = static_cast<int64_t>(pending.size());
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t s = 0; s < numSubtrees; ++s) {
+        Node node = nodes[pending[s]];
+        buildSubtree(node, subtrees[s], depth);
+        nodes[pending[s]] = node;
+    }
+    for (std::size_t s = 0; s < subtrees.size(); ++s) {
+        const auto offset = static_cast<uint32_t>(nodes.size());
+        if (nodes[pending[s]].numChildren > 0) {
+            nodes[pending[s]].firstChild += offset;
+        }
+        for (auto node : subtrees[s]) {
+            if (node.numChildren > 0) {
+                node.firstChild += offset;
+            }
+            nodes.push_back(node);
+        }
+    }
+
+    // Centers of mass bottom-up, the ones of the leaves are already known
+    for (std::size_t idx = nodes.size(); idx-- > 0;) {
+        Node& node = nodes[idx];
+        if (node.numChildren == 0) {
+            continue;
+        }
+        std::fill(node.centerOfMass, node.centerOfMass + maxDims, 0.0);
+        for (uint32_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c) {
+            const double weight = static_cast<double>(nodes[c].end - nodes[c].begin);
+            for (int d = 0; d < dims; ++d) {
+                node.centerOfMass[d] += weight * nodes[c].centerOfMass[d];
+            }
+        }
+        for (int d = 0; d < dims; ++d) {
+            node.centerOfMass[d] /= static_cast<double>(node.end - node.begin);
+        }
+    }
+}
+
+bool BarnesHutTSNE::splitNode(Node& node, std::vector<Node>& out, std::size_t depth) {
+    const uint32_t count = node.end - node.begin;
+
+    if (count <= leafSize || depth >= maxDepth) {
+        std::fill(node.centerOfMass, node.centerOfMass + maxDims, 0.0);
+        for (uint32_t k = node.begin; k < node.end; ++k) {
+            for (int d = 0; d < dims; ++d) {
+                node.centerOfMass[d] += Y[static_cast<std::size_t>(treeOrder[k]) * dims + d];
+            }
+        }
+        for (int d = 0; d < dims; ++d) {
+            node.centerOfMass[d] /= static_cast<double>(count);
+        }
+        node.firstChild = 0;
+        node.numChildren = 0;
+        return false;
+    }
+
+    auto cellOf = [&](uint32_t point) {
+        uint32_t cell = 0;
+        for (int d = 0; d < dims; ++d) {
+            if (Y[static_cast<std::size_t>(point) * dims + d] > node.center[d]) {
+                cell |= 1u << d;
+            }
+        }
+        return cell;
+    };
+
+    // Counting sort of the points into the child cells
+    const uint32_t numCells = 1u << dims;
+    uint32_t offsets[(1u << maxDims) + 1] = {0};
+    for (uint32_t k = node.begin; k < node.end; ++k) {
+        ++offsets[cellOf(treeOrder[k]) + 1];
+    }
+    for (uint32_t c = 0; c < numCells; ++c) {
+        offsets[c + 1] += offsets[c];
+    }
+    uint32_t fill[1u << maxDims];
+    std::copy(offsets, offsets + numCells, fill);
+    for (uint32_t k = node.begin; k < node.end; ++k) {
+        treeScratch[node.begin + fill[cellOf(treeOrder[k])]++] = treeOrder[k];
+    }
+    std::copy(treeScratch.begin() + node.begin, treeScratch.begin() + node.end, treeOrder.begin() + node.begin);
+
+    node.firstChild = static_cast<uint32_t>(out.size());
+    node.numChildren = 0;
+    for (uint32_t c = 0; c < numCells; ++c) {
+        if (offsets[c] == offsets[c + 1]) {
+            continue;
+        }
+        Node child{};
+        child.maxWidth = 0.5 * node.maxWidth;
+        for (int d = 0; d < dims; ++d) {
+            child.halfWidth[d] = 0.5 * node.halfWidth[d];
+            child.center[d] = node.center[d] + ((c >> d) & 1u ? child.halfWidth[d] : -child.halfWidth[d]);
+        }
+        child.begin = node.begin + offsets[c];
+        child.end = node.begin + offsets[c + 1];
+        out.push_back(child);
+        ++node.numChildren;
+    }
+
+    return true;
+}
+
+void BarnesHutTSNE::buildSubtree(Node& node, std::vector<Node>& out, std::size_t depth) {
+    if (!splitNode(node, out, depth)) {
+        return;
+    }
+    for (uint32_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c) {
+        Node child = out[c];
+        buildSubtree(child, out, depth + 1);
+        out[c] = child;
+    }
+}
+
+double BarnesHutTSNE::computeRepulsion(std::size_t point, double* force) const {
+    const double* yi = &Y[point * dims];
+    const double theta2 = settings.theta * settings.theta;
+    double sumQ = 0.0;
+
+    uint32_t stack[maxDepth * (1u << maxDims) + 1];
+    std::size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+
+        if (node.numChildren == 0) {
+            for (uint32_t k = node.begin; k < node.end; ++k) {
+                const std::size_t j = treeOrder[k];
+                if (j == point) {
+                    continue;
+                }
+                double diff[maxDims];
+                double dist = 0.0;
+                for (int d = 0; d < dims; ++d) {
+                    diff[d] = yi[d] - Y[j * dims + d];
+                    dist += diff[d] * diff[d];
+                }
+                const double q = 1.0 / (1.0 + dist);
+                sumQ += q;
+                for (int d = 0; d < dims; ++d) {
+                    force[d] += q * q * diff[d];
+                }
+            }
+            continue;
+        }
+
+        double diff[maxDims];
+        double dist = 0.0;
+        for (int d = 0; d < dims; ++d) {
+            diff[d] = yi[d] - node.centerOfMass[d];
+            dist += diff[d] * diff[d];
+        }
+        if (node.maxWidth * node.maxWidth < theta2 * dist) {
+            // Summarize the cell by its center of mass
+            const double q = 1.0 / (1.0 + dist);
+            const double mult = static_cast<double>(node.end - node.begin) * q;
+            sumQ += mult;
+            for (int d = 0; d < dims; ++d) {
+                force[d] += mult * q * diff[d];
+            }
+        } else {
+            for (uint32_t c = node.firstChild; c < node.firstChild + node.numChildren; ++c) {
+                stack[top++] = c;
+            }
+        }
+    }
+
+    return sumQ;
+}
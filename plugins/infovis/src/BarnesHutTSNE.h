@@ -0,0 +1,123 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace megamol::infovis {
+
+/**
+ * Multithreaded Barnes-Hut t-SNE (van der Maaten, 2014).
+ *
+ * The input similarities are computed from the exact k nearest neighbors only and stored sparsely, the repulsive
+ * forces are approximated with a space-partitioning tree over the embedding. Memory is linear in the number of
+ * points, no N x N matrix is ever built. The optimization runs step by step, such that intermediate embeddings can be
+ * inspected.
+ */
+class BarnesHutTSNE {
+public:
+    /** Maximum number of output dimensions supported by the space-partitioning tree */
+    static constexpr int maxDims = 3;
+
+    struct Settings {
+        int outputDims = 2;
+        double perplexity = 30.0;
+        /** Accuracy of the Barnes-Hut approximation, 0 computes the exact repulsive forces */
+        double theta = 0.5;
+        /** Learning rate, values <= 0 select max(200, N / earlyExaggeration) */
+        double learningRate = 0.0;
+        double earlyExaggeration = 12.0;
+        int stopLyingIter = 250;
+        int momentumSwitchIter = 250;
+        int seed = 42;
+    };
+
+    /**
+     * Computes the input similarities of 'rows' points of 'cols' dimensions in row-major 'data' and initializes the
+     * embedding randomly.
+     *
+     * @return 'false' if the settings do not fit the data.
+     */
+    bool init(const float* data, std::size_t rows, std::size_t cols, const Settings& settings);
+
+    /** Runs one iteration of the gradient descent */
+    void step();
+
+    /** Answer the number of iterations run since init() */
+    int iteration() const {
+        return iter;
+    }
+
+    /** Answer the number of output dimensions */
+    int outputDims() const {
+        return dims;
+    }
+
+    /** Answer the current embedding, row-major with 'outputDims' values per point */
+    const std::vector<double>& embedding() const {
+        return Y;
+    }
+
+private:
+    struct Node {
+        double center[maxDims];
+        double halfWidth[maxDims];
+        double centerOfMass[maxDims];
+        /** Maximum edge length of the cell */
+        double maxWidth;
+        /** Range of the node's points in 'treeOrder' */
+        uint32_t begin;
+        uint32_t end;
+        /** Index of the first of 'numChildren' consecutive children, leaves have no children */
+        uint32_t firstChild;
+        uint32_t numChildren;
+    };
+
+    void computeInputSimilarities(const float* data, std::size_t cols);
+
+    void buildTree();
+
+    /**
+     * Partitions the points of 'node' into its child cells, which are appended to 'out'.
+     *
+     * @return 'false' if 'node' has become a leaf.
+     */
+    bool splitNode(Node& node, std::vector<Node>& out, std::size_t depth);
+
+    void buildSubtree(Node& node, std::vector<Node>& out, std::size_t depth);
+
+    double computeRepulsion(std::size_t point, double* force) const;
+
+    Settings settings;
+
+    std::size_t N = 0;
+
+    int dims = 2;
+
+    int iter = 0;
+
+    double learningRate = 200.0;
+
+    /** Symmetric input similarities in compressed sparse row format */
+    std::vector<std::size_t> rowOffsets;
+    std::vector<uint32_t> colIndices;
+    std::vector<float> values;
+
+    std::vector<double> Y;
+    std::vector<double> update;
+    std::vector<double> gains;
+    std::vector<double> gradient;
+
+    /** Space-partitioning tree over the embedding, rebuilt every iteration */
+    std::vector<Node> nodes;
+    std::vector<uint32_t> treeOrder;
+    std::vector<uint32_t> treeScratch;
+};
+
+} // namespace megamol::infovis
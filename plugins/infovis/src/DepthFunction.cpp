@@ -1,11 +1,15 @@
 #include "DepthFunction.h"
 
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/IntParam.h"
 #include "mmcore/param/StringParam.h"
 
 #include "HD/HD.h"
 #include <Eigen/LU>
+#include <algorithm>
+#include <omp.h>
+#include <random>
 
 using namespace megamol;
 using namespace megamol::infovis;
@@ -13,12 +17,33 @@ using namespace Eigen;
 
 enum DepthType { HALFSPACE_DEPTH = 0, FUNCTIONAL_DEPTH, MAHALANOBIS_DEPTH, SIMPLICAL_DEPTH };
 
-Eigen::VectorXd DepthFunction::halfSpaceDepth(Eigen::MatrixXd dataMatrix) {
-    Eigen::VectorXd result = Eigen::VectorXd(dataMatrix.rows());
+namespace {
 
+using RowMatrixXd = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+/** Number of points processed together against one tile of samples */
+constexpr int64_t pointTileSize = 256;
+
+/** Number of samples (bands, simplices) kept in cache while being tested against a tile of points */
+constexpr int64_t sampleTileSize = 256;
+
+/** Independent random stream per sample, such that results do not depend on the number of threads */
+std::mt19937 sampleRng(unsigned int seed, int64_t sample) {
+    std::seed_seq seq{seed, static_cast<unsigned int>(sample), static_cast<unsigned int>(sample >> 32)};
+    return std::mt19937(seq);
+}
+
+} // namespace
+
+Eigen::VectorXd DepthFunction::halfSpaceDepth(const Eigen::MatrixXd& dataMatrix) {
     int nPoints = dataMatrix.rows();
     int nDims = dataMatrix.cols();
 
+    Eigen::VectorXd result = Eigen::VectorXd::Zero(nPoints);
+    if (nPoints == 0 || nDims == 0) {
+        return result;
+    }
+
     double** x;
     x = new double*[nPoints];
 
@@ -28,182 +53,230 @@ Eigen::VectorXd DepthFunction::halfSpaceDepth(Eigen::MatrixXd dataMatrix) {
             x[i][j] = dataMatrix(i, j);
     }
 
-    double* z;
-    z = new double[dataMatrix.cols()];
+    // The exact algorithm only reads the data, the points are independent
+#pragma omp parallel
+    {
+        std::vector<double> z(nDims);
 
-    for (int pIndex = 0; pIndex < nPoints; pIndex++) {
-        for (int j = 0; j < dataMatrix.cols(); j++) {
-            z[j] = dataMatrix(pIndex, j);
+#pragma omp for schedule(dynamic, 16)
+        for (int pIndex = 0; pIndex < nPoints; pIndex++) {
+            std::copy(x[pIndex], x[pIndex] + nDims, z.begin());
+            result(pIndex) = HalfspaceDepth::HD_Comb2(z.data(), x, nPoints, nDims);
         }
-        result(pIndex) = HalfspaceDepth::HD_Comb2(z, x, nPoints, nDims);
     }
 
     for (int k = 0; k < nPoints; k++)
         delete[] x[k];
     delete[] x;
-    delete[] z;
 
     return result;
 }
 
+Eigen::VectorXd DepthFunction::approximateHalfSpaceDepth(
+    const Eigen::MatrixXd& dataMatrix, int directionsCount, unsigned int seed) {
+    const int64_t nPoints = dataMatrix.rows();
+    const int64_t nDims = dataMatrix.cols();
 
-double DepthFunction::binomialCoeff(int n, int k) {
-    if (k == 0 || k == n) {
-        return 1;
+    if (nPoints == 0 || nDims == 0 || directionsCount <= 0) {
+        return Eigen::VectorXd::Zero(nPoints);
     }
 
-    double result = 1.0;
-
-    for (int i = 0; i < k; i++) {
-        result *= (n + 1.0 - i) / i;
+    // Uniformly distributed directions, the length does not matter for the ranks
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> normal;
+    Eigen::MatrixXd directions(nDims, directionsCount);
+    for (int k = 0; k < directionsCount; k++) {
+        for (int64_t dim = 0; dim < nDims; dim++) {
+            directions(dim, k) = normal(rng);
+        }
     }
 
-    return result;
-}
-
-Eigen::VectorXd DepthFunction::functionalDepth(
-    Eigen::MatrixXd dataMatrix, int samplesCount, int samplesLength, unsigned int seed) {
-    srand(seed);
-
-    Eigen::VectorXd result = Eigen::VectorXd(dataMatrix.rows());
-    double binom = binomialCoeff(dataMatrix.rows(), samplesCount);
-
-    // count the hits for every data point (= row in the data matrix)
-    for (int row = 0; row < dataMatrix.rows(); row++) {
-        Eigen::RowVectorXd dataPoint = dataMatrix.row(row);
-
-        int hitsCount = 0;
-
-        // generate random samples of length samplesLength
-        for (int sampleIndex = 0; sampleIndex < samplesCount; sampleIndex++) {
-            Eigen::VectorXd rndIndices =
-                (Eigen::VectorXd::Random(samplesLength).array() + 1.0) / 2.0 * (dataMatrix.rows() - 1.0);
-
-            bool minMaxFound = true;
-
-            // for every property of the data point (= columns)
-            for (int dim = 0; dim < dataMatrix.cols(); dim++) {
-
-                double dataPointValue = dataPoint(dim);
-
-                bool dim_maxFound = false;
-                bool dim_minFound = false;
-
-                // for every data point in the random set, check if its value
-                // is <= or >= than the current data point value
-                // (equiv. to: is the data point contained in a random set of points?)
-                for (int rndIndexCounter = 0; rndIndexCounter < samplesLength; rndIndexCounter++) {
-                    int rndIndex = rndIndices(rndIndexCounter);
-
-                    if (dataMatrix(rndIndex, dim) <= dataPointValue)
-                        dim_minFound = true;
-                    if (dataMatrix(rndIndex, dim) >= dataPointValue)
-                        dim_maxFound = true;
+    std::vector<int64_t> depth(nPoints, nPoints);
+#pragma omp parallel
+    {
+        std::vector<int64_t> localDepth(nPoints, nPoints);
+        Eigen::VectorXd projection(nPoints);
+        std::vector<std::pair<double, int64_t>> order(nPoints);
+
+#pragma omp for schedule(dynamic, 1)
+        for (int k = 0; k < directionsCount; k++) {
+            projection.noalias() = dataMatrix * directions.col(k);
+            for (int64_t i = 0; i < nPoints; i++) {
+                order[i] = std::make_pair(projection(i), i);
+            }
+            std::sort(order.begin(), order.end());
 
-                    if (dim_minFound && dim_maxFound)
-                        break;
+            // Points with equal projection [first, last) lie in both closed halfspaces of each other
+            for (int64_t first = 0, last = 0; first < nPoints; first = last) {
+                while (last < nPoints && order[last].first == order[first].first) {
+                    last++;
                 }
-
-                // if a dimension was found where neither a min nor a max was found,
-                // this datapoint isn't in the random set/sample
-                if (!(dim_minFound && dim_maxFound)) {
-                    minMaxFound = false;
-                    break;
+                const int64_t count = std::min(last, nPoints - first);
+                for (int64_t i = first; i < last; i++) {
+                    localDepth[order[i].second] = std::min(localDepth[order[i].second], count);
                 }
             }
-
-            if (minMaxFound)
-                hitsCount++;
         }
 
-        // result = 1 / binom(n, j) * hitsCount
-        // where n = samplesLength and j = samplesCount
-        result(row) = static_cast<double>(hitsCount) / static_cast<double>(binom);
+#pragma omp critical
+        {
+            for (int64_t i = 0; i < nPoints; i++) {
+                depth[i] = std::min(depth[i], localDepth[i]);
+            }
+        }
     }
 
+    Eigen::VectorXd result(nPoints);
+    for (int64_t i = 0; i < nPoints; i++) {
+        result(i) = static_cast<double>(depth[i]);
+    }
     return result;
 }
 
-bool insideSimplexCheck(Eigen::VectorXd p, Eigen::MatrixXd x) {
-    Eigen::MatrixXd tmp(x.rows() + 1, x.cols());
-    tmp << x.transpose(), Eigen::MatrixXd::Ones(x.cols(), 1);
-    tmp.transposeInPlace();
-    double nominator = tmp.determinant();
-
-    tmp.block(0, 0, x.rows(), 1) = p;
-
-    double sum = 0;
+Eigen::VectorXd DepthFunction::functionalDepth(
+    const Eigen::MatrixXd& dataMatrix, int samplesCount, int samplesLength, unsigned int seed) {
+    const int64_t nPoints = dataMatrix.rows();
+    const int64_t nDims = dataMatrix.cols();
 
-    for (int pointIndex = 0; pointIndex < x.cols(); pointIndex++) {
+    Eigen::VectorXd result = Eigen::VectorXd::Zero(nPoints);
+    if (nPoints == 0 || samplesCount <= 0 || samplesLength <= 0) {
+        return result;
+    }
 
-        if (pointIndex != 0)
-            tmp.block(0, pointIndex, x.rows(), 1) = x.block(0, pointIndex - 1, x.rows(), 1); // update matrix
+    const RowMatrixXd points = dataMatrix;
+
+    // Envelope of every random band, i.e., per-column minimum and maximum of samplesLength random rows
+    RowMatrixXd bandMin(samplesCount, nDims);
+    RowMatrixXd bandMax(samplesCount, nDims);
+#pragma omp parallel for schedule(static)
+    for (int sampleIndex = 0; sampleIndex < samplesCount; sampleIndex++) {
+        auto rng = sampleRng(seed, sampleIndex);
+        std::uniform_int_distribution<int64_t> pick(0, nPoints - 1);
+        bandMin.row(sampleIndex) = bandMax.row(sampleIndex) = points.row(pick(rng));
+        for (int rndIndexCounter = 1; rndIndexCounter < samplesLength; rndIndexCounter++) {
+            const auto rndIndex = pick(rng);
+            bandMin.row(sampleIndex) = bandMin.row(sampleIndex).cwiseMin(points.row(rndIndex));
+            bandMax.row(sampleIndex) = bandMax.row(sampleIndex).cwiseMax(points.row(rndIndex));
+        }
+    }
 
-        double sign = ((pointIndex % 2) * (-2.0) + 1.0);     // pow(-1,pointIndex)
-        double alpha = sign * tmp.determinant() / nominator; // barycentric coordinate
+    // Count the bands containing each point in all columns, tile by tile
+    const int64_t pointTiles = (nPoints + pointTileSize - 1) / pointTileSize;
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t pointTile = 0; pointTile < pointTiles; pointTile++) {
+        const int64_t pointBegin = pointTile * pointTileSize;
+        const int64_t pointEnd = std::min(pointBegin + pointTileSize, nPoints);
+        int64_t hitsCount[pointTileSize] = {0};
+
+        for (int64_t sampleBegin = 0; sampleBegin < samplesCount; sampleBegin += sampleTileSize) {
+            const int64_t sampleEnd = std::min<int64_t>(sampleBegin + sampleTileSize, samplesCount);
+            for (int64_t row = pointBegin; row < pointEnd; row++) {
+                const double* dataPoint = points.row(row).data();
+                for (int64_t sampleIndex = sampleBegin; sampleIndex < sampleEnd; sampleIndex++) {
+                    const double* minValues = bandMin.row(sampleIndex).data();
+                    const double* maxValues = bandMax.row(sampleIndex).data();
+                    int64_t dim = 0;
+                    while (dim < nDims && minValues[dim] <= dataPoint[dim] && dataPoint[dim] <= maxValues[dim]) {
+                        dim++;
+                    }
+                    if (dim == nDims) {
+                        hitsCount[row - pointBegin]++;
+                    }
+                }
+            }
+        }
 
-        sum += alpha;
-        if (alpha > 1.0 || alpha < 0.0)
-            return false;
+        for (int64_t row = pointBegin; row < pointEnd; row++) {
+            result(row) = static_cast<double>(hitsCount[row - pointBegin]) / static_cast<double>(samplesCount);
+        }
     }
 
-    return true;
+    return result;
 }
 
-Eigen::VectorXd DepthFunction::simplicalDepth(Eigen::MatrixXd dataMatrix, int samplesCount, unsigned int seed) {
-    srand(seed);
-
-    int nPoints = dataMatrix.rows();
-    int nDims = dataMatrix.cols();
-
-    Eigen::VectorXd result = Eigen::VectorXd(dataMatrix.rows());
-
-    for (int row = 0; row < dataMatrix.rows(); row++) {
-        Eigen::VectorXd dataPoint = dataMatrix.row(row).transpose();
-
-        int hitsCount = 0;
-
-        for (int sampleIndex = 0; sampleIndex < samplesCount; sampleIndex++) {
-            Eigen::VectorXd rndIndices =
-                (Eigen::VectorXd::Random(nDims + 1).array() + 1.0) / 2.0 * (dataMatrix.rows() - 1.0);
-
-
-            Eigen::MatrixXd vertices(nDims, nDims + 1);
+Eigen::VectorXd DepthFunction::simplicalDepth(const Eigen::MatrixXd& dataMatrix, int samplesCount, unsigned int seed) {
+    const int64_t nPoints = dataMatrix.rows();
+    const int64_t nDims = dataMatrix.cols();
 
-            for (int rndIndexCounter = 0; rndIndexCounter < nDims + 1; rndIndexCounter++) {
-                int rndIndex = rndIndices(rndIndexCounter);
+    Eigen::VectorXd result = Eigen::VectorXd::Zero(nPoints);
+    if (nPoints == 0 || samplesCount <= 0) {
+        return result;
+    }
 
-                vertices.block(0, rndIndexCounter, nDims, 1) = dataMatrix.row(rndIndex).transpose();
+    const RowMatrixXd points = dataMatrix;
+    std::vector<int64_t> hitsCount(nPoints, 0);
+
+    // The barycentric coordinates of a point are the product of the inverted vertex matrix (in homogeneous
+    // coordinates) with the point, such that each simplex is only factorized once.
+    std::vector<Eigen::MatrixXd> inverses(sampleTileSize);
+    std::vector<char> valid(sampleTileSize);
+
+    for (int64_t sampleBegin = 0; sampleBegin < samplesCount; sampleBegin += sampleTileSize) {
+        const int64_t sampleEnd = std::min<int64_t>(sampleBegin + sampleTileSize, samplesCount);
+
+#pragma omp parallel for schedule(static)
+        for (int64_t sampleIndex = sampleBegin; sampleIndex < sampleEnd; sampleIndex++) {
+            auto rng = sampleRng(seed, sampleIndex);
+            std::uniform_int_distribution<int64_t> pick(0, nPoints - 1);
+            Eigen::MatrixXd vertices(nDims + 1, nDims + 1);
+            for (int64_t rndIndexCounter = 0; rndIndexCounter < nDims + 1; rndIndexCounter++) {
+                vertices.block(0, rndIndexCounter, nDims, 1) = points.row(pick(rng)).transpose();
+                vertices(nDims, rndIndexCounter) = 1.0;
             }
 
+            // Degenerate simplices do not contain any point
+            Eigen::FullPivLU<Eigen::MatrixXd> lu(vertices);
+            valid[sampleIndex - sampleBegin] = lu.isInvertible();
+            if (lu.isInvertible()) {
+                inverses[sampleIndex - sampleBegin] = lu.inverse();
+            }
+        }
 
-            if (insideSimplexCheck(dataPoint, vertices))
-                hitsCount++;
+#pragma omp parallel
+        {
+            Eigen::VectorXd dataPoint(nDims + 1);
+            Eigen::VectorXd alpha(nDims + 1);
+            dataPoint(nDims) = 1.0;
+
+#pragma omp for schedule(static, pointTileSize)
+            for (int64_t row = 0; row < nPoints; row++) {
+                dataPoint.head(nDims) = points.row(row).transpose();
+                for (int64_t sampleIndex = sampleBegin; sampleIndex < sampleEnd; sampleIndex++) {
+                    if (!valid[sampleIndex - sampleBegin]) {
+                        continue;
+                    }
+                    alpha.noalias() = inverses[sampleIndex - sampleBegin] * dataPoint;
+                    if (alpha.minCoeff() >= 0.0) {
+                        hitsCount[row]++;
+                    }
+                }
+            }
         }
+    }
 
-        result(row) = static_cast<double>(hitsCount) / static_cast<double>(samplesCount);
+    for (int64_t row = 0; row < nPoints; row++) {
+        result(row) = static_cast<double>(hitsCount[row]) / static_cast<double>(samplesCount);
     }
 
     return result;
 }
 
-Eigen::MatrixXd DepthFunction::mahalanobisDepth(Eigen::MatrixXd dataMatrix) {
-    int nPoints = dataMatrix.rows();
+Eigen::MatrixXd DepthFunction::mahalanobisDepth(const Eigen::MatrixXd& dataMatrix) {
+    const int64_t nPoints = dataMatrix.rows();
 
     Eigen::MatrixXd mahalaDepth = Eigen::MatrixXd::Zero(nPoints, 1);
-    Eigen::MatrixXd invS =
-        (1.0 / (nPoints - 1.0) * dataMatrix.transpose() *
-            (Eigen::MatrixXd::Identity(nPoints, nPoints) - 1.0 / nPoints * Eigen::MatrixXd::Ones(nPoints, nPoints)) *
-            dataMatrix)
-            .inverse(); // inverse covariance Matrix
-
-    Eigen::MatrixXd mu = 1.0 / nPoints * dataMatrix.transpose() * Eigen::MatrixXd::Ones(nPoints, 1);
-    Eigen::MatrixXd xi;
-
-    //#pragma omp parallel for //doesn't work
-    for (int index = 0; index < nPoints; index++) {
-        xi = dataMatrix.row(index).transpose();
-        mahalaDepth(index, 0) = 1.0 / (1.0 + ((xi - mu).transpose() * invS * (xi - mu))(0, 0));
+    if (nPoints == 0) {
+        return mahalaDepth;
+    }
+
+    const Eigen::RowVectorXd mu = dataMatrix.colwise().mean();
+    const Eigen::MatrixXd centered = dataMatrix.rowwise() - mu;
+    const Eigen::MatrixXd invS =
+        (centered.transpose() * centered / std::max(nPoints - 1.0, 1.0)).inverse(); // inverse covariance Matrix
+
+#pragma omp parallel for schedule(static)
+    for (int64_t index = 0; index < nPoints; index++) {
+        mahalaDepth(index, 0) = 1.0 / (1.0 + centered.row(index) * invS * centered.row(index).transpose());
     }
     return mahalaDepth;
 }
@@ -252,9 +325,12 @@ DepthFunction::DepthFunction()
         , columnGroupsSlot("columnGroups", "Semicolon-separated groups of comma-separated column indices to compute "
                                            "the data depth for. Defaults to one group, all columns.")
         , depthType("depthType", "The depth function to use for computing the depth statistics")
-        , sampleCount("sampleCount", "The number of samples, that will be drawn (functional depth only)")
+        , sampleCount("sampleCount", "The number of samples, that will be drawn (functional and simplical depth)")
         , sampleLength("sampleLength", "The length of one sample (functional depth only)")
-        , randomSeed("randomSeed", "The random seed (functional depth only)") {
+        , randomSeed("randomSeed", "The random seed (sampled depths only)")
+        , approximate("approximate", "Estimate the depth from at most sampleBudget samples. Halfspace depth "
+                                     "then uses random Tukey depth, an upper bound of the exact depth")
+        , sampleBudget("sampleBudget", "The maximum number of samples or random directions in approximate mode") {
 
     // Data input slot
     this->dataInSlot.SetCompatibleCall<megamol::datatools::table::TableDataCallDescription>();
@@ -288,12 +364,20 @@ DepthFunction::DepthFunction()
     randomSeed << new ::megamol::core::param::IntParam(1337);
     this->MakeSlotAvailable(&randomSeed);
 
+    approximate << new ::megamol::core::param::BoolParam(false);
+    this->MakeSlotAvailable(&approximate);
+
+    sampleBudget << new ::megamol::core::param::IntParam(1000, 1);
+    this->MakeSlotAvailable(&sampleBudget);
+
     // Add all parameters to common-parameter-handling list
     params.push_back(&columnGroupsSlot);
     params.push_back(&depthType);
     params.push_back(&sampleCount);
     params.push_back(&sampleLength);
     params.push_back(&randomSeed);
+    params.push_back(&approximate);
+    params.push_back(&sampleBudget);
 }
 
 DepthFunction::~DepthFunction() {
@@ -422,6 +506,14 @@ bool megamol::infovis::DepthFunction::apply(megamol::datatools::table::TableData
         columnGroups.push_back(columns);
     }
 
+    const bool approximateDepth = this->approximate.Param<core::param::BoolParam>()->Value();
+    const int budget = this->sampleBudget.Param<core::param::IntParam>()->Value();
+    const unsigned int seed = this->randomSeed.Param<core::param::IntParam>()->Value();
+    int samples = this->sampleCount.Param<core::param::IntParam>()->Value();
+    if (approximateDepth) {
+        samples = std::min(samples, budget);
+    }
+
     // Compute depths for all column groups.
     Eigen::MatrixXd groupDepths = Eigen::MatrixXd::Zero(inDataMat.rows(), columnGroups.size());
     for (int group = 0; group < columnGroups.size(); group++) {
@@ -437,21 +529,19 @@ bool megamol::infovis::DepthFunction::apply(megamol::datatools::table::TableData
         // Compute depth function.
         switch (this->depthType.Param<core::param::EnumParam>()->Value()) {
         case HALFSPACE_DEPTH:
-            groupDepths.block(0, group, inDataMat.rows(), 1) = halfSpaceDepth(columnGroupMat);
+            groupDepths.block(0, group, inDataMat.rows(), 1) =
+                approximateDepth ? approximateHalfSpaceDepth(columnGroupMat, budget, seed)
+                                 : halfSpaceDepth(columnGroupMat);
             break;
         case FUNCTIONAL_DEPTH:
-            groupDepths.block(0, group, inDataMat.rows(), 1) =
-                functionalDepth(columnGroupMat, this->sampleCount.Param<core::param::IntParam>()->Value(),
-                    this->sampleLength.Param<core::param::IntParam>()->Value(),
-                    this->randomSeed.Param<core::param::IntParam>()->Value());
+            groupDepths.block(0, group, inDataMat.rows(), 1) = functionalDepth(
+                columnGroupMat, samples, this->sampleLength.Param<core::param::IntParam>()->Value(), seed);
             break;
         case MAHALANOBIS_DEPTH:
             groupDepths.block(0, group, inDataMat.rows(), 1) = mahalanobisDepth(columnGroupMat);
             break;
         case SIMPLICAL_DEPTH:
-            groupDepths.block(0, group, inDataMat.rows(), 1) =
-                simplicalDepth(inDataMat, this->sampleCount.Param<core::param::IntParam>()->Value(),
-                    this->randomSeed.Param<core::param::IntParam>()->Value());
+            groupDepths.block(0, group, inDataMat.rows(), 1) = simplicalDepth(columnGroupMat, samples, seed);
             break;
         }
     }
@@ -29,12 +29,28 @@ public:
         return true;
     }
 
-    static Eigen::VectorXd halfSpaceDepth(Eigen::MatrixXd dataMatrix);
-    static Eigen::MatrixXd mahalanobisDepth(Eigen::MatrixXd dataMatrix);
+    /** Exact halfspace depth, i.e., the minimum number of points in a closed halfspace containing the point */
+    static Eigen::VectorXd halfSpaceDepth(const Eigen::MatrixXd& dataMatrix);
+
+    /**
+     * Random Tukey depth: upper bound of the halfspace depth from the halfspaces orthogonal to 'directionsCount'
+     * random directions. The cost is O(directionsCount * n log n) for all points, whereas the exact computation
+     * costs O(n^(d-1) log n) per point.
+     */
+    static Eigen::VectorXd approximateHalfSpaceDepth(
+        const Eigen::MatrixXd& dataMatrix, int directionsCount, unsigned int seed);
+
+    static Eigen::MatrixXd mahalanobisDepth(const Eigen::MatrixXd& dataMatrix);
+
+    /**
+     * Fraction of 'samplesCount' random bands, i.e., the per-column envelopes of 'samplesLength' random rows, that
+     * contain the point. The bands are shared by all points.
+     */
     static Eigen::VectorXd functionalDepth(
-        Eigen::MatrixXd dataMatrix, int samplesCount, int samplesLength, unsigned int seed);
+        const Eigen::MatrixXd& dataMatrix, int samplesCount, int samplesLength, unsigned int seed);
 
-    Eigen::VectorXd simplicalDepth(Eigen::MatrixXd dataMatrix, int samplesCount, unsigned int seed);
+    /** Fraction of 'samplesCount' random simplices that contain the point. The simplices are shared by all points. */
+    static Eigen::VectorXd simplicalDepth(const Eigen::MatrixXd& dataMatrix, int samplesCount, unsigned int seed);
 
     /** Constructor */
     DepthFunction();
@@ -64,9 +80,6 @@ private:
     /** compute function */
     bool apply(megamol::datatools::table::TableDataCall* inCall);
 
-    /** compute binomial coefficient */
-    static double binomialCoeff(int n, int k);
-
     /** Data output slot */
     CalleeSlot dataOutSlot;
 
@@ -88,6 +101,12 @@ private:
     /** Seed */
     ::megamol::core::param::ParamSlot randomSeed;
 
+    /** Approximate mode */
+    ::megamol::core::param::ParamSlot approximate;
+
+    /** Maximum number of samples in approximate mode */
+    ::megamol::core::param::ParamSlot sampleBudget;
+
     /** Hash of the current data */
     size_t datahash;
     size_t dataInHash;
@@ -7,6 +7,9 @@
 #include "MDSProjection.h"
 #include <Eigen/Dense>
 #include <Eigen/SVD>
+#include <numeric>
+#include <omp.h>
+#include <random>
 #include <set>
 #include <sstream>
 
@@ -21,6 +24,9 @@ MDSProjection::MDSProjection()
         , dataOutSlot("dataOut", "Ouput")
         , dataInSlot("dataIn", "Input")
         , reduceToNSlot("nComponents", "Number of components (dimensions) to keep")
+        , landmarksSlot("landmarks", "Number of randomly chosen rows the classic MDS is computed for, all other rows "
+                                     "are placed relative to them. Set to 0 to use all rows, which needs memory "
+                                     "quadratic in the number of rows")
         , datahash(0)
         , dataInHash(0)
         , columnInfos() {
@@ -36,6 +42,9 @@ MDSProjection::MDSProjection()
 
     reduceToNSlot << new ::megamol::core::param::IntParam(2);
     this->MakeSlotAvailable(&reduceToNSlot);
+
+    landmarksSlot << new ::megamol::core::param::IntParam(1000, 0);
+    this->MakeSlotAvailable(&landmarksSlot);
 }
 
 MDSProjection::~MDSProjection() {
@@ -116,7 +125,7 @@ bool MDSProjection::getHashCallback(core::Call& c) {
 bool megamol::infovis::MDSProjection::dataProjection(megamol::datatools::table::TableDataCall* inCall) {
     // Test if inData has changed and if slots have changed
     if (this->dataInHash == inCall->DataHash()) {
-        if (!reduceToNSlot.IsDirty()) {
+        if (!reduceToNSlot.IsDirty() && !landmarksSlot.IsDirty()) {
             return true; // Nothing to do
         }
     }
@@ -133,18 +142,25 @@ bool megamol::infovis::MDSProjection::dataProjection(megamol::datatools::table::
         return false;
     }
 
-    // Load data in a Matrix
-    Eigen::MatrixXd inDataMat = Eigen::MatrixXd(rowsCount, columnCount);
-    for (int row = 0; row < rowsCount; row++) {
-        for (int col = 0; col < columnCount; col++) {
-            inDataMat(row, col) = inData[row * columnCount + col];
+    size_t landmarkCount = this->landmarksSlot.Param<core::param::IntParam>()->Value();
+
+    Eigen::MatrixXd result;
+    if (landmarkCount == 0 || landmarkCount >= rowsCount) {
+        // Load data in a Matrix
+        Eigen::MatrixXd inDataMat = Eigen::MatrixXd(rowsCount, columnCount);
+        for (int row = 0; row < rowsCount; row++) {
+            for (int col = 0; col < columnCount; col++) {
+                inDataMat(row, col) = inData[row * columnCount + col];
+            }
         }
-    }
 
-    // generate dissimilarity Matrix( squared euclidean Distance matrix)
-    Eigen::MatrixXd delta2 = euclideanDissimilarityMatrix(inDataMat).array().pow(2);
-    // compute MDS
-    Eigen::MatrixXd result = classicMds(delta2, outputDimCount);
+        // generate dissimilarity Matrix( squared euclidean Distance matrix)
+        Eigen::MatrixXd delta2 = euclideanDissimilarityMatrix(inDataMat).array().pow(2);
+        // compute MDS
+        result = classicMds(delta2, outputDimCount);
+    } else {
+        result = landmarkMds(inData, rowsCount, columnCount, outputDimCount, landmarkCount);
+    }
 
     // generate new columns
     this->columnInfos.clear();
@@ -170,6 +186,7 @@ bool megamol::infovis::MDSProjection::dataProjection(megamol::datatools::table::
     this->dataInHash = inCall->DataHash();
     this->datahash++;
     reduceToNSlot.ResetDirty();
+    landmarksSlot.ResetDirty();
 
     return true;
 }
@@ -228,6 +245,78 @@ Eigen::MatrixXd megamol::infovis::MDSProjection::classicMds(
     return result;
 }
 
+Eigen::MatrixXd megamol::infovis::MDSProjection::landmarkMds(const float* data, size_t rowsCount, size_t columnCount,
+    int outputDimension, size_t landmarkCount, unsigned int seed) {
+    landmarkCount = std::min(landmarkCount, rowsCount);
+    const int64_t rows = static_cast<int64_t>(rowsCount);
+    const int64_t landmarks = static_cast<int64_t>(landmarkCount);
+
+    // Random landmarks, partial Fisher-Yates shuffle
+    std::vector<size_t> indices(rowsCount);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < landmarkCount; i++) {
+        std::uniform_int_distribution<size_t> dist(i, rowsCount - 1);
+        std::swap(indices[i], indices[dist(rng)]);
+    }
+    MatrixXd L(landmarkCount, columnCount);
+    for (size_t i = 0; i < landmarkCount; i++) {
+        for (size_t col = 0; col < columnCount; col++) {
+            L(i, col) = data[indices[i] * columnCount + col];
+        }
+    }
+    std::vector<size_t>().swap(indices);
+
+    // Squared dissimilarities of the landmarks
+    MatrixXd delta2(landmarkCount, landmarkCount);
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int64_t i = 0; i < landmarks; i++) {
+        for (int64_t j = 0; j < landmarks; j++) {
+            delta2(i, j) = (L.row(i) - L.row(j)).squaredNorm();
+        }
+    }
+
+    // Classic MDS of the landmarks, double centering without materializing the centering matrix
+    const VectorXd mean = delta2.colwise().mean().transpose();
+    const double totalMean = mean.mean();
+    MatrixXd B = -0.5 * ((delta2.colwise() - mean).rowwise() - mean.transpose()).array() - 0.5 * totalMean;
+    SelfAdjointEigenSolver<MatrixXd> eigSolver(B);
+    if (eigSolver.info() != Eigen::Success) {
+        return MatrixXd::Zero(rowsCount, outputDimension);
+    }
+
+    // Pseudo-inverse of the landmark coordinates from the largest eigenvalues, which come last. Dimensions without
+    // significantly positive eigenvalue are degenerate and collapse to zero.
+    MatrixXd pseudoInverse = MatrixXd::Zero(outputDimension, landmarkCount);
+    const double minEigVal = 1e-10 * std::max(eigSolver.eigenvalues()(landmarks - 1), 0.0);
+    for (int i = 0; i < outputDimension && i < landmarks; ++i) {
+        const double eigVal = eigSolver.eigenvalues()(landmarks - 1 - i);
+        if (eigVal > minEigVal && eigVal > 0.0) {
+            pseudoInverse.row(i) = eigSolver.eigenvectors().col(landmarks - 1 - i).transpose() / sqrt(eigVal);
+        }
+    }
+
+    // Triangulation of all rows
+    MatrixXd result(rowsCount, outputDimension);
+#pragma omp parallel
+    {
+        VectorXd x(columnCount);
+        VectorXd delta(landmarkCount);
+#pragma omp for schedule(static, 4096)
+        for (int64_t row = 0; row < rows; row++) {
+            for (size_t col = 0; col < columnCount; col++) {
+                x(col) = data[row * columnCount + col];
+            }
+            for (int64_t j = 0; j < landmarks; j++) {
+                delta(j) = (L.row(j).transpose() - x).squaredNorm();
+            }
+            result.row(row) = (-0.5 * pseudoInverse * (delta - mean)).transpose();
+        }
+    }
+
+    return result;
+}
+
 Eigen::MatrixXd megamol::infovis::MDSProjection::bMatrix(
     Eigen::MatrixXd X, Eigen::MatrixXd W, Eigen::MatrixXd dissimilarityMatrix) {
     assert(X.rows() == W.rows());
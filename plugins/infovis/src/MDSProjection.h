@@ -41,6 +41,14 @@ public:
 
     static Eigen::MatrixXd classicMds(Eigen::MatrixXd squaredDissimilarityMatrix, int outputDimension);
 
+    /**
+     * Landmark MDS (de Silva and Tenenbaum, 2004): classic MDS of 'landmarkCount' randomly chosen rows of the
+     * row-major 'data', all other rows are placed by distance-based triangulation. Memory is linear in the number of
+     * rows, apart from the landmarkCount x landmarkCount dissimilarity matrix.
+     */
+    static Eigen::MatrixXd landmarkMds(const float* data, size_t rowsCount, size_t columnCount, int outputDimension,
+        size_t landmarkCount, unsigned int seed = 42);
+
     static Eigen::MatrixXd smacofMds(Eigen::MatrixXd squaredDissimilarityMatrix, int outputDimension = 2,
         int countSteps = 100, Eigen::MatrixXd weightsMatrix = Eigen::MatrixXd::Ones(1, 1), double tolerance = 1e-3);
 
@@ -78,6 +86,9 @@ private:
     /** Parameter slot for target number of dimensions */
     ::megamol::core::param::ParamSlot reduceToNSlot;
 
+    /** Parameter slot for the number of landmarks */
+    ::megamol::core::param::ParamSlot landmarksSlot;
+
     /** ID of the current frame */
     // int frameID; //TODO: unknown
 
@@ -5,8 +5,9 @@
 #include "mmcore/param/IntParam.h"
 
 #include <Eigen/Dense>
-#include <Eigen/SVD>
-#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <omp.h>
 
 
 using namespace megamol;
@@ -21,8 +22,11 @@ PCAProjection::PCAProjection()
         , reduceToNSlot("nComponents", "Number of components (dimensions) to keep")
         , scaleSlot("scale", "Set to scale each column to unit variance")
         , centerSlot("center", "Set to shift the mean centroid to the origin")
+        , incrementalSlot("incremental", "Set to update the basis with the rows of every new frame instead of "
+                                         "computing it from the current frame only")
         , datahash(0)
         , dataInHash(0)
+        , dataInFrameID(std::numeric_limits<unsigned int>::max())
         , columnInfos() {
 
     this->dataInSlot.SetCompatibleCall<megamol::datatools::table::TableDataCallDescription>();
@@ -42,6 +46,9 @@ PCAProjection::PCAProjection()
 
     scaleSlot << new ::megamol::core::param::BoolParam(false);
     this->MakeSlotAvailable(&scaleSlot);
+
+    incrementalSlot << new ::megamol::core::param::BoolParam(false);
+    this->MakeSlotAvailable(&incrementalSlot);
 }
 
 
@@ -121,24 +128,77 @@ bool PCAProjection::getHashCallback(core::Call& c) {
     return true;
 }
 
+void megamol::infovis::PCAProjection::Moments::merge(const Moments& other) {
+    if (other.count == 0.0) {
+        return;
+    }
+    if (count == 0.0) {
+        *this = other;
+        return;
+    }
+    const double total = count + other.count;
+    const Eigen::VectorXd delta = other.mean - mean;
+    scatter += other.scatter + (count * other.count / total) * delta * delta.transpose();
+    mean += (other.count / total) * delta;
+    count = total;
+}
+
+megamol::infovis::PCAProjection::Moments megamol::infovis::PCAProjection::computeMoments(
+    const float* data, size_t rowsCount, size_t columnCount) {
+    // Blocks of rows turn the accumulation of outer products into cache-friendly matrix products
+    constexpr int64_t blockSize = 256;
+    const int64_t blockCount = (static_cast<int64_t>(rowsCount) + blockSize - 1) / blockSize;
+
+    std::vector<Moments> partial(omp_get_max_threads(), Moments(columnCount));
+#pragma omp parallel
+    {
+        Moments& local = partial[omp_get_thread_num()];
+        MatrixXd block(blockSize, columnCount);
+        Moments blockMoments(columnCount);
+
+#pragma omp for schedule(static)
+        for (int64_t b = 0; b < blockCount; b++) {
+            const int64_t begin = b * blockSize;
+            const int64_t n = std::min(blockSize, static_cast<int64_t>(rowsCount) - begin);
+            for (int64_t row = 0; row < n; row++) {
+                for (size_t col = 0; col < columnCount; col++) {
+                    block(row, col) = data[(begin + row) * columnCount + col];
+                }
+            }
+            auto rows = block.topRows(n);
+            blockMoments.count = static_cast<double>(n);
+            blockMoments.mean = rows.colwise().mean().transpose();
+            rows.rowwise() -= blockMoments.mean.transpose();
+            blockMoments.scatter.noalias() = rows.transpose() * rows;
+            local.merge(blockMoments);
+        }
+    }
+
+    Moments result(columnCount);
+    for (const auto& p : partial) {
+        result.merge(p);
+    }
+    return result;
+}
+
 bool megamol::infovis::PCAProjection::project(megamol::datatools::table::TableDataCall* inCall) {
 
     // check if inData has changed and if Slots have changed
-    if (this->dataInHash == inCall->DataHash()) {
-        if (!reduceToNSlot.IsDirty() && !scaleSlot.IsDirty() && !centerSlot.IsDirty()) {
+    if (this->dataInHash == inCall->DataHash() && this->dataInFrameID == inCall->GetFrameID()) {
+        if (!reduceToNSlot.IsDirty() && !scaleSlot.IsDirty() && !centerSlot.IsDirty() &&
+            !incrementalSlot.IsDirty()) {
             return true; // Nothing to do
         }
     }
 
-
     auto columnCount = inCall->GetColumnsCount();
-    auto column_infos = inCall->GetColumnsInfos();
     auto rowsCount = inCall->GetRowsCount();
     auto inData = inCall->GetData();
 
     unsigned int outputDimCount = this->reduceToNSlot.Param<core::param::IntParam>()->Value();
     bool center = this->centerSlot.Param<core::param::BoolParam>()->Value();
     bool scale = this->scaleSlot.Param<core::param::BoolParam>()->Value();
+    bool incremental = this->incrementalSlot.Param<core::param::BoolParam>()->Value();
 
 
     if (outputDimCount <= 0 || outputDimCount > columnCount) {
@@ -147,91 +207,93 @@ bool megamol::infovis::PCAProjection::project(megamol::datatools::table::TableDa
         return false;
     }
 
-    // Load data in a Matrix
-    Eigen::MatrixXd inDataMat = Eigen::MatrixXd(rowsCount, columnCount);
-    for (int row = 0; row < rowsCount; row++) {
-        for (int col = 0; col < columnCount; col++) {
-            inDataMat(row, col) = inData[row * columnCount + col];
-        }
+    // Accumulate the moments of the current frame, which is the only one outside of incremental mode. The table is
+    // never copied, the memory required is O(columnCount^2).
+    if (!incremental || incrementalSlot.IsDirty() || this->moments.mean.size() != columnCount) {
+        this->moments = Moments(columnCount);
+        this->accumulatedFrames.clear();
     }
-
-    // calculate mean for each column
-    Eigen::VectorXd mean_vector(columnCount);
-    mean_vector = inDataMat.colwise().mean();
-
-
-    // prepare data
-    if (center) {
-        // substract mean columnwise
-        for (int col = 0; col < columnCount; col++) {
-            inDataMat.col(col) -= Eigen::VectorXd::Constant(rowsCount, mean_vector(col));
-        }
+    if (this->accumulatedFrames.insert(std::make_pair(inCall->GetFrameID(), inCall->DataHash())).second) {
+        this->moments.merge(computeMoments(inData, rowsCount, columnCount));
     }
 
+    // calculate CovarianceMatrix
+    // if center is off: "R ggfortify" doesn't substract mean for the covariance matrix
+    MatrixXd covarianceMatrix = this->moments.scatter;
+    if (!center) {
+        covarianceMatrix += this->moments.count * this->moments.mean * this->moments.mean.transpose();
+    }
+    covarianceMatrix /= std::max(this->moments.count - 1.0, 1.0);
 
+    // scale data to unit variance by dividing by standard deviation
+    VectorXd stdDev = VectorXd::Ones(columnCount);
     if (scale) {
-        // scale data to unit variance by dividing by standard deviation
-        Eigen::VectorXd stdDev(columnCount);
+        stdDev = covarianceMatrix.diagonal().cwiseSqrt();
         for (int col = 0; col < columnCount; col++) {
-            stdDev(col) = sqrt(inDataMat.col(col).cwiseProduct(inDataMat.col(col)).sum() / (rowsCount - 1));
-            inDataMat.col(col) /= stdDev(col);
+            if (stdDev(col) == 0.0) {
+                stdDev(col) = 1.0;
+            }
         }
+        covarianceMatrix = stdDev.cwiseInverse().asDiagonal() * covarianceMatrix * stdDev.cwiseInverse().asDiagonal();
     }
 
-
-    // calculate CovarianceMatrix
-    MatrixXd covarianceMatrix = inDataMat;
-
-    /** if center is off: "R ggfortify" doesn't substract mean for the covariance matrix
-    //substract mean for cov Matrix
-    mean_vector = inDataMat.colwise().mean();
-    for (int col = 0; col < columnCount; col++) {
-        covarianceMatrix.col(col) -= Eigen::VectorXd::Constant(rowsCount, mean_vector(col));
-    }*/
-
-
-    covarianceMatrix = covarianceMatrix.transpose() * covarianceMatrix;
-    covarianceMatrix = covarianceMatrix / (float) (rowsCount - 1);
-
-
-    // calculate Eigenvalues and Eigenvectors
-    EigenSolver<MatrixXd> eigSolver(covarianceMatrix);
-
-    VectorXd eigVal = eigSolver.eigenvalues().real();
-    MatrixXd eigVec = eigSolver.eigenvectors().real();
-
-    // sort eigenvalues (with index): descending
-    // each eigenvalue represents the variance
-    typedef std::pair<float, int> eigenPair;
-    std::vector<eigenPair> sorted;
-    for (unsigned int i = 0; i < columnCount; ++i) {
-        sorted.push_back(std::make_pair(eigVal(i), i));
+    // calculate Eigenvalues and Eigenvectors, the covariance matrix is symmetric
+    SelfAdjointEigenSolver<MatrixXd> eigSolver(covarianceMatrix);
+    if (eigSolver.info() != Eigen::Success) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            _T("%hs: Failed to compute the principal components\n"), ClassName());
+        return false;
     }
-    std::sort(sorted.begin(), sorted.end(), [&sorted](eigenPair& a, eigenPair& b) { return a.first > b.first; });
 
-    // create Matrix out of sorted (and selected) eigenvectors
+    // create Matrix out of the eigenvectors of the largest eigenvalues, which come last. The sign of each eigenvector
+    // is fixed, such that incremental updates do not flip the projection.
     MatrixXd eigVecBasis = MatrixXd(columnCount, outputDimCount);
     for (unsigned int i = 0; i < outputDimCount; ++i) {
-        eigVecBasis.col(i) = eigVec.col(sorted[i].second);
+        eigVecBasis.col(i) = eigSolver.eigenvectors().col(columnCount - 1 - i);
+        Index maxIndex;
+        eigVecBasis.col(i).cwiseAbs().maxCoeff(&maxIndex);
+        if (eigVecBasis(maxIndex, i) < 0.0) {
+            eigVecBasis.col(i) *= -1.0;
+        }
     }
 
+    // calculate PCA as affine map of the original rows
+    const MatrixXd projection = eigVecBasis.transpose() * stdDev.cwiseInverse().asDiagonal();
+    const VectorXd offset = center ? VectorXd(-projection * this->moments.mean) : VectorXd::Zero(outputDimCount);
+
+    std::vector<double> minimas(outputDimCount, std::numeric_limits<double>::max());
+    std::vector<double> maximas(outputDimCount, std::numeric_limits<double>::lowest());
+    this->data.resize(rowsCount * outputDimCount);
+    const int64_t rows = static_cast<int64_t>(rowsCount);
+#pragma omp parallel
+    {
+        VectorXd x(columnCount);
+        VectorXd y(outputDimCount);
+        std::vector<double> localMin(minimas);
+        std::vector<double> localMax(maximas);
+
+#pragma omp for schedule(static)
+        for (int64_t row = 0; row < rows; row++) {
+            for (size_t col = 0; col < columnCount; col++) {
+                x(col) = inData[row * columnCount + col];
+            }
+            y.noalias() = projection * x;
+            y += offset;
+            for (unsigned int col = 0; col < outputDimCount; col++) {
+                this->data[row * outputDimCount + col] = static_cast<float>(y(col));
+                localMin[col] = std::min(localMin[col], y(col));
+                localMax[col] = std::max(localMax[col], y(col));
+            }
+        }
 
-    // calculate PCA
-    MatrixXd result = inDataMat * eigVecBasis;
-
-
-    //// center
-    // mean_vector = result.colwise().mean();
-    //// substract mean adjusted Matrix (shift to mean to zero)
-    // for (int col = 0; col < result.cols(); col++) {
-    //    result.col(col) -= Eigen::VectorXd::Constant(rowsCount, mean_vector(col));
-    //}
-
-
-    std::stringstream debug;
-    debug << std::endl << result << std::endl;
-
-    megamol::core::utility::log::Log::DefaultLog.WriteInfo(debug.str().c_str());
+#pragma omp critical
+        {
+            for (unsigned int col = 0; col < outputDimCount; col++) {
+                minimas[col] = std::min(minimas[col], localMin[col]);
+                maximas[col] = std::max(maximas[col], localMax[col]);
+            }
+        }
+    }
 
     // generate new columns
     this->columnInfos.clear();
@@ -241,25 +303,18 @@ bool megamol::infovis::PCAProjection::project(megamol::datatools::table::TableDa
         columnInfos[indexX]
             .SetName("PC" + std::to_string(indexX))
             .SetType(megamol::datatools::table::TableDataCall::ColumnType::QUANTITATIVE)
-            .SetMinimumValue(result.col(indexX).minCoeff())
-            .SetMaximumValue(result.col(indexX).maxCoeff());
-    }
-
-    // Result Matrix into Output
-    this->data.clear();
-    this->data.reserve(rowsCount * outputDimCount);
-
-    for (size_t row = 0; row < rowsCount; row++) {
-        for (size_t col = 0; col < outputDimCount; col++)
-            this->data.push_back(result(row, col));
+            .SetMinimumValue(rowsCount > 0 ? minimas[indexX] : 0.0)
+            .SetMaximumValue(rowsCount > 0 ? maximas[indexX] : 0.0);
     }
 
 
     this->dataInHash = inCall->DataHash();
+    this->dataInFrameID = inCall->GetFrameID();
     this->datahash++;
     reduceToNSlot.ResetDirty();
     scaleSlot.ResetDirty();
     centerSlot.ResetDirty();
+    incrementalSlot.ResetDirty();
 
     return true;
 }
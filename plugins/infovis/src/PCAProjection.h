@@ -1,5 +1,10 @@
 #pragma once
 
+#include <set>
+#include <utility>
+
+#include <Eigen/Dense>
+
 #include "datatools/table/TableDataCall.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
@@ -42,6 +47,26 @@ protected:
     void release() override;
 
 private:
+    /**
+     * Streaming statistics of table rows: row count, column means and scatter matrix (sum of the outer products of
+     * the centered rows). Statistics of disjoint sets of rows can be merged (Chan et al.), such that the memory does
+     * not depend on the number of rows.
+     */
+    struct Moments {
+        double count = 0.0;
+        Eigen::VectorXd mean;
+        Eigen::MatrixXd scatter;
+
+        explicit Moments(Eigen::Index columnCount = 0)
+                : mean(Eigen::VectorXd::Zero(columnCount))
+                , scatter(Eigen::MatrixXd::Zero(columnCount, columnCount)) {}
+
+        void merge(const Moments& other);
+    };
+
+    /** Computes the moments of row-major 'data' in a single parallel pass over blocks of rows */
+    static Moments computeMoments(const float* data, size_t rowsCount, size_t columnCount);
+
     /** Data callback */
     bool getDataCallback(core::Call& c);
 
@@ -59,6 +84,7 @@ private:
     ::megamol::core::param::ParamSlot reduceToNSlot;
     ::megamol::core::param::ParamSlot scaleSlot;
     ::megamol::core::param::ParamSlot centerSlot;
+    ::megamol::core::param::ParamSlot incrementalSlot;
 
     /** ID of the current frame */
     // int frameID; //TODO: unknown
@@ -66,6 +92,13 @@ private:
     /** Hash of the current data */
     size_t datahash;
     size_t dataInHash;
+    unsigned int dataInFrameID;
+
+    /** Moments of all rows the basis is computed from */
+    Moments moments;
+
+    /** Frames (ID and data hash) contained in the moments in incremental mode */
+    std::set<std::pair<unsigned int, size_t>> accumulatedFrames;
 
     /** Vector storing information about columns */
     std::vector<megamol::datatools::table::TableDataCall::ColumnInfo> columnInfos;
@@ -6,7 +6,6 @@
 #include "mmcore/param/IntParam.h"
 
 #include <sstream>
-#include <tsne.h>
 
 using namespace megamol;
 using namespace megamol::infovis;
@@ -21,9 +20,16 @@ TSNEProjection::TSNEProjection()
               "theta = 0 corresponds to standard, slow t-SNE, while theta = 1 corresponds to very crude approximations")
         , maxIterSlot("maxIter", "Set the maximum Iterations")
         , perplexitySlot("perplexity", "Set the Perplexity")
+        , learningRateSlot("learningRate", "Learning rate of the gradient descent. Set to 0 to derive it from the "
+                                           "number of rows, which speeds up the convergence for large tables")
+        , updateIntervalSlot("updateInterval",
+              "Publish the intermediate embedding every n iterations while the optimization continues in the "
+              "background. Set to 0 to block until the final embedding is available")
         , datahash(0)
         , dataInHash(0)
-        , columnInfos() {
+        , columnInfos()
+        , cancelWorker(false)
+        , hasPublished(false) {
 
     this->dataInSlot.SetCompatibleCall<megamol::datatools::table::TableDataCallDescription>();
     this->MakeSlotAvailable(&this->dataInSlot);
@@ -48,6 +54,12 @@ TSNEProjection::TSNEProjection()
 
     thetaSlot << new ::megamol::core::param::FloatParam(0.5);
     this->MakeSlotAvailable(&thetaSlot);
+
+    learningRateSlot << new ::megamol::core::param::FloatParam(0.0f, 0.0f);
+    this->MakeSlotAvailable(&learningRateSlot);
+
+    updateIntervalSlot << new ::megamol::core::param::IntParam(50, 0);
+    this->MakeSlotAvailable(&updateIntervalSlot);
 }
 
 TSNEProjection::~TSNEProjection() {
@@ -58,7 +70,9 @@ bool TSNEProjection::create() {
     return true;
 }
 
-void TSNEProjection::release() {}
+void TSNEProjection::release() {
+    stopWorker();
+}
 
 bool TSNEProjection::getDataCallback(core::Call& c) {
     try {
@@ -78,6 +92,7 @@ bool TSNEProjection::getDataCallback(core::Call& c) {
         bool finished = project(inCall);
         if (finished == false)
             return false;
+        fetchEmbedding();
 
         outCall->SetFrameCount(inCall->GetFrameCount());
         outCall->SetDataHash(this->datahash);
@@ -113,6 +128,7 @@ bool TSNEProjection::getHashCallback(core::Call& c) {
         inCall->SetFrameID(outCall->GetFrameID());
         if (!(*inCall)(1))
             return false;
+        fetchEmbedding();
 
         outCall->SetFrameCount(inCall->GetFrameCount());
         outCall->SetDataHash(this->datahash);
@@ -129,102 +145,136 @@ bool megamol::infovis::TSNEProjection::project(megamol::datatools::table::TableD
     // check if inData has changed and if Slots have changed
     if (this->dataInHash == inCall->DataHash()) {
         if (!reduceToNSlot.IsDirty() && !maxIterSlot.IsDirty() && !thetaSlot.IsDirty() && !perplexitySlot.IsDirty() &&
-            !randomSeedSlot.IsDirty()) {
+            !randomSeedSlot.IsDirty() && !learningRateSlot.IsDirty() && !updateIntervalSlot.IsDirty()) {
             return true; // Nothing to do
         }
     }
 
     auto columnCount = inCall->GetColumnsCount();
-    auto column_infos = inCall->GetColumnsInfos();
     auto rowsCount = inCall->GetRowsCount();
     auto inData = inCall->GetData();
 
-    unsigned int outputColumnCount = this->reduceToNSlot.Param<core::param::IntParam>()->Value();
+    BarnesHutTSNE::Settings settings;
+    settings.outputDims = this->reduceToNSlot.Param<core::param::IntParam>()->Value();
+    settings.seed = this->randomSeedSlot.Param<core::param::IntParam>()->Value();
+    settings.theta = this->thetaSlot.Param<core::param::FloatParam>()->Value();
+    settings.perplexity = this->perplexitySlot.Param<core::param::FloatParam>()->Value();
+    settings.learningRate = this->learningRateSlot.Param<core::param::FloatParam>()->Value();
     int maxIter = this->maxIterSlot.Param<core::param::IntParam>()->Value();
-    int randomSeed = this->randomSeedSlot.Param<core::param::IntParam>()->Value();
-    double theta = this->thetaSlot.Param<core::param::FloatParam>()->Value();
-    double perplexity = this->perplexitySlot.Param<core::param::FloatParam>()->Value();
+    int updateInterval = this->updateIntervalSlot.Param<core::param::IntParam>()->Value();
 
-
-    if (outputColumnCount <= 0 || outputColumnCount > columnCount) {
+    if (settings.outputDims <= 0 || settings.outputDims > columnCount ||
+        settings.outputDims > BarnesHutTSNE::maxDims) {
         megamol::core::utility::log::Log::DefaultLog.WriteError(
-            _T("%hs: No valid Dimension Count has been given\n"), ClassName());
+            _T("%hs: No valid Dimension Count has been given (at most %d)\n"), ClassName(), BarnesHutTSNE::maxDims);
         return false;
     }
 
-    // Load data in a double Array
-    double* inputData = (double*) malloc(columnCount * rowsCount * sizeof(double));
-    for (int col = 0; col < columnCount; col++) {
-        for (int row = 0; row < rowsCount; row++) {
-            inputData[row * columnCount + col] = inData[row * columnCount + col];
-            // inputData[col*rowsCount + row] = inData[row * columnCount + col];
-        }
+    // The optimization outlives the input data
+    stopWorker();
+    std::vector<float> input(inData, inData + columnCount * rowsCount);
+
+    if (updateInterval > 0) {
+        cancelWorker = false;
+        worker = std::thread(&TSNEProjection::computeEmbedding, this, std::move(input), rowsCount, columnCount,
+            settings, maxIter, updateInterval);
+    } else {
+        computeEmbedding(std::move(input), rowsCount, columnCount, settings, maxIter, 0);
     }
 
-    double* result = (double*) malloc(rowsCount * outputColumnCount * sizeof(double));
-    TSNE::run(inputData, rowsCount, columnCount, result, outputColumnCount, perplexity, theta, randomSeed, false,
-        maxIter, 250, 250);
+    this->dataInHash = inCall->DataHash();
+    reduceToNSlot.ResetDirty();
+    maxIterSlot.ResetDirty();
+    randomSeedSlot.ResetDirty();
+    thetaSlot.ResetDirty();
+    perplexitySlot.ResetDirty();
+    learningRateSlot.ResetDirty();
+    updateIntervalSlot.ResetDirty();
 
-    double* maximas = new double[outputColumnCount];
-    double* minimas = new double[outputColumnCount];
+    return true;
+}
+
+void megamol::infovis::TSNEProjection::computeEmbedding(std::vector<float> input, std::size_t rows, std::size_t cols,
+    BarnesHutTSNE::Settings settings, int maxIter, int updateInterval) {
+    try {
+        BarnesHutTSNE tsne;
+        if (!tsne.init(input.data(), rows, cols, settings)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                _T("%hs: Cannot embed %zu rows with the given parameters\n"), ClassName(), rows);
+            return;
+        }
+        std::vector<float>().swap(input);
 
-    for (int col = 0; col < outputColumnCount; col++) {
-        maximas[col] = result[col];
-        minimas[col] = result[col];
+        if (updateInterval > 0) {
+            publishEmbedding(tsne);
+        }
+        while (tsne.iteration() < maxIter) {
+            if (cancelWorker) {
+                return;
+            }
+            tsne.step();
+            if (updateInterval > 0 && tsne.iteration() % updateInterval == 0 && tsne.iteration() < maxIter) {
+                publishEmbedding(tsne);
+            }
+        }
+        publishEmbedding(tsne);
+    } catch (std::exception& ex) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            _T("%hs: Failed to compute the embedding: %hs\n"), ClassName(), ex.what());
     }
+}
 
-    for (int col = 0; col < outputColumnCount; col++) {
-        for (int row = 1; row < rowsCount; row++) {
+void megamol::infovis::TSNEProjection::publishEmbedding(const BarnesHutTSNE& tsne) {
+    const auto& result = tsne.embedding();
+    const std::size_t outputColumnCount = tsne.outputDims();
+    const std::size_t rowsCount = result.size() / outputColumnCount;
+
+    std::vector<double> maximas(result.begin(), result.begin() + outputColumnCount);
+    std::vector<double> minimas(maximas);
+    std::vector<float> embedding(result.size());
+    for (size_t row = 0; row < rowsCount; row++) {
+        for (size_t col = 0; col < outputColumnCount; col++) {
             double value = result[row * outputColumnCount + col];
             if (maximas[col] < value)
                 maximas[col] = value;
             if (minimas[col] > value)
                 minimas[col] = value;
+            embedding[row * outputColumnCount + col] = static_cast<float>(value);
         }
     }
 
-
-    // std::stringstream debug;
-    // debug << std::endl << result << std::endl;
-    // megamol::core::utility::log::Log::DefaultLog.WriteInfo(debug.str().c_str());
-
     // generate new columns
-    this->columnInfos.clear();
-    this->columnInfos.resize(outputColumnCount);
-
+    std::vector<megamol::datatools::table::TableDataCall::ColumnInfo> infos(outputColumnCount);
     for (int indexX = 0; indexX < outputColumnCount; indexX++) {
-        this->columnInfos[indexX]
+        infos[indexX]
             .SetName("TSNE" + std::to_string(indexX))
             .SetType(megamol::datatools::table::TableDataCall::ColumnType::QUANTITATIVE)
             .SetMinimumValue(minimas[indexX])
             .SetMaximumValue(maximas[indexX]);
     }
 
-    // Result Matrix into Output
-    this->data.clear();
-    this->data.reserve(rowsCount * outputColumnCount);
-
+    std::lock_guard<std::mutex> lock(publishedMutex);
+    publishedColumnInfos.swap(infos);
+    publishedData.swap(embedding);
+    hasPublished = true;
+}
 
-    for (size_t row = 0; row < rowsCount; row++) {
-        for (size_t col = 0; col < outputColumnCount; col++)
-            this->data.push_back(result[row * outputColumnCount + col]);
+void megamol::infovis::TSNEProjection::fetchEmbedding() {
+    std::lock_guard<std::mutex> lock(publishedMutex);
+    if (!hasPublished) {
+        return;
     }
-
-
-    this->dataInHash = inCall->DataHash();
+    this->columnInfos.swap(publishedColumnInfos);
+    this->data.swap(publishedData);
+    hasPublished = false;
     this->datahash++;
-    reduceToNSlot.ResetDirty();
-    maxIterSlot.ResetDirty();
-    randomSeedSlot.ResetDirty();
-    thetaSlot.ResetDirty();
-    perplexitySlot.ResetDirty();
-
-    free(result);
-    result = NULL;
-    free(inputData);
-    inputData = NULL;
-    delete[] maximas;
-    delete[] minimas;
+}
 
-    return true;
+void megamol::infovis::TSNEProjection::stopWorker() {
+    if (worker.joinable()) {
+        cancelWorker = true;
+        worker.join();
+    }
+    std::lock_guard<std::mutex> lock(publishedMutex);
+    hasPublished = false;
 }
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "BarnesHutTSNE.h"
 #include "datatools/table/TableDataCall.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
@@ -50,6 +55,22 @@ private:
 
     bool project(megamol::datatools::table::TableDataCall* inCall);
 
+    /**
+     * Runs the optimization on a copy of the input table. If 'updateInterval' is larger than zero, the embedding is
+     * additionally published every 'updateInterval' iterations.
+     */
+    void computeEmbedding(std::vector<float> input, std::size_t rows, std::size_t cols,
+        BarnesHutTSNE::Settings settings, int maxIter, int updateInterval);
+
+    /** Hands the current embedding over to the callbacks */
+    void publishEmbedding(const BarnesHutTSNE& tsne);
+
+    /** Takes over the latest published embedding, if any, as output data */
+    void fetchEmbedding();
+
+    /** Cancels a running optimization and waits for it */
+    void stopWorker();
+
     /** Data output slot */
     CalleeSlot dataOutSlot;
 
@@ -62,6 +83,8 @@ private:
     ::megamol::core::param::ParamSlot thetaSlot;
     ::megamol::core::param::ParamSlot perplexitySlot;
     ::megamol::core::param::ParamSlot maxIterSlot;
+    ::megamol::core::param::ParamSlot learningRateSlot;
+    ::megamol::core::param::ParamSlot updateIntervalSlot;
 
     /** ID of the current frame */
     // int frameID; //TODO: unknown
@@ -75,6 +98,17 @@ private:
 
     /** Vector stroing the actual float data */
     std::vector<float> data;
+
+    /** Thread running the optimization in the background */
+    std::thread worker;
+
+    std::atomic<bool> cancelWorker;
+
+    /** Embedding published by the worker, guarded by publishedMutex */
+    std::mutex publishedMutex;
+    bool hasPublished;
+    std::vector<megamol::datatools::table::TableDataCall::ColumnInfo> publishedColumnInfos;
+    std::vector<float> publishedData;
 };
 
 } // namespace megamol::infovis
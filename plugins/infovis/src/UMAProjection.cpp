@@ -6,7 +6,9 @@
 
 #include "UMAProjection.h"
 
+#include <algorithm>
 #include <sstream>
+#include <thread>
 
 #include <umappp/Umap.hpp>
 
@@ -268,6 +270,9 @@ bool megamol::infovis::UMAProjection::project(megamol::datatools::table::TableDa
     umap.set_initialize(static_cast<umappp::InitMethod>(initialize));
     umap.set_negative_sample_rate(negativeSampleRate);
     umap.set_num_neighbors(nNeighbors);
+    // Neighbor search and optimization on all cores, unless OpenMP is disabled for this file (see CMakeLists.txt)
+    umap.set_num_threads(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+    umap.set_parallel_optimization(true);
     auto status = umap.run(dimCount, obsCount, inputData.data(), nDims, embeddingData.data(), 0);
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(_T("Epoch %d of %d; a: %lf b: %lf, obs: %d\n"),
         status.epoch(), status.num_epochs(), status.rparams.a, status.rparams.b, status.nobs());
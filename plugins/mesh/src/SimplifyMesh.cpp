@@ -4,6 +4,7 @@
 #include "mesh/TriangleMeshCall.h"
 
 #include "mmcore/param/FloatParam.h"
+#include "mmcore/param/IntParam.h"
 
 #include "mmcore/utility/DataHash.h"
 
@@ -17,10 +18,14 @@
 #include <CGAL/Polygon_mesh_processing/polygon_soup_to_polygon_mesh.h>
 #include <CGAL/Polygon_mesh_processing/repair_polygon_soup.h>
 
+#include <CGAL/Surface_mesh_simplification/Edge_collapse_visitor_base.h>
 #include <CGAL/Surface_mesh_simplification/Policies/Edge_collapse/Count_ratio_stop_predicate.h>
 #include <CGAL/Surface_mesh_simplification/edge_collapse.h>
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
@@ -35,11 +40,50 @@ typedef std::vector<std::size_t> CGAL_Polygon;
 namespace PMP = CGAL::Polygon_mesh_processing;
 namespace SMS = CGAL::Surface_mesh_simplification;
 
+namespace {
+/**
+ * Visitor recording all edge collapses, from which any intermediate simplification can be reconstructed
+ */
+template<typename collapse_t>
+class collapse_recorder : public SMS::Edge_collapse_visitor_base<Mesh> {
+public:
+    collapse_recorder(const Mesh& mesh, std::vector<collapse_t>& collapses) : mesh(mesh), collapses(collapses) {}
+
+    template<typename profile_t, typename placement_t>
+    void OnCollapsing(const profile_t&, const placement_t& placement) {
+        has_placement = static_cast<bool>(placement);
+        if (has_placement) {
+            this->placement = *placement;
+        }
+    }
+
+    template<typename profile_t>
+    void OnCollapsed(const profile_t& profile, const Mesh::Vertex_index kept) {
+        const auto removed = (kept == profile.v0()) ? profile.v1() : profile.v0();
+        const auto& position = has_placement ? placement : mesh.point(kept);
+
+        collapses.push_back(collapse_t{static_cast<unsigned int>(removed.idx()), static_cast<unsigned int>(kept.idx()),
+            {static_cast<float>(position.x()), static_cast<float>(position.y()), static_cast<float>(position.z())},
+            mesh.number_of_edges()});
+    }
+
+private:
+    const Mesh& mesh;
+    std::vector<collapse_t>& collapses;
+
+    bool has_placement = false;
+    Point placement;
+};
+} // namespace
+
 megamol::mesh::SimplifyMesh::SimplifyMesh()
         : mesh_lhs_slot("mesh_lhs_slot", "Simplified mesh.")
         , mesh_rhs_slot("mesh_rhs_slot", "Input surface mesh.")
         , stop_ratio("stop_ratio", "Ratio defining the number of resulting faces compared to the original mesh.")
-        , input_hash(SimplifyMesh::GUID()) {
+        , min_ratio("min_ratio", "Smallest ratio of the level-of-detail pyramid. Smaller stop ratios are clamped.")
+        , cache_size("cache_size", "Number of inputs for which the level-of-detail pyramid is kept.")
+        , input_hash(SimplifyMesh::GUID())
+        , pyramid_hash(SimplifyMesh::GUID()) {
 
     // Connect input slot
     this->mesh_rhs_slot.SetCompatibleCall<mesh::TriangleMeshCall::triangle_mesh_description>();
@@ -55,6 +99,12 @@ megamol::mesh::SimplifyMesh::SimplifyMesh()
     // Initialize parameter slots
     this->stop_ratio << new core::param::FloatParam(1.0f);
     this->MakeSlotAvailable(&this->stop_ratio);
+
+    this->min_ratio << new core::param::FloatParam(0.05f, 0.0f, 1.0f);
+    this->MakeSlotAvailable(&this->min_ratio);
+
+    this->cache_size << new core::param::IntParam(4, 1);
+    this->MakeSlotAvailable(&this->cache_size);
 }
 
 megamol::mesh::SimplifyMesh::~SimplifyMesh() {
@@ -128,16 +178,14 @@ bool megamol::mesh::SimplifyMesh::compute() {
         return false;
     }
 
-    bool input_changed = false;
+    const auto pyramid_hash = compute_pyramid_hash(tmc.DataHash());
 
-    if (compute_hash(tmc.DataHash()) != this->input_hash) {
+    if (pyramid_hash != this->pyramid_hash) {
         this->input.vertices = tmc.get_vertices();
         this->input.normals = tmc.get_normals();
         this->input.indices = tmc.get_indices();
 
-        this->input_hash = compute_hash(tmc.DataHash());
-
-        input_changed = true;
+        this->pyramid_hash = pyramid_hash;
     }
 
     // Set empty output when encountering empty input
@@ -146,96 +194,190 @@ bool megamol::mesh::SimplifyMesh::compute() {
         this->output.normals = nullptr;
         this->output.indices = nullptr;
 
-        input_changed = false;
-
         return true;
     }
 
     // Perform computation
-    if (input_changed) {
-        this->output.vertices = std::make_shared<std::vector<float>>();
-        this->output.normals = std::make_shared<std::vector<float>>();
-        this->output.indices = std::make_shared<std::vector<unsigned int>>();
+    if (compute_hash(pyramid_hash) != this->input_hash) {
+        this->input_hash = compute_hash(pyramid_hash);
 
-        // Create surface mesh from input triangles and bounding box
-        Mesh mesh;
+        // Get pyramid from cache, or build it if the input has not been simplified recently
+        std::shared_ptr<const pyramid_t> pyramid;
 
-        {
-            std::vector<Point> points;
-            std::vector<CGAL_Polygon> polygon_vec;
+        auto cached = std::find_if(this->pyramids.begin(), this->pyramids.end(),
+            [pyramid_hash](const auto& entry) { return entry.first == pyramid_hash; });
 
-            // Add input mesh to polygon soup
-            points.resize(this->input.vertices->size() / 3);
-            polygon_vec.resize(this->input.indices->size() / 3);
+        if (cached != this->pyramids.end()) {
+            this->pyramids.splice(this->pyramids.begin(), this->pyramids, cached);
+            pyramid = cached->second;
+        } else {
+            pyramid = build_pyramid();
 
-            for (std::size_t i = 0; i < points.size(); ++i) {
-                points[i] = Point((*this->input.vertices)[i * 3 + 0], (*this->input.vertices)[i * 3 + 1],
-                    (*this->input.vertices)[i * 3 + 2]);
+            if (pyramid == nullptr) {
+                return false;
             }
 
-            for (std::size_t i = 0; i < polygon_vec.size(); ++i) {
-                polygon_vec[i] = {(*this->input.indices)[i * 3 + 0], (*this->input.indices)[i * 3 + 1],
-                    (*this->input.indices)[i * 3 + 2]};
-            }
+            this->pyramids.emplace_front(pyramid_hash, pyramid);
+        }
 
-            // Create CGAL surface mesh from polygon soup
-            {
-                PMP::remove_isolated_points_in_polygon_soup(points, polygon_vec);
-                PMP::merge_duplicate_points_in_polygon_soup(points, polygon_vec);
-                PMP::duplicate_non_manifold_edges_in_polygon_soup(points, polygon_vec);
+        const auto max_pyramids = static_cast<std::size_t>(this->cache_size.Param<core::param::IntParam>()->Value());
 
-                if (!PMP::orient_polygon_soup(points, polygon_vec)) {
-                    megamol::core::utility::log::Log::DefaultLog.WriteError(
-                        "Error orienting the triangles to form a surface mesh. [%s, %s, line %d]\n", __FILE__,
-                        __FUNCTION__, __LINE__);
+        while (this->pyramids.size() > max_pyramids) {
+            this->pyramids.pop_back();
+        }
 
-                    return false;
-                }
+        extract_level(*pyramid, this->stop_ratio.Param<core::param::FloatParam>()->Value());
+    }
 
-                if (!PMP::is_polygon_soup_a_polygon_mesh(polygon_vec)) {
-                    megamol::core::utility::log::Log::DefaultLog.WriteError(
-                        "Cannot form a surface mesh from the input triangles. [%s, %s, line %d]\n", __FILE__,
-                        __FUNCTION__, __LINE__);
+    return true;
+}
 
-                    return false;
-                }
+std::shared_ptr<const megamol::mesh::SimplifyMesh::pyramid_t> megamol::mesh::SimplifyMesh::build_pyramid() const {
+    // Create surface mesh from input triangles and bounding box
+    Mesh mesh;
 
-                PMP::polygon_soup_to_polygon_mesh(points, polygon_vec, mesh);
-            }
-        }
+    {
+        std::vector<Point> points;
+        std::vector<CGAL_Polygon> polygon_vec;
 
-        // Simplify mesh
-        const auto stop_ratio = this->stop_ratio.Param<core::param::FloatParam>()->Value();
+        // Add input mesh to polygon soup
+        points.resize(this->input.vertices->size() / 3);
+        polygon_vec.resize(this->input.indices->size() / 3);
 
-        if (stop_ratio < 1.0f) {
-            SMS::Count_ratio_stop_predicate<Mesh> stop(stop_ratio);
-            SMS::edge_collapse(mesh, stop);
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            points[i] = Point((*this->input.vertices)[i * 3 + 0], (*this->input.vertices)[i * 3 + 1],
+                (*this->input.vertices)[i * 3 + 2]);
         }
 
-        // Create output
-        for (auto point_it = mesh.points().begin(); point_it != mesh.points().end(); ++point_it) {
-            this->output.vertices->push_back(static_cast<float>(point_it->cartesian(0)));
-            this->output.vertices->push_back(static_cast<float>(point_it->cartesian(1)));
-            this->output.vertices->push_back(static_cast<float>(point_it->cartesian(2)));
+        for (std::size_t i = 0; i < polygon_vec.size(); ++i) {
+            polygon_vec[i] = {(*this->input.indices)[i * 3 + 0], (*this->input.indices)[i * 3 + 1],
+                (*this->input.indices)[i * 3 + 2]};
         }
 
-        for (auto face_it = mesh.faces_begin(); face_it != mesh.faces_end(); ++face_it) {
-            const auto range = mesh.vertices_around_face(mesh.halfedge(*face_it));
+        // Create CGAL surface mesh from polygon soup
+        {
+            PMP::remove_isolated_points_in_polygon_soup(points, polygon_vec);
+            PMP::merge_duplicate_points_in_polygon_soup(points, polygon_vec);
+            PMP::duplicate_non_manifold_edges_in_polygon_soup(points, polygon_vec);
+
+            if (!PMP::orient_polygon_soup(points, polygon_vec)) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "Error orienting the triangles to form a surface mesh. [%s, %s, line %d]\n", __FILE__,
+                    __FUNCTION__, __LINE__);
+
+                return nullptr;
+            }
+
+            if (!PMP::is_polygon_soup_a_polygon_mesh(polygon_vec)) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "Cannot form a surface mesh from the input triangles. [%s, %s, line %d]\n", __FILE__,
+                    __FUNCTION__, __LINE__);
 
-            for (auto vert_it = range.begin(); vert_it != range.end(); ++vert_it) {
-                this->output.indices->push_back(vert_it->idx());
+                return nullptr;
             }
+
+            PMP::polygon_soup_to_polygon_mesh(points, polygon_vec, mesh);
         }
+    }
 
-        this->output.normals = nullptr;
+    // Store the initial mesh, whose vertex indices remain valid during simplification
+    auto pyramid = std::make_shared<pyramid_t>();
+
+    for (auto point_it = mesh.points().begin(); point_it != mesh.points().end(); ++point_it) {
+        pyramid->vertices.push_back(static_cast<float>(point_it->cartesian(0)));
+        pyramid->vertices.push_back(static_cast<float>(point_it->cartesian(1)));
+        pyramid->vertices.push_back(static_cast<float>(point_it->cartesian(2)));
     }
 
-    return true;
+    for (auto face_it = mesh.faces_begin(); face_it != mesh.faces_end(); ++face_it) {
+        const auto range = mesh.vertices_around_face(mesh.halfedge(*face_it));
+
+        for (auto vert_it = range.begin(); vert_it != range.end(); ++vert_it) {
+            pyramid->indices.push_back(vert_it->idx());
+        }
+    }
+
+    pyramid->num_edges = mesh.number_of_edges();
+
+    // Simplify mesh down to the smallest ratio, recording all collapses
+    const auto min_ratio = this->min_ratio.Param<core::param::FloatParam>()->Value();
+
+    if (min_ratio < 1.0f) {
+        collapse_recorder<pyramid_t::collapse_t> recorder(mesh, pyramid->collapses);
+
+        SMS::Count_ratio_stop_predicate<Mesh> stop(min_ratio);
+        SMS::edge_collapse(mesh, stop, CGAL::parameters::visitor(recorder));
+    }
+
+    return pyramid;
+}
+
+void megamol::mesh::SimplifyMesh::extract_level(const pyramid_t& pyramid, const float ratio) {
+    // Find the number of collapses after which the edge collapse would have stopped for the given ratio
+    std::size_t num_collapses = 0;
+
+    if (ratio < 1.0f) {
+        const auto last = std::partition_point(
+            pyramid.collapses.begin(), pyramid.collapses.end(), [&pyramid, ratio](const auto& collapse) {
+                return static_cast<double>(collapse.num_edges) / static_cast<double>(pyramid.num_edges) >= ratio;
+            });
+
+        num_collapses = std::min(
+            static_cast<std::size_t>(std::distance(pyramid.collapses.begin(), last)) + 1, pyramid.collapses.size());
+    }
+
+    // Determine the vertex each vertex has been merged into, by resolving the collapses backwards
+    const auto num_vertices = pyramid.vertices.size() / 3;
+
+    std::vector<unsigned int> merged(num_vertices);
+    std::iota(merged.begin(), merged.end(), 0u);
+
+    for (auto i = num_collapses; i-- > 0;) {
+        merged[pyramid.collapses[i].removed] = merged[pyramid.collapses[i].kept];
+    }
+
+    std::vector<float> positions(pyramid.vertices);
+
+    for (std::size_t i = 0; i < num_collapses; ++i) {
+        std::copy(pyramid.collapses[i].position.begin(), pyramid.collapses[i].position.end(),
+            positions.begin() + 3 * pyramid.collapses[i].kept);
+    }
+
+    // Create output, omitting collapsed triangles and unused vertices
+    this->output.vertices = std::make_shared<std::vector<float>>();
+    this->output.normals = nullptr;
+    this->output.indices = std::make_shared<std::vector<unsigned int>>();
+
+    std::vector<unsigned int> output_index(num_vertices, std::numeric_limits<unsigned int>::max());
+
+    for (std::size_t i = 0; i < pyramid.indices.size(); i += 3) {
+        const std::array<unsigned int, 3> triangle{
+            merged[pyramid.indices[i + 0]], merged[pyramid.indices[i + 1]], merged[pyramid.indices[i + 2]]};
+
+        if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0]) {
+            continue;
+        }
+
+        for (const auto vertex : triangle) {
+            if (output_index[vertex] == std::numeric_limits<unsigned int>::max()) {
+                output_index[vertex] = static_cast<unsigned int>(this->output.vertices->size() / 3);
+
+                this->output.vertices->insert(
+                    this->output.vertices->end(), positions.begin() + 3 * vertex, positions.begin() + 3 * vertex + 3);
+            }
+
+            this->output.indices->push_back(output_index[vertex]);
+        }
+    }
 }
 
-SIZE_T megamol::mesh::SimplifyMesh::compute_hash(const SIZE_T data_hash) const {
+SIZE_T megamol::mesh::SimplifyMesh::compute_pyramid_hash(const SIZE_T data_hash) const {
     return core::utility::DataHash(
-        SimplifyMesh::GUID(), data_hash, this->stop_ratio.Param<core::param::FloatParam>()->Value());
+        SimplifyMesh::GUID(), data_hash, this->min_ratio.Param<core::param::FloatParam>()->Value());
+}
+
+SIZE_T megamol::mesh::SimplifyMesh::compute_hash(const SIZE_T pyramid_hash) const {
+    return core::utility::DataHash(pyramid_hash, this->stop_ratio.Param<core::param::FloatParam>()->Value());
 }
 #else
 bool megamol::mesh::SimplifyMesh::create() {
@@ -16,13 +16,19 @@
 #include "mesh/MeshDataCall.h"
 
 #include <array>
+#include <list>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace megamol::mesh {
 /**
  * Module for simplifying a mesh.
  *
+ * The input mesh is collapsed once down to the smallest ratio of the level-of-detail pyramid, recording every edge
+ * collapse. Meshes for any ratio in between are then reconstructed by replaying the recorded collapses, without
+ * running the simplification again. Pyramids are cached for the most recently used inputs.
+ *
  * @author Alexander Straub
  */
 class SimplifyMesh : public core::Module {
@@ -101,8 +107,40 @@ private:
     /** Function to start the computation */
     bool compute();
 
-    /** Compute input hash */
-    SIZE_T compute_hash(SIZE_T data_hash) const;
+    /** Level-of-detail pyramid, represented by the initial mesh and the sequence of edge collapses */
+    struct pyramid_t {
+        struct collapse_t {
+            /** Vertex removed by the collapse */
+            unsigned int removed;
+
+            /** Vertex the removed one is merged into */
+            unsigned int kept;
+
+            /** New position of the kept vertex */
+            std::array<float, 3> position;
+
+            /** Number of edges after the collapse */
+            std::size_t num_edges;
+        };
+
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        std::size_t num_edges;
+
+        std::vector<collapse_t> collapses;
+    };
+
+    /** Build the pyramid for the current input */
+    std::shared_ptr<const pyramid_t> build_pyramid() const;
+
+    /** Reconstruct the simplified mesh of the given ratio from a pyramid */
+    void extract_level(const pyramid_t& pyramid, float ratio);
+
+    /** Compute hash of the pyramid for the given input */
+    SIZE_T compute_pyramid_hash(SIZE_T data_hash) const;
+
+    /** Compute output hash */
+    SIZE_T compute_hash(SIZE_T pyramid_hash) const;
 
     /** The slots for requesting data from this module, i.e., lhs connection */
     megamol::core::CalleeSlot mesh_lhs_slot;
@@ -112,6 +150,8 @@ private:
 
     /** Parameter slots */
     core::param::ParamSlot stop_ratio;
+    core::param::ParamSlot min_ratio;
+    core::param::ParamSlot cache_size;
 
     /** Input */
     struct input_t {
@@ -122,6 +162,11 @@ private:
 
     SIZE_T input_hash;
 
+    /** Pyramids of recent inputs, most recently used first */
+    std::list<std::pair<SIZE_T, std::shared_ptr<const pyramid_t>>> pyramids;
+
+    SIZE_T pyramid_hash;
+
     /** Output */
     struct output_t {
         std::shared_ptr<std::vector<float>> vertices;
@@ -1,14 +1,21 @@
 #include "WavefrontObjLoader.h"
 
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FilePathParam.h"
+#include "mmcore/utility/log/Log.h"
 
 megamol::mesh::WavefrontObjLoader::WavefrontObjLoader()
         : AbstractMeshDataSource()
         , m_version(0)
         , m_meta_data()
-        , m_filename_slot("Wavefront OBJ filename", "The name of the obj file to load") {
+        , m_filename_slot("Wavefront OBJ filename", "The name of the obj file to load")
+        , m_use_cache_slot("Use cache", "Reads the meshes from a binary cache next to the obj file, which is written "
+                                        "on the first load and replaced whenever the obj file changes") {
     this->m_filename_slot << new core::param::FilePathParam("");
     this->MakeSlotAvailable(&this->m_filename_slot);
+
+    this->m_use_cache_slot << new core::param::BoolParam(true);
+    this->MakeSlotAvailable(&this->m_use_cache_slot);
 }
 
 megamol::mesh::WavefrontObjLoader::~WavefrontObjLoader() {}
@@ -47,191 +54,61 @@ bool megamol::mesh::WavefrontObjLoader::getMeshDataCallback(core::Call& caller)
         auto vislib_filename = m_filename_slot.Param<core::param::FilePathParam>()->Value();
         std::string filename(vislib_filename.generic_string());
 
-        m_obj_model = std::make_shared<TinyObjModel>();
-
-        std::string warn;
-        std::string err;
-
-        bool ret = tinyobj::LoadObj(
-            &m_obj_model->attrib, &m_obj_model->shapes, &m_obj_model->materials, &warn, &err, filename.c_str());
-
-        if (!warn.empty()) {
-            std::cout << warn << std::endl;
-        }
-
-        if (!err.empty()) {
-            std::cerr << err << std::endl;
-        }
-
-        if (!ret) {
-            return false;
-        }
-
-        const bool has_normals = !m_obj_model->attrib.normals.empty();
-        const bool has_texcoords = !m_obj_model->attrib.texcoords.empty();
-
-        // size_t vertex_cnt = m_obj_model->shapes.size() * 3;
-        this->m_positions.clear();
-        this->m_normals.clear();
-        this->m_texcoords.clear();
-
-        std::array<float, 6> bbox;
-        bbox[0] = std::numeric_limits<float>::max();
-        bbox[1] = std::numeric_limits<float>::max();
-        bbox[2] = std::numeric_limits<float>::max();
-        bbox[3] = -std::numeric_limits<float>::max();
-        bbox[4] = -std::numeric_limits<float>::max();
-        bbox[5] = -std::numeric_limits<float>::max();
-
-        m_indices.resize(m_obj_model->shapes.size());
-        m_positions.resize(m_obj_model->shapes.size());
-        if (has_normals) {
-            this->m_normals.resize(m_obj_model->shapes.size());
-        }
-        if (has_texcoords) {
-            this->m_texcoords.resize(m_obj_model->shapes.size());
-        }
-
-        // Loop over shapes
-        for (size_t s = 0; s < m_obj_model->shapes.size(); s++) {
-            auto& mesh = m_obj_model->shapes[s].mesh;
-            auto& lines = m_obj_model->shapes[s].lines;
-
-            uint64_t vertex_cnt = 0;
-            if (!mesh.indices.empty()) {
-                // Loop over faces(polygon)
-                size_t index_offset = 0;
-
-                m_indices[s].resize(mesh.num_face_vertices.size() * 3);
-                m_positions[s].reserve(mesh.num_face_vertices.size() * 3 * 3);
-                if (has_normals) {
-                    this->m_normals[s].reserve(mesh.num_face_vertices.size() * 3 * 3);
-                }
-                if (has_texcoords) {
-                    this->m_texcoords[s].reserve(mesh.num_face_vertices.size() * 3 * 2);
-                }
-
-                for (size_t f = 0; f < mesh.num_face_vertices.size(); f++) {
-                    int fv = mesh.num_face_vertices[f];
-
-                    assert(fv == 3); // assume that triangulation was forced
-
-                    // Loop over vertices in the face.
-                    for (size_t v = 0; v < fv; v++) {
-                        // access to vertex
-                        tinyobj::index_t idx = mesh.indices[index_offset + v];
-                        tinyobj::real_t vx = m_obj_model->attrib.vertices[3 * idx.vertex_index + 0];
-                        tinyobj::real_t vy = m_obj_model->attrib.vertices[3 * idx.vertex_index + 1];
-                        tinyobj::real_t vz = m_obj_model->attrib.vertices[3 * idx.vertex_index + 2];
-
-                        bbox[0] = std::min(bbox[0], static_cast<float>(vx));
-                        bbox[1] = std::min(bbox[1], static_cast<float>(vy));
-                        bbox[2] = std::min(bbox[2], static_cast<float>(vz));
-                        bbox[3] = std::max(bbox[3], static_cast<float>(vx));
-                        bbox[4] = std::max(bbox[4], static_cast<float>(vy));
-                        bbox[5] = std::max(bbox[5], static_cast<float>(vz));
-
-                        m_indices[s][index_offset + v] = index_offset + v;
-
-                        auto current_position_ptr = &(m_obj_model->attrib.vertices[3 * idx.vertex_index]);
-                        m_positions[s].insert(m_positions[s].end(), current_position_ptr, current_position_ptr + 3);
-
-                        if (has_normals && idx.normal_index >= 0) {
-                            auto current_normal_ptr = &(m_obj_model->attrib.normals[3 * idx.normal_index]);
-                            m_normals[s].insert(m_normals[s].end(), current_normal_ptr, current_normal_ptr + 3);
-                        }
-
-                        if (has_texcoords && idx.texcoord_index >= 0) {
-                            auto current_texcoords_ptr = &(m_obj_model->attrib.texcoords[2 * idx.texcoord_index]);
-                            m_texcoords[s].insert(
-                                m_texcoords[s].end(), current_texcoords_ptr, current_texcoords_ptr + 2);
-                        }
-                    }
-                    index_offset += fv;
-                    // per-face material
-                    // m_obj_model->shapes[s].mesh.material_ids[f];
-                }
-
-                vertex_cnt = mesh.num_face_vertices.size() * 3;
-
-            } else {
-                // Loop over line
-                size_t index_offset = 0;
-
-                m_indices[s].resize(lines.num_line_vertices.size() * 2);
-                m_positions[s].reserve(lines.num_line_vertices.size() * 3);
-
-                for (size_t f = 0; f < lines.num_line_vertices.size(); f++) {
-                    // access to vertex
-                    tinyobj::index_t idx = lines.indices[index_offset];
-                    tinyobj::real_t vx = m_obj_model->attrib.vertices[3 * idx.vertex_index + 0];
-                    tinyobj::real_t vy = m_obj_model->attrib.vertices[3 * idx.vertex_index + 1];
-                    tinyobj::real_t vz = m_obj_model->attrib.vertices[3 * idx.vertex_index + 2];
-
-                    bbox[0] = std::min(bbox[0], static_cast<float>(vx));
-                    bbox[1] = std::min(bbox[1], static_cast<float>(vy));
-                    bbox[2] = std::min(bbox[2], static_cast<float>(vz));
-                    bbox[3] = std::max(bbox[3], static_cast<float>(vx));
-                    bbox[4] = std::max(bbox[4], static_cast<float>(vy));
-                    bbox[5] = std::max(bbox[5], static_cast<float>(vz));
-
-                    auto current_position_ptr = &(m_obj_model->attrib.vertices[3 * idx.vertex_index]);
-                    m_positions[s].insert(m_positions[s].end(), current_position_ptr, current_position_ptr + 3);
-
-                    // Loop over line segments
-                    int fv = lines.num_line_vertices[f];
-                    for (size_t v = 0; v < fv; v++) {
-                        m_indices[s][index_offset + v] = lines.indices[index_offset + v].vertex_index;
-                    }
-                    index_offset += fv;
-                    // per-face material
-                    // m_obj_model->shapes[s].mesh.material_ids[f];
-                }
-
-                vertex_cnt = lines.num_line_vertices.size();
+        // The meshes reference the buffers of the model, which are about to be replaced
+        clearMeshAccessCollection();
+
+        const bool use_cache = m_use_cache_slot.Param<core::param::BoolParam>()->Value();
+        if (!use_cache || !WavefrontObjParser::readCache(vislib_filename, m_obj_model)) {
+            std::string error;
+            if (!WavefrontObjParser::parse(vislib_filename, m_obj_model, error)) {
+                core::utility::log::Log::DefaultLog.WriteError(
+                    "[WavefrontObjLoader] Failed to load %s: %s", filename.c_str(), error.c_str());
+                m_obj_model.shapes.clear();
+                return false;
             }
+            if (use_cache && !WavefrontObjParser::writeCache(vislib_filename, m_obj_model)) {
+                core::utility::log::Log::DefaultLog.WriteWarn("[WavefrontObjLoader] Failed to write cache %s",
+                    WavefrontObjParser::getCachePath(vislib_filename).generic_string().c_str());
+            }
+        }
 
-            const auto pos_ptr = m_positions[s].data();
+        for (auto& shape : m_obj_model.shapes) {
+            const auto vertex_cnt = shape.positions.size() / 3;
             std::vector<MeshDataAccessCollection::VertexAttribute> mesh_attributes;
 
-            mesh_attributes.emplace_back(MeshDataAccessCollection::VertexAttribute{reinterpret_cast<uint8_t*>(pos_ptr),
+            mesh_attributes.emplace_back(MeshDataAccessCollection::VertexAttribute{
+                reinterpret_cast<uint8_t*>(shape.positions.data()),
                 3 * vertex_cnt * MeshDataAccessCollection::getByteSize(MeshDataAccessCollection::FLOAT), 3,
                 MeshDataAccessCollection::FLOAT, 12, 0, MeshDataAccessCollection::AttributeSemanticType::POSITION});
 
-            if (has_normals) {
-                const auto normal_ptr = m_normals[s].data();
-
+            if (!shape.normals.empty()) {
                 mesh_attributes.emplace_back(MeshDataAccessCollection::VertexAttribute{
-                    reinterpret_cast<uint8_t*>(normal_ptr),
+                    reinterpret_cast<uint8_t*>(shape.normals.data()),
                     3 * vertex_cnt * MeshDataAccessCollection::getByteSize(MeshDataAccessCollection::FLOAT), 3,
                     MeshDataAccessCollection::FLOAT, 12, 0, MeshDataAccessCollection::AttributeSemanticType::NORMAL});
             }
 
-            if (has_texcoords) {
-                const auto texcoord_ptr = m_texcoords[s].data();
+            if (!shape.texcoords.empty()) {
                 mesh_attributes.emplace_back(MeshDataAccessCollection::VertexAttribute{
-                    reinterpret_cast<uint8_t*>(texcoord_ptr),
+                    reinterpret_cast<uint8_t*>(shape.texcoords.data()),
                     2 * vertex_cnt * MeshDataAccessCollection::getByteSize(MeshDataAccessCollection::FLOAT), 2,
                     MeshDataAccessCollection::FLOAT, 8, 0, MeshDataAccessCollection::AttributeSemanticType::TEXCOORD});
             }
 
             MeshDataAccessCollection::IndexData mesh_indices;
-            mesh_indices.data = reinterpret_cast<uint8_t*>(m_indices[s].data());
+            mesh_indices.data = reinterpret_cast<uint8_t*>(shape.indices.data());
             mesh_indices.byte_size =
-                m_indices[s].size() * MeshDataAccessCollection::getByteSize(MeshDataAccessCollection::UNSIGNED_INT);
+                shape.indices.size() * MeshDataAccessCollection::getByteSize(MeshDataAccessCollection::UNSIGNED_INT);
             mesh_indices.type = MeshDataAccessCollection::UNSIGNED_INT;
 
             // TODO add file name?
-            std::string identifier = m_obj_model->shapes[s].name;
-            if (!mesh.indices.empty()) {
-                m_mesh_access_collection.first->addMesh(
-                    identifier, mesh_attributes, mesh_indices, MeshDataAccessCollection::PrimitiveType::TRIANGLES);
-            } else {
-                m_mesh_access_collection.first->addMesh(identifier, mesh_attributes, mesh_indices);
-            }
-            m_mesh_access_collection.second.push_back(identifier);
+            const auto primitive_type = shape.lines ? MeshDataAccessCollection::PrimitiveType::LINES
+                                                    : MeshDataAccessCollection::PrimitiveType::TRIANGLES;
+            m_mesh_access_collection.first->addMesh(shape.name, mesh_attributes, mesh_indices, primitive_type);
+            m_mesh_access_collection.second.push_back(shape.name);
         }
 
+        const auto& bbox = m_obj_model.bbox;
         m_meta_data.m_bboxs.SetBoundingBox(bbox[0], bbox[1], bbox[2], bbox[3], bbox[4], bbox[5]);
         m_meta_data.m_bboxs.SetClipBox(bbox[0], bbox[1], bbox[2], bbox[3], bbox[4], bbox[5]);
         m_meta_data.m_frame_cnt = 1;
@@ -7,8 +7,7 @@
 
 #pragma once
 
-#include <tiny_obj_loader.h>
-
+#include "WavefrontObjParser.h"
 #include "mesh/AbstractMeshDataSource.h"
 #include "mesh/MeshCalls.h"
 #include "mesh/MeshDataAccessCollection.h"
@@ -74,46 +73,23 @@ protected:
     void release() override;
 
 private:
-    struct TinyObjModel {
-        tinyobj::attrib_t attrib;
-        std::vector<tinyobj::shape_t> shapes;
-        std::vector<tinyobj::material_t> materials;
-    };
-
     uint32_t m_version;
 
     /**
-     * Representation of obj model as loaded by tinyobjloader
-     */
-    std::shared_ptr<TinyObjModel> m_obj_model;
-
-    /**
-     * Internal storage for unpacked positions, i.e one position per vertex, three vertices per triangle
-     */
-    std::vector<std::vector<float>> m_positions;
-
-    /**
-     * Internal storage for unpacked normals, i.e one normal per vertex, three vertices per triangle
+     * Meshes of the obj file, one index buffer and set of vertex attributes per shape
      */
-    std::vector<std::vector<float>> m_normals;
-
-    /**
-     * Internal storage for unpacked texcoords, i.e one texcoord per vertex, three vertices per triangle
-     */
-    std::vector<std::vector<float>> m_texcoords;
-
-    /**
-     *
-     */
-    std::vector<std::vector<unsigned int>> m_indices;
+    WavefrontObjParser::Model m_obj_model;
 
     /**
      * Meta data for communicating data updates, as well as data size
      */
     core::Spatial3DMetaData m_meta_data;
 
-    /** The gltf file name */
+    /** The obj file name */
     core::param::ParamSlot m_filename_slot;
+
+    /** Whether to read and write the binary cache next to the obj file */
+    core::param::ParamSlot m_use_cache_slot;
 };
 
 } // namespace megamol::mesh
@@ -0,0 +1,820 @@
+/*
+ * WavefrontObjParser.cpp
+ *
+ * Copyright (C) 2023 by Universitaet Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#include "WavefrontObjParser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+#include <omp.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else /* _WIN32 */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+
+namespace megamol::mesh {
+
+namespace {
+
+constexpr std::uint32_t InvalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+constexpr std::uint32_t CacheMagic = 0x434a424f; // "OBJC"
+constexpr std::uint32_t CacheVersion = 1;
+
+/** Minimum number of bytes per chunk, to keep the overhead of small files low */
+constexpr std::size_t MinChunkSize = 1 << 16;
+
+/** Position, texture coordinate and normal index of a polygon corner */
+struct Corner {
+    std::uint32_t position;
+    std::uint32_t texcoord;
+    std::uint32_t normal;
+
+    bool operator==(const Corner& other) const {
+        return position == other.position && texcoord == other.texcoord && normal == other.normal;
+    }
+};
+
+struct CornerHash {
+    std::size_t operator()(const Corner& corner) const {
+        std::uint64_t hash = corner.position;
+        hash = hash * 0x9e3779b97f4a7c15ull + corner.texcoord;
+        hash = hash * 0x9e3779b97f4a7c15ull + corner.normal;
+        return static_cast<std::size_t>(hash ^ (hash >> 32));
+    }
+};
+
+/** Consecutive faces and lines of a chunk belonging to the same shape */
+struct Segment {
+    /** False for the first segment of a chunk, which continues the shape of the previous chunk */
+    bool startsShape = false;
+    std::string name;
+
+    /** Three corners per triangle */
+    std::vector<Corner> triangles;
+
+    /** Two corners per line segment */
+    std::vector<Corner> lines;
+};
+
+struct Chunk {
+    const char* begin;
+    const char* end;
+
+    std::size_t positionCount = 0;
+    std::size_t normalCount = 0;
+    std::size_t texcoordCount = 0;
+
+    std::vector<Segment> segments;
+    std::string error;
+};
+
+/** Shape as it appears in the file, made up of segments of one or more chunks */
+struct ShapeSource {
+    std::string name;
+    std::vector<const Segment*> segments;
+};
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* skipSpace(const char* pos, const char* end) {
+    while (pos != end && isSpace(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
+
+const char* skipToken(const char* pos, const char* end) {
+    while (pos != end && !isSpace(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
+
+/** Answers the keyword at the start of a line, e.g. "v" or "f" */
+std::string_view keywordOf(const char* line, const char* end) {
+    return std::string_view(line, skipToken(line, end) - line);
+}
+
+/** Parses up to 'count' floats, of which the first 'required' ones must be present. Missing ones are set to zero. */
+bool parseFloats(const char* pos, const char* end, float* values, int count, int required) {
+    for (int i = 0; i < count; ++i) {
+        pos = skipSpace(pos, end);
+        if (pos != end && *pos == '+') {
+            ++pos;
+        }
+        const auto result = std::from_chars(pos, end, values[i]);
+        if (result.ec != std::errc()) {
+            values[i] = 0.0f;
+            if (i < required) {
+                return false;
+            }
+        }
+        pos = result.ptr;
+    }
+    return true;
+}
+
+/**
+ * Resolves a one-based or negative (relative) OBJ index to a zero-based index, given the number of elements declared
+ * so far. An empty token resolves to InvalidIndex.
+ */
+bool parseIndex(const char*& pos, const char* end, std::size_t declared, std::uint32_t& index) {
+    if (pos == end || *pos == '/' || isSpace(*pos)) {
+        index = InvalidIndex;
+        return true;
+    }
+
+    std::int64_t value = 0;
+    const auto result = std::from_chars(pos, end, value);
+    if (result.ec != std::errc() || value == 0) {
+        return false;
+    }
+    pos = result.ptr;
+
+    const std::int64_t resolved = value > 0 ? value - 1 : static_cast<std::int64_t>(declared) + value;
+    if (resolved < 0 || resolved >= static_cast<std::int64_t>(InvalidIndex)) {
+        return false;
+    }
+    index = static_cast<std::uint32_t>(resolved);
+    return true;
+}
+
+/** Parses corners of the form "v", "v/vt", "v//vn" or "v/vt/vn" up to the end of the line */
+bool parseCorners(const char* pos, const char* end, const std::size_t declared[3], std::vector<Corner>& corners) {
+    corners.clear();
+    for (pos = skipSpace(pos, end); pos != end; pos = skipSpace(pos, end)) {
+        Corner corner;
+        if (!parseIndex(pos, end, declared[0], corner.position) || corner.position == InvalidIndex) {
+            return false;
+        }
+        corner.texcoord = InvalidIndex;
+        corner.normal = InvalidIndex;
+        if (pos != end && *pos == '/') {
+            ++pos;
+            if (!parseIndex(pos, end, declared[1], corner.texcoord)) {
+                return false;
+            }
+            if (pos != end && *pos == '/') {
+                ++pos;
+                if (!parseIndex(pos, end, declared[2], corner.normal)) {
+                    return false;
+                }
+            }
+        }
+        if (pos != end && !isSpace(*pos)) {
+            return false;
+        }
+        corners.push_back(corner);
+    }
+    return true;
+}
+
+/** Calls 'func' for every non-empty line of a chunk, passing begin and end of the line without leading whitespace */
+template<typename Func>
+void forEachLine(const Chunk& chunk, Func func) {
+    const char* pos = chunk.begin;
+    while (pos != chunk.end) {
+        const char* end = static_cast<const char*>(std::memchr(pos, '\n', chunk.end - pos));
+        end = end != nullptr ? end : chunk.end;
+        const char* line = skipSpace(pos, end);
+        if (line != end && *line != '#' && !func(line, end)) {
+            return;
+        }
+        pos = end != chunk.end ? end + 1 : end;
+    }
+}
+
+/** Counts the vertex data declared in a chunk */
+void countChunk(Chunk& chunk) {
+    forEachLine(chunk, [&](const char* line, const char* end) {
+        const auto keyword = keywordOf(line, end);
+        if (keyword == "v") {
+            ++chunk.positionCount;
+        } else if (keyword == "vn") {
+            ++chunk.normalCount;
+        } else if (keyword == "vt") {
+            ++chunk.texcoordCount;
+        }
+        return true;
+    });
+}
+
+/**
+ * Parses a chunk, storing its vertex data at the given offsets of the global arrays and collecting its faces and
+ * lines.
+ */
+void parseChunk(Chunk& chunk, std::size_t positionOffset, std::size_t normalOffset, std::size_t texcoordOffset,
+    float* positions, float* normals, float* texcoords) {
+    std::size_t declared[3] = {positionOffset, texcoordOffset, normalOffset};
+    std::vector<Corner> corners;
+
+    chunk.segments.emplace_back();
+
+    forEachLine(chunk, [&](const char* line, const char* end) {
+        const auto keyword = keywordOf(line, end);
+        const char* args = line + keyword.size();
+
+        bool valid = true;
+        if (keyword == "v") {
+            valid = parseFloats(args, end, positions + 3 * declared[0]++, 3, 3);
+        } else if (keyword == "vt") {
+            // The optional third texture coordinate is ignored
+            valid = parseFloats(args, end, texcoords + 2 * declared[1]++, 2, 1);
+        } else if (keyword == "vn") {
+            valid = parseFloats(args, end, normals + 3 * declared[2]++, 3, 3);
+        } else if (keyword == "f") {
+            valid = parseCorners(args, end, declared, corners) && corners.size() >= 3;
+            if (valid) {
+                auto& triangles = chunk.segments.back().triangles;
+                for (std::size_t i = 2; i < corners.size(); ++i) {
+                    triangles.push_back(corners[0]);
+                    triangles.push_back(corners[i - 1]);
+                    triangles.push_back(corners[i]);
+                }
+            }
+        } else if (keyword == "l") {
+            valid = parseCorners(args, end, declared, corners) && corners.size() >= 2;
+            if (valid) {
+                auto& lines = chunk.segments.back().lines;
+                for (std::size_t i = 1; i < corners.size(); ++i) {
+                    lines.push_back(corners[i - 1]);
+                    lines.push_back(corners[i]);
+                }
+            }
+        } else if (keyword == "o" || keyword == "g") {
+            auto& segment = chunk.segments.emplace_back();
+            segment.startsShape = true;
+            const char* name = skipSpace(args, end);
+            const char* nameEnd = end;
+            while (nameEnd != name && isSpace(nameEnd[-1])) {
+                --nameEnd;
+            }
+            segment.name.assign(name, nameEnd);
+        }
+
+        if (!valid) {
+            chunk.error = "Invalid line \"" + std::string(line, end) + "\"";
+        }
+        return valid;
+    });
+}
+
+/** Splits a buffer into roughly equally sized chunks of whole lines */
+std::vector<Chunk> splitIntoChunks(const char* data, std::size_t size) {
+    const std::size_t targetCount = static_cast<std::size_t>(omp_get_max_threads()) * 4;
+    const std::size_t chunkSize = std::max(MinChunkSize, size / targetCount + 1);
+
+    std::vector<Chunk> chunks;
+    const char* pos = data;
+    const char* const end = data + size;
+    while (pos != end) {
+        const char* chunkEnd = end;
+        if (static_cast<std::size_t>(end - pos) > chunkSize) {
+            const auto* newline = static_cast<const char*>(std::memchr(pos + chunkSize, '\n', end - pos - chunkSize));
+            chunkEnd = newline != nullptr ? newline + 1 : end;
+        }
+        chunks.push_back(Chunk{pos, chunkEnd});
+        pos = chunkEnd;
+    }
+    return chunks;
+}
+
+/**
+ * Builds a shape from the given corners, creating one vertex per distinct combination of position, texture
+ * coordinate and normal. Missing normals and texture coordinates are set to zero.
+ *
+ * The parts are deduplicated independently, in parallel if 'parallel' is set, and then merged in order. This yields
+ * the same vertices in the same order as deduplicating all corners at once, but only the distinct corners of each
+ * part pass the sequential merge.
+ */
+void buildShape(const std::vector<const std::vector<Corner>*>& parts, const std::vector<float>& positions,
+    const std::vector<float>& normals, const std::vector<float>& texcoords, WavefrontObjParser::Shape& shape,
+    bool parallel) {
+    std::size_t cornerCount = 0;
+    bool hasNormals = false;
+    bool hasTexcoords = false;
+    for (const auto* part : parts) {
+        cornerCount += part->size();
+        for (const auto& corner : *part) {
+            hasNormals |= corner.normal != InvalidIndex;
+            hasTexcoords |= corner.texcoord != InvalidIndex;
+        }
+    }
+
+    // Without parallelism, all corners form a single part, which needs no merge
+    const auto partCount = parallel ? static_cast<std::int64_t>(parts.size()) : std::int64_t(1);
+    std::vector<std::size_t> indexOffsets(partCount + 1, 0);
+    for (std::int64_t i = 0; i < partCount; ++i) {
+        indexOffsets[i + 1] = indexOffsets[i] + (parallel ? parts[i]->size() : cornerCount);
+    }
+
+    // Distinct corners of each part in order of their first use, and the local vertex index of every corner
+    std::vector<std::vector<Corner>> partVertices(partCount);
+    shape.indices.resize(cornerCount);
+#pragma omp parallel for schedule(dynamic) if (parallel)
+    for (std::int64_t i = 0; i < partCount; ++i) {
+        const std::size_t begin = parallel ? i : 0;
+        const std::size_t end = parallel ? i + 1 : parts.size();
+        std::unordered_map<Corner, std::uint32_t, CornerHash> vertices;
+        vertices.reserve(indexOffsets[i + 1] - indexOffsets[i]);
+        std::uint32_t* indices = shape.indices.data() + indexOffsets[i];
+        for (std::size_t p = begin; p < end; ++p) {
+            for (const auto& corner : *parts[p]) {
+                const auto [it, inserted] =
+                    vertices.try_emplace(corner, static_cast<std::uint32_t>(vertices.size()));
+                if (inserted) {
+                    partVertices[i].push_back(corner);
+                }
+                *indices++ = it->second;
+            }
+        }
+    }
+
+    // Merge the distinct corners of all parts and map the local vertex indices to the merged ones
+    std::vector<Corner> corners;
+    if (partCount == 1) {
+        corners = std::move(partVertices[0]);
+    } else {
+        std::vector<std::vector<std::uint32_t>> remap(partCount);
+        std::unordered_map<Corner, std::uint32_t, CornerHash> vertices;
+        for (std::int64_t i = 0; i < partCount; ++i) {
+            remap[i].reserve(partVertices[i].size());
+            for (const auto& corner : partVertices[i]) {
+                const auto [it, inserted] = vertices.try_emplace(corner, static_cast<std::uint32_t>(corners.size()));
+                if (inserted) {
+                    corners.push_back(corner);
+                }
+                remap[i].push_back(it->second);
+            }
+        }
+
+#pragma omp parallel for schedule(dynamic) if (parallel)
+        for (std::int64_t i = 0; i < partCount; ++i) {
+            for (std::size_t j = indexOffsets[i]; j < indexOffsets[i + 1]; ++j) {
+                shape.indices[j] = remap[i][shape.indices[j]];
+            }
+        }
+    }
+
+    const auto vertexCount = static_cast<std::int64_t>(corners.size());
+    shape.positions.resize(3 * corners.size());
+    shape.normals.resize(hasNormals ? 3 * corners.size() : 0);
+    shape.texcoords.resize(hasTexcoords ? 2 * corners.size() : 0);
+#pragma omp parallel for if (parallel)
+    for (std::int64_t v = 0; v < vertexCount; ++v) {
+        const auto& corner = corners[v];
+        const float* position = positions.data() + 3 * static_cast<std::size_t>(corner.position);
+        std::copy(position, position + 3, shape.positions.data() + 3 * v);
+
+        if (hasNormals) {
+            if (corner.normal != InvalidIndex) {
+                const float* normal = normals.data() + 3 * static_cast<std::size_t>(corner.normal);
+                std::copy(normal, normal + 3, shape.normals.data() + 3 * v);
+            } else {
+                std::fill_n(shape.normals.data() + 3 * v, 3, 0.0f);
+            }
+        }
+
+        if (hasTexcoords) {
+            if (corner.texcoord != InvalidIndex) {
+                const float* texcoord = texcoords.data() + 2 * static_cast<std::size_t>(corner.texcoord);
+                std::copy(texcoord, texcoord + 2, shape.texcoords.data() + 2 * v);
+            } else {
+                std::fill_n(shape.texcoords.data() + 2 * v, 2, 0.0f);
+            }
+        }
+    }
+}
+
+bool checkRange(const std::vector<Segment>& segments, std::size_t positionCount, std::size_t normalCount,
+    std::size_t texcoordCount) {
+    auto check = [&](const std::vector<Corner>& corners) {
+        return std::all_of(corners.begin(), corners.end(), [&](const Corner& corner) {
+            return corner.position < positionCount &&
+                   (corner.normal == InvalidIndex || corner.normal < normalCount) &&
+                   (corner.texcoord == InvalidIndex || corner.texcoord < texcoordCount);
+        });
+    };
+    return std::all_of(segments.begin(), segments.end(),
+        [&](const Segment& segment) { return check(segment.triangles) && check(segment.lines); });
+}
+
+/** Answers size and modification time of a file, which identify the state a cache has been created from */
+bool getSourceState(const std::filesystem::path& filename, std::uint64_t& size, std::int64_t& time) {
+    std::error_code ec;
+    size = static_cast<std::uint64_t>(std::filesystem::file_size(filename, ec));
+    if (ec) {
+        return false;
+    }
+    time = static_cast<std::int64_t>(std::filesystem::last_write_time(filename, ec).time_since_epoch().count());
+    return !ec;
+}
+
+/** Sequential reader of a buffer, which fails instead of reading past its end */
+class BufferReader {
+public:
+    BufferReader(const char* data, std::size_t size) : pos(data), end(data + size) {}
+
+    template<typename T>
+    bool read(T& value) {
+        return readBytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    bool readVector(std::vector<T>& values, std::uint64_t count) {
+        if (count > static_cast<std::uint64_t>(end - pos) / sizeof(T)) {
+            return false;
+        }
+        values.resize(count);
+        return readBytes(values.data(), count * sizeof(T));
+    }
+
+    bool readString(std::string& value) {
+        std::uint64_t length = 0;
+        if (!read(length) || length > static_cast<std::uint64_t>(end - pos)) {
+            return false;
+        }
+        value.assign(pos, length);
+        pos += length;
+        return true;
+    }
+
+    bool atEnd() const {
+        return pos == end;
+    }
+
+private:
+    bool readBytes(void* target, std::size_t size) {
+        if (size > static_cast<std::size_t>(end - pos)) {
+            return false;
+        }
+        if (size == 0) {
+            return true;
+        }
+        std::memcpy(target, pos, size);
+        pos += size;
+        return true;
+    }
+
+    const char* pos;
+    const char* end;
+};
+
+template<typename T>
+void write(std::ostream& stream, const T& value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+void writeVector(std::ostream& stream, const std::vector<T>& values) {
+    stream.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+/** Read-only memory mapping of a whole file, which is unmapped on destruction */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    bool open(const std::filesystem::path& filename) {
+        close();
+
+#ifdef _WIN32
+        fileHandle = ::CreateFileW(filename.native().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (fileHandle == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!::GetFileSizeEx(fileHandle, &fileSize)) {
+            close();
+            return false;
+        }
+        if (fileSize.QuadPart == 0) {
+            // Empty files cannot be mapped
+            return true;
+        }
+        mappingHandle = ::CreateFileMappingW(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mappingHandle == NULL) {
+            close();
+            return false;
+        }
+        void* view = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (view == NULL) {
+            close();
+            return false;
+        }
+        mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+#else  /* _WIN32 */
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        if (st.st_size == 0) {
+            // Empty files cannot be mapped
+            ::close(fd);
+            return true;
+        }
+        void* view = ::mmap(NULL, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping keeps its own reference to the file
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            return false;
+        }
+        ::madvise(view, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+        mappedSize = static_cast<std::size_t>(st.st_size);
+#endif /* _WIN32 */
+
+        mappedData = static_cast<const char*>(view);
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (mappedData != nullptr) {
+            ::UnmapViewOfFile(mappedData);
+        }
+        if (mappingHandle != NULL) {
+            ::CloseHandle(mappingHandle);
+            mappingHandle = NULL;
+        }
+        if (fileHandle != INVALID_HANDLE_VALUE) {
+            ::CloseHandle(fileHandle);
+            fileHandle = INVALID_HANDLE_VALUE;
+        }
+#else  /* _WIN32 */
+        if (mappedData != nullptr) {
+            ::munmap(const_cast<char*>(mappedData), mappedSize);
+        }
+#endif /* _WIN32 */
+        mappedData = nullptr;
+        mappedSize = 0;
+    }
+
+    const char* data() const {
+        return mappedData;
+    }
+
+    std::size_t size() const {
+        return mappedSize;
+    }
+
+private:
+    const char* mappedData = nullptr;
+    std::size_t mappedSize = 0;
+
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = NULL;
+#endif /* _WIN32 */
+};
+
+} // namespace
+
+bool WavefrontObjParser::parse(const std::filesystem::path& filename, Model& model, std::string& error) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        error = "Cannot read " + filename.generic_string();
+        return false;
+    }
+
+    auto chunks = splitIntoChunks(file.data(), file.size());
+    const auto chunkCount = static_cast<std::int64_t>(chunks.size());
+
+    // First pass: count vertex data per chunk to determine where each chunk stores its data
+#pragma omp parallel for schedule(dynamic)
+    for (std::int64_t i = 0; i < chunkCount; ++i) {
+        countChunk(chunks[i]);
+    }
+
+    std::vector<std::size_t> positionOffsets(chunks.size() + 1, 0);
+    std::vector<std::size_t> normalOffsets(chunks.size() + 1, 0);
+    std::vector<std::size_t> texcoordOffsets(chunks.size() + 1, 0);
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        positionOffsets[i + 1] = positionOffsets[i] + chunks[i].positionCount;
+        normalOffsets[i + 1] = normalOffsets[i] + chunks[i].normalCount;
+        texcoordOffsets[i + 1] = texcoordOffsets[i] + chunks[i].texcoordCount;
+    }
+
+    std::vector<float> positions(3 * positionOffsets.back());
+    std::vector<float> normals(3 * normalOffsets.back());
+    std::vector<float> texcoords(2 * texcoordOffsets.back());
+
+    // Second pass: parse vertex data in place and collect faces and lines
+#pragma omp parallel for schedule(dynamic)
+    for (std::int64_t i = 0; i < chunkCount; ++i) {
+        parseChunk(chunks[i], positionOffsets[i], normalOffsets[i], texcoordOffsets[i], positions.data(),
+            normals.data(), texcoords.data());
+    }
+
+    for (const auto& chunk : chunks) {
+        if (!chunk.error.empty()) {
+            error = chunk.error;
+            return false;
+        }
+        if (!checkRange(chunk.segments, positionOffsets.back(), normalOffsets.back(), texcoordOffsets.back())) {
+            error = "Index out of range in " + filename.generic_string();
+            return false;
+        }
+    }
+
+    // Join the segments of all chunks to shapes
+    std::vector<ShapeSource> sources(1);
+    for (const auto& chunk : chunks) {
+        for (const auto& segment : chunk.segments) {
+            if (segment.startsShape) {
+                sources.emplace_back().name = segment.name;
+            }
+            sources.back().segments.push_back(&segment);
+        }
+    }
+
+    // Shapes containing both faces and lines are split into a triangle and a line shape
+    std::vector<std::vector<const std::vector<Corner>*>> parts;
+    model.shapes.clear();
+    for (const auto& source : sources) {
+        std::vector<const std::vector<Corner>*> triangles;
+        std::vector<const std::vector<Corner>*> lines;
+        for (const auto* segment : source.segments) {
+            if (!segment->triangles.empty()) {
+                triangles.push_back(&segment->triangles);
+            }
+            if (!segment->lines.empty()) {
+                lines.push_back(&segment->lines);
+            }
+        }
+        const bool hasTriangles = !triangles.empty();
+        if (hasTriangles) {
+            model.shapes.emplace_back().name = source.name;
+            parts.push_back(std::move(triangles));
+        }
+        if (!lines.empty()) {
+            auto& shape = model.shapes.emplace_back();
+            shape.name = hasTriangles ? source.name + "_lines" : source.name;
+            shape.lines = true;
+            parts.push_back(std::move(lines));
+        }
+    }
+
+    // Few shapes, e.g. a single large one, are built one after another, each deduplicating its parts in parallel
+    const auto shapeCount = static_cast<std::int64_t>(model.shapes.size());
+    const bool parallelShapes = shapeCount >= omp_get_max_threads();
+#pragma omp parallel for schedule(dynamic) if (parallelShapes)
+    for (std::int64_t i = 0; i < shapeCount; ++i) {
+        buildShape(parts[i], positions, normals, texcoords, model.shapes[i], !parallelShapes);
+    }
+
+    model.bbox = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
+        -std::numeric_limits<float>::max()};
+    for (const auto& shape : model.shapes) {
+        for (std::size_t i = 0; i < shape.positions.size(); i += 3) {
+            for (std::size_t axis = 0; axis < 3; ++axis) {
+                model.bbox[axis] = std::min(model.bbox[axis], shape.positions[i + axis]);
+                model.bbox[axis + 3] = std::max(model.bbox[axis + 3], shape.positions[i + axis]);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool WavefrontObjParser::readCache(const std::filesystem::path& filename, Model& model) {
+    std::uint64_t sourceSize = 0;
+    std::int64_t sourceTime = 0;
+    if (!getSourceState(filename, sourceSize, sourceTime)) {
+        return false;
+    }
+
+    // The arrays are copied straight from the mapping into the model
+    MappedFile file;
+    if (!file.open(getCachePath(filename))) {
+        return false;
+    }
+
+    BufferReader reader(file.data(), file.size());
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    std::uint64_t cachedSize = 0;
+    std::int64_t cachedTime = 0;
+    std::uint64_t shapeCount = 0;
+    if (!reader.read(magic) || !reader.read(version) || !reader.read(cachedSize) || !reader.read(cachedTime) ||
+        magic != CacheMagic || version != CacheVersion || cachedSize != sourceSize || cachedTime != sourceTime ||
+        !reader.read(model.bbox) || !reader.read(shapeCount)) {
+        return false;
+    }
+
+    model.shapes.clear();
+    for (std::uint64_t i = 0; i < shapeCount; ++i) {
+        auto& shape = model.shapes.emplace_back();
+        std::uint8_t lines = 0;
+        std::uint8_t hasNormals = 0;
+        std::uint8_t hasTexcoords = 0;
+        std::uint64_t vertexCount = 0;
+        std::uint64_t indexCount = 0;
+        if (!reader.readString(shape.name) || !reader.read(lines) || !reader.read(hasNormals) ||
+            !reader.read(hasTexcoords) || !reader.read(vertexCount) || !reader.read(indexCount) ||
+            !reader.readVector(shape.positions, 3 * vertexCount) ||
+            !reader.readVector(shape.normals, hasNormals != 0 ? 3 * vertexCount : 0) ||
+            !reader.readVector(shape.texcoords, hasTexcoords != 0 ? 2 * vertexCount : 0) ||
+            !reader.readVector(shape.indices, indexCount)) {
+            model.shapes.clear();
+            return false;
+        }
+        shape.lines = lines != 0;
+    }
+
+    return reader.atEnd();
+}
+
+bool WavefrontObjParser::writeCache(const std::filesystem::path& filename, const Model& model) {
+    std::uint64_t sourceSize = 0;
+    std::int64_t sourceTime = 0;
+    if (!getSourceState(filename, sourceSize, sourceTime)) {
+        return false;
+    }
+
+    // Write to a temporary file first, such that concurrent readers never see a partially written cache
+    const auto cachePath = getCachePath(filename);
+    auto tempPath = cachePath;
+    tempPath += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+
+        write(file, CacheMagic);
+        write(file, CacheVersion);
+        write(file, sourceSize);
+        write(file, sourceTime);
+        write(file, model.bbox);
+        write(file, static_cast<std::uint64_t>(model.shapes.size()));
+
+        for (const auto& shape : model.shapes) {
+            write(file, static_cast<std::uint64_t>(shape.name.size()));
+            file.write(shape.name.data(), shape.name.size());
+            write(file, static_cast<std::uint8_t>(shape.lines));
+            write(file, static_cast<std::uint8_t>(!shape.normals.empty()));
+            write(file, static_cast<std::uint8_t>(!shape.texcoords.empty()));
+            write(file, static_cast<std::uint64_t>(shape.positions.size() / 3));
+            write(file, static_cast<std::uint64_t>(shape.indices.size()));
+            writeVector(file, shape.positions);
+            writeVector(file, shape.normals);
+            writeVector(file, shape.texcoords);
+            writeVector(file, shape.indices);
+        }
+
+        if (!file) {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+std::filesystem::path WavefrontObjParser::getCachePath(const std::filesystem::path& filename) {
+    auto path = filename;
+    path += ".mmcache";
+    return path;
+}
+
+} // namespace megamol::mesh
@@ -0,0 +1,85 @@
+/*
+ * WavefrontObjParser.h
+ *
+ * Copyright (C) 2023 by Universitaet Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace megamol::mesh {
+
+/**
+ * Parser for Wavefront OBJ files producing indexed meshes.
+ *
+ * The file is split into chunks of lines, which are parsed in parallel. Vertices sharing the same combination of
+ * position, texture coordinate and normal are merged per shape. Parsed models can be stored in a binary cache file
+ * next to the OBJ file, which is only used as long as size and modification time of the OBJ file are unchanged.
+ */
+class WavefrontObjParser {
+public:
+    struct Shape {
+        std::string name;
+
+        /** Line segments if true, triangles otherwise */
+        bool lines = false;
+
+        /** Three floats per vertex */
+        std::vector<float> positions;
+
+        /** Three floats per vertex, empty if no face of the shape references normals */
+        std::vector<float> normals;
+
+        /** Two floats per vertex, empty if no face of the shape references texture coordinates */
+        std::vector<float> texcoords;
+
+        /** Two indices per line segment or three indices per triangle */
+        std::vector<std::uint32_t> indices;
+    };
+
+    struct Model {
+        std::vector<Shape> shapes;
+
+        /** Bounding box of all vertices as min x, y, z and max x, y, z */
+        std::array<float, 6> bbox;
+    };
+
+    /**
+     * Parses an OBJ file. Polygons are triangulated as fans, line strips are split into segments, and shapes without
+     * any face or line are dropped. Materials, groups and smoothing groups are ignored.
+     *
+     * @param filename The OBJ file.
+     * @param model Receives the meshes.
+     * @param error Receives a description of the problem if parsing fails.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    static bool parse(const std::filesystem::path& filename, Model& model, std::string& error);
+
+    /**
+     * Reads the cached model of an OBJ file.
+     *
+     * @return 'true' if a cache matching the current state of the OBJ file exists and has been read, 'false' otherwise.
+     */
+    static bool readCache(const std::filesystem::path& filename, Model& model);
+
+    /**
+     * Writes the cache of an OBJ file.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    static bool writeCache(const std::filesystem::path& filename, const Model& model);
+
+    /**
+     * Answer the path of the cache file of an OBJ file.
+     */
+    static std::filesystem::path getCachePath(const std::filesystem::path& filename);
+};
+
+} // namespace megamol::mesh
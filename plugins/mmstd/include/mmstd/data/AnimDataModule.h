@@ -7,10 +7,12 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "mmcore/Module.h"
-#include "vislib/sys/CriticalSection.h"
-#include "vislib/sys/Thread.h"
 
 
 namespace megamol::core::view {
@@ -49,7 +51,7 @@ protected:
          *
          * @param owner The owning AnimDataModule
          */
-        Frame(AnimDataModule& owner) : frame(0), owner(owner), state(STATE_INVALID) {
+        Frame(AnimDataModule& owner) : frame(0), owner(owner), state(STATE_INVALID), loadingIdx(0) {
             // intentionally empty
         }
 
@@ -98,6 +100,9 @@ protected:
 
         /** the state of this frame */
         State state;
+
+        /** the index of the frame being loaded while in 'STATE_LOADING' */
+        unsigned int loadingIdx;
     };
 
     /**
@@ -166,6 +171,16 @@ protected:
      */
     void resetFrameCache();
 
+    /**
+     * Sets the number of loader threads filling the frame cache. Must not
+     * be called after the frame cache has been initialised! More than one
+     * loader thread must only be used if 'loadFrame' is safe to be called
+     * concurrently for different frames.
+     *
+     * @param cnt The number of loader threads. Must not be zero.
+     */
+    void setLoaderThreadCount(unsigned int cnt);
+
     /**
      * Sets the number of time frames of the dataset. Must not be called
      * after the frame cache has been initialised!
@@ -181,12 +196,35 @@ protected:
 private:
     /**
      * The loader thread function.
+     */
+    void loaderFunction();
+
+    /**
+     * Answers the cached frame holding the given index. The caller must
+     * hold 'stateLock'.
+     *
+     * @param idx The frame index.
+     *
+     * @return The available or locked frame for 'idx', or NULL.
+     */
+    Frame* findCachedFrame(unsigned int idx) const;
+
+    /**
+     * Searches for the most important frame to be loaded next along the
+     * current playback direction and the cache entry to be overwritten by
+     * it. The caller must hold 'stateLock'.
      *
-     * @param userData Pointer to this object.
+     * @param outIdx Receives the index of the frame to be loaded.
      *
-     * @return The return value.
+     * @return The frame object to load into, or NULL if there is nothing
+     *         to do right now.
+     */
+    Frame* findLoadJob(unsigned int& outIdx) const;
+
+    /**
+     * Stops and joins all loader threads.
      */
-    static DWORD loaderFunction(void* userData);
+    void stopLoaders();
 
     /**
      * Unlocks the given frame
@@ -200,8 +238,11 @@ private:
     /** The number of time frames of the dataset */
     unsigned int frameCnt;
 
-    /** The loading thread */
-    vislib::sys::Thread loader;
+    /** The loading threads */
+    std::vector<std::thread> loaders;
+
+    /** The number of loading threads to start */
+    unsigned int loaderCnt;
 
     /** The frame cache */
     Frame** frameCache;
@@ -210,14 +251,26 @@ private:
     unsigned int cacheSize;
 
     /**
-     * The critical section to synchornise the state changes of the
-     * cached frames.
+     * The mutex to synchronise the state changes of the cached frames.
      */
-    vislib::sys::CriticalSection stateLock;
+    mutable std::mutex stateLock;
+
+    /** Signalled when the loader threads might find new work */
+    std::condition_variable loaderCond;
+
+    /** Signalled when a frame finished loading */
+    std::condition_variable frameCond;
 
     /** The frame number requested the last time 'requestLockedFrame' was called */
     unsigned int lastRequested;
 
+    /**
+     * The estimated playback step (signed frame difference between two
+     * consecutive distinct requests), used to prefetch along the playback
+     * direction and speed.
+     */
+    int playbackStep;
+
     /** TODO: The Mueller shalt document his stuff */
     std::atomic_bool isRunning;
 #ifdef _WIN32
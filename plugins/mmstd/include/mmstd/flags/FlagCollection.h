@@ -6,7 +6,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <deque>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "FlagStorageTypes.h"
 
@@ -14,6 +18,9 @@ namespace megamol::core {
 
 class FlagCollection_CPU {
 public:
+    /** Half-open range [first, second) of flag indices */
+    using index_range = std::pair<FlagStorageTypes::index_type, FlagStorageTypes::index_type>;
+
     std::shared_ptr<FlagStorageTypes::flag_vector_type> flags;
 
     void validateFlagCount(FlagStorageTypes::index_type num) {
@@ -21,5 +28,147 @@ public:
             flags->resize(num, FlagStorageTypes::to_integral(FlagStorageTypes::flag_bits::ENABLED));
         }
     }
+
+    /**
+     * Records that the flags in [begin, end) have been modified. Writers recording all of their modifications allow
+     * the flag storage and all readers to only process these ranges. If a writer records nothing, all flags are
+     * considered modified.
+     */
+    void markDirty(FlagStorageTypes::index_type begin, FlagStorageTypes::index_type end) {
+        if (begin >= end) {
+            return;
+        }
+        dirtyRanges.emplace_back(begin, end);
+        if (dirtyRanges.size() > maxDirtyRanges) {
+            dirtyRanges = getDirtyRanges();
+            if (dirtyRanges.size() > maxDirtyRanges / 2) {
+                // many disjoint ranges are not worth tracking individually
+                dirtyRanges.assign(1, index_range(dirtyRanges.front().first, dirtyRanges.back().second));
+            }
+        }
+    }
+
+    /**
+     * Overwrites the first 'count' flags with 'newFlags' and records the flags that actually changed, for writers
+     * that do not know which flags they modified, e.g. because the flags have been computed on the GPU or received
+     * as a whole. Costs a single pass over the flags in the writer instead of one in every reader.
+     */
+    void assignAndMarkDirty(const FlagStorageTypes::flag_item_type* newFlags, FlagStorageTypes::index_type count) {
+        auto& current = *flags;
+        changesRecorded = true;
+        const FlagStorageTypes::index_type common = std::min<FlagStorageTypes::index_type>(count, current.size());
+        if (current.size() < static_cast<std::size_t>(count)) {
+            current.resize(count);
+            markDirty(common, count);
+        }
+        FlagStorageTypes::index_type i = 0;
+        while (i < common) {
+            if (current[i] == newFlags[i]) {
+                ++i;
+                continue;
+            }
+            const auto begin = i;
+            while (i < common && current[i] != newFlags[i]) {
+                ++i;
+            }
+            markDirty(begin, i);
+        }
+        std::copy(newFlags, newFlags + count, current.begin());
+    }
+
+    /**
+     * Answer whether modifications have been recorded since the last call to clearDirty().
+     */
+    bool hasDirtyRanges() const {
+        return !dirtyRanges.empty();
+    }
+
+    /**
+     * Answer the recorded modifications as sorted, non-overlapping ranges.
+     */
+    std::vector<index_range> getDirtyRanges() const {
+        return mergeRanges(dirtyRanges);
+    }
+
+    void clearDirty() {
+        dirtyRanges.clear();
+        changesRecorded = false;
+    }
+
+    /**
+     * Moves the recorded modifications into the change log as the modifications from version 'from' to version 'to'.
+     * Called by the flag storage when accepting a write.
+     */
+    void commitChanges(FlagStorageTypes::flag_version_type from, FlagStorageTypes::flag_version_type to) {
+        if (!changeLog.empty() && changeLog.back().to != from) {
+            changeLog.clear();
+        }
+        changeLog.push_back(ChangeSet{from, to, changesRecorded || hasDirtyRanges(), getDirtyRanges()});
+        if (changeLog.size() > maxChangeLogSize) {
+            changeLog.pop_front();
+        }
+        clearDirty();
+    }
+
+    /**
+     * Answers the flags modified after 'version' as sorted, non-overlapping ranges, allowing readers to only update
+     * the affected items.
+     *
+     * @return 'true' on success, 'false' if the modifications are unknown because a writer has not recorded them or
+     *         'version' is too old. In that case, all flags have to be considered modified.
+     */
+    bool getChangesSince(FlagStorageTypes::flag_version_type version, std::vector<index_range>& ranges) const {
+        ranges.clear();
+        auto it = std::find_if(
+            changeLog.begin(), changeLog.end(), [version](const ChangeSet& c) { return c.from >= version; });
+        if (it == changeLog.end()) {
+            return !changeLog.empty() && changeLog.back().to == version;
+        }
+        if (it->from != version) {
+            return false;
+        }
+        for (; it != changeLog.end(); ++it) {
+            if (!it->tracked) {
+                return false;
+            }
+            ranges.insert(ranges.end(), it->ranges.begin(), it->ranges.end());
+        }
+        ranges = mergeRanges(std::move(ranges));
+        return true;
+    }
+
+private:
+    struct ChangeSet {
+        FlagStorageTypes::flag_version_type from;
+        FlagStorageTypes::flag_version_type to;
+        /** False if the writer did not record its modifications */
+        bool tracked;
+        std::vector<index_range> ranges;
+    };
+
+    static std::vector<index_range> mergeRanges(std::vector<index_range> ranges) {
+        std::sort(ranges.begin(), ranges.end());
+        std::size_t merged = 0;
+        for (std::size_t i = 1; i < ranges.size(); ++i) {
+            if (ranges[i].first <= ranges[merged].second) {
+                ranges[merged].second = std::max(ranges[merged].second, ranges[i].second);
+            } else {
+                ranges[++merged] = ranges[i];
+            }
+        }
+        ranges.resize(std::min(ranges.size(), merged + 1));
+        return ranges;
+    }
+
+    static constexpr std::size_t maxDirtyRanges = 4096;
+
+    static constexpr std::size_t maxChangeLogSize = 64;
+
+    std::vector<index_range> dirtyRanges;
+
+    /** True if the modifications are known, even if no flag has been modified */
+    bool changesRecorded = false;
+
+    std::deque<ChangeSet> changeLog;
 };
 } // namespace megamol::core
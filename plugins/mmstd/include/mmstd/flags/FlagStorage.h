@@ -6,6 +6,10 @@
 
 #pragma once
 
+#include <chrono>
+#include <string>
+#include <vector>
+
 #include "mmcore/Call.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/Module.h"
@@ -104,10 +108,35 @@ protected:
      */
     virtual bool writeCPUDataCallback(core::Call& caller);
 
-    static nlohmann::json make_bit_array(
-        const FlagStorageTypes::index_vector& bit_starts, const FlagStorageTypes::index_vector& bit_ends);
     void array_to_bits(const nlohmann::json& json, FlagStorageTypes::flag_bits flag_bit);
     static FlagStorageTypes::index_type array_max(const nlohmann::json& json);
+
+    /**
+     * Remembers the flags modified since 'previousVersion' for the next serialization. Uses the change log of the
+     * flag collection, or all flags if the modifications are unknown.
+     */
+    void markSerializationDirty(FlagStorageTypes::flag_version_type previousVersion);
+
+    /**
+     * Restarts the delay until the next serialization without marking any flags as modified.
+     */
+    void scheduleSerialization();
+
+    /**
+     * Marks the chunks containing flags modified since 'previousVersion' for encoding at the next serialization.
+     */
+    void markSerializationStale(FlagStorageTypes::flag_version_type previousVersion);
+
+    /**
+     * Answer whether modified flags are waiting for serialization and no write has happened for a while, such that
+     * continuous interaction, e.g. brushing, does not serialize every intermediate state.
+     */
+    bool isSerializationDue() const;
+
+    /**
+     * Stores the flags as binary run-length encoding in the serializedFlags parameter. Only the chunks containing
+     * modified flags are encoded again.
+     */
     void serializeCPUData();
     void deserializeCPUData();
     virtual bool onJSONChanged(param::ParamSlot& slot);
@@ -123,6 +152,19 @@ protected:
 
     std::shared_ptr<FlagCollection_CPU> theCPUData;
     uint32_t version = 0;
+
+    /** Run-length encoded flags per chunk of serializationChunkSize flags */
+    std::vector<std::string> serializedChunks;
+
+    /** Chunks containing flags modified since their last encoding */
+    std::vector<uint8_t> staleChunks;
+
+    /** Number of flags when the chunks were last encoded */
+    std::size_t serializedFlagCount = 0;
+
+    bool serializationPending = false;
+
+    std::chrono::steady_clock::time_point lastWriteTime;
 };
 
 } // namespace megamol::core
@@ -6,9 +6,11 @@
 
 #include "mmstd/data/AnimDataModule.h"
 #include "mmcore/utility/log/Log.h"
+#include "vislib/String.h"
 #include "vislib/assert.h"
-#include "vislib/sys/Thread.h"
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 
 using namespace megamol::core;
 
@@ -21,11 +23,15 @@ using namespace megamol::core;
 view::AnimDataModule::AnimDataModule()
         : Module()
         , frameCnt(0)
-        , loader(loaderFunction)
+        , loaders()
+        , loaderCnt(1)
         , frameCache(NULL)
         , cacheSize(0)
         , stateLock()
-        , lastRequested(0) {
+        , loaderCond()
+        , frameCond()
+        , lastRequested(0)
+        , playbackStep(0) {
     this->isRunning.store(false);
 }
 
@@ -37,11 +43,7 @@ view::AnimDataModule::~AnimDataModule() {
     this->Release();
 
     Frame** frames = this->frameCache;
-    //    this->frameCache = NULL;
-    this->isRunning.store(false);
-    if (this->loader.IsRunning()) {
-        this->loader.Join();
-    }
+    this->stopLoaders();
     this->frameCache = NULL;
     if (frames != NULL) {
         for (unsigned int i = 0; i < this->cacheSize; i++) {
@@ -56,7 +58,7 @@ view::AnimDataModule::~AnimDataModule() {
  * view::AnimDataModule::initframeCache
  */
 void view::AnimDataModule::initFrameCache(unsigned int cacheSize) {
-    ASSERT(this->loader.IsRunning() == false);
+    ASSERT(this->loaders.empty());
     ASSERT(cacheSize > 0);
     ASSERT(this->frameCnt > 0);
 
@@ -89,12 +91,12 @@ void view::AnimDataModule::initFrameCache(unsigned int cacheSize) {
         this->loadFrame(this->frameCache[0], 0); // load first frame directly.
         this->frameCache[0]->state = Frame::STATE_AVAILABLE;
         this->lastRequested = 0;
+        this->playbackStep = 0;
 
         this->isRunning.store(true);
-        this->loader.Start(this);
-        // XXX Is there a race condition that requires higher sleep time (value originally was 250)?
-        // XXX Reduced for faster module creation, because called in ctor.
-        vislib::sys::Thread::Sleep(10);
+        for (unsigned int i = 0; i < this->loaderCnt; i++) {
+            this->loaders.emplace_back(&AnimDataModule::loaderFunction, this);
+        }
     } else {
         megamol::core::utility::log::Log::DefaultLog.WriteError(
             "Unable to create frame data cache ('constructFrame' returned 'NULL').");
@@ -107,29 +109,60 @@ void view::AnimDataModule::initFrameCache(unsigned int cacheSize) {
  */
 view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned int idx) {
     Frame* retval = NULL;
-    int dist, minDist = this->frameCnt;
+    unsigned int minDist = this->frameCnt;
     static bool deadlockwarning = true;
+    bool requestChanged = false;
+    unsigned int clcf = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(this->stateLock);
+
+        if (idx != this->lastRequested) {
+            // estimate playback direction and speed from consecutive requests.
+            // Larger jumps are seeks and do not change the estimate.
+            long long d = static_cast<long long>(idx) - static_cast<long long>(this->lastRequested);
+            long long const n = static_cast<long long>(this->frameCnt);
+            if (2 * d > n) {
+                d -= n;
+            } else if (2 * d < -n) {
+                d += n;
+            }
+            if (std::llabs(d) <= static_cast<long long>(std::max(this->cacheSize / 2, 1u))) {
+                this->playbackStep = static_cast<int>(d);
+            }
+            this->lastRequested = idx;
+            requestChanged = true;
+        }
 
-    this->stateLock.Lock();
-    this->lastRequested = idx; // TODO: choose better caching strategy!!!
-    for (unsigned int i = 0; i < this->cacheSize; i++) {
-        if ((this->frameCache[i]->state == Frame::STATE_AVAILABLE) ||
-            (this->frameCache[i]->state == Frame::STATE_INUSE)) {
-            // note: do not wrap distance around!
-            dist = labs(this->frameCache[i]->frame - idx);
-            if (dist == 0) {
-                retval = this->frameCache[i];
-                break;
-            } else if (dist < minDist) {
-                retval = this->frameCache[i];
-                minDist = dist;
+        for (unsigned int i = 0; i < this->cacheSize; i++) {
+            if ((this->frameCache[i]->state == Frame::STATE_AVAILABLE) ||
+                (this->frameCache[i]->state == Frame::STATE_INUSE)) {
+                // note: do not wrap distance around!
+                unsigned int const f = this->frameCache[i]->frame;
+                unsigned int const dist = (f > idx) ? (f - idx) : (idx - f);
+                if (dist == 0) {
+                    retval = this->frameCache[i];
+                    break;
+                } else if (dist < minDist) {
+                    retval = this->frameCache[i];
+                    minDist = dist;
+                }
+            }
+        }
+        if (retval != NULL) {
+            retval->state = Frame::STATE_INUSE;
+        }
+
+        for (unsigned int i = 0; i < this->cacheSize; i++) {
+            if (this->frameCache[i]->state == Frame::STATE_INUSE) {
+                clcf++;
             }
         }
     }
-    if (retval != NULL) {
-        retval->state = Frame::STATE_INUSE;
+
+    if (requestChanged) {
+        this->loaderCond.notify_all();
     }
-    this->stateLock.Unlock();
 
     if (deadlockwarning
 #if !(defined(DEBUG) || defined(_DEBUG))
@@ -137,15 +170,6 @@ view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned i
     // streaming is required to handle this data set
 #endif /* !(defined(DEBUG) || defined(_DEBUG)) */
     ) {
-        unsigned int clcf = 0;
-        for (unsigned int i = 0; i < this->cacheSize; i++) {
-            if (this->frameCache[i]->state == Frame::STATE_INUSE) {
-                clcf++;
-            }
-        }
-
-        //printf("======== %u frames locked\n", clcf);
-
         if ((clcf == this->cacheSize) && (this->cacheSize > 2)) {
             megamol::core::utility::log::Log::DefaultLog.WriteError("Possible data frame cache deadlock detected!");
             deadlockwarning = false;
@@ -161,7 +185,7 @@ view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned i
  */
 view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned int idx, bool forceIdx) {
     Frame* f = this->requestLockedFrame(idx);
-    if ((f->FrameNumber() == idx) || (!forceIdx))
+    if ((f == NULL) || (f->FrameNumber() == idx) || (!forceIdx))
         return f;
     // wrong frame number and frame is forced
 
@@ -170,17 +194,23 @@ view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned i
         idx = this->frameCnt - 1;
         f->Unlock();
         f = this->requestLockedFrame(idx);
+        if ((f == NULL) || (f->FrameNumber() == idx))
+            return f;
     }
-
-    // wait for the new frame
-    while (idx != f->FrameNumber()) {
-        f->Unlock();
-
-        // HAZARD: This will wait for all eternity if the requested frame is never loaded
-
-        vislib::sys::Thread::Sleep(100); // time for the loader thread to load
-        f = this->requestLockedFrame(idx);
+    f->Unlock();
+
+    // wait for the loader threads to deliver the new frame
+    // HAZARD: This will wait for all eternity if the requested frame is never loaded
+    std::unique_lock<std::mutex> lock(this->stateLock);
+    this->frameCond.wait(
+        lock, [this, idx]() { return !this->isRunning.load() || (this->findCachedFrame(idx) != NULL); });
+    f = this->findCachedFrame(idx);
+    if (f == NULL) {
+        // loaders have been stopped
+        lock.unlock();
+        return this->requestLockedFrame(idx);
     }
+    f->state = Frame::STATE_INUSE;
 
     return f;
 }
@@ -191,11 +221,7 @@ view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned i
  */
 void view::AnimDataModule::resetFrameCache() {
     Frame** frames = this->frameCache;
-    //    this->frameCache = NULL;
-    this->isRunning.store(false);
-    if (this->loader.IsRunning()) {
-        this->loader.Join();
-    }
+    this->stopLoaders();
     this->frameCache = NULL;
     if (frames != NULL) {
         for (unsigned int i = 0; i < this->cacheSize; i++) {
@@ -206,6 +232,17 @@ void view::AnimDataModule::resetFrameCache() {
     this->frameCnt = 0;
     this->cacheSize = 0;
     this->lastRequested = 0;
+    this->playbackStep = 0;
+}
+
+
+/*
+ * view::AnimDataModule::setLoaderThreadCount
+ */
+void view::AnimDataModule::setLoaderThreadCount(unsigned int cnt) {
+    ASSERT(this->loaders.empty());
+    ASSERT(cnt > 0);
+    this->loaderCnt = std::max(cnt, 1u);
 }
 
 
@@ -213,155 +250,170 @@ void view::AnimDataModule::resetFrameCache() {
  * view::AnimDataModule::setFrameCount
  */
 void view::AnimDataModule::setFrameCount(unsigned int cnt) {
-    ASSERT(this->loader.IsRunning() == false);
+    ASSERT(this->loaders.empty());
     ASSERT(cnt > 0);
     this->frameCnt = cnt;
 }
 
 
 /*
- * view::AnimDataModule::loaderFunction
+ * view::AnimDataModule::findCachedFrame
  */
-DWORD view::AnimDataModule::loaderFunction(void* userData) {
-    AnimDataModule* This = static_cast<AnimDataModule*>(userData);
-    ASSERT(This != NULL);
-    unsigned int index, i, j, req;
-#ifdef _LOADING_REPORTING
-    unsigned int l;
-#endif /* _LOADING_REPORTING */
-    Frame* frame;
-    vislib::StringA fullName(This->FullName());
+view::AnimDataModule::Frame* view::AnimDataModule::findCachedFrame(unsigned int idx) const {
+    for (unsigned int i = 0; i < this->cacheSize; i++) {
+        if (((this->frameCache[i]->state == Frame::STATE_AVAILABLE) ||
+                (this->frameCache[i]->state == Frame::STATE_INUSE)) &&
+            (this->frameCache[i]->frame == idx)) {
+            return this->frameCache[i];
+        }
+    }
+    return NULL;
+}
 
-    std::chrono::high_resolution_clock::duration accumDuration = std::chrono::seconds(0);
-    unsigned int accumCount = 0;
-    std::chrono::system_clock::time_point lastReportTime = std::chrono::system_clock::now();
-    const std::chrono::system_clock::duration lastReportDistance = std::chrono::seconds(3);
 
-    while (This->isRunning.load()) {
-        // sleep to enforce thread changes
-        vislib::sys::Thread::Sleep(1);
-        if (!This->isRunning.load())
-            break;
-
-        // idea:
-        //  1. search for the most important frame to be loaded.
-        //  2. search for the best cached frame to be overwritten.
-        //  3. load the frame
-
-        // 1.
-        // Note: we do not need to lock here, because we won't change the frame
-        // state now, and the different states that can be set outside this
-        // thread are aquivalent for us.
-        index = req = This->lastRequested;
-        for (j = 0; j < This->cacheSize; j++) {
-            for (i = 0; i < This->cacheSize; i++) {
-                if (!This->isRunning.load())
-                    break;
-                if (((This->frameCache[i]->state == Frame::STATE_AVAILABLE) ||
-                        (This->frameCache[i]->state == Frame::STATE_INUSE)) &&
-                    (This->frameCache[i]->frame == index)) {
-                    break;
-                }
-            }
-            if (!This->isRunning.load())
-                break;
-            if (i >= This->cacheSize) {
+/*
+ * view::AnimDataModule::findLoadJob
+ */
+view::AnimDataModule::Frame* view::AnimDataModule::findLoadJob(unsigned int& outIdx) const {
+    long long const n = static_cast<long long>(this->frameCnt);
+    long long const req = static_cast<long long>(this->lastRequested);
+    long long const step = (this->playbackStep != 0) ? this->playbackStep : 1;
+    long long const stride = std::llabs(step);
+
+    // distance of a frame ahead of the requested one along the playback direction
+    auto const aheadDist = [n, req, step](unsigned int frame) -> long long {
+        long long d = (step > 0) ? (static_cast<long long>(frame) - req) : (req - static_cast<long long>(frame));
+        return ((d % n) + n) % n;
+    };
+
+    // 1. search for the most important frame to be loaded: the first frame
+    //    along the playback direction which is neither cached nor in flight.
+    long long target = -1;
+    long long targetDist = 0;
+    for (unsigned int k = 0; (k < this->cacheSize) && (target < 0); k++) {
+        long long const i = (((req + static_cast<long long>(k) * step) % n) + n) % n;
+        unsigned int const idx = static_cast<unsigned int>(i);
+        if (this->findCachedFrame(idx) != NULL) {
+            continue;
+        }
+        bool inFlight = false;
+        for (unsigned int j = 0; j < this->cacheSize; j++) {
+            if ((this->frameCache[j]->state == Frame::STATE_LOADING) && (this->frameCache[j]->loadingIdx == idx)) {
+                inFlight = true;
                 break;
             }
-            index = (index + 1) % This->frameCnt;
         }
-        if (!This->isRunning.load())
-            break;
-        if (j >= This->cacheSize) {
-            if (j >= This->frameCnt) {
-                ASSERT(This->frameCnt == This->cacheSize);
-                megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-                    "All frames of the dataset loaded into cache. Terminating loading Thread.");
-                break;
+        if (!inFlight) {
+            target = i;
+            targetDist = aheadDist(idx);
+        }
+    }
+    if (target < 0) {
+        return NULL;
+    }
+
+    // 2. search for the best cached frame to be overwritten: an unused one,
+    //    or the one farthest ahead (i.e. already behind the playback
+    //    position). Frames off the playback stride are not going to be shown.
+    Frame* frame = NULL;
+    long long frameDist = -1;
+    for (unsigned int i = 0; i < this->cacheSize; i++) {
+        if (this->frameCache[i]->state == Frame::STATE_INVALID) {
+            outIdx = static_cast<unsigned int>(target);
+            return this->frameCache[i];
+        } else if (this->frameCache[i]->state == Frame::STATE_AVAILABLE) {
+            long long d = aheadDist(this->frameCache[i]->frame);
+            if ((d % stride) != 0) {
+                d += n;
+            }
+            if (d > frameDist) {
+                frame = this->frameCache[i];
+                frameDist = d;
             }
-            continue;
         }
+    }
 
-        // 2.
-        // Note: We now need to lock, because we must synchronise against
-        // frames changing from 'STATE_AVAILABLE' to 'STATE_INUSE'.
-        This->stateLock.Lock();
-        // core idea: search for the frame with the largest distance to the requested frame
-        frame = NULL; // the frame to be overwritten
-        j = 0;        // the distance to the found frame to be overwritten
-        for (i = 0; i < This->cacheSize; i++) {
-            if (This->frameCache[i]->state == Frame::STATE_INVALID) {
-                frame = This->frameCache[i];
-                // j = UINT_MAX; // not required, since we instantly leave the loop
-#ifdef _LOADING_REPORTING
-                l = i;
-#endif /* _LOADING_REPORTING */
-                break;
-            } else if (This->frameCache[i]->state == Frame::STATE_AVAILABLE) {
-                // distance to the frame[i];
-                long ld = static_cast<long>(This->frameCache[i]->frame) - static_cast<long>(req);
-                if (ld < 0) {
-                    if (ld < (static_cast<long>(This->frameCnt)) / 10) {
-                        ld += static_cast<long>(This->frameCnt);
-                        if (ld < 0)
-                            ld = 0; // should never happen
-                    } else {
-                        ld = -10 * ld;
-                    }
-                }
+    // do not evict frames that are more important than the one to be loaded
+    if ((frame == NULL) || (frameDist <= targetDist)) {
+        return NULL;
+    }
 
-                if (j < static_cast<unsigned int>(ld)) {
-                    frame = This->frameCache[i];
-                    j = static_cast<unsigned int>(ld);
-#ifdef _LOADING_REPORTING
-                    l = i;
-#endif /* _LOADING_REPORTING */
-                }
-            }
-            if (!This->isRunning.load())
-                break;
+    outIdx = static_cast<unsigned int>(target);
+    return frame;
+}
+
+
+/*
+ * view::AnimDataModule::stopLoaders
+ */
+void view::AnimDataModule::stopLoaders() {
+    {
+        std::lock_guard<std::mutex> lock(this->stateLock);
+        this->isRunning.store(false);
+    }
+    this->loaderCond.notify_all();
+    this->frameCond.notify_all();
+    for (auto& t : this->loaders) {
+        if (t.joinable()) {
+            t.join();
         }
+    }
+    this->loaders.clear();
+}
+
+
+/*
+ * view::AnimDataModule::loaderFunction
+ */
+void view::AnimDataModule::loaderFunction() {
+    vislib::StringA fullName(this->FullName());
 
-        // 3.
-        if (frame != NULL) {
-            frame->state = Frame::STATE_LOADING;
+    std::chrono::high_resolution_clock::duration accumDuration = std::chrono::seconds(0);
+    unsigned int accumCount = 0;
+    std::chrono::system_clock::time_point lastReportTime = std::chrono::system_clock::now();
+    const std::chrono::system_clock::duration lastReportDistance = std::chrono::seconds(3);
+
+    std::unique_lock<std::mutex> lock(this->stateLock);
+    while (this->isRunning.load()) {
+        unsigned int index = 0;
+        Frame* frame = this->findLoadJob(index);
+        if (frame == NULL) {
+            // nothing to do until a new frame is requested or a frame is unlocked
+            this->loaderCond.wait(lock);
+            continue;
         }
-        // if frame is NULL no suitable cache buffer found for loading. This is
-        // mostly the case if the cache is too small or if the data source
-        // locks too much frames.
-        This->stateLock.Unlock();
 
-        if ((frame != NULL) && This->isRunning.load()) {
+        frame->state = Frame::STATE_LOADING;
+        frame->loadingIdx = index;
+        lock.unlock();
+
 #ifdef _LOADING_REPORTING
-            printf("Loading frame %i into cache %i\n", index, l);
+        printf("Loading frame %u\n", index);
 #endif /* _LOADING_REPORTING */
 
-            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
-
-            This->loadFrame(frame, index);
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
 
-            std::chrono::high_resolution_clock::duration duration = std::chrono::high_resolution_clock::now() - start;
-            accumDuration += duration;
-            accumCount++;
+        this->loadFrame(frame, index);
 
-            std::chrono::system_clock::time_point reportTime = std::chrono::system_clock::now();
-            if ((reportTime - lastReportTime) > lastReportDistance) {
-                lastReportTime = reportTime;
-                if (accumCount > 0) {
-                    megamol::core::utility::log::Log::DefaultLog.WriteInfo("[%s] Loading speed: %f ms/f (%u)",
-                        fullName.PeekBuffer(),
-                        1000.0 * std::chrono::duration_cast<std::chrono::duration<double>>(accumDuration).count() /
-                            static_cast<double>(accumCount),
-                        static_cast<unsigned int>(accumCount));
-                }
-            }
+        std::chrono::high_resolution_clock::duration duration = std::chrono::high_resolution_clock::now() - start;
+        accumDuration += duration;
+        accumCount++;
 
-            // we no not need to lock here, because this transition from
-            // 'STATE_LOADING' to 'STATE_AVAILABLE' is safe for the using
-            // thread.
-            frame->state = Frame::STATE_AVAILABLE;
+        std::chrono::system_clock::time_point reportTime = std::chrono::system_clock::now();
+        if ((reportTime - lastReportTime) > lastReportDistance) {
+            lastReportTime = reportTime;
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo("[%s] Loading speed: %f ms/f (%u)",
+                fullName.PeekBuffer(),
+                1000.0 * std::chrono::duration_cast<std::chrono::duration<double>>(accumDuration).count() /
+                    static_cast<double>(accumCount),
+                static_cast<unsigned int>(accumCount));
         }
+
+        lock.lock();
+        frame->state = Frame::STATE_AVAILABLE;
+        this->frameCond.notify_all();
     }
+    lock.unlock();
 
     if (accumCount > 0) {
         megamol::core::utility::log::Log::DefaultLog.WriteInfo("[%s] Loading speed: %f ms/f (%u)",
@@ -372,7 +424,6 @@ DWORD view::AnimDataModule::loaderFunction(void* userData) {
     }
 
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("The loader thread is exiting.");
-    return 0;
 }
 
 
@@ -382,7 +433,10 @@ DWORD view::AnimDataModule::loaderFunction(void* userData) {
 void view::AnimDataModule::unlock(view::AnimDataModule::Frame* frame) {
     ASSERT(&frame->owner == this);
     ASSERT(frame->state == Frame::STATE_INUSE);
-    this->stateLock.Lock();
-    frame->state = Frame::STATE_AVAILABLE;
-    this->stateLock.Unlock();
+    {
+        std::lock_guard<std::mutex> lock(this->stateLock);
+        frame->state = Frame::STATE_AVAILABLE;
+    }
+    // the frame may now be overwritten
+    this->loaderCond.notify_all();
 }
@@ -6,9 +6,13 @@
 
 #include "mmstd/flags/FlagStorage.h"
 
+#include <algorithm>
+#include <limits>
+#include <string_view>
+
 #include <nlohmann/json.hpp>
+#include <tbb/tbb.h>
 
-#include "FlagStorageBitsChecker.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/StringParam.h"
 #include "mmstd/flags/FlagCalls.h"
@@ -17,6 +21,111 @@ using namespace megamol;
 using namespace megamol::core;
 using megamol::core::utility::log::Log;
 
+namespace {
+
+constexpr std::size_t serializationChunkSize = 1 << 16;
+
+constexpr auto serializationDelay = std::chrono::milliseconds(500);
+
+/** Marks the binary format, the legacy JSON format starts with '{' */
+constexpr std::string_view serializationPrefix = "rle:";
+
+constexpr FlagStorageTypes::flag_item_type serializedBits =
+    FlagStorageTypes::to_integral(FlagStorageTypes::flag_bits::ENABLED) |
+    FlagStorageTypes::to_integral(FlagStorageTypes::flag_bits::FILTERED) |
+    FlagStorageTypes::to_integral(FlagStorageTypes::flag_bits::SELECTED);
+
+constexpr std::string_view base64Chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+void appendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool readVarint(const std::string& in, std::size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; pos < in.size() && shift < 64; shift += 7) {
+        const auto byte = static_cast<uint8_t>(in[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Encodes the flags in [begin, end) as runs of equal serialized bits, each stored as the bits followed by the run
+ * length.
+ */
+std::string encodeRuns(const FlagStorageTypes::flag_vector_type& flags, std::size_t begin, std::size_t end) {
+    std::string runs;
+    while (begin < end) {
+        const auto bits = flags[begin] & serializedBits;
+        std::size_t runEnd = begin + 1;
+        while (runEnd < end && (flags[runEnd] & serializedBits) == bits) {
+            ++runEnd;
+        }
+        runs.push_back(static_cast<char>(bits));
+        appendVarint(runs, runEnd - begin);
+        begin = runEnd;
+    }
+    return runs;
+}
+
+std::string encodeBase64(const std::string& in) {
+    std::string out;
+    out.reserve((in.size() + 2) / 3 * 4);
+    std::size_t i = 0;
+    for (; i + 2 < in.size(); i += 3) {
+        const uint32_t v = (static_cast<uint8_t>(in[i]) << 16) | (static_cast<uint8_t>(in[i + 1]) << 8) |
+                           static_cast<uint8_t>(in[i + 2]);
+        out.push_back(base64Chars[(v >> 18) & 0x3f]);
+        out.push_back(base64Chars[(v >> 12) & 0x3f]);
+        out.push_back(base64Chars[(v >> 6) & 0x3f]);
+        out.push_back(base64Chars[v & 0x3f]);
+    }
+    if (i < in.size()) {
+        uint32_t v = static_cast<uint8_t>(in[i]) << 16;
+        if (i + 1 < in.size()) {
+            v |= static_cast<uint8_t>(in[i + 1]) << 8;
+        }
+        out.push_back(base64Chars[(v >> 18) & 0x3f]);
+        out.push_back(base64Chars[(v >> 12) & 0x3f]);
+        out.push_back(i + 1 < in.size() ? base64Chars[(v >> 6) & 0x3f] : '=');
+        out.push_back('=');
+    }
+    return out;
+}
+
+bool decodeBase64(std::string_view in, std::string& out) {
+    out.clear();
+    out.reserve(in.size() / 4 * 3);
+    uint32_t v = 0;
+    int bits = 0;
+    for (const char c : in) {
+        if (c == '=') {
+            break;
+        }
+        const auto pos = base64Chars.find(c);
+        if (pos == std::string_view::npos) {
+            return false;
+        }
+        v = (v << 6) | static_cast<uint32_t>(pos);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<char>((v >> bits) & 0xff));
+        }
+    }
+    return true;
+}
+
+} // namespace
+
 
 FlagStorage::FlagStorage()
         : readCPUFlagsSlot("readCPUFlags", "Provides flag data to clients.")
@@ -71,6 +180,10 @@ bool FlagStorage::readCPUDataCallback(core::Call& caller) {
     if (fc == nullptr)
         return false;
 
+    if (isSerializationDue()) {
+        serializeCPUData();
+    }
+
     fc->setData(this->theCPUData, this->version);
     return true;
 }
@@ -82,9 +195,11 @@ bool FlagStorage::writeCPUDataCallback(core::Call& caller) {
         return false;
 
     if (fc->version() > this->version) {
+        const auto previousVersion = this->version;
         this->theCPUData = fc->getData();
         this->version = fc->version();
-        serializeCPUData();
+        this->theCPUData->commitChanges(previousVersion, this->version);
+        markSerializationDirty(previousVersion);
     }
     return true;
 }
@@ -99,21 +214,6 @@ bool FlagStorage::writeMetaDataCallback(core::Call& caller) {
 }
 
 
-nlohmann::json FlagStorage::make_bit_array(
-    const FlagStorageTypes::index_vector& bit_starts, const FlagStorageTypes::index_vector& bit_ends) {
-    auto the_array = nlohmann::json::array();
-    for (uint32_t x = 0; x < bit_starts.size(); ++x) {
-        const auto& s = bit_starts[x];
-        const auto& e = bit_ends[x];
-        if (s == e) {
-            the_array.push_back(s);
-        } else {
-            the_array.push_back(nlohmann::json::array({s, e}));
-        }
-    }
-    return the_array;
-}
-
 void FlagStorage::array_to_bits(const nlohmann::json& json, FlagStorageTypes::flag_bits flag_bit) {
     for (auto& j : json) {
         if (j.is_array()) {
@@ -145,56 +245,78 @@ FlagStorageTypes::index_type FlagStorage::array_max(const nlohmann::json& json)
 }
 
 
+void FlagStorage::markSerializationDirty(FlagStorageTypes::flag_version_type previousVersion) {
+    scheduleSerialization();
+    markSerializationStale(previousVersion);
+}
+
+
+void FlagStorage::scheduleSerialization() {
+    lastWriteTime = std::chrono::steady_clock::now();
+    serializationPending = true;
+}
+
+
+void FlagStorage::markSerializationStale(FlagStorageTypes::flag_version_type previousVersion) {
+    const auto numChunks = (theCPUData->flags->size() + serializationChunkSize - 1) / serializationChunkSize;
+    staleChunks.resize(numChunks, 1);
+    serializedChunks.resize(numChunks);
+
+    std::vector<FlagCollection_CPU::index_range> changes;
+    if (theCPUData->getChangesSince(previousVersion, changes)) {
+        for (const auto& [begin, end] : changes) {
+            const auto lastChunk = std::min<std::size_t>((end - 1) / serializationChunkSize + 1, numChunks);
+            for (std::size_t c = begin / serializationChunkSize; c < lastChunk; ++c) {
+                staleChunks[c] = 1;
+            }
+        }
+    } else {
+        std::fill(staleChunks.begin(), staleChunks.end(), 1);
+    }
+}
+
+
+bool FlagStorage::isSerializationDue() const {
+    return serializationPending && std::chrono::steady_clock::now() - lastWriteTime >= serializationDelay;
+}
+
+
 void FlagStorage::serializeCPUData() {
+    serializationPending = false;
     if (skipFlagsSerializationParam.Param<core::param::BoolParam>()->Value()) {
         return;
     }
 
-    const auto& cdata = theCPUData->flags;
-
-    FlagStorageTypes::index_vector enabled_starts, enabled_ends;
-    FlagStorageTypes::index_vector filtered_starts, filtered_ends;
-    FlagStorageTypes::index_vector selected_starts, selected_ends;
-    FlagStorageTypes::index_type curr_enabled_start = -1, curr_filtered_start = -1, curr_selected_start = -1;
-
-#if 0 // serial version
-    const auto startSerialTime = std::chrono::high_resolution_clock::now();
-    for (index_type x = 0; x < cdata->size(); ++x) {
-        check_bits(FlagStorage::ENABLED, enabled_starts, enabled_ends, curr_enabled_start, x, cdata);
-        check_bits(FlagStorage::FILTERED, filtered_starts, filtered_ends, curr_filtered_start, x, cdata);
-        check_bits(FlagStorage::SELECTED, selected_starts, selected_ends, curr_selected_start, x, cdata);
-    }
-    terminate_bit(cdata, enabled_ends, curr_enabled_start);
-    terminate_bit(cdata, filtered_ends, curr_filtered_start);
-    terminate_bit(cdata, selected_ends, curr_selected_start);
-    const auto endSerialTime = std::chrono::high_resolution_clock::now();
-    ASSERT(enabled_starts.size() == enabled_ends.size());
-    ASSERT(filtered_starts.size() == filtered_ends.size());
-    ASSERT(selected_starts.size() == selected_ends.size());
-    nlohmann::json ser_data;
-    ser_data["enabled"] = make_bit_array(enabled_starts, enabled_ends);
-    ser_data["filtered"] = make_bit_array(filtered_starts, filtered_ends);
-    ser_data["selected"] = make_bit_array(selected_starts, selected_ends);
-    const std::chrono::duration<double, std::milli> diffSerialMillis = endSerialTime - startSerialTime;
-    Log::DefaultLog.WriteInfo("serial reduction: %lf ms", diffSerialMillis.count());
-    this->serializedFlags.Param<core::param::StringParam>()->SetValue(ser_data.dump().c_str());
-#else
-    const auto startParallelTime = std::chrono::high_resolution_clock::now();
-    BitsChecker bc(cdata);
-    tbb::parallel_reduce(tbb::blocked_range<int32_t>(0, static_cast<int32_t>(cdata->size()), 50000), bc);
-    const auto endParallelTime = std::chrono::high_resolution_clock::now();
-    ASSERT(bc.enabled_starts.size() == bc.enabled_ends.size());
-    ASSERT(bc.filtered_starts.size() == bc.filtered_ends.size());
-    ASSERT(bc.selected_starts.size() == bc.selected_ends.size());
-    nlohmann::json parallel_data;
-    parallel_data["enabled"] = make_bit_array(bc.enabled_starts, bc.enabled_ends);
-    parallel_data["filtered"] = make_bit_array(bc.filtered_starts, bc.filtered_ends);
-    parallel_data["selected"] = make_bit_array(bc.selected_starts, bc.selected_ends);
-    const std::chrono::duration<double, std::milli> diffParallelMillis = endParallelTime - startParallelTime;
-    Log::DefaultLog.WriteInfo("parallel reduction: %lf ms", diffParallelMillis.count());
-    this->serializedFlags.Param<core::param::StringParam>()->SetValue(parallel_data.dump().c_str());
-#endif
-    //ASSERT(parallel_data.dump() == ser_data.dump());
+    const auto& cdata = *theCPUData->flags;
+    const auto numChunks = (cdata.size() + serializationChunkSize - 1) / serializationChunkSize;
+    if (cdata.size() != serializedFlagCount) {
+        // the formerly last chunk changes its extent
+        const auto firstChanged = std::min(cdata.size(), serializedFlagCount) / serializationChunkSize;
+        staleChunks.resize(numChunks, 1);
+        serializedChunks.resize(numChunks);
+        std::fill(staleChunks.begin() + std::min(firstChanged, numChunks), staleChunks.end(), 1);
+        serializedFlagCount = cdata.size();
+    }
+
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, numChunks), [&](const tbb::blocked_range<std::size_t>& r) {
+        for (std::size_t c = r.begin(); c != r.end(); ++c) {
+            if (staleChunks[c] != 0) {
+                const auto begin = c * serializationChunkSize;
+                serializedChunks[c] = encodeRuns(cdata, begin, std::min(begin + serializationChunkSize, cdata.size()));
+                staleChunks[c] = 0;
+            }
+        }
+    });
+
+    std::string binary;
+    appendVarint(binary, cdata.size());
+    for (const auto& chunk : serializedChunks) {
+        binary += chunk;
+    }
+
+    // the parameter must not be parsed again, as it already matches the flags
+    this->serializedFlags.Param<core::param::StringParam>()->SetValue(
+        std::string(serializationPrefix) + encodeBase64(binary), false);
 }
 
 void FlagStorage::deserializeCPUData() {
@@ -202,8 +324,49 @@ void FlagStorage::deserializeCPUData() {
         return;
     }
 
+    // the encoded chunks do not match the loaded flags anymore
+    serializedChunks.clear();
+    staleChunks.clear();
+    serializedFlagCount = 0;
+
+    const std::string value = this->serializedFlags.Param<core::param::StringParam>()->Value();
+    if (value.compare(0, serializationPrefix.size(), serializationPrefix) == 0) {
+        std::string binary;
+        std::size_t pos = 0;
+        uint64_t count = 0;
+        if (!decodeBase64(std::string_view(value).substr(serializationPrefix.size()), binary) ||
+            !readVarint(binary, pos, count) || count > static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+            utility::log::Log::DefaultLog.WriteError("FlagStorage: failed decoding serialized flags");
+            return;
+        }
+        // Decode into a copy, such that corrupt values leave the flags untouched. The serialized flags replace all
+        // flags, only the bits that are not serialized are kept.
+        auto& flags = *theCPUData->flags;
+        FlagStorageTypes::flag_vector_type decoded(
+            count, FlagStorageTypes::to_integral(FlagStorageTypes::flag_bits::ENABLED));
+        std::copy_n(flags.begin(), std::min<std::size_t>(count, flags.size()), decoded.begin());
+        std::size_t index = 0;
+        while (pos < binary.size()) {
+            const auto bits = static_cast<uint8_t>(binary[pos++]);
+            uint64_t length = 0;
+            if (!readVarint(binary, pos, length) || length > count - index) {
+                utility::log::Log::DefaultLog.WriteError("FlagStorage: serialized flags are corrupt");
+                return;
+            }
+            for (const auto end = index + length; index < end; ++index) {
+                decoded[index] = (decoded[index] & ~serializedBits) | (bits & serializedBits);
+            }
+        }
+        if (index != count) {
+            utility::log::Log::DefaultLog.WriteError("FlagStorage: serialized flags are truncated");
+            return;
+        }
+        flags.swap(decoded);
+        return;
+    }
+
     try {
-        auto j = nlohmann::json::parse(this->serializedFlags.Param<core::param::StringParam>()->Value());
+        auto j = nlohmann::json::parse(value);
         FlagStorageTypes::index_type max_flag_index = 0;
         // reset all flags
         if (j.contains("enabled")) {
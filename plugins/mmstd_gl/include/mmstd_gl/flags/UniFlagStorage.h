@@ -123,12 +123,12 @@ protected:
     bool onJSONChanged(core::param::ParamSlot& slot) override;
 
     /**
-     * Helper to copy CPU flags to GL flags
+     * Helper to copy CPU flags to GL flags, only uploads the flags modified since gpu_version if possible
      */
     void CPU2GLCopy();
 
     /**
-     * Helper to copy GL flags to CPU flags
+     * Helper to copy GL flags to CPU flags, records the modified flags as the change from cpu_version
      */
     void GL2CPUCopy();
 
@@ -142,6 +142,16 @@ protected:
     std::shared_ptr<mmstd_gl::FlagCollection_GL> theGLData;
     bool cpu_stale = true;
     bool gpu_stale = true;
+
+    /** Version of the CPU flags last copied to or from the GL flags, if the GL flags match any version at all */
+    bool gpu_version_valid = false;
+    uint32_t gpu_version = 0;
+
+    /** Version of the flags last copied from GL to CPU or written on the CPU */
+    uint32_t cpu_version = 0;
+
+    /** Buffer for comparing the downloaded GL flags with the CPU flags */
+    core::FlagStorageTypes::flag_vector_type downloadedFlags;
 };
 
 } // namespace megamol::mmstd_gl
@@ -6,6 +6,8 @@
 
 #include "mmstd_gl/flags/UniFlagStorage.h"
 
+#include <algorithm>
+
 #include "OpenGL_Context.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore_gl/utility/ShaderFactory.h"
@@ -82,9 +84,13 @@ bool UniFlagStorage::readGLDataCallback(core::Call& caller) {
         gpu_stale = false;
     }
 
-    // this is for debugging only
-    //GL2CPUCopy();
-    //serializeCPUData();
+    if (isSerializationDue()) {
+        if (cpu_stale) {
+            GL2CPUCopy();
+            cpu_stale = false;
+        }
+        serializeCPUData();
+    }
 
     fc->setData(this->theGLData, this->version);
     return true;
@@ -96,19 +102,17 @@ bool UniFlagStorage::writeGLDataCallback(core::Call& caller) {
         return false;
 
     if (fc->version() > this->version) {
+        if (!cpu_stale) {
+            cpu_version = this->version;
+        }
         this->theGLData = fc->getData();
         this->version = fc->version();
         cpu_stale = true;
+        gpu_version_valid = true;
+        gpu_version = this->version;
 
-        if (!skipFlagsSerializationParam.Param<core::param::BoolParam>()->Value()) {
-            // TODO try to avoid this and only fetch the serialization data from the GPU!!!! (if and when it works)
-            // see compress_bitflags.comp.glsl (never tested yet!)
-            // -> replace the whole block below with serializeData()
-            // actually with TBB performance is fine already haha
-            GL2CPUCopy();
-            cpu_stale = false; // on purpose!
-            serializeCPUData();
-        }
+        // GL writers do not record their modifications, they are determined when the flags are downloaded
+        scheduleSerialization();
     }
     return true;
 }
@@ -131,6 +135,7 @@ bool UniFlagStorage::writeCPUDataCallback(core::Call& caller) {
         //this->theCPUData = fc->getData();
         //this->version = fc->version();
         gpu_stale = true;
+        cpu_stale = false;
         //serializeCPUData();
     }
     return core::FlagStorage::writeCPUDataCallback(caller);
@@ -150,21 +155,53 @@ void UniFlagStorage::serializeGLData() {
 bool UniFlagStorage::onJSONChanged(core::param::ParamSlot& slot) {
     if (cpu_stale) {
         GL2CPUCopy();
+        cpu_stale = false;
     }
     deserializeCPUData();
     gpu_stale = true;
+    gpu_version_valid = false;
     return true;
 }
 
 void UniFlagStorage::CPU2GLCopy() {
+    constexpr auto itemSize = sizeof(core::FlagStorageTypes::flag_item_type);
     const auto& flags = *theCPUData->flags;
+
+    std::vector<core::FlagCollection_CPU::index_range> changes;
+    const bool incremental = gpu_version_valid && theGLData->flags != nullptr &&
+                             theGLData->flags->getByteSize() / itemSize >= flags.size() &&
+                             theCPUData->getChangesSince(gpu_version, changes);
+
     theGLData->validateFlagCount(flags.size());
-    glNamedBufferSubData(
-        theGLData->flags->getName(), 0, flags.size() * sizeof(core::FlagStorageTypes::flag_item_type), flags.data());
+    if (incremental) {
+        for (const auto& [begin, end] : changes) {
+            const auto clampedEnd = std::min<std::size_t>(end, flags.size());
+            if (static_cast<std::size_t>(begin) < clampedEnd) {
+                glNamedBufferSubData(theGLData->flags->getName(), begin * itemSize, (clampedEnd - begin) * itemSize,
+                    flags.data() + begin);
+            }
+        }
+    } else {
+        glNamedBufferSubData(theGLData->flags->getName(), 0, flags.size() * itemSize, flags.data());
+    }
+    gpu_version_valid = true;
+    gpu_version = this->version;
 }
 
 void UniFlagStorage::GL2CPUCopy() {
     auto const num = theGLData->flags->getByteSize() / sizeof(core::FlagStorageTypes::flag_item_type);
-    theCPUData->validateFlagCount(num);
-    glGetNamedBufferSubData(theGLData->flags->getName(), 0, theGLData->flags->getByteSize(), theCPUData->flags->data());
+    downloadedFlags.resize(num);
+    glGetNamedBufferSubData(theGLData->flags->getName(), 0, theGLData->flags->getByteSize(), downloadedFlags.data());
+
+    // Determine the modifications of the GL writers once here, such that the CPU readers and the serialization only
+    // need to process the modified flags
+    theCPUData->clearDirty();
+    theCPUData->assignAndMarkDirty(downloadedFlags.data(), num);
+    if (cpu_version != this->version) {
+        theCPUData->commitChanges(cpu_version, this->version);
+        markSerializationStale(cpu_version);
+    } else {
+        theCPUData->clearDirty();
+    }
+    cpu_version = this->version;
 }
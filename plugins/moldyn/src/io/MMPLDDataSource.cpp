@@ -15,6 +15,13 @@
 #include "vislib/sys/FastFile.h"
 #include "vislib/sys/SystemInformation.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* !_WIN32 */
+
 namespace megamol::moldyn::io {
 
 
@@ -31,7 +38,11 @@ namespace megamol::moldyn::io {
 /*
  * MMPLDDataSource::Frame::Frame
  */
-MMPLDDataSource::Frame::Frame(AnimDataModule& owner) : AnimDataModule::Frame(owner), dat() {
+MMPLDDataSource::Frame::Frame(AnimDataModule& owner)
+        : AnimDataModule::Frame(owner)
+        , dat()
+        , mapped()
+        , mappedSize(0) {
     // intentionally empty
 }
 
@@ -50,17 +61,49 @@ MMPLDDataSource::Frame::~Frame() {
 bool MMPLDDataSource::Frame::LoadFrame(vislib::sys::File* file, unsigned int idx, UINT64 size, unsigned int version) {
     this->frame = idx;
     this->fileVersion = version;
+    this->mapped.reset();
+    this->mappedSize = 0;
     this->dat.EnforceSize(static_cast<SIZE_T>(size));
     return (file->Read(this->dat, size) == size);
 }
 
 
+/*
+ * MMPLDDataSource::Frame::MapFrame
+ */
+bool MMPLDDataSource::Frame::MapFrame(std::shared_ptr<const char> const& mapping, UINT64 offset, unsigned int idx,
+    UINT64 size, unsigned int version) {
+    this->frame = idx;
+    this->fileVersion = version;
+    this->dat.EnforceSize(0);
+    if (mapping == nullptr) {
+        this->mapped.reset();
+        this->mappedSize = 0;
+        return false;
+    }
+    // shares the ownership of the whole mapping, pointing to the frame
+    const char* data = mapping.get() + offset;
+    this->mapped = std::shared_ptr<const char>(mapping, data);
+    this->mappedSize = static_cast<SIZE_T>(size);
+#ifndef _WIN32
+    // hint the kernel to start paging in the frame asynchronously
+    long const pageSize = ::sysconf(_SC_PAGESIZE);
+    if (pageSize > 0) {
+        uintptr_t const begin = reinterpret_cast<uintptr_t>(data) & ~static_cast<uintptr_t>(pageSize - 1);
+        ::madvise(reinterpret_cast<void*>(begin), static_cast<size_t>(reinterpret_cast<uintptr_t>(data) - begin + size),
+            MADV_WILLNEED);
+    }
+#endif /* !_WIN32 */
+    return true;
+}
+
+
 /*
  * MMPLDDataSource::Frame::SetData
  */
 void MMPLDDataSource::Frame::SetData(
     geocalls::MultiParticleDataCall& call, vislib::math::Cuboid<float> const& bbox, bool overrideBBox) {
-    if (this->dat.IsEmpty()) {
+    if ((this->mapped == nullptr) ? this->dat.IsEmpty() : (this->mappedSize == 0)) {
         call.SetParticleListCount(0);
         return;
     }
@@ -70,18 +113,18 @@ void MMPLDDataSource::Frame::SetData(
     // HAZARD for megamol up to fc4e784dae531953ad4cd3180f424605474dd18b this reads == 102
     // which means that many MMPLDs out there with version 103 are written wrongly (no timestamp)!
     if (this->fileVersion >= 102) {
-        timestamp = *this->dat.AsAt<float>(p);
+        timestamp = *this->dataAt<float>(p);
         p += sizeof(float);
     }
-    UINT32 plc = *this->dat.AsAt<UINT32>(p);
+    UINT32 plc = *this->dataAt<UINT32>(p);
     p += sizeof(UINT32);
     call.SetParticleListCount(plc);
     for (UINT32 i = 0; i < plc; i++) {
         geocalls::MultiParticleDataCall::Particles& pts = call.AccessParticles(i);
 
-        UINT8 vrtType = *this->dat.AsAt<UINT8>(p);
+        UINT8 vrtType = *this->dataAt<UINT8>(p);
         p += 1;
-        UINT8 colType = *this->dat.AsAt<UINT8>(p);
+        UINT8 colType = *this->dataAt<UINT8>(p);
         p += 1;
         geocalls::MultiParticleDataCall::Particles::VertexDataType vrtDatType;
         geocalls::MultiParticleDataCall::Particles::ColourDataType colDatType;
@@ -160,7 +203,7 @@ void MMPLDDataSource::Frame::SetData(
         unsigned int stride = static_cast<unsigned int>(vrtSize + colSize);
 
         if ((vrtType == 1) || (vrtType == 3) || (vrtType == 4)) {
-            pts.SetGlobalRadius(*this->dat.AsAt<float>(p));
+            pts.SetGlobalRadius(*this->dataAt<float>(p));
             p += 4;
         } else {
             pts.SetGlobalRadius(0.05f);
@@ -168,23 +211,23 @@ void MMPLDDataSource::Frame::SetData(
 
         if (colType == 0) {
             pts.SetGlobalColour(
-                *this->dat.AsAt<UINT8>(p), *this->dat.AsAt<UINT8>(p + 1), *this->dat.AsAt<UINT8>(p + 2));
+                *this->dataAt<UINT8>(p), *this->dataAt<UINT8>(p + 1), *this->dataAt<UINT8>(p + 2));
             p += 4;
         } else {
             pts.SetGlobalColour(192, 192, 192);
             if (colType == 3 || colType == 7) {
-                pts.SetColourMapIndexValues(*this->dat.AsAt<float>(p), *this->dat.AsAt<float>(p + 4));
+                pts.SetColourMapIndexValues(*this->dataAt<float>(p), *this->dataAt<float>(p + 4));
                 p += 8;
             } else {
                 pts.SetColourMapIndexValues(0.0f, 1.0f);
             }
         }
 
-        pts.SetCount(*this->dat.AsAt<UINT64>(p));
+        pts.SetCount(*this->dataAt<UINT64>(p));
         p += 8;
 
         if (this->fileVersion >= 103) {
-            auto const box = this->dat.AsAt<float>(p);
+            auto const box = this->dataAt<float>(p);
             vislib::math::Cuboid<float> bbox;
             bbox.Set(box[0], box[1], box[2], box[3], box[4], box[5]);
             pts.SetBBox(bbox);
@@ -194,8 +237,8 @@ void MMPLDDataSource::Frame::SetData(
             pts.SetBBox(bbox);
         }
 
-        pts.SetVertexData(vrtDatType, this->dat.At(p), stride);
-        pts.SetColourData(colDatType, this->dat.At(p + vrtSize), stride);
+        pts.SetVertexData(vrtDatType, this->dataAt<char>(p), stride);
+        pts.SetColourData(colDatType, this->dataAt<char>(p + vrtSize), stride);
 
         p += static_cast<SIZE_T>(stride * pts.GetCount());
 
@@ -203,12 +246,12 @@ void MMPLDDataSource::Frame::SetData(
             // TODO: who deletes this?
             geocalls::SimpleSphericalParticles::ClusterInfos* ci =
                 new geocalls::SimpleSphericalParticles::ClusterInfos();
-            ci->numClusters = *this->dat.AsAt<unsigned int>(p);
+            ci->numClusters = *this->dataAt<unsigned int>(p);
             p += sizeof(unsigned int);
-            ci->sizeofPlainData = *this->dat.AsAt<size_t>(p);
+            ci->sizeofPlainData = *this->dataAt<size_t>(p);
             p += sizeof(size_t);
             ci->plainData = (unsigned int*) malloc(ci->sizeofPlainData);
-            memcpy(ci->plainData, this->dat.At(p), ci->sizeofPlainData);
+            memcpy(ci->plainData, this->dataAt<char>(p), ci->sizeofPlainData);
             p += ci->sizeofPlainData;
             pts.SetClusterInfos(ci);
         }
@@ -227,9 +270,14 @@ MMPLDDataSource::MMPLDDataSource()
         , limitMemorySlot("limitMemory", "Limits the memory cache size")
         , limitMemorySizeSlot("limitMemorySize", "Specifies the size limit (in MegaBytes) of the memory cache")
         , overrideBBoxSlot("overrideLocalBBox", "Override local bbox")
+        , useMemoryMappingSlot("useMemoryMapping",
+              "Maps the file into memory and hands out the particle data without copying. The memory cache size "
+              "then only limits the read-ahead.")
         , getData("getdata", "Slot to request data from this data source.")
         , file(NULL)
         , frameIdx(NULL)
+        , mappedData()
+        , mappedSize(0)
         , bbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
         , clipbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
         , data_hash(0) {
@@ -254,6 +302,10 @@ MMPLDDataSource::MMPLDDataSource()
     this->overrideBBoxSlot << new core::param::BoolParam(false);
     this->MakeSlotAvailable(&this->overrideBBoxSlot);
 
+    this->useMemoryMappingSlot << new core::param::BoolParam(false);
+    this->useMemoryMappingSlot.SetUpdateCallback(&MMPLDDataSource::filenameChanged);
+    this->MakeSlotAvailable(&this->useMemoryMappingSlot);
+
     this->getData.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
         geocalls::MultiParticleDataCall::FunctionName(0), &MMPLDDataSource::getDataCallback);
     this->getData.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
@@ -306,6 +358,15 @@ void MMPLDDataSource::loadFrame(AnimDataModule::Frame* frame, unsigned int idx)
     //printf("Requesting frame %u of %u frames\n", idx, this->FrameCount());
     //Log::DefaultLog.WriteInfo( "Requesting frame %u of %u frames\n", idx, this->FrameCount());
     ASSERT(idx < this->FrameCount());
+    if (this->mappedData != nullptr) {
+        if ((this->frameIdx[idx] > this->frameIdx[idx + 1]) || (this->frameIdx[idx + 1] > this->mappedSize) ||
+            !f->MapFrame(this->mappedData, this->frameIdx[idx], idx, this->frameIdx[idx + 1] - this->frameIdx[idx],
+                this->fileVersion)) {
+            f->Clear();
+            Log::DefaultLog.WriteError("Unable to map frame %d from MMPLD file\n", idx);
+        }
+        return;
+    }
     this->file->Seek(this->frameIdx[idx]);
     if (!f->LoadFrame(this->file, idx, this->frameIdx[idx + 1] - this->frameIdx[idx], this->fileVersion)) {
         // failed
@@ -325,6 +386,7 @@ void MMPLDDataSource::release() {
         f->Close();
         delete f;
     }
+    this->unmapFile();
     ARY_SAFE_DELETE(this->frameIdx);
 }
 
@@ -336,6 +398,7 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
     using megamol::core::utility::log::Log;
     using vislib::sys::File;
     this->resetFrameCache();
+    this->unmapFile();
     this->bbox.Set(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f);
     this->clipbox = this->bbox;
     this->data_hash++;
@@ -406,6 +469,16 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
     size /= static_cast<double>(frmCnt);
     size *= CACHE_FRAME_FACTOR;
 
+    if (this->useMemoryMappingSlot.Param<core::param::BoolParam>()->Value()) {
+        if (this->mapFile(this->filename.Param<core::param::FilePathParam>()->Value())) {
+            if (this->frameIdx[frmCnt] > this->mappedSize) {
+                Log::DefaultLog.WriteWarn("MMPLD frame index exceeds file size; truncated frames will be empty.");
+            }
+        } else {
+            Log::DefaultLog.WriteWarn("Unable to memory-map MMPLD file. Falling back to reading frames.");
+        }
+    }
+
     UINT64 mem = vislib::sys::SystemInformation::AvailableMemorySize();
     if (this->limitMemorySlot.Param<core::param::BoolParam>()->Value()) {
         mem = vislib::math::Min(mem,
@@ -427,6 +500,8 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(msg);
     }
 
+    // mapped frames can be set up concurrently, reading frames shares 'file'
+    this->setLoaderThreadCount((this->mappedData != nullptr) ? 2 : 1);
     this->setFrameCount(frmCnt);
     this->initFrameCache(cacheSize);
 
@@ -437,6 +512,75 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
 }
 
 
+/*
+ * MMPLDDataSource::mapFile
+ */
+bool MMPLDDataSource::mapFile(std::filesystem::path const& path) {
+    this->unmapFile();
+
+#ifdef _WIN32
+    HANDLE fileHandle = ::CreateFileW(path.native().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!::GetFileSizeEx(fileHandle, &fileSize) || (fileSize.QuadPart <= 0)) {
+        ::CloseHandle(fileHandle);
+        return false;
+    }
+    HANDLE mappingHandle = ::CreateFileMappingW(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    ::CloseHandle(fileHandle);
+    if (mappingHandle == NULL) {
+        return false;
+    }
+    void* view = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    // the view keeps its own references to the mapping object and the file
+    ::CloseHandle(mappingHandle);
+    if (view == NULL) {
+        return false;
+    }
+    const UINT64 size = static_cast<UINT64>(fileSize.QuadPart);
+    this->mappedData =
+        std::shared_ptr<const char>(static_cast<const char*>(view), [](const char* data) { ::UnmapViewOfFile(data); });
+#else  /* _WIN32 */
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if ((::fstat(fd, &st) != 0) || (st.st_size <= 0)) {
+        ::close(fd);
+        return false;
+    }
+    // MAP_SHARED lets all processes on this node use the same page cache
+    void* view = ::mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    ::madvise(view, static_cast<size_t>(st.st_size), MADV_RANDOM);
+    const UINT64 size = static_cast<UINT64>(st.st_size);
+    this->mappedData = std::shared_ptr<const char>(static_cast<const char*>(view),
+        [size](const char* data) { ::munmap(const_cast<char*>(data), static_cast<size_t>(size)); });
+#endif /* _WIN32 */
+
+    this->mappedSize = size;
+    return true;
+}
+
+
+/*
+ * MMPLDDataSource::unmapFile
+ */
+void MMPLDDataSource::unmapFile() {
+    // frames still handed out keep the mapping alive until they are unlocked
+    this->mappedData.reset();
+    this->mappedSize = 0;
+}
+
+
 /*
  * MMPLDDataSource::getDataCallback
  */
@@ -16,6 +16,9 @@
 #include "vislib/sys/File.h"
 #include "vislib/types.h"
 
+#include <filesystem>
+#include <memory>
+
 
 namespace megamol::moldyn::io {
 
@@ -108,6 +111,8 @@ protected:
          */
         inline void Clear() {
             this->dat.EnforceSize(0);
+            this->mapped.reset();
+            this->mappedSize = 0;
         }
 
         /**
@@ -123,6 +128,31 @@ protected:
          */
         bool LoadFrame(vislib::sys::File* file, unsigned int idx, UINT64 size, unsigned int version);
 
+        /**
+         * Points this object to frame data residing in a memory-mapped
+         * file. No data is copied; this frame keeps the mapping alive as
+         * long as it references it.
+         *
+         * @param mapping The mapping of the whole file
+         * @param offset The offset of the frame in the mapping in bytes
+         * @param idx The zero-based index of the frame
+         * @param size The size of the frame data in bytes
+         * @param version File version (100 = standard, 101 with clusterInfos)
+         *
+         * @return True on success
+         */
+        bool MapFrame(std::shared_ptr<const char> const& mapping, UINT64 offset, unsigned int idx, UINT64 size,
+            unsigned int version);
+
+        /**
+         * Answer the mapped frame data.
+         *
+         * @return The frame data inside the file mapping, or empty if the data has been loaded
+         */
+        inline std::shared_ptr<const char> const& MappedData() const {
+            return this->mapped;
+        }
+
         /**
          * Sets the data into the call
          *
@@ -131,9 +161,28 @@ protected:
         void SetData(geocalls::MultiParticleDataCall& call, vislib::math::Cuboid<float> const& bbox, bool overrideBBox);
 
     private:
+        /**
+         * Answer the frame data, either mapped or loaded.
+         *
+         * @param offset The offset in bytes from the beginning of the frame
+         *
+         * @return Pointer to the frame data at 'offset'
+         */
+        template<class T>
+        inline const T* dataAt(SIZE_T offset) const {
+            return reinterpret_cast<const T*>(
+                ((this->mapped != nullptr) ? this->mapped.get() : this->dat.As<char>()) + offset);
+        }
+
         /** position data per type */
         vislib::RawStorage dat;
 
+        /** frame data inside the file mapping, or empty if 'dat' holds the data */
+        std::shared_ptr<const char> mapped;
+
+        /** size of the mapped frame data in bytes */
+        SIZE_T mappedSize;
+
         /** file version */
         unsigned int fileVersion;
     };
@@ -149,7 +198,10 @@ protected:
          *
          * @param frame The frame to unlock
          */
-        Unlocker(Frame& frame) : geocalls::MultiParticleDataCall::Unlocker(), frame(&frame) {
+        Unlocker(Frame& frame)
+                : geocalls::MultiParticleDataCall::Unlocker()
+                , frame(&frame)
+                , mapping(frame.MappedData()) {
             // intentionally empty
         }
 
@@ -165,11 +217,15 @@ protected:
                 this->frame->Unlock();
                 this->frame = NULL; // DO NOT DELETE!
             }
+            this->mapping.reset();
         }
 
     private:
         /** The frame to unlock */
         Frame* frame;
+
+        /** Keeps the mapped frame data valid until unlocked, even if the file is unmapped meanwhile */
+        std::shared_ptr<const char> mapping;
     };
 
     /**
@@ -181,6 +237,20 @@ protected:
      */
     bool filenameChanged(core::param::ParamSlot& slot);
 
+    /**
+     * Maps the whole file read-only into the address space of the process.
+     *
+     * @param path The path of the file to map
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool mapFile(std::filesystem::path const& path);
+
+    /**
+     * Releases the file mapping, if any.
+     */
+    void unmapFile();
+
     /**
      * Gets the data from the source.
      *
@@ -211,6 +281,9 @@ protected:
     /** Override local bbox */
     core::param::ParamSlot overrideBBoxSlot;
 
+    /** Hands out the data directly from a memory-mapped file */
+    core::param::ParamSlot useMemoryMappingSlot;
+
     /** The slot for requesting data */
     core::CalleeSlot getData;
 
@@ -220,6 +293,16 @@ protected:
     /** The frame index table */
     UINT64* frameIdx;
 
+    /**
+     * The read-only mapping of the whole data file, or empty if frames are
+     * read into memory. Mapped frames and their unlockers share ownership,
+     * so the file is only unmapped after the last frame has been released.
+     */
+    std::shared_ptr<const char> mappedData;
+
+    /** The size of the file mapping in bytes */
+    UINT64 mappedSize;
+
     /** The data set bounding box */
     vislib::math::Cuboid<float> bbox;
 
@@ -8,10 +8,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <memory>
 #include <random>
 #include <string>
 #include <variant>
+#include <vector>
 
 namespace megamol {
 namespace probe {
@@ -59,7 +63,7 @@ public:
     void probe(DatafieldType const& datafield) { /* ToDo*/
     }
 
-    std::shared_ptr<SamplingResult> getSamplingResult() const {
+    std::shared_ptr<SamplingResult> const& getSamplingResult() const {
         return m_result;
     }
 
@@ -88,7 +92,7 @@ public:
     void probe(DatafieldType const& datafield) { /* ToDo*/
     }
 
-    std::shared_ptr<SamplingResult> getSamplingResult() const {
+    std::shared_ptr<SamplingResult> const& getSamplingResult() const {
         return m_result;
     }
 
@@ -113,7 +117,7 @@ public:
     void probe(DatafieldType const& datafield) { /* ToDo*/
     }
 
-    std::shared_ptr<SamplingResult> getSamplingResult() const {
+    std::shared_ptr<SamplingResult> const& getSamplingResult() const {
         return m_result;
     }
 
@@ -144,30 +148,77 @@ public:
         return std::get<ProbeType>(m_probes[idx]);
     }
 
+    /**
+     * Provides in-place access to a probe of known type. Different probes may
+     * be accessed concurrently.
+     */
+    template<typename ProbeType>
+    ProbeType& getProbeRef(size_t idx) {
+        return std::get<ProbeType>(m_probes[idx]);
+    }
+
     GenericProbe getGenericProbe(size_t idx) const {
         return m_probes[idx];
     }
 
+    GenericProbe& getGenericProbeRef(size_t idx) {
+        return m_probes[idx];
+    }
+
     BaseProbe getBaseProbe(size_t idx) const {
-        using T = std::decay_t<decltype(m_probes[idx])>;
-        if constexpr (std::is_same_v<T, probe::FloatProbe>) {
-            FloatProbe fp = std::get<FloatProbe>(m_probes[idx]);
-            FloatProbe* fpp = &fp;
-            BaseProbe* bpp = dynamic_cast<BaseProbe*>(fpp);
-            return *bpp;
-        } else if constexpr (std::is_same_v<T, probe::IntProbe>) {
-            IntProbe ip = std::get<IntProbe>(m_probes[idx]);
-            IntProbe* ipp = &ip;
-            BaseProbe* bpp = dynamic_cast<BaseProbe*>(ipp);
-            return *bpp;
-        } else if constexpr (std::is_same_v<T, probe::Vec4Probe>) {
-            Vec4Probe vecp = std::get<Vec4Probe>(m_probes[idx]);
-            Vec4Probe* vecpp = &vecp;
-            BaseProbe* bpp = dynamic_cast<BaseProbe*>(vecpp);
-            return *bpp;
-        } else {
-            return std::get<BaseProbe>(m_probes[idx]);
+        return std::visit([](auto const& probe) -> BaseProbe { return probe; }, m_probes[idx]);
+    }
+
+    /**
+     * Converts all probes which are not of type 'ProbeType' into this type,
+     * retaining their BaseProbe attributes. The sampling results of converted
+     * probes are empty.
+     */
+    template<typename ProbeType>
+    void convertProbes() {
+        auto const cnt = static_cast<int64_t>(m_probes.size());
+#pragma omp parallel for
+        for (int64_t i = 0; i < cnt; ++i) {
+            if (!std::holds_alternative<ProbeType>(m_probes[i])) {
+                ProbeType probe;
+                std::visit([&probe](auto const& arg) { static_cast<BaseProbe&>(probe) = arg; }, m_probes[i]);
+                m_probes[i] = std::move(probe);
+            }
+        }
+    }
+
+    /**
+     * Contiguous copies of the geometry of all probes, which allows for
+     * traversing the probes without touching the remaining attributes.
+     */
+    struct Geometry {
+        std::vector<std::array<float, 3>> positions;
+        std::vector<std::array<float, 3>> directions;
+        std::vector<float> begins;
+        std::vector<float> ends;
+    };
+
+    Geometry getGeometry() const {
+        Geometry geometry;
+        geometry.positions.resize(m_probes.size());
+        geometry.directions.resize(m_probes.size());
+        geometry.begins.resize(m_probes.size());
+        geometry.ends.resize(m_probes.size());
+
+        auto const cnt = static_cast<int64_t>(m_probes.size());
+#pragma omp parallel for
+        for (int64_t i = 0; i < cnt; ++i) {
+            std::visit(
+                [&geometry, i](auto const& probe) {
+                    geometry.positions[i] = probe.m_position;
+                    geometry.directions[i] = probe.m_direction;
+                    geometry.begins[i] = probe.m_begin;
+                    geometry.ends[i] = probe.m_end;
+                },
+                m_probes[i]);
         }
+
+        return geometry;
     }
 
     uint32_t getProbeCount() const {
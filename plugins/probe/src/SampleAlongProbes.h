@@ -95,6 +95,23 @@ protected:
     core::param::ParamSlot _vec_param_to_samplex_w;
 
 private:
+    /**
+     * Converts all probes into 'ProbeType', sets their sample radius to
+     * 'radius_scale' times the distance of two samples and answers their
+     * geometry for sampling them in parallel.
+     */
+    template<typename ProbeType>
+    ProbeCollection::Geometry prepareProbes(int samples_per_probe, float radius_scale);
+
+    /**
+     * Answers the cell of 'tri' containing each sample of each probe, ordered by probe. The walk through the
+     * triangulation uses its internal random generator and must not run concurrently, so the cells are located
+     * serially and each walk starts at the cell of the previous sample of the probe.
+     */
+    template<typename Triangulation>
+    static std::vector<typename Triangulation::Cell_handle> locateSamples(
+        const Triangulation& tri, const ProbeCollection::Geometry& geometry, int samples_per_probe);
+
     template<typename T>
     void doScalarSampling(const std::shared_ptr<pcl::KdTreeFLANN<pcl::PointXYZ>>& tree, std::vector<T>& data);
 
@@ -138,108 +155,133 @@ private:
 };
 
 
-template<typename T>
-void SampleAlongPobes::doScalarSampling(
-    const std::shared_ptr<pcl::KdTreeFLANN<pcl::PointXYZ>>& tree, std::vector<T>& data) {
-
-    const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
-    const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
-
-    float global_min = std::numeric_limits<float>::max();
-    float global_max = -std::numeric_limits<float>::max();
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
-
-        FloatProbe probe;
-
-        auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::Vec4Probe> ||
-                          std::is_same_v<T, probe::FloatDistributionProbe>) {
+template<typename ProbeType>
+ProbeCollection::Geometry SampleAlongPobes::prepareProbes(int samples_per_probe, float radius_scale) {
+    _probes->convertProbes<ProbeType>();
 
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-                probe.m_cluster_id = arg.m_cluster_id;
+    auto const probe_cnt = static_cast<int64_t>(_probes->getProbeCount());
+#pragma omp parallel for
+    for (int64_t i = 0; i < probe_cnt; ++i) {
+        auto& probe = _probes->getProbeRef<ProbeType>(i);
+        auto const sample_step = probe.m_end / static_cast<float>(samples_per_probe);
+        probe.m_sample_radius = radius_scale * sample_step;
+    }
 
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = 0.5 * sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
+    return _probes->getGeometry();
+}
 
-                _probes->setProbe(i, probe);
+template<typename Triangulation>
+std::vector<typename Triangulation::Cell_handle> SampleAlongPobes::locateSamples(
+    const Triangulation& tri, const ProbeCollection::Geometry& geometry, int samples_per_probe) {
+    using Point = typename Triangulation::Point;
+    using Cell_handle = typename Triangulation::Cell_handle;
 
-            } else if constexpr (std::is_same_v<T, probe::FloatProbe>) {
-                probe = arg;
+    auto const probe_cnt = static_cast<int64_t>(geometry.positions.size());
+    std::vector<Cell_handle> cells(probe_cnt * samples_per_probe);
+    for (int64_t i = 0; i < probe_cnt; ++i) {
+        auto const& position = geometry.positions[i];
+        auto const& direction = geometry.directions[i];
+        auto sample_step = geometry.ends[i] / static_cast<float>(samples_per_probe);
 
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
+        Cell_handle hint;
+        for (int j = 0; j < samples_per_probe; ++j) {
+            Point sample_point(position[0] + static_cast<float>(j) * sample_step * direction[0],
+                position[1] + static_cast<float>(j) * sample_step * direction[1],
+                position[2] + static_cast<float>(j) * sample_step * direction[2]);
+            hint = tri.locate(sample_point, hint);
+            cells[i * samples_per_probe + j] = hint;
+        }
+    }
+    return cells;
+}
 
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
 
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = 0.5 * sample_step * sample_radius_factor;
+template<typename T>
+void SampleAlongPobes::doScalarSampling(
+    const std::shared_ptr<pcl::KdTreeFLANN<pcl::PointXYZ>>& tree, std::vector<T>& data) {
 
-        std::shared_ptr<FloatProbe::SamplingResult> samples = probe.getSamplingResult();
+    const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
+    const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
+    const bool use_average = this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0;
 
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = -std::numeric_limits<float>::max();
-        float min_data = std::numeric_limits<float>::max();
-        float max_data = -std::numeric_limits<float>::max();
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
+    auto const geometry = prepareProbes<FloatProbe>(samples_per_probe, 0.5f * sample_radius_factor);
+    auto const probe_cnt = static_cast<int64_t>(_probes->getProbeCount());
 
-        for (int j = 0; j < samples_per_probe; j++) {
+    float global_min = std::numeric_limits<float>::max();
+    float global_max = -std::numeric_limits<float>::max();
+#pragma omp parallel
+    {
+        float local_min = std::numeric_limits<float>::max();
+        float local_max = -std::numeric_limits<float>::max();
+        std::vector<uint32_t> k_indices;
+        std::vector<float> k_distances;
+
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t i = 0; i < probe_cnt; i++) {
+            auto const& position = geometry.positions[i];
+            auto const& direction = geometry.directions[i];
+            auto sample_step = geometry.ends[i] / static_cast<float>(samples_per_probe);
+            auto radius = 0.5 * sample_step * sample_radius_factor;
+
+            auto const& samples = _probes->getProbeRef<FloatProbe>(i).getSamplingResult();
+
+            float min_value = std::numeric_limits<float>::max();
+            float max_value = -std::numeric_limits<float>::max();
+            float min_data = std::numeric_limits<float>::max();
+            float max_data = -std::numeric_limits<float>::max();
+            float avg_value = 0.0f;
+            samples->samples.resize(samples_per_probe);
 
-            pcl::PointXYZ sample_point;
-            sample_point.x = probe.m_position[0] + j * sample_step * probe.m_direction[0];
-            sample_point.y = probe.m_position[1] + j * sample_step * probe.m_direction[1];
-            sample_point.z = probe.m_position[2] + j * sample_step * probe.m_direction[2];
+            for (int j = 0; j < samples_per_probe; j++) {
 
-            std::vector<uint32_t> k_indices;
-            std::vector<float> k_distances;
+                pcl::PointXYZ sample_point;
+                sample_point.x = position[0] + j * sample_step * direction[0];
+                sample_point.y = position[1] + j * sample_step * direction[1];
+                sample_point.z = position[2] + j * sample_step * direction[2];
 
-            auto num_neighbors = tree->radiusSearch(sample_point, radius, k_indices, k_distances);
-            if (num_neighbors == 0) {
-                num_neighbors = tree->nearestKSearch(sample_point, 1, k_indices, k_distances);
-            }
+                auto num_neighbors = tree->radiusSearch(sample_point, radius, k_indices, k_distances);
+                if (num_neighbors == 0) {
+                    num_neighbors = tree->nearestKSearch(sample_point, 1, k_indices, k_distances);
+                }
 
-            // accumulate values
-            float value = 0;
-            for (int n = 0; n < num_neighbors; n++) {
-                auto distance_weight = k_distances[n] / radius;
-                value += data[k_indices[n]] * distance_weight;
-                min_data = std::min(min_data, static_cast<float>(data[k_indices[n]]));
-                max_data = std::max(max_data, static_cast<float>(data[k_indices[n]]));
-            } // end num_neighbors
-            value /= num_neighbors;
-            if (this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0) {
-                samples->samples[j] = value;
+                // accumulate values
+                float value = 0;
+                for (int n = 0; n < num_neighbors; n++) {
+                    auto distance_weight = k_distances[n] / radius;
+                    value += data[k_indices[n]] * distance_weight;
+                    min_data = std::min(min_data, static_cast<float>(data[k_indices[n]]));
+                    max_data = std::max(max_data, static_cast<float>(data[k_indices[n]]));
+                } // end num_neighbors
+                value /= num_neighbors;
+                if (use_average) {
+                    samples->samples[j] = value;
+                } else {
+                    samples->samples[j] = max_data;
+                }
+                min_value = std::min(min_value, value);
+                max_value = std::max(max_value, value);
+                avg_value += value;
+            } // end num samples per probe
+            avg_value /= samples_per_probe;
+            if (use_average) {
+                samples->average_value = avg_value;
+                samples->max_value = max_value;
+                samples->min_value = min_value;
             } else {
-                samples->samples[j] = max_data;
+                samples->average_value = max_data;
+                samples->max_value = max_data;
+                samples->min_value = max_data;
             }
-            min_value = std::min(min_value, value);
-            max_value = std::max(max_value, value);
-            avg_value += value;
-        } // end num samples per probe
-        avg_value /= samples_per_probe;
-        if (this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0) {
-            samples->average_value = avg_value;
-            samples->max_value = max_value;
-            samples->min_value = min_value;
-        } else {
-            samples->average_value = max_data;
-            samples->max_value = max_data;
-            samples->min_value = max_data;
+            local_min = std::min(local_min, samples->min_value);
+            local_max = std::max(local_max, samples->max_value);
+        } // end for probes
+
+#pragma omp critical
+        {
+            global_min = std::min(global_min, local_min);
+            global_max = std::max(global_max, local_max);
         }
-        global_min = std::min(global_min, samples->min_value);
-        global_max = std::max(global_max, samples->max_value);
-    } // end for probes
+    }
     _probes->setGlobalMinMax(global_min, global_max);
 }
 
@@ -250,91 +292,74 @@ inline void SampleAlongPobes::doScalarDistributionSampling(
     const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
     const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
 
+    auto const geometry = prepareProbes<FloatDistributionProbe>(samples_per_probe, 0.5f * sample_radius_factor);
+    auto const probe_cnt = static_cast<int64_t>(_probes->getProbeCount());
+
     float global_min = std::numeric_limits<float>::max();
     float global_max = -std::numeric_limits<float>::max();
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
-
-        FloatDistributionProbe probe;
-
-        auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::FloatProbe> ||
-                          std::is_same_v<T, probe::Vec4Probe>) {
-
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-                probe.m_cluster_id = arg.m_cluster_id;
-
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = 0.5 * sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
-
-                _probes->setProbe(i, probe);
-
-            } else if constexpr (std::is_same_v<T, probe::FloatDistributionProbe>) {
-                probe = arg;
-
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
-
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
-
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = 0.5 * sample_step * sample_radius_factor;
-
-        std::shared_ptr<FloatDistributionProbe::SamplingResult> samples = probe.getSamplingResult();
-
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = std::numeric_limits<float>::min();
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
-
-        for (int j = 0; j < samples_per_probe; j++) {
-
-            pcl::PointXYZ sample_point;
-            sample_point.x = probe.m_position[0] + j * sample_step * probe.m_direction[0];
-            sample_point.y = probe.m_position[1] + j * sample_step * probe.m_direction[1];
-            sample_point.z = probe.m_position[2] + j * sample_step * probe.m_direction[2];
-
-            std::vector<uint32_t> k_indices;
-            std::vector<float> k_distances;
-
-            auto num_neighbors = tree->radiusSearch(sample_point, radius, k_indices, k_distances);
-            if (num_neighbors == 0) {
-                num_neighbors = tree->nearestKSearch(sample_point, 1, k_indices, k_distances);
-            }
+#pragma omp parallel
+    {
+        float local_min = std::numeric_limits<float>::max();
+        float local_max = -std::numeric_limits<float>::max();
+        std::vector<uint32_t> k_indices;
+        std::vector<float> k_distances;
+
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t i = 0; i < probe_cnt; i++) {
+            auto const& position = geometry.positions[i];
+            auto const& direction = geometry.directions[i];
+            auto sample_step = geometry.ends[i] / static_cast<float>(samples_per_probe);
+            auto radius = 0.5 * sample_step * sample_radius_factor;
+
+            auto const& samples = _probes->getProbeRef<FloatDistributionProbe>(i).getSamplingResult();
+
+            float min_value = std::numeric_limits<float>::max();
+            float max_value = std::numeric_limits<float>::min();
+            float avg_value = 0.0f;
+            samples->samples.resize(samples_per_probe);
+
+            for (int j = 0; j < samples_per_probe; j++) {
+
+                pcl::PointXYZ sample_point;
+                sample_point.x = position[0] + j * sample_step * direction[0];
+                sample_point.y = position[1] + j * sample_step * direction[1];
+                sample_point.z = position[2] + j * sample_step * direction[2];
+
+                auto num_neighbors = tree->radiusSearch(sample_point, radius, k_indices, k_distances);
+                if (num_neighbors == 0) {
+                    num_neighbors = tree->nearestKSearch(sample_point, 1, k_indices, k_distances);
+                }
 
-            // accumulate values
-            float value = 0.0f;
-            float min_data = std::numeric_limits<float>::max();
-            float max_data = std::numeric_limits<float>::min();
-            for (int n = 0; n < num_neighbors; n++) {
-                value += data[k_indices[n]];
-                min_data = std::min(min_data, static_cast<float>(data[k_indices[n]]));
-                max_data = std::max(max_data, static_cast<float>(data[k_indices[n]]));
-            } // end num_neighbors
-            value /= num_neighbors;
-
-            samples->samples[j].mean = value;
-            samples->samples[j].lower_bound = min_data;
-            samples->samples[j].upper_bound = max_data;
-
-            min_value = std::min(min_value, min_data);
-            max_value = std::max(max_value, max_data);
-            avg_value += value;
-        } // end num samples per probe
-
-        global_min = std::min(global_min, min_value);
-        global_max = std::max(global_max, max_value);
-    } // end for probes
+                // accumulate values
+                float value = 0.0f;
+                float min_data = std::numeric_limits<float>::max();
+                float max_data = std::numeric_limits<float>::min();
+                for (int n = 0; n < num_neighbors; n++) {
+                    value += data[k_indices[n]];
+                    min_data = std::min(min_data, static_cast<float>(data[k_indices[n]]));
+                    max_data = std::max(max_data, static_cast<float>(data[k_indices[n]]));
+                } // end num_neighbors
+                value /= num_neighbors;
+
+                samples->samples[j].mean = value;
+                samples->samples[j].lower_bound = min_data;
+                samples->samples[j].upper_bound = max_data;
+
+                min_value = std::min(min_value, min_data);
+                max_value = std::max(max_value, max_data);
+                avg_value += value;
+            } // end num samples per probe
+
+            local_min = std::min(local_min, min_value);
+            local_max = std::max(local_max, max_value);
+        } // end for probes
+
+#pragma omp critical
+        {
+            global_min = std::min(global_min, local_min);
+            global_max = std::max(global_max, local_max);
+        }
+    }
     _probes->setGlobalMinMax(global_min, global_max);
 }
 
@@ -346,98 +371,51 @@ inline void SampleAlongPobes::doVectorSamling(const std::shared_ptr<pcl::KdTreeF
     const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
     const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
 
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
-
-        Vec4Probe probe;
-
-        auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::FloatProbe> ||
-                          std::is_same_v<T, probe::FloatDistributionProbe>) {
-
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-                probe.m_cluster_id = arg.m_cluster_id;
-
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
-
-                _probes->setProbe(i, probe);
-
-            } else if constexpr (std::is_same_v<T, probe::Vec4Probe>) {
-                probe = arg;
-
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
-
-                _probes->setProbe(i, probe);
-
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
+    auto const geometry = prepareProbes<Vec4Probe>(samples_per_probe, sample_radius_factor);
+    auto const probe_cnt = static_cast<int64_t>(_probes->getProbeCount());
 
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
-
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = sample_step * sample_radius_factor;
-
-        std::shared_ptr<Vec4Probe::SamplingResult> samples = probe.getSamplingResult();
+#pragma omp parallel
+    {
+        std::vector<uint32_t> k_indices;
+        std::vector<float> k_distances;
 
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = -std::numeric_limits<float>::max();
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t i = 0; i < probe_cnt; i++) {
+            auto const& position = geometry.positions[i];
+            auto const& direction = geometry.directions[i];
+            auto sample_step = geometry.ends[i] / static_cast<float>(samples_per_probe);
+            auto radius = sample_step * sample_radius_factor;
 
-        for (int j = 0; j < samples_per_probe; j++) {
+            auto const& samples = _probes->getProbeRef<Vec4Probe>(i).getSamplingResult();
+            samples->samples.resize(samples_per_probe);
 
-            pcl::PointXYZ sample_point;
-            sample_point.x = probe.m_position[0] + j * sample_step * probe.m_direction[0];
-            sample_point.y = probe.m_position[1] + j * sample_step * probe.m_direction[1];
-            sample_point.z = probe.m_position[2] + j * sample_step * probe.m_direction[2];
+            for (int j = 0; j < samples_per_probe; j++) {
 
-            std::vector<uint32_t> k_indices;
-            std::vector<float> k_distances;
-
-            auto num_neighbors = tree->radiusSearch(sample_point, radius, k_indices, k_distances);
-            if (num_neighbors == 0) {
-                num_neighbors = tree->nearestKSearch(sample_point, 1, k_indices, k_distances);
-            }
+                pcl::PointXYZ sample_point;
+                sample_point.x = position[0] + j * sample_step * direction[0];
+                sample_point.y = position[1] + j * sample_step * direction[1];
+                sample_point.z = position[2] + j * sample_step * direction[2];
 
+                auto num_neighbors = tree->radiusSearch(sample_point, radius, k_indices, k_distances);
+                if (num_neighbors == 0) {
+                    num_neighbors = tree->nearestKSearch(sample_point, 1, k_indices, k_distances);
+                }
 
-            // accumulate values
-            float value_x = 0, value_y = 0, value_z = 0, value_w = 0;
-            for (int n = 0; n < num_neighbors; n++) {
-                value_x += data_x[k_indices[n]];
-                value_y += data_y[k_indices[n]];
-                value_z += data_z[k_indices[n]];
-                value_w += data_w[k_indices[n]];
-            } // end num_neighbors
-            samples->samples[j][0] = value_x / num_neighbors;
-            ;
-            samples->samples[j][1] = value_y / num_neighbors;
-            ;
-            samples->samples[j][2] = value_z / num_neighbors;
-            ;
-            samples->samples[j][3] = value_w / num_neighbors;
-            ;
-            //min_value = std::min(min_value, value);
-            //max_value = std::max(max_value, value);
-            //avg_value += value;
-        } // end num samples per probe
-        //avg_value /= samples_per_probe;
-        //samples->average_value = avg_value;
-        //samples->max_value = max_value;
-        //samples->min_value = min_value;
-    } // end for probes
+                // accumulate values
+                float value_x = 0, value_y = 0, value_z = 0, value_w = 0;
+                for (int n = 0; n < num_neighbors; n++) {
+                    value_x += data_x[k_indices[n]];
+                    value_y += data_y[k_indices[n]];
+                    value_z += data_z[k_indices[n]];
+                    value_w += data_w[k_indices[n]];
+                } // end num_neighbors
+                samples->samples[j][0] = value_x / num_neighbors;
+                samples->samples[j][1] = value_y / num_neighbors;
+                samples->samples[j][2] = value_z / num_neighbors;
+                samples->samples[j][3] = value_w / num_neighbors;
+            } // end num samples per probe
+        }     // end for probes
+    }
 }
 
 
@@ -468,109 +446,91 @@ void SampleAlongPobes::doTetrahedralSampling(
     const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
     const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
 
+    auto const geometry = prepareProbes<FloatProbe>(samples_per_probe, 0.5f * sample_radius_factor);
+    auto const probe_cnt = static_cast<int64_t>(_probes->getProbeCount());
+    auto const cells = locateSamples(tri, geometry, samples_per_probe);
+
     float global_min = std::numeric_limits<float>::max();
     float global_max = std::numeric_limits<float>::lowest();
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); ++i) {
-
-        FloatProbe probe;
-
-        auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::Vec4Probe> ||
-                          std::is_same_v<T, probe::FloatDistributionProbe>) {
-
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-                probe.m_cluster_id = arg.m_cluster_id;
-
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = 0.5 * sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
-
-                _probes->setProbe(i, probe);
-
-            } else if constexpr (std::is_same_v<T, probe::FloatProbe>) {
-                probe = arg;
-
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
-
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
-
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = 0.5 * sample_step * sample_radius_factor;
-
-        std::shared_ptr<FloatProbe::SamplingResult> samples = probe.getSamplingResult();
-
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = std::numeric_limits<float>::lowest();
-        /*float min_data = std::numeric_limits<float>::max();
-        float max_data = -std::numeric_limits<float>::max();*/
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
+#pragma omp parallel
+    {
+        float local_min = std::numeric_limits<float>::max();
+        float local_max = std::numeric_limits<float>::lowest();
+
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t i = 0; i < probe_cnt; ++i) {
+            auto const& position = geometry.positions[i];
+            auto const& direction = geometry.directions[i];
+            auto sample_step = geometry.ends[i] / static_cast<float>(samples_per_probe);
+
+            auto const& samples = _probes->getProbeRef<FloatProbe>(i).getSamplingResult();
+
+            float min_value = std::numeric_limits<float>::max();
+            float max_value = std::numeric_limits<float>::lowest();
+            float avg_value = 0.0f;
+            samples->samples.resize(samples_per_probe);
+
+            for (int j = 0; j < samples_per_probe; ++j) {
+
+                Point sample_point(position[0] + static_cast<float>(j) * sample_step * direction[0],
+                    position[1] + static_cast<float>(j) * sample_step * direction[1],
+                    position[2] + static_cast<float>(j) * sample_step * direction[2]);
+
+                T val = std::numeric_limits<T>::signaling_NaN();
+
+                auto cell = cells[i * samples_per_probe + j];
+                if (!tri.is_infinite(cell)) {
+                    Tetrahedron tet_c = Tetrahedron(cell->vertex(0)->point(), cell->vertex(1)->point(),
+                        cell->vertex(2)->point(), cell->vertex(3)->point());
+                    Tetrahedron tet_0 = Tetrahedron(
+                        sample_point, cell->vertex(1)->point(), cell->vertex(2)->point(), cell->vertex(3)->point());
+                    Tetrahedron tet_1 = Tetrahedron(
+                        cell->vertex(0)->point(), sample_point, cell->vertex(2)->point(), cell->vertex(3)->point());
+                    Tetrahedron tet_2 = Tetrahedron(
+                        cell->vertex(0)->point(), cell->vertex(1)->point(), sample_point, cell->vertex(3)->point());
+                    Tetrahedron tet_3 = Tetrahedron(
+                        cell->vertex(0)->point(), cell->vertex(1)->point(), cell->vertex(2)->point(), sample_point);
+
+                    auto const V_c = tet_c.volume();
+
+                    auto const V_0 = tet_0.volume();
+                    auto const V_1 = tet_1.volume();
+                    auto const V_2 = tet_2.volume();
+                    auto const V_3 = tet_3.volume();
+
+                    auto const a_0 = V_0 / V_c;
+                    auto const a_1 = V_1 / V_c;
+                    auto const a_2 = V_2 / V_c;
+                    auto const a_3 = V_3 / V_c;
+
+                    auto const val_0 = cell->vertex(0)->info();
+                    auto const val_1 = cell->vertex(1)->info();
+                    auto const val_2 = cell->vertex(2)->info();
+                    auto const val_3 = cell->vertex(3)->info();
+
+                    val = a_0 * val_0 + a_1 * val_1 + a_2 * val_2 + a_3 * val_3;
+                }
+                samples->samples[j] = val;
 
-        for (int j = 0; j < samples_per_probe; ++j) {
+                min_value = std::min<decltype(min_value)>(min_value, val);
+                max_value = std::max<decltype(max_value)>(max_value, val);
+                avg_value += val;
+            } // end num samples per probe
 
-            Point sample_point(probe.m_position[0] + static_cast<float>(j) * sample_step * probe.m_direction[0],
-                probe.m_position[1] + static_cast<float>(j) * sample_step * probe.m_direction[1],
-                probe.m_position[2] + static_cast<float>(j) * sample_step * probe.m_direction[2]);
-
-            T val = std::numeric_limits<T>::signaling_NaN();
-
-            auto cell = tri.locate(sample_point);
-            if (!tri.is_infinite(cell)) {
-                Tetrahedron tet_c = Tetrahedron(cell->vertex(0)->point(), cell->vertex(1)->point(),
-                    cell->vertex(2)->point(), cell->vertex(3)->point());
-                Tetrahedron tet_0 = Tetrahedron(
-                    sample_point, cell->vertex(1)->point(), cell->vertex(2)->point(), cell->vertex(3)->point());
-                Tetrahedron tet_1 = Tetrahedron(
-                    cell->vertex(0)->point(), sample_point, cell->vertex(2)->point(), cell->vertex(3)->point());
-                Tetrahedron tet_2 = Tetrahedron(
-                    cell->vertex(0)->point(), cell->vertex(1)->point(), sample_point, cell->vertex(3)->point());
-                Tetrahedron tet_3 = Tetrahedron(
-                    cell->vertex(0)->point(), cell->vertex(1)->point(), cell->vertex(2)->point(), sample_point);
-
-                auto const V_c = tet_c.volume();
-
-                auto const V_0 = tet_0.volume();
-                auto const V_1 = tet_1.volume();
-                auto const V_2 = tet_2.volume();
-                auto const V_3 = tet_3.volume();
-
-                auto const a_0 = V_0 / V_c;
-                auto const a_1 = V_1 / V_c;
-                auto const a_2 = V_2 / V_c;
-                auto const a_3 = V_3 / V_c;
-
-                auto const val_0 = cell->vertex(0)->info();
-                auto const val_1 = cell->vertex(1)->info();
-                auto const val_2 = cell->vertex(2)->info();
-                auto const val_3 = cell->vertex(3)->info();
-
-                val = a_0 * val_0 + a_1 * val_1 + a_2 * val_2 + a_3 * val_3;
-            }
-            samples->samples[j] = val;
-
-            min_value = std::min<decltype(min_value)>(min_value, val);
-            max_value = std::max<decltype(max_value)>(max_value, val);
-            avg_value += val;
-        } // end num samples per probe
-
-        avg_value /= samples_per_probe;
-        samples->average_value = avg_value;
-        samples->max_value = max_value;
-        samples->min_value = min_value;
-        global_min = std::min(global_min, samples->min_value);
-        global_max = std::max(global_max, samples->max_value);
-    } // end for probes
+            avg_value /= samples_per_probe;
+            samples->average_value = avg_value;
+            samples->max_value = max_value;
+            samples->min_value = min_value;
+            local_min = std::min(local_min, samples->min_value);
+            local_max = std::max(local_max, samples->max_value);
+        } // end for probes
+
+#pragma omp critical
+        {
+            global_min = std::min(global_min, local_min);
+            global_max = std::max(global_max, local_max);
+        }
+    }
     _probes->setGlobalMinMax(global_min, global_max);
     _probes->shuffle_probes();
 }
@@ -613,124 +573,96 @@ inline void SampleAlongPobes::doTetrahedralVectorSamling(const std::shared_ptr<p
     const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
     const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
 
+    auto const geometry = prepareProbes<Vec4Probe>(samples_per_probe, sample_radius_factor);
+    auto const probe_cnt = static_cast<int64_t>(_probes->getProbeCount());
+    auto const cells = locateSamples(tri, geometry, samples_per_probe);
+
     std::vector<char> invalid_probes(_probes->getProbeCount(), 1);
 
     float global_min = std::numeric_limits<float>::max();
     float global_max = std::numeric_limits<float>::lowest();
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); ++i) {
-
-        Vec4Probe probe;
-
-        auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::FloatProbe> ||
-                          std::is_same_v<T, probe::FloatDistributionProbe>) {
-
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-                probe.m_cluster_id = arg.m_cluster_id;
-
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
-
-                _probes->setProbe(i, probe);
-
-            } else if constexpr (std::is_same_v<T, probe::Vec4Probe>) {
-                probe = arg;
-
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
-
-                _probes->setProbe(i, probe);
-
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
-
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
-
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = 0.5 * sample_step * sample_radius_factor;
-
-        std::shared_ptr<Vec4Probe::SamplingResult> samples = probe.getSamplingResult();
-
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = std::numeric_limits<float>::lowest();
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
-
-        for (int j = 0; j < samples_per_probe; ++j) {
-
-            Point sample_point(probe.m_position[0] + static_cast<float>(j) * sample_step * probe.m_direction[0],
-                probe.m_position[1] + static_cast<float>(j) * sample_step * probe.m_direction[1],
-                probe.m_position[2] + static_cast<float>(j) * sample_step * probe.m_direction[2]);
-
-            InfoType val = {std::numeric_limits<float>::signaling_NaN(), std::numeric_limits<float>::signaling_NaN(),
-                std::numeric_limits<float>::signaling_NaN(), std::numeric_limits<float>::signaling_NaN()};
-
-            auto cell = tri.locate(sample_point);
-            if (!tri.is_infinite(cell)) {
-                invalid_probes[i] = 0;
-
-                Tetrahedron tet_c = Tetrahedron(cell->vertex(0)->point(), cell->vertex(1)->point(),
-                    cell->vertex(2)->point(), cell->vertex(3)->point());
-                Tetrahedron tet_0 = Tetrahedron(
-                    sample_point, cell->vertex(1)->point(), cell->vertex(2)->point(), cell->vertex(3)->point());
-                Tetrahedron tet_1 = Tetrahedron(
-                    cell->vertex(0)->point(), sample_point, cell->vertex(2)->point(), cell->vertex(3)->point());
-                Tetrahedron tet_2 = Tetrahedron(
-                    cell->vertex(0)->point(), cell->vertex(1)->point(), sample_point, cell->vertex(3)->point());
-                Tetrahedron tet_3 = Tetrahedron(
-                    cell->vertex(0)->point(), cell->vertex(1)->point(), cell->vertex(2)->point(), sample_point);
-
-                auto const V_c = tet_c.volume();
-
-                auto const V_0 = tet_0.volume();
-                auto const V_1 = tet_1.volume();
-                auto const V_2 = tet_2.volume();
-                auto const V_3 = tet_3.volume();
-
-                auto const a_0 = V_0 / V_c;
-                auto const a_1 = V_1 / V_c;
-                auto const a_2 = V_2 / V_c;
-                auto const a_3 = V_3 / V_c;
-
-                auto const val_0 = cell->vertex(0)->info();
-                auto const val_1 = cell->vertex(1)->info();
-                auto const val_2 = cell->vertex(2)->info();
-                auto const val_3 = cell->vertex(3)->info();
-
-                std::get<0>(val) = a_0 * std::get<0>(val_0) + a_1 * std::get<0>(val_1) + a_2 * std::get<0>(val_2) +
-                                   a_3 * std::get<0>(val_3);
-                std::get<1>(val) = a_0 * std::get<1>(val_0) + a_1 * std::get<1>(val_1) + a_2 * std::get<1>(val_2) +
-                                   a_3 * std::get<1>(val_3);
-                std::get<2>(val) = a_0 * std::get<2>(val_0) + a_1 * std::get<2>(val_1) + a_2 * std::get<2>(val_2) +
-                                   a_3 * std::get<2>(val_3);
-                std::get<3>(val) = a_0 * std::get<3>(val_0) + a_1 * std::get<3>(val_1) + a_2 * std::get<3>(val_2) +
-                                   a_3 * std::get<3>(val_3);
-            }
-            std::array<float, 4> sample = {std::get<0>(val), std::get<1>(val), std::get<2>(val), std::get<3>(val)};
-            samples->samples[j] = sample;
-
-            min_value = std::min(min_value, std::get<3>(sample));
-            max_value = std::max(max_value, std::get<3>(sample));
-            avg_value += std::get<3>(sample);
-        } // end num samples per probe
-
-        avg_value /= samples_per_probe;
-
-        global_min = std::min(global_min, min_value);
-        global_max = std::max(global_max, max_value);
-    } // end for probes
+#pragma omp parallel
+    {
+        float local_min = std::numeric_limits<float>::max();
+        float local_max = std::numeric_limits<float>::lowest();
+
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t i = 0; i < probe_cnt; ++i) {
+            auto const& position = geometry.positions[i];
+            auto const& direction = geometry.directions[i];
+            auto sample_step = geometry.ends[i] / static_cast<float>(samples_per_probe);
+
+            auto const& samples = _probes->getProbeRef<Vec4Probe>(i).getSamplingResult();
+
+            float min_value = std::numeric_limits<float>::max();
+            float max_value = std::numeric_limits<float>::lowest();
+            float avg_value = 0.0f;
+            samples->samples.resize(samples_per_probe);
+
+            for (int j = 0; j < samples_per_probe; ++j) {
+
+                Point sample_point(position[0] + static_cast<float>(j) * sample_step * direction[0],
+                    position[1] + static_cast<float>(j) * sample_step * direction[1],
+                    position[2] + static_cast<float>(j) * sample_step * direction[2]);
+
+                InfoType val = {std::numeric_limits<float>::signaling_NaN(),
+                    std::numeric_limits<float>::signaling_NaN(), std::numeric_limits<float>::signaling_NaN(),
+                    std::numeric_limits<float>::signaling_NaN()};
+
+                auto cell = cells[i * samples_per_probe + j];
+                if (!tri.is_infinite(cell)) {
+                    invalid_probes[i] = 0;
+
+                    Tetrahedron tet_c = Tetrahedron(cell->vertex(0)->point(), cell->vertex(1)->point(),
+                        cell->vertex(2)->point(), cell->vertex(3)->point());
+                    Tetrahedron tet_0 = Tetrahedron(
+                        sample_point, cell->vertex(1)->point(), cell->vertex(2)->point(), cell->vertex(3)->point());
+                    Tetrahedron tet_1 = Tetrahedron(
+                        cell->vertex(0)->point(), sample_point, cell->vertex(2)->point(), cell->vertex(3)->point());
+                    Tetrahedron tet_2 = Tetrahedron(
+                        cell->vertex(0)->point(), cell->vertex(1)->point(), sample_point, cell->vertex(3)->point());
+                    Tetrahedron tet_3 = Tetrahedron(
+                        cell->vertex(0)->point(), cell->vertex(1)->point(), cell->vertex(2)->point(), sample_point);
+
+                    auto const V_c = tet_c.volume();
+
+                    auto const V_0 = tet_0.volume();
+                    auto const V_1 = tet_1.volume();
+                    auto const V_2 = tet_2.volume();
+                    auto const V_3 = tet_3.volume();
+
+                    auto const a_0 = V_0 / V_c;
+                    auto const a_1 = V_1 / V_c;
+                    auto const a_2 = V_2 / V_c;
+                    auto const a_3 = V_3 / V_c;
+
+                    auto const val_0 = cell->vertex(0)->info();
+                    auto const val_1 = cell->vertex(1)->info();
+                    auto const val_2 = cell->vertex(2)->info();
+                    auto const val_3 = cell->vertex(3)->info();
+
+                    for (int c = 0; c < 4; ++c) {
+                        val[c] = a_0 * val_0[c] + a_1 * val_1[c] + a_2 * val_2[c] + a_3 * val_3[c];
+                    }
+                }
+                std::array<float, 4> sample = {std::get<0>(val), std::get<1>(val), std::get<2>(val), std::get<3>(val)};
+                samples->samples[j] = sample;
+
+                min_value = std::min(min_value, std::get<3>(sample));
+                max_value = std::max(max_value, std::get<3>(sample));
+                avg_value += std::get<3>(sample);
+            } // end num samples per probe
+
+            local_min = std::min(local_min, min_value);
+            local_max = std::max(local_max, max_value);
+        } // end for probes
+
+#pragma omp critical
+        {
+            global_min = std::min(global_min, local_min);
+            global_max = std::max(global_max, local_max);
+        }
+    }
     _probes->setGlobalMinMax(global_min, global_max);
     _probes->erase_probes(invalid_probes);
     _probes->shuffle_probes();
@@ -764,90 +696,66 @@ void SampleAlongPobes::doNearestNeighborSampling(
     const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
     const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
 
+    auto const geometry = prepareProbes<FloatProbe>(samples_per_probe, 0.5f * sample_radius_factor);
+    auto const probe_cnt = static_cast<int64_t>(_probes->getProbeCount());
+    auto const cells = locateSamples(tri, geometry, samples_per_probe);
+
     float global_min = std::numeric_limits<float>::max();
     float global_max = std::numeric_limits<float>::lowest();
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); ++i) {
-
-        FloatProbe probe;
-
-        auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::Vec4Probe> ||
-                          std::is_same_v<T, probe::FloatDistributionProbe>) {
-
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-                probe.m_cluster_id = arg.m_cluster_id;
-
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = 0.5 * sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
-
-                _probes->setProbe(i, probe);
-
-            } else if constexpr (std::is_same_v<T, probe::FloatProbe>) {
-                probe = arg;
-
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
-
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
+#pragma omp parallel
+    {
+        float local_min = std::numeric_limits<float>::max();
+        float local_max = std::numeric_limits<float>::lowest();
 
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = 0.5 * sample_step * sample_radius_factor;
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t i = 0; i < probe_cnt; ++i) {
+            auto const& position = geometry.positions[i];
+            auto const& direction = geometry.directions[i];
+            auto sample_step = geometry.ends[i] / static_cast<float>(samples_per_probe);
 
-        std::shared_ptr<FloatProbe::SamplingResult> samples = probe.getSamplingResult();
+            auto const& samples = _probes->getProbeRef<FloatProbe>(i).getSamplingResult();
 
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = std::numeric_limits<float>::lowest();
-        /*float min_data = std::numeric_limits<float>::max();
-        float max_data = -std::numeric_limits<float>::max();*/
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
+            float min_value = std::numeric_limits<float>::max();
+            float max_value = std::numeric_limits<float>::lowest();
+            float avg_value = 0.0f;
+            samples->samples.resize(samples_per_probe);
 
-        for (int j = 0; j < samples_per_probe; ++j) {
+            for (int j = 0; j < samples_per_probe; ++j) {
 
-            Point sample_point(probe.m_position[0] + static_cast<float>(j) * sample_step * probe.m_direction[0],
-                probe.m_position[1] + static_cast<float>(j) * sample_step * probe.m_direction[1],
-                probe.m_position[2] + static_cast<float>(j) * sample_step * probe.m_direction[2]);
+                Point sample_point(position[0] + static_cast<float>(j) * sample_step * direction[0],
+                    position[1] + static_cast<float>(j) * sample_step * direction[1],
+                    position[2] + static_cast<float>(j) * sample_step * direction[2]);
 
-            T val = std::numeric_limits<T>::signaling_NaN();
+                T val = std::numeric_limits<T>::signaling_NaN();
 
-            auto cell = tri.locate(sample_point);
-            if (!tri.is_infinite(cell)) {
-                auto vertex = tri.nearest_vertex_in_cell(sample_point, cell);
+                auto cell = cells[i * samples_per_probe + j];
+                if (!tri.is_infinite(cell)) {
+                    auto vertex = tri.nearest_vertex_in_cell(sample_point, cell);
 
-                val = vertex->info();
-            }
+                    val = vertex->info();
+                }
 
-            samples->samples[j] = val;
+                samples->samples[j] = val;
 
-            min_value = std::min<decltype(min_value)>(min_value, val);
-            max_value = std::max<decltype(max_value)>(max_value, val);
-            avg_value += val;
-        } // end num samples per probe
+                min_value = std::min<decltype(min_value)>(min_value, val);
+                max_value = std::max<decltype(max_value)>(max_value, val);
+                avg_value += val;
+            } // end num samples per probe
 
-        avg_value /= samples_per_probe;
-        /*if (this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0) {
+            avg_value /= samples_per_probe;
             samples->average_value = avg_value;
             samples->max_value = max_value;
             samples->min_value = min_value;
-        } else {
-            samples->average_value = max_data;
-            samples->max_value = max_data;
-            samples->min_value = max_data;
-        }*/
-        global_min = std::min(global_min, samples->min_value);
-        global_max = std::max(global_max, samples->max_value);
-    } // end for probes
+            local_min = std::min(local_min, samples->min_value);
+            local_max = std::max(local_max, samples->max_value);
+        } // end for probes
+
+#pragma omp critical
+        {
+            global_min = std::min(global_min, local_min);
+            global_max = std::max(global_max, local_max);
+        }
+    }
     _probes->setGlobalMinMax(global_min, global_max);
 }
 
@@ -855,136 +763,126 @@ template<typename T>
 void SampleAlongPobes::SampleAlongPobes::doVolumeRadiusSampling(T* data) {
     const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
     const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
+    const bool use_average = this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0;
 
     glm::vec3 origin = {_vol_metadata->Origin[0], _vol_metadata->Origin[1], _vol_metadata->Origin[2]};
     glm::vec3 spacing = {*_vol_metadata->SliceDists[0], *_vol_metadata->SliceDists[1], *_vol_metadata->SliceDists[2]};
-    float min_spacing = std::min(std::min(spacing.x, spacing.y), spacing.z);
+    std::array<size_t, 3> const resolution = {
+        _vol_metadata->Resolution[0], _vol_metadata->Resolution[1], _vol_metadata->Resolution[2]};
+
+    auto const geometry = prepareProbes<FloatProbe>(samples_per_probe, 0.5f * sample_radius_factor);
+    auto const probe_cnt = static_cast<int64_t>(_probes->getProbeCount());
 
+    bool is_finite = true;
     float global_min = std::numeric_limits<float>::max();
     float global_max = -std::numeric_limits<float>::max();
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
-
-        FloatProbe probe;
-
-        auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::Vec4Probe>) {
-
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-                probe.m_cluster_id = arg.m_cluster_id;
-
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = 0.5 * sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
-
-                _probes->setProbe(i, probe);
-
-            } else if constexpr (std::is_same_v<T, probe::FloatProbe>) {
-                probe = arg;
-
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
-
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
-
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = 0.5 * sample_step * sample_radius_factor;
-        auto grid_radius = glm::vec3(radius) / spacing;
-        std::array<int, 3> num_grid_points_per_dim = {grid_radius.x * 2, grid_radius.y * 2, grid_radius.z * 2};
-
-        bool get_nearest = false;
-        for (int i = 0; i < num_grid_points_per_dim.size(); ++i) {
-            if (num_grid_points_per_dim[i] < 1) {
-                num_grid_points_per_dim[i] = 1;
-                get_nearest = true;
+#pragma omp parallel
+    {
+        float local_min = std::numeric_limits<float>::max();
+        float local_max = -std::numeric_limits<float>::max();
+        bool local_is_finite = true;
+
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t i = 0; i < probe_cnt; i++) {
+            auto const& position = geometry.positions[i];
+            auto const& direction = geometry.directions[i];
+            auto sample_step = geometry.ends[i] / static_cast<float>(samples_per_probe);
+            auto radius = 0.5 * sample_step * sample_radius_factor;
+            auto grid_radius = glm::vec3(radius) / spacing;
+            std::array<int, 3> num_grid_points_per_dim = {static_cast<int>(grid_radius.x * 2),
+                static_cast<int>(grid_radius.y * 2), static_cast<int>(grid_radius.z * 2)};
+
+            bool get_nearest = false;
+            for (int d = 0; d < num_grid_points_per_dim.size(); ++d) {
+                if (num_grid_points_per_dim[d] < 1) {
+                    num_grid_points_per_dim[d] = 1;
+                    get_nearest = true;
+                }
             }
-        }
 
-        std::shared_ptr<FloatProbe::SamplingResult> samples = probe.getSamplingResult();
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = -std::numeric_limits<float>::max();
-        float min_data = std::numeric_limits<float>::max();
-        float max_data = -std::numeric_limits<float>::max();
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
-
-
-        for (int j = 0; j < samples_per_probe; j++) {
-
-            glm::vec3 sample_point;
-            sample_point.x = probe.m_position[0] + j * sample_step * probe.m_direction[0];
-            sample_point.y = probe.m_position[1] + j * sample_step * probe.m_direction[1];
-            sample_point.z = probe.m_position[2] + j * sample_step * probe.m_direction[2];
-
-
-            // calculate in which cell (i,j,k) the point resides in
-            glm::vec3 grid_point = (sample_point - origin) / spacing;
-
-            glm::vec3 start = {std::roundf(grid_point.x - grid_radius.x), std::roundf(grid_point.y - grid_radius.y),
-                std::roundf(grid_point.z - grid_radius.z)};
-            auto end = grid_point + grid_radius;
-
-            float value = 0;
-            int num_samples = 0;
-            for (int k = 0; k < num_grid_points_per_dim[0]; ++k) {
-                for (int l = 0; l < num_grid_points_per_dim[1]; ++l) {
-                    for (int m = 0; m < num_grid_points_per_dim[2]; ++m) {
-                        auto pos = start + glm::vec3(k, l, m);
-                        auto dif = pos - grid_point;
-                        if ((std::abs(dif.x) <= grid_radius.x && std::abs(dif.y) <= grid_radius.y &&
-                                std::abs(dif.z) <= grid_radius.z) ||
-                            get_nearest) {
-                            int index =
-                                pos.z + _vol_metadata->Resolution[1] * (pos.y + _vol_metadata->Resolution[2] * pos.x);
-                            assert(index < _vol_metadata->Resolution[0] * _vol_metadata->Resolution[1] *
-                                               _vol_metadata->Resolution[2]);
-                            float current_data = data[index];
-                            value += current_data;
-                            min_data = std::min(min_data, current_data);
-                            max_data = std::max(max_data, current_data);
-
-                            num_samples++;
+            auto const& samples = _probes->getProbeRef<FloatProbe>(i).getSamplingResult();
+            float min_value = std::numeric_limits<float>::max();
+            float max_value = -std::numeric_limits<float>::max();
+            float min_data = std::numeric_limits<float>::max();
+            float max_data = -std::numeric_limits<float>::max();
+            float avg_value = 0.0f;
+            samples->samples.resize(samples_per_probe);
+
+            for (int j = 0; j < samples_per_probe; j++) {
+
+                glm::vec3 sample_point;
+                sample_point.x = position[0] + j * sample_step * direction[0];
+                sample_point.y = position[1] + j * sample_step * direction[1];
+                sample_point.z = position[2] + j * sample_step * direction[2];
+
+                // calculate in which cell (i,j,k) the point resides in
+                glm::vec3 grid_point = (sample_point - origin) / spacing;
+
+                glm::vec3 start = {std::roundf(grid_point.x - grid_radius.x), std::roundf(grid_point.y - grid_radius.y),
+                    std::roundf(grid_point.z - grid_radius.z)};
+
+                float value = 0;
+                int num_samples = 0;
+                for (int k = 0; k < num_grid_points_per_dim[0]; ++k) {
+                    for (int l = 0; l < num_grid_points_per_dim[1]; ++l) {
+                        for (int m = 0; m < num_grid_points_per_dim[2]; ++m) {
+                            auto pos = start + glm::vec3(k, l, m);
+                            auto dif = pos - grid_point;
+                            if ((std::abs(dif.x) <= grid_radius.x && std::abs(dif.y) <= grid_radius.y &&
+                                    std::abs(dif.z) <= grid_radius.z) ||
+                                get_nearest) {
+                                auto const index = static_cast<size_t>(
+                                    pos.z + resolution[1] * (pos.y + resolution[2] * static_cast<double>(pos.x)));
+                                assert(index < resolution[0] * resolution[1] * resolution[2]);
+                                float current_data = data[index];
+                                value += current_data;
+                                min_data = std::min(min_data, current_data);
+                                max_data = std::max(max_data, current_data);
+
+                                num_samples++;
+                            }
                         }
                     }
                 }
+                if (value != 0)
+                    value /= num_samples;
+                if (use_average) {
+                    samples->samples[j] = value;
+                } else {
+                    samples->samples[j] = max_data;
+                }
+                min_value = std::min(min_value, value);
+                max_value = std::max(max_value, value);
+                avg_value += value;
             }
-            if (value != 0)
-                value /= num_samples;
-            if (this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0) {
-                samples->samples[j] = value;
+            if (avg_value != 0)
+                avg_value /= samples_per_probe;
+            if (!std::isfinite(avg_value)) {
+                local_is_finite = false;
+            }
+            if (use_average) {
+                samples->average_value = avg_value;
+                samples->max_value = max_value;
+                samples->min_value = min_value;
             } else {
-                samples->samples[j] = max_data;
+                samples->average_value = max_data;
+                samples->max_value = max_data;
+                samples->min_value = max_data;
             }
-            min_value = std::min(min_value, value);
-            max_value = std::max(max_value, value);
-            avg_value += value;
-        }
-        if (avg_value != 0)
-            avg_value /= samples_per_probe;
-        if (!std::isfinite(avg_value)) {
-            core::utility::log::Log::DefaultLog.WriteError("[SampleAlongProbes] Non-finite value in sampled.");
+            local_min = std::min(local_min, samples->min_value);
+            local_max = std::max(local_max, samples->max_value);
+        } // end for probes
+
+#pragma omp critical
+        {
+            global_min = std::min(global_min, local_min);
+            global_max = std::max(global_max, local_max);
+            is_finite = is_finite && local_is_finite;
         }
-        if (this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0) {
-            samples->average_value = avg_value;
-            samples->max_value = max_value;
-            samples->min_value = min_value;
-        } else {
-            samples->average_value = max_data;
-            samples->max_value = max_data;
-            samples->min_value = max_data;
-        }
-        global_min = std::min(global_min, samples->min_value);
-        global_max = std::max(global_max, samples->max_value);
-    } // end for probes
+    }
+    if (!is_finite) {
+        core::utility::log::Log::DefaultLog.WriteError("[SampleAlongProbes] Non-finite value in sampled.");
+    }
     _probes->setGlobalMinMax(global_min, global_max);
 }
 
@@ -993,130 +891,101 @@ void SampleAlongPobes::SampleAlongPobes::doVolumeTrilinSampling(T* data) {
     const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
     const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
 
-    glm::vec3 origin = {_vol_metadata->Origin[0], _vol_metadata->Origin[1], _vol_metadata->Origin[2]};
-    glm::vec3 spacing = {*_vol_metadata->SliceDists[0], *_vol_metadata->SliceDists[1], *_vol_metadata->SliceDists[2]};
-    float min_spacing = std::min(std::min(spacing.x, spacing.y), spacing.z);
+    std::array<size_t, 3> const resolution = {
+        _vol_metadata->Resolution[0], _vol_metadata->Resolution[1], _vol_metadata->Resolution[2]};
 
-    float global_min = std::numeric_limits<float>::max();
-    float global_max = -std::numeric_limits<float>::max();
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
+    auto const geometry = prepareProbes<FloatProbe>(samples_per_probe, 0.5f * sample_radius_factor);
+    auto const probe_cnt = static_cast<int64_t>(_probes->getProbeCount());
 
-        FloatProbe probe;
+    auto const voxel = [data, &resolution](float x, float y, float z) {
+        return data[static_cast<size_t>(z) +
+                    resolution[1] * (static_cast<size_t>(y) + resolution[2] * static_cast<size_t>(x))];
+    };
 
-        auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::Vec4Probe>) {
-
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-                probe.m_cluster_id = arg.m_cluster_id;
+    bool is_finite = true;
+    float global_min = std::numeric_limits<float>::max();
+    float global_max = -std::numeric_limits<float>::max();
+#pragma omp parallel
+    {
+        float local_min = std::numeric_limits<float>::max();
+        float local_max = -std::numeric_limits<float>::max();
+        bool local_is_finite = true;
+
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t i = 0; i < probe_cnt; i++) {
+            auto const& position = geometry.positions[i];
+            auto const& direction = geometry.directions[i];
+            auto sample_step = geometry.ends[i] / static_cast<float>(samples_per_probe);
+
+            auto const& samples = _probes->getProbeRef<FloatProbe>(i).getSamplingResult();
+            float min_value = std::numeric_limits<float>::max();
+            float max_value = -std::numeric_limits<float>::max();
+            float avg_value = 0.0f;
+            samples->samples.resize(samples_per_probe);
+
+            for (int j = 0; j < samples_per_probe; j++) {
+
+                glm::vec3 sample_point;
+                sample_point.x = position[0] + j * sample_step * direction[0];
+                sample_point.y = position[1] + j * sample_step * direction[1];
+                sample_point.z = position[2] + j * sample_step * direction[2];
+
+                auto const x0 = std::floor(sample_point.x), x1 = std::ceil(sample_point.x);
+                auto const y0 = std::floor(sample_point.y), y1 = std::ceil(sample_point.y);
+                auto const z0 = std::floor(sample_point.z), z1 = std::ceil(sample_point.z);
+
+                auto xd = sample_point.x - x0 / (x1 - x0);
+                auto yd = sample_point.y - y0 / (y1 - y0);
+                auto zd = sample_point.z - z0 / (z1 - z0);
+
+                auto c000 = voxel(x0, y0, z0);
+                auto c001 = voxel(x0, y0, z1);
+                auto c010 = voxel(x0, y1, z0);
+                auto c011 = voxel(x0, y1, z1);
+                auto c100 = voxel(x1, y0, z0);
+                auto c101 = voxel(x1, y0, z1);
+                auto c110 = voxel(x1, y1, z0);
+                auto c111 = voxel(x1, y1, z1);
+
+                auto c00 = c000 * (1 - xd) + c100 * xd;
+                auto c01 = c001 * (1 - xd) + c101 * xd;
+                auto c10 = c010 * (1 - xd) + c110 * xd;
+                auto c11 = c011 * (1 - xd) + c111 * xd;
+
+                auto c0 = c00 * (1 - yd) + c10 * yd;
+                auto c1 = c01 * (1 - yd) + c11 * yd;
+
+                auto value = c0 * (1 - zd) + c1 * zd;
+                samples->samples[j] = value;
 
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = 0.5 * sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
+                min_value = std::min(min_value, value);
+                max_value = std::max(max_value, value);
+                avg_value += value;
+            }
+            if (avg_value != 0)
+                avg_value /= samples_per_probe;
+            if (!std::isfinite(avg_value)) {
+                local_is_finite = false;
+            }
 
-                _probes->setProbe(i, probe);
+            samples->average_value = avg_value;
+            samples->max_value = max_value;
+            samples->min_value = min_value;
 
-            } else if constexpr (std::is_same_v<T, probe::FloatProbe>) {
-                probe = arg;
+            local_min = std::min(local_min, samples->min_value);
+            local_max = std::max(local_max, samples->max_value);
+        } // end for probes
 
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
-
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
-
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-
-        std::shared_ptr<FloatProbe::SamplingResult> samples = probe.getSamplingResult();
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = -std::numeric_limits<float>::max();
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
-
-
-        for (int j = 0; j < samples_per_probe; j++) {
-
-            glm::vec3 sample_point;
-            sample_point.x = probe.m_position[0] + j * sample_step * probe.m_direction[0];
-            sample_point.y = probe.m_position[1] + j * sample_step * probe.m_direction[1];
-            sample_point.z = probe.m_position[2] + j * sample_step * probe.m_direction[2];
-
-            auto xd = sample_point.x -
-                      std::floorf(sample_point.x) / (std::ceilf(sample_point.x) - std::floorf(sample_point.x));
-            auto yd = sample_point.y -
-                      std::floorf(sample_point.y) / (std::ceilf(sample_point.y) - std::floorf(sample_point.y));
-            auto zd = sample_point.z -
-                      std::floorf(sample_point.z) / (std::ceilf(sample_point.z) - std::floorf(sample_point.z));
-
-            auto c000 = data[static_cast<size_t>(std::floor(sample_point.z)) +
-                             _vol_metadata->Resolution[1] *
-                                 (static_cast<size_t>(std::floor(sample_point.y)) +
-                                     _vol_metadata->Resolution[2] * static_cast<size_t>(std::floor(sample_point.x)))];
-            auto c001 = data[static_cast<size_t>(std::ceil(sample_point.z)) +
-                             _vol_metadata->Resolution[1] *
-                                 (static_cast<size_t>(std::floor(sample_point.y)) +
-                                     _vol_metadata->Resolution[2] * static_cast<size_t>(std::floor(sample_point.x)))];
-            auto c010 = data[static_cast<size_t>(std::floor(sample_point.z)) +
-                             _vol_metadata->Resolution[1] *
-                                 (static_cast<size_t>(std::ceil(sample_point.y)) +
-                                     _vol_metadata->Resolution[2] * static_cast<size_t>(std::floor(sample_point.x)))];
-            auto c011 = data[static_cast<size_t>(std::ceil(sample_point.z)) +
-                             _vol_metadata->Resolution[1] *
-                                 (static_cast<size_t>(std::ceil(sample_point.y)) +
-                                     _vol_metadata->Resolution[2] * static_cast<size_t>(std::floor(sample_point.x)))];
-            auto c100 = data[static_cast<size_t>(std::floor(sample_point.z)) +
-                             _vol_metadata->Resolution[1] *
-                                 (static_cast<size_t>(std::floor(sample_point.y)) +
-                                     _vol_metadata->Resolution[2] * static_cast<size_t>(std::ceil(sample_point.x)))];
-            auto c101 = data[static_cast<size_t>(std::ceil(sample_point.z)) +
-                             _vol_metadata->Resolution[1] *
-                                 (static_cast<size_t>(std::floor(sample_point.y)) +
-                                     _vol_metadata->Resolution[2] * static_cast<size_t>(std::ceil(sample_point.x)))];
-            auto c110 = data[static_cast<size_t>(std::floor(sample_point.z)) +
-                             _vol_metadata->Resolution[1] *
-                                 (static_cast<size_t>(std::ceil(sample_point.y)) +
-                                     _vol_metadata->Resolution[2] * static_cast<size_t>(std::ceil(sample_point.x)))];
-            auto c111 = data[static_cast<size_t>(std::ceil(sample_point.z)) +
-                             _vol_metadata->Resolution[1] *
-                                 (static_cast<size_t>(std::ceil(sample_point.y)) +
-                                     _vol_metadata->Resolution[2] * static_cast<size_t>(std::ceil(sample_point.x)))];
-
-            auto c00 = c000 * (1 - xd) + c100 * xd;
-            auto c01 = c001 * (1 - xd) + c101 * xd;
-            auto c10 = c010 * (1 - xd) + c110 * xd;
-            auto c11 = c011 * (1 - xd) + c111 * xd;
-
-            auto c0 = c00 * (1 - yd) + c10 * yd;
-            auto c1 = c01 * (1 - yd) + c11 * yd;
-
-            auto value = c0 * (1 - zd) + c1 * zd;
-            samples->samples[j] = value;
-
-            min_value = std::min(min_value, value);
-            max_value = std::max(max_value, value);
-            avg_value += value;
+#pragma omp critical
+        {
+            global_min = std::min(global_min, local_min);
+            global_max = std::max(global_max, local_max);
+            is_finite = is_finite && local_is_finite;
         }
-        if (avg_value != 0)
-            avg_value /= samples_per_probe;
-        if (!std::isfinite(avg_value)) {
-            core::utility::log::Log::DefaultLog.WriteError("[SampleAlongProbes] Non-finite value in sampled.");
-        }
-
-        samples->average_value = avg_value;
-        samples->max_value = max_value;
-        samples->min_value = min_value;
-
-        global_min = std::min(global_min, samples->min_value);
-        global_max = std::max(global_max, samples->max_value);
-    } // end for probes
+    }
+    if (!is_finite) {
+        core::utility::log::Log::DefaultLog.WriteError("[SampleAlongProbes] Non-finite value in sampled.");
+    }
     _probes->setGlobalMinMax(global_min, global_max);
 }
 
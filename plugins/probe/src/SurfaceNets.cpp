@@ -5,10 +5,15 @@
  */
 
 #include "SurfaceNets.h"
+
+#include <algorithm>
+#include <limits>
+
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "geometry_calls/VolumetricDataCall.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FloatParam.h"
+#include "mmcore/utility/log/Log.h"
 
 namespace megamol {
 namespace probe {
@@ -63,6 +68,32 @@ bool SurfaceNets::InterfaceIsDirty() {
 }
 
 
+namespace {
+
+/** Edge length of the blocks of cells processed independently. */
+constexpr uint32_t block_size = 32;
+
+constexpr float flt_max = std::numeric_limits<float>::max();
+
+/**
+ * Chunk-local state of a block of cells. Cells are numbered block-locally in
+ * scan order, so 'cells' is sorted and vertices of neighbouring blocks can be
+ * looked up by binary search instead of a lookup array covering the grid.
+ */
+struct SurfaceNetsBlock {
+    std::vector<uint32_t> cells;
+    std::vector<uint8_t> edge_crossings;
+    std::vector<std::array<float, 4>> vertices;
+    std::vector<std::array<float, 3>> normals;
+    std::vector<std::array<uint32_t, 4>> faces;
+    std::array<float, 3> min = {flt_max, flt_max, flt_max};
+    std::array<float, 3> max = {-flt_max, -flt_max, -flt_max};
+    uint32_t first_vertex = 0;
+};
+
+} // namespace
+
+
 void SurfaceNets::calculateSurfaceNets() {
 
     _bboxs.Clear();
@@ -72,6 +103,10 @@ void SurfaceNets::calculateSurfaceNets() {
     _faces.clear();
     _triangles.clear();
 
+    if (_dims[0] < 2 || _dims[1] < 2 || _dims[2] < 2) {
+        return;
+    }
+
     std::array<std::array<uint32_t, 3>, 8> cube_offsets;
     cube_offsets[0] = {0, 0, 0};
     cube_offsets[1] = {1, 0, 0};
@@ -109,231 +144,282 @@ void SurfaceNets::calculateSurfaceNets() {
 
     float const iso_value = this->_isoSlot.Param<core::param::FloatParam>()->Value();
 
-    std::vector<uint32_t> voxel_lookup(_dims[0] * _dims[1] * _dims[2]);
-    std::vector<uint32_t> voxel_filled;
-    voxel_filled.reserve(voxel_lookup.size());
-
-    std::vector<uint32_t> voxel_edge_crossings(_dims[0] * _dims[1] * _dims[2]);
-
-    auto dims = _dims;
-
-    auto const offset_now = [dims](
-                                uint32_t x, uint32_t y, uint32_t z) { return dims[0] * dims[1] * z + dims[0] * y + x; };
-
-    for (uint32_t z = 0; z < _dims[2] - 1; z++) {
-        for (uint32_t y = 0; y < _dims[1] - 1; y++) {
-            for (uint32_t x = 0; x < _dims[0] - 1; x++) {
-
-                std::array<float, 8> sample_value;
-                sample_value[0] =
-                    _data[offset_now(x + cube_offsets[0][0], y + cube_offsets[0][1], z + cube_offsets[0][2])];
-                sample_value[1] =
-                    _data[offset_now(x + cube_offsets[1][0], y + cube_offsets[1][1], z + cube_offsets[1][2])];
-                sample_value[2] =
-                    _data[offset_now(x + cube_offsets[2][0], y + cube_offsets[2][1], z + cube_offsets[2][2])];
-                sample_value[3] =
-                    _data[offset_now(x + cube_offsets[3][0], y + cube_offsets[3][1], z + cube_offsets[3][2])];
-                sample_value[4] =
-                    _data[offset_now(x + cube_offsets[4][0], y + cube_offsets[4][1], z + cube_offsets[4][2])];
-                sample_value[5] =
-                    _data[offset_now(x + cube_offsets[5][0], y + cube_offsets[5][1], z + cube_offsets[5][2])];
-                sample_value[6] =
-                    _data[offset_now(x + cube_offsets[6][0], y + cube_offsets[6][1], z + cube_offsets[6][2])];
-                sample_value[7] =
-                    _data[offset_now(x + cube_offsets[7][0], y + cube_offsets[7][1], z + cube_offsets[7][2])];
-
-                uint32_t edge_crossings = 0;
-
-                std::array<float, 3> center_of_mass = {0.0f, 0.0f, 0.0f};
-                float normalization = 0.0f;
-
-                // Compute edge crossings and center of mass
-                for (int i = 0; i < 12; ++i) {
-                    uint32_t const idx_0 = edge_vertex_offsets[i * 2 + 0];
-                    uint32_t const idx_1 = edge_vertex_offsets[i * 2 + 1];
-
-                    auto const v_0 = sample_value[idx_0];
-                    auto const v_1 = sample_value[idx_1];
-
-                    auto edge_crossing = uint32_t(!((v_0 > iso_value) == (v_1 > iso_value)));
-                    edge_crossings |= (edge_crossing << i);
-
-
-                    if (edge_crossing == 1) {
-
-                        float d = ((iso_value - v_0) / (v_1 - v_0));
-                        std::array<float, 3> mix;
-                        mix[0] = static_cast<float>(cube_offsets[idx_0][0]) * (1.0f - d) +
-                                 static_cast<float>(cube_offsets[idx_1][0]) * d;
-                        mix[1] = static_cast<float>(cube_offsets[idx_0][1]) * (1.0f - d) +
-                                 static_cast<float>(cube_offsets[idx_1][1]) * d;
-                        mix[2] = static_cast<float>(cube_offsets[idx_0][2]) * (1.0f - d) +
-                                 static_cast<float>(cube_offsets[idx_1][2]) * d;
-                        std::array<float, 3> intersect_pos;
-                        intersect_pos[0] = static_cast<float>(x) + mix[0];
-                        intersect_pos[1] = static_cast<float>(y) + mix[1];
-                        intersect_pos[2] = static_cast<float>(z) + mix[2];
-                        center_of_mass[0] += intersect_pos[0];
-                        center_of_mass[1] += intersect_pos[1];
-                        center_of_mass[2] += intersect_pos[2];
-                        normalization += 1.0f;
+    auto const dims = _dims;
+    auto const spacing = _spacing;
+    auto const origin = _volume_origin;
+    auto const data = _data;
+
+    auto const offset_now = [dims](uint32_t x, uint32_t y, uint32_t z) {
+        return (static_cast<uint64_t>(z) * dims[1] + y) * dims[0] + x;
+    };
+
+    // The grid of cells is decomposed into blocks, which are processed in
+    // parallel using block-local memory only.
+    std::array<uint32_t, 3> const cells = {dims[0] - 1, dims[1] - 1, dims[2] - 1};
+    std::array<uint32_t, 3> const blocks = {(cells[0] + block_size - 1) / block_size,
+        (cells[1] + block_size - 1) / block_size, (cells[2] + block_size - 1) / block_size};
+    std::vector<SurfaceNetsBlock> block_data(static_cast<size_t>(blocks[0]) * blocks[1] * blocks[2]);
+    auto const block_cnt = static_cast<int64_t>(block_data.size());
+
+    auto const block_coords = [blocks](int64_t b) {
+        return std::array<uint32_t, 3>{static_cast<uint32_t>(b % blocks[0]),
+            static_cast<uint32_t>((b / blocks[0]) % blocks[1]), static_cast<uint32_t>(b / blocks[0] / blocks[1])};
+    };
+
+    // Pass 1: place a vertex in each cell with an edge crossing.
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t b = 0; b < block_cnt; ++b) {
+        auto& block = block_data[b];
+        auto const bc = block_coords(b);
+        std::array<uint32_t, 3> const begin = {bc[0] * block_size, bc[1] * block_size, bc[2] * block_size};
+        std::array<uint32_t, 3> const end = {std::min(begin[0] + block_size, cells[0]),
+            std::min(begin[1] + block_size, cells[1]), std::min(begin[2] + block_size, cells[2])};
+
+        for (uint32_t z = begin[2]; z < end[2]; z++) {
+            for (uint32_t y = begin[1]; y < end[1]; y++) {
+                for (uint32_t x = begin[0]; x < end[0]; x++) {
+
+                    std::array<float, 8> sample_value;
+                    for (int i = 0; i < 8; ++i) {
+                        sample_value[i] =
+                            data[offset_now(x + cube_offsets[i][0], y + cube_offsets[i][1], z + cube_offsets[i][2])];
                     }
-                } // for i < 12
-
-                voxel_edge_crossings[offset_now(x, y, z)] = edge_crossings;
-
-                if (normalization > 0.0f) {
-
-                    center_of_mass[0] /= normalization;
-                    center_of_mass[1] /= normalization;
-                    center_of_mass[2] /= normalization;
-
-                    std::array<float, 4> position;
-                    position[0] = ((center_of_mass[0] / _dims[0]) * _dims[0] * _spacing[0]) + _volume_origin[0];
-                    position[1] = ((center_of_mass[1] / _dims[1]) * _dims[1] * _spacing[1]) + _volume_origin[1];
-                    position[2] = ((center_of_mass[2] / _dims[2]) * _dims[2] * _spacing[2]) + _volume_origin[2];
-                    position[3] = 1.0f;
-                    _vertices.push_back(position);
-
-                    float eps = 0.005;
-                    vislib::math::Cuboid<float> point_box(position[0] - eps, position[1] - eps, position[2] - eps,
-                        position[0] + eps, position[1] + eps, position[2] + eps);
-
-                    auto bbox = _bboxs.BoundingBox();
-                    auto cbox = _bboxs.ClipBox();
-                    bbox.Union(point_box);
-                    cbox.Union(point_box);
-                    _bboxs.SetBoundingBox(bbox);
-                    _bboxs.SetClipBox(cbox);
-
-                    voxel_lookup[offset_now(x, y, z)] = _vertices.size() - 1;
-                    voxel_filled.push_back(offset_now(x, y, z));
-
-                    std::array<float, 3> normal;
-                    normal[0] = _data[offset_now(x >= _dims[0] - 1 ? x : x + 1, y, z)] -
-                                _data[offset_now(x < 1 ? x : x - 1, y, z)];
-                    normal[1] = _data[offset_now(x, y >= _dims[1] - 1 ? y : y + 1, z)] -
-                                _data[offset_now(x, y < 1 ? y : y - 1, z)];
-                    normal[2] = _data[offset_now(x, y, z >= _dims[2] - 1 ? z : z + 1)] -
-                                _data[offset_now(x, y, z < 1 ? z : z - 1)];
-                    if (normal[0] <= 1e-6 && normal[1] <= 1e-6 && normal[2] <= 1e-6) {
-                        normal[0] = _data[offset_now(x >= _dims[0] - 2 ? x : x + 2, y, z)] -
-                                    _data[offset_now(x < 2 ? x : x - 2, y, z)];
-                        normal[1] = _data[offset_now(x, y >= _dims[1] - 2 ? y : y + 2, z)] -
-                                    _data[offset_now(x, y < 2 ? y : y - 2, z)];
-                        normal[2] = _data[offset_now(x, y, z >= _dims[2] - 2 ? z : z + 2)] -
-                                    _data[offset_now(x, y, z < 2 ? z : z - 2)];
+
+                    uint32_t edge_crossings = 0;
+
+                    std::array<float, 3> center_of_mass = {0.0f, 0.0f, 0.0f};
+                    float normalization = 0.0f;
+
+                    // Compute edge crossings and center of mass
+                    for (int i = 0; i < 12; ++i) {
+                        uint32_t const idx_0 = edge_vertex_offsets[i * 2 + 0];
+                        uint32_t const idx_1 = edge_vertex_offsets[i * 2 + 1];
+
+                        auto const v_0 = sample_value[idx_0];
+                        auto const v_1 = sample_value[idx_1];
+
+                        auto edge_crossing = uint32_t(!((v_0 > iso_value) == (v_1 > iso_value)));
+                        edge_crossings |= (edge_crossing << i);
+
+                        if (edge_crossing == 1) {
+                            float d = ((iso_value - v_0) / (v_1 - v_0));
+                            center_of_mass[0] += static_cast<float>(x) +
+                                                 static_cast<float>(cube_offsets[idx_0][0]) * (1.0f - d) +
+                                                 static_cast<float>(cube_offsets[idx_1][0]) * d;
+                            center_of_mass[1] += static_cast<float>(y) +
+                                                 static_cast<float>(cube_offsets[idx_0][1]) * (1.0f - d) +
+                                                 static_cast<float>(cube_offsets[idx_1][1]) * d;
+                            center_of_mass[2] += static_cast<float>(z) +
+                                                 static_cast<float>(cube_offsets[idx_0][2]) * (1.0f - d) +
+                                                 static_cast<float>(cube_offsets[idx_1][2]) * d;
+                            normalization += 1.0f;
+                        }
+                    } // for i < 12
+
+                    if (normalization > 0.0f) {
+                        std::array<float, 4> position;
+                        for (int k = 0; k < 3; ++k) {
+                            position[k] = (center_of_mass[k] / normalization) * spacing[k] + origin[k];
+                            block.min[k] = std::min(block.min[k], position[k]);
+                            block.max[k] = std::max(block.max[k], position[k]);
+                        }
+                        position[3] = 1.0f;
+                        block.vertices.push_back(position);
+                        block.cells.push_back(((z - begin[2]) * block_size + (y - begin[1])) * block_size +
+                                              (x - begin[0]));
+                        // Only the edges 0 to 2 starting at the cell origin generate faces.
+                        block.edge_crossings.push_back(static_cast<uint8_t>(edge_crossings & 0x7));
+
+                        std::array<float, 3> normal;
+                        normal[0] = data[offset_now(x >= dims[0] - 1 ? x : x + 1, y, z)] -
+                                    data[offset_now(x < 1 ? x : x - 1, y, z)];
+                        normal[1] = data[offset_now(x, y >= dims[1] - 1 ? y : y + 1, z)] -
+                                    data[offset_now(x, y < 1 ? y : y - 1, z)];
+                        normal[2] = data[offset_now(x, y, z >= dims[2] - 1 ? z : z + 1)] -
+                                    data[offset_now(x, y, z < 1 ? z : z - 1)];
+                        if (normal[0] <= 1e-6 && normal[1] <= 1e-6 && normal[2] <= 1e-6) {
+                            normal[0] = data[offset_now(x >= dims[0] - 2 ? x : x + 2, y, z)] -
+                                        data[offset_now(x < 2 ? x : x - 2, y, z)];
+                            normal[1] = data[offset_now(x, y >= dims[1] - 2 ? y : y + 2, z)] -
+                                        data[offset_now(x, y < 2 ? y : y - 2, z)];
+                            normal[2] = data[offset_now(x, y, z >= dims[2] - 2 ? z : z + 2)] -
+                                        data[offset_now(x, y, z < 2 ? z : z - 2)];
+                        }
+                        auto const normal_length =
+                            std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+                        normal[0] /= (normal_length < 0.00000001) ? 1.0 : normal_length;
+                        normal[1] /= (normal_length < 0.00000001) ? 1.0 : normal_length;
+                        normal[2] /= (normal_length < 0.00000001) ? 1.0 : normal_length;
+                        block.normals.push_back(normal);
                     }
-                    auto const normal_length =
-                        std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
-                    normal[0] /= (normal_length < 0.00000001) ? 1.0 : normal_length;
-                    normal[1] /= (normal_length < 0.00000001) ? 1.0 : normal_length;
-                    normal[2] /= (normal_length < 0.00000001) ? 1.0 : normal_length;
-                    _normals.push_back(normal);
-                }
-            } // for x
-        }     // for y
-    }         // for z
-    voxel_filled.shrink_to_fit();
-
-    auto const coordinateFromLinearIndex = [](uint32_t idx, uint32_t max_x, uint32_t max_y) {
-        std::array<uint32_t, 3> coords;
-        coords[0] = idx % (max_x);
-        idx /= (max_x);
-        coords[1] = idx % (max_y);
-        idx /= (max_y);
-        coords[2] = idx;
-        return coords;
+                } // for x
+            }     // for y
+        }         // for z
+    }             // for blocks
+
+    // Stitch the blocks: each block's vertices get a contiguous range of the
+    // global vertex indices, which are in turn written in parallel.
+    uint64_t vertex_cnt = 0;
+    for (auto& block : block_data) {
+        block.first_vertex = static_cast<uint32_t>(vertex_cnt);
+        vertex_cnt += block.vertices.size();
+    }
+    if (vertex_cnt > std::numeric_limits<uint32_t>::max()) {
+        core::utility::log::Log::DefaultLog.WriteError(
+            "[SurfaceNets] The surface has more vertices than can be indexed with 32 bit.");
+        return;
+    }
+
+    _vertices.resize(vertex_cnt);
+    _normals.resize(vertex_cnt);
+
+    std::array<float, 3> bbox_min = {flt_max, flt_max, flt_max};
+    std::array<float, 3> bbox_max = {-flt_max, -flt_max, -flt_max};
+    for (auto const& block : block_data) {
+        for (int k = 0; k < 3; ++k) {
+            bbox_min[k] = std::min(bbox_min[k], block.min[k]);
+            bbox_max[k] = std::max(bbox_max[k], block.max[k]);
+        }
+    }
+
+    // Answers the global index of the vertex of the given cell, which may be
+    // located in a neighbouring block.
+    auto const vertex_of = [&block_data, blocks](uint32_t x, uint32_t y, uint32_t z) -> int64_t {
+        auto const& block =
+            block_data[(static_cast<size_t>(z / block_size) * blocks[1] + y / block_size) * blocks[0] + x / block_size];
+        uint32_t const cell = ((z % block_size) * block_size + (y % block_size)) * block_size + (x % block_size);
+        auto it = std::lower_bound(block.cells.begin(), block.cells.end(), cell);
+        if (it == block.cells.end() || *it != cell) {
+            return -1;
+        }
+        return block.first_vertex + std::distance(block.cells.begin(), it);
     };
 
+    // Pass 2: connect the vertices of the cells around each crossing edge.
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t b = 0; b < block_cnt; ++b) {
+        auto& block = block_data[b];
+        auto const bc = block_coords(b);
+
+        std::copy(block.vertices.begin(), block.vertices.end(), _vertices.begin() + block.first_vertex);
+        std::copy(block.normals.begin(), block.normals.end(), _normals.begin() + block.first_vertex);
+
+        for (size_t v = 0; v < block.cells.size(); ++v) {
+            auto const cell = block.cells[v];
+            std::array<uint32_t, 3> const coords = {bc[0] * block_size + cell % block_size,
+                bc[1] * block_size + (cell / block_size) % block_size,
+                bc[2] * block_size + cell / block_size / block_size};
+            if (coords[0] == 0 || coords[1] == 0 || coords[2] == 0) {
+                continue;
+            }
 
-    for (auto id : voxel_filled) {
-        for (uint32_t i = 0; i < 3; ++i) {
-            auto const edge_crossing = 1 & (voxel_edge_crossings[id] >> i);
-            if (edge_crossing == 1) {
-                auto coords = coordinateFromLinearIndex(id, _dims[0], _dims[1]);
-                if (coords[0] > 0 && coords[1] > 0 && coords[2] > 0) {
-                    std::array<uint32_t, 4> indices;
-                    std::array<uint32_t, 3> triangle1;
-                    std::array<uint32_t, 3> triangle2;
-                    if (i == 0) {
-                        indices[0] = voxel_lookup[offset_now(coords[0], coords[1] - 1, coords[2])];
-                        indices[1] = voxel_lookup[offset_now(coords[0], coords[1] - 1, coords[2] - 1)];
-                        indices[2] = voxel_lookup[offset_now(coords[0], coords[1], coords[2] - 1)];
-                        indices[3] = voxel_lookup[offset_now(coords[0], coords[1], coords[2])]; // or just id
-                    } else if (i == 1) {
-                        indices[0] = voxel_lookup[offset_now(coords[0] - 1, coords[1] - 1, coords[2])];
-                        indices[1] = voxel_lookup[offset_now(coords[0], coords[1] - 1, coords[2])];
-                        indices[2] = voxel_lookup[offset_now(coords[0], coords[1], coords[2])];
-                        indices[3] = voxel_lookup[offset_now(coords[0] - 1, coords[1], coords[2])];
-                    } else if (i == 2) {
-                        indices[0] = voxel_lookup[offset_now(coords[0] - 1, coords[1], coords[2])];
-                        indices[1] = voxel_lookup[offset_now(coords[0], coords[1], coords[2])];
-                        indices[2] = voxel_lookup[offset_now(coords[0], coords[1], coords[2] - 1)];
-                        indices[3] = voxel_lookup[offset_now(coords[0] - 1, coords[1], coords[2] - 1)];
-                    }
-                    triangle1[0] = indices[0];
-                    triangle1[1] = indices[1];
-                    triangle1[2] = indices[2];
-                    triangle2[0] = indices[0];
-                    triangle2[1] = indices[2];
-                    triangle2[2] = indices[3];
-
-                    // hack normals
-                    auto tangent = _vertices[indices[2]];
-                    auto bitangent = _vertices[indices[1]];
-
-                    tangent[0] -= _vertices[indices[0]][0];
-                    tangent[1] -= _vertices[indices[0]][1];
-                    tangent[2] -= _vertices[indices[0]][2];
-                    auto t_length =
-                        std::sqrt(tangent[0] * tangent[0] + tangent[1] * tangent[1] + tangent[2] * tangent[2]);
-                    tangent[0] /= t_length;
-                    tangent[1] /= t_length;
-                    tangent[2] /= t_length;
-
-                    bitangent[0] -= _vertices[indices[0]][0];
-                    bitangent[1] -= _vertices[indices[0]][1];
-                    bitangent[2] -= _vertices[indices[0]][2];
-                    auto bt_length = std::sqrt(
-                        bitangent[0] * bitangent[0] + bitangent[1] * bitangent[1] + bitangent[2] * bitangent[2]);
-                    bitangent[0] /= bt_length;
-                    bitangent[1] /= bt_length;
-                    bitangent[2] /= bt_length;
-
-                    std::array<float, 3> normal;
-                    normal[0] = tangent[1] * bitangent[2] - tangent[2] * bitangent[1];
-                    normal[1] = tangent[2] * bitangent[0] - tangent[0] * bitangent[2];
-                    normal[2] = tangent[0] * bitangent[1] - tangent[1] * bitangent[0];
-                    auto n_length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
-                    normal[0] /= n_length;
-                    normal[1] /= n_length;
-                    normal[2] /= n_length;
-
-                    auto myDot = [](std::array<float, 3> const& v0, std::array<float, 3> const& v1) -> float {
-                        return (v0[0] * v1[0] + v0[1] * v1[1] + v0[2] * v1[2]);
-                    };
-
-                    _normals[indices[0]] = myDot(_normals[indices[0]], normal) > 0.0
-                                               ? normal
-                                               : std::array<float, 3>{-normal[0], -normal[1], -normal[2]};
-                    _normals[indices[1]] = myDot(_normals[indices[1]], normal) > 0.0
-                                               ? normal
-                                               : std::array<float, 3>{-normal[0], -normal[1], -normal[2]};
-                    _normals[indices[2]] = myDot(_normals[indices[2]], normal) > 0.0
-                                               ? normal
-                                               : std::array<float, 3>{-normal[0], -normal[1], -normal[2]};
-                    _normals[indices[3]] = myDot(_normals[indices[3]], normal) > 0.0
-                                               ? normal
-                                               : std::array<float, 3>{-normal[0], -normal[1], -normal[2]};
-
-                    _faces.emplace_back(indices);
-                    _triangles.emplace_back(triangle1);
-                    _triangles.emplace_back(triangle2);
+            for (uint32_t i = 0; i < 3; ++i) {
+                if ((1 & (block.edge_crossings[v] >> i)) == 0) {
+                    continue;
                 }
-            }
-        } // for i < 3
-    }     // for voxel_filled
+
+                std::array<int64_t, 4> indices;
+                if (i == 0) {
+                    indices[0] = vertex_of(coords[0], coords[1] - 1, coords[2]);
+                    indices[1] = vertex_of(coords[0], coords[1] - 1, coords[2] - 1);
+                    indices[2] = vertex_of(coords[0], coords[1], coords[2] - 1);
+                    indices[3] = block.first_vertex + v;
+                } else if (i == 1) {
+                    indices[0] = vertex_of(coords[0] - 1, coords[1] - 1, coords[2]);
+                    indices[1] = vertex_of(coords[0], coords[1] - 1, coords[2]);
+                    indices[2] = block.first_vertex + v;
+                    indices[3] = vertex_of(coords[0] - 1, coords[1], coords[2]);
+                } else {
+                    indices[0] = vertex_of(coords[0] - 1, coords[1], coords[2]);
+                    indices[1] = block.first_vertex + v;
+                    indices[2] = vertex_of(coords[0], coords[1], coords[2] - 1);
+                    indices[3] = vertex_of(coords[0] - 1, coords[1], coords[2] - 1);
+                }
+                if (std::any_of(indices.begin(), indices.end(), [](int64_t idx) { return idx < 0; })) {
+                    continue;
+                }
+                block.faces.push_back({static_cast<uint32_t>(indices[0]), static_cast<uint32_t>(indices[1]),
+                    static_cast<uint32_t>(indices[2]), static_cast<uint32_t>(indices[3])});
+            } // for i < 3
+        }
+
+        // The vertices have been copied and are no longer needed.
+        block.vertices = std::vector<std::array<float, 4>>();
+        block.normals = std::vector<std::array<float, 3>>();
+    }
+
+    size_t face_cnt = 0;
+    std::vector<size_t> first_face(block_data.size());
+    for (size_t b = 0; b < block_data.size(); ++b) {
+        first_face[b] = face_cnt;
+        face_cnt += block_data[b].faces.size();
+    }
+
+    _faces.resize(face_cnt);
+    _triangles.resize(2 * face_cnt);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t b = 0; b < block_cnt; ++b) {
+        auto& block = block_data[b];
+        for (size_t f = 0; f < block.faces.size(); ++f) {
+            auto const& indices = block.faces[f];
+            auto const dst = first_face[b] + f;
+            _faces[dst] = indices;
+            _triangles[2 * dst + 0] = {indices[0], indices[1], indices[2]};
+            _triangles[2 * dst + 1] = {indices[0], indices[2], indices[3]};
+        }
+        block.faces = std::vector<std::array<uint32_t, 4>>();
+    }
+
+    // hack normals: the face normals overwrite the vertex normals in the order
+    // of the faces, which keeps the result independent of the thread count.
+    auto myDot = [](std::array<float, 3> const& v0, std::array<float, 3> const& v1) -> float {
+        return (v0[0] * v1[0] + v0[1] * v1[1] + v0[2] * v1[2]);
+    };
+
+    for (auto const& indices : _faces) {
+        auto tangent = _vertices[indices[2]];
+        auto bitangent = _vertices[indices[1]];
+
+        tangent[0] -= _vertices[indices[0]][0];
+        tangent[1] -= _vertices[indices[0]][1];
+        tangent[2] -= _vertices[indices[0]][2];
+        auto t_length = std::sqrt(tangent[0] * tangent[0] + tangent[1] * tangent[1] + tangent[2] * tangent[2]);
+        tangent[0] /= t_length;
+        tangent[1] /= t_length;
+        tangent[2] /= t_length;
+
+        bitangent[0] -= _vertices[indices[0]][0];
+        bitangent[1] -= _vertices[indices[0]][1];
+        bitangent[2] -= _vertices[indices[0]][2];
+        auto bt_length =
+            std::sqrt(bitangent[0] * bitangent[0] + bitangent[1] * bitangent[1] + bitangent[2] * bitangent[2]);
+        bitangent[0] /= bt_length;
+        bitangent[1] /= bt_length;
+        bitangent[2] /= bt_length;
+
+        std::array<float, 3> normal;
+        normal[0] = tangent[1] * bitangent[2] - tangent[2] * bitangent[1];
+        normal[1] = tangent[2] * bitangent[0] - tangent[0] * bitangent[2];
+        normal[2] = tangent[0] * bitangent[1] - tangent[1] * bitangent[0];
+        auto n_length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        normal[0] /= n_length;
+        normal[1] /= n_length;
+        normal[2] /= n_length;
+
+        for (auto const idx : indices) {
+            _normals[idx] =
+                myDot(_normals[idx], normal) > 0.0 ? normal : std::array<float, 3>{-normal[0], -normal[1], -normal[2]};
+        }
+    }
+
+    if (vertex_cnt > 0) {
+        float eps = 0.005;
+        vislib::math::Cuboid<float> box(bbox_min[0] - eps, bbox_min[1] - eps, bbox_min[2] - eps, bbox_max[0] + eps,
+            bbox_max[1] + eps, bbox_max[2] + eps);
+        _bboxs.SetBoundingBox(box);
+        _bboxs.SetClipBox(box);
+    }
 }
 
 bool SurfaceNets::getData(core::Call& call) {
@@ -377,15 +463,12 @@ bool SurfaceNets::getData(core::Call& call) {
         if (cd->GetScalarType() == geocalls::FLOATING_POINT) {
             _data = static_cast<float*>(cd->GetData());
         } else if (cd->GetScalarType() == geocalls::UNSIGNED_INTEGER) {
-            _converted_data.reserve(_dims[0] * _dims[1] * _dims[2]);
+            auto const cnt = static_cast<int64_t>(_dims[0]) * _dims[1] * _dims[2];
+            _converted_data.resize(cnt);
             auto c_data = static_cast<unsigned char*>(cd->GetData());
-            for (uint32_t z = 0; z < _dims[2]; ++z) {
-                for (uint32_t y = 0; y < _dims[1]; ++y) {
-                    for (uint32_t x = 0; x < _dims[0]; ++x) {
-                        uint64_t idx = z * _dims[0] * _dims[1] + y * _dims[0] + x;
-                        _converted_data.emplace_back(c_data[idx]);
-                    }
-                }
+#pragma omp parallel for
+            for (int64_t idx = 0; idx < cnt; ++idx) {
+                _converted_data[idx] = c_data[idx];
             }
             _data = _converted_data.data();
         }
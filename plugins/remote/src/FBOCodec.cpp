@@ -0,0 +1,368 @@
+#include "FBOCodec.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include <omp.h>
+#include <snappy.h>
+
+namespace {
+
+/** Per-thread scratch buffers, slot 0 is used by the tilers, slot 1 by the codecs */
+std::vector<char>& thread_scratch(int slot) {
+    thread_local std::vector<char> bufs[2];
+    return bufs[slot];
+}
+
+
+class RawCodec : public megamol::remote::FBOCodec {
+public:
+    size_t MaxCompressedSize(size_t size) const override {
+        return size;
+    }
+
+    size_t Compress(char const* src, size_t size, size_t row_length, char* dst) const override {
+        std::memcpy(dst, src, size);
+        return size;
+    }
+
+    bool Uncompress(char const* src, size_t comp_size, size_t row_length, char* dst, size_t size) const override {
+        if (comp_size != size) {
+            return false;
+        }
+        std::memcpy(dst, src, size);
+        return true;
+    }
+};
+
+
+class SnappyCodec : public megamol::remote::FBOCodec {
+public:
+    size_t MaxCompressedSize(size_t size) const override {
+        return snappy::MaxCompressedLength(size);
+    }
+
+    size_t Compress(char const* src, size_t size, size_t row_length, char* dst) const override {
+        size_t comp_size = 0;
+        snappy::RawCompress(src, size, dst, &comp_size);
+        return comp_size;
+    }
+
+    bool Uncompress(char const* src, size_t comp_size, size_t row_length, char* dst, size_t size) const override {
+        size_t length = 0;
+        if (!snappy::GetUncompressedLength(src, comp_size, &length) || length != size) {
+            return false;
+        }
+        return snappy::RawUncompress(src, comp_size, dst);
+    }
+};
+
+
+/**
+ * Splits the elements into byte planes, optionally storing the bytes as differences to the left neighbor.
+ */
+class ShuffleSnappyCodec : public SnappyCodec {
+public:
+    ShuffleSnappyCodec(unsigned int el_size, bool delta) : el_size_{el_size}, delta_{delta} {}
+
+    size_t Compress(char const* src, size_t size, size_t row_length, char* dst) const override {
+        auto& planes = thread_scratch(1);
+        planes.resize(size);
+
+        auto const num = size / el_size_;
+        auto const row = std::max<size_t>(row_length, 1);
+        for (unsigned int b = 0; b < el_size_; ++b) {
+            auto plane = reinterpret_cast<unsigned char*>(planes.data()) + b * num;
+            auto const in = reinterpret_cast<unsigned char const*>(src) + b;
+            for (size_t i = 0; i < num; ++i) {
+                auto const value = in[i * el_size_];
+                plane[i] = (delta_ && i % row != 0) ? static_cast<unsigned char>(value - in[(i - 1) * el_size_])
+                                                    : value;
+            }
+        }
+        // trailing bytes of incomplete elements are kept as they are
+        std::copy(src + num * el_size_, src + size, planes.data() + num * el_size_);
+
+        return SnappyCodec::Compress(planes.data(), size, row_length, dst);
+    }
+
+    bool Uncompress(char const* src, size_t comp_size, size_t row_length, char* dst, size_t size) const override {
+        auto& planes = thread_scratch(1);
+        planes.resize(size);
+        if (!SnappyCodec::Uncompress(src, comp_size, row_length, planes.data(), size)) {
+            return false;
+        }
+
+        auto const num = size / el_size_;
+        auto const row = std::max<size_t>(row_length, 1);
+        for (unsigned int b = 0; b < el_size_; ++b) {
+            auto const plane = reinterpret_cast<unsigned char const*>(planes.data()) + b * num;
+            auto out = reinterpret_cast<unsigned char*>(dst) + b;
+            for (size_t i = 0; i < num; ++i) {
+                out[i * el_size_] = (delta_ && i % row != 0)
+                                        ? static_cast<unsigned char>(plane[i] + out[(i - 1) * el_size_])
+                                        : plane[i];
+            }
+        }
+        std::copy(planes.data() + num * el_size_, planes.data() + size, dst + num * el_size_);
+
+        return true;
+    }
+
+private:
+    unsigned int el_size_;
+
+    bool delta_;
+};
+
+
+size_t tile_count(unsigned int extent, unsigned int tile_size) {
+    return (static_cast<size_t>(extent) + tile_size - 1) / tile_size;
+}
+
+} // namespace
+
+
+std::unique_ptr<megamol::remote::FBOCodec> megamol::remote::FBOCodec::Create(
+    fbo_codec_type type, unsigned int el_size) {
+    switch (type) {
+    case FC_RAW:
+        return std::make_unique<RawCodec>();
+    case FC_SNAPPY:
+        return std::make_unique<SnappyCodec>();
+    case FC_SHUFFLE_SNAPPY:
+        return std::make_unique<ShuffleSnappyCodec>(el_size, false);
+    case FC_DELTA_SNAPPY:
+        return std::make_unique<ShuffleSnappyCodec>(el_size, true);
+    default:
+        return nullptr;
+    }
+}
+
+
+megamol::remote::FBOTileEncoder::FBOTileEncoder()
+        : type_{FC_SNAPPY}
+        , tile_size_{128}
+        , codec_{nullptr}
+        , codec_type_{FC_SNAPPY}
+        , codec_el_size_{0}
+        , codec_tile_size_{0}
+        , key_frame_{true}
+        , width_{0}
+        , height_{0}
+        , last_tile_count_{0} {}
+
+
+void megamol::remote::FBOTileEncoder::SetCodec(fbo_codec_type type) {
+    type_ = type;
+}
+
+
+void megamol::remote::FBOTileEncoder::SetTileSize(unsigned int tile_size) {
+    tile_size_ = std::max(tile_size, 8u);
+}
+
+
+void megamol::remote::FBOTileEncoder::RequestKeyFrame() {
+    key_frame_ = true;
+}
+
+
+size_t megamol::remote::FBOTileEncoder::Encode(
+    char const* image, unsigned int width, unsigned int height, unsigned int el_size, std::vector<char>& out) {
+    if (codec_ == nullptr || type_ != codec_type_ || el_size != codec_el_size_ || tile_size_ != codec_tile_size_) {
+        codec_ = FBOCodec::Create(type_, el_size);
+        if (codec_ == nullptr) {
+            type_ = FC_SNAPPY;
+            codec_ = FBOCodec::Create(type_, el_size);
+        }
+        codec_type_ = type_;
+        codec_el_size_ = el_size;
+        codec_tile_size_ = tile_size_;
+        key_frame_ = true;
+    }
+    if (width != width_ || height != height_) {
+        width_ = width;
+        height_ = height;
+        key_frame_ = true;
+    }
+    auto const row_size = static_cast<size_t>(width) * el_size;
+    previous_.resize(row_size * height);
+
+    auto const tile_size = codec_tile_size_;
+    auto const tiles_x = tile_count(width, tile_size);
+    auto const num_tiles = tiles_x * tile_count(height, tile_size);
+    tile_bufs_.resize(num_tiles);
+    tile_sizes_.assign(num_tiles, 0);
+
+    auto const key_frame = key_frame_;
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t t = 0; t < static_cast<int64_t>(num_tiles); ++t) {
+        auto const x = (t % tiles_x) * tile_size;
+        auto const y = (t / tiles_x) * tile_size;
+        auto const tile_width = std::min<size_t>(tile_size, width - x);
+        auto const tile_height = std::min<size_t>(tile_size, height - y);
+        auto const tile_row_size = tile_width * el_size;
+        auto const first = y * row_size + x * el_size;
+
+        bool changed = key_frame;
+        for (size_t row = 0; row < tile_height && !changed; ++row) {
+            auto const offset = first + row * row_size;
+            changed = std::memcmp(image + offset, previous_.data() + offset, tile_row_size) != 0;
+        }
+        if (!changed) {
+            continue;
+        }
+
+        // gather the tile into a contiguous block and remember it as known to the receiver
+        auto& tile = thread_scratch(0);
+        tile.resize(tile_row_size * tile_height);
+        for (size_t row = 0; row < tile_height; ++row) {
+            auto const offset = first + row * row_size;
+            std::memcpy(tile.data() + row * tile_row_size, image + offset, tile_row_size);
+            std::memcpy(previous_.data() + offset, image + offset, tile_row_size);
+        }
+
+        auto& comp = tile_bufs_[t];
+        comp.resize(codec_->MaxCompressedSize(tile.size()));
+        tile_sizes_[t] = static_cast<uint32_t>(codec_->Compress(tile.data(), tile.size(), tile_width, comp.data()));
+    }
+    key_frame_ = false;
+
+    // compose the stream from header, tile table and payloads
+    fbo_tile_header header;
+    header.codec = codec_type_;
+    header.width = width;
+    header.height = height;
+    header.el_size = el_size;
+    header.tile_size = tile_size;
+    header.key_frame = key_frame ? 1 : 0;
+    header.num_tiles = 0;
+    size_t payload_size = 0;
+    for (size_t t = 0; t < num_tiles; ++t) {
+        if (tile_sizes_[t] > 0) {
+            ++header.num_tiles;
+            payload_size += tile_sizes_[t];
+        }
+    }
+    last_tile_count_ = header.num_tiles;
+
+    auto const start = out.size();
+    auto const stream_size = sizeof(fbo_tile_header) + header.num_tiles * sizeof(fbo_tile_entry) + payload_size;
+    out.resize(start + stream_size);
+    auto ptr = out.data() + start;
+    std::memcpy(ptr, &header, sizeof(fbo_tile_header));
+    ptr += sizeof(fbo_tile_header);
+    for (size_t t = 0; t < num_tiles; ++t) {
+        if (tile_sizes_[t] > 0) {
+            fbo_tile_entry const entry{static_cast<uint32_t>(t), tile_sizes_[t]};
+            std::memcpy(ptr, &entry, sizeof(fbo_tile_entry));
+            ptr += sizeof(fbo_tile_entry);
+        }
+    }
+    for (size_t t = 0; t < num_tiles; ++t) {
+        if (tile_sizes_[t] > 0) {
+            std::memcpy(ptr, tile_bufs_[t].data(), tile_sizes_[t]);
+            ptr += tile_sizes_[t];
+        }
+    }
+
+    return stream_size;
+}
+
+
+megamol::remote::FBOTileDecoder::FBOTileDecoder()
+        : codec_{nullptr}
+        , codec_type_{FC_RAW}
+        , el_size_{0}
+        , width_{0}
+        , height_{0} {}
+
+
+bool megamol::remote::FBOTileDecoder::Decode(char const* data, size_t size) {
+    fbo_tile_header header;
+    if (size < sizeof(fbo_tile_header)) {
+        image_.clear();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(fbo_tile_header));
+    data += sizeof(fbo_tile_header);
+    size -= sizeof(fbo_tile_header);
+
+    if (header.codec >= FC_COUNT || header.el_size == 0 || header.el_size > 16 || header.tile_size == 0 ||
+        header.width > 65536 || header.height > 65536) {
+        image_.clear();
+        return false;
+    }
+    if (header.key_frame == 0 &&
+        (image_.empty() || header.width != width_ || header.height != height_ || header.el_size != el_size_)) {
+        image_.clear();
+        return false;
+    }
+
+    if (codec_ == nullptr || header.codec != codec_type_ || header.el_size != el_size_) {
+        codec_type_ = static_cast<fbo_codec_type>(header.codec);
+        codec_ = FBOCodec::Create(codec_type_, header.el_size);
+    }
+    el_size_ = header.el_size;
+    width_ = header.width;
+    height_ = header.height;
+    auto const row_size = static_cast<size_t>(width_) * el_size_;
+    image_.resize(row_size * height_);
+
+    auto const tiles_x = tile_count(width_, header.tile_size);
+    auto const num_tiles = tiles_x * tile_count(height_, header.tile_size);
+    if (header.num_tiles > num_tiles || size < header.num_tiles * sizeof(fbo_tile_entry)) {
+        image_.clear();
+        return false;
+    }
+    std::vector<fbo_tile_entry> entries(header.num_tiles);
+    std::memcpy(entries.data(), data, entries.size() * sizeof(fbo_tile_entry));
+    data += entries.size() * sizeof(fbo_tile_entry);
+    size -= entries.size() * sizeof(fbo_tile_entry);
+
+    offsets_.resize(entries.size());
+    size_t offset = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].index >= num_tiles) {
+            image_.clear();
+            return false;
+        }
+        offsets_[i] = offset;
+        offset += entries[i].size;
+    }
+    if (offset > size) {
+        image_.clear();
+        return false;
+    }
+
+    auto const tile_size = header.tile_size;
+    std::atomic<bool> valid{true};
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t i = 0; i < static_cast<int64_t>(entries.size()); ++i) {
+        auto const t = entries[i].index;
+        auto const x = (t % tiles_x) * tile_size;
+        auto const y = (t / tiles_x) * tile_size;
+        auto const tile_width = std::min<size_t>(tile_size, width_ - x);
+        auto const tile_height = std::min<size_t>(tile_size, height_ - y);
+        auto const tile_row_size = tile_width * el_size_;
+
+        auto& tile = thread_scratch(0);
+        tile.resize(tile_row_size * tile_height);
+        if (!codec_->Uncompress(data + offsets_[i], entries[i].size, tile_width, tile.data(), tile.size())) {
+            valid = false;
+            continue;
+        }
+        for (size_t row = 0; row < tile_height; ++row) {
+            std::memcpy(image_.data() + (y + row) * row_size + x * el_size_, tile.data() + row * tile_row_size,
+                tile_row_size);
+        }
+    }
+
+    if (!valid) {
+        image_.clear();
+        return false;
+    }
+    return true;
+}
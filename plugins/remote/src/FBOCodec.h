@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace megamol {
+namespace remote {
+
+/**
+ * Compression schemes for color and depth buffers.
+ * The shuffle codecs reorder the elements into planes of equal byte significance before compressing with snappy,
+ * which groups the slowly changing high bytes of float depth values. The delta codec additionally stores each
+ * element as difference to its left neighbor within the row.
+ */
+enum fbo_codec_type : unsigned int { FC_RAW = 0, FC_SNAPPY, FC_SHUFFLE_SNAPPY, FC_DELTA_SNAPPY, FC_COUNT };
+
+
+/**
+ * Stateless compression of a contiguous block of elements.
+ * Implementations are safe to be used concurrently from multiple threads.
+ */
+class FBOCodec {
+public:
+    /**
+     * Creates the codec of the given type for elements of 'el_size' bytes.
+     *
+     * @return The codec or nullptr if the type is unknown.
+     */
+    static std::unique_ptr<FBOCodec> Create(fbo_codec_type type, unsigned int el_size);
+
+    /** Answer the maximum size of the compressed representation of 'size' bytes */
+    virtual size_t MaxCompressedSize(size_t size) const = 0;
+
+    /**
+     * Compresses 'size' bytes of 'src' into 'dst', which must hold at least MaxCompressedSize(size) bytes.
+     * Rows of 'row_length' elements are the unit of the delta codec.
+     *
+     * @return The size of the compressed data, which is larger than zero for non-empty input.
+     */
+    virtual size_t Compress(char const* src, size_t size, size_t row_length, char* dst) const = 0;
+
+    /**
+     * Uncompresses 'comp_size' bytes of 'src' into the 'size' bytes of 'dst'.
+     *
+     * @return 'true' on success, 'false' if the data is malformed or does not uncompress to 'size' bytes.
+     */
+    virtual bool Uncompress(char const* src, size_t comp_size, size_t row_length, char* dst, size_t size) const = 0;
+
+    virtual ~FBOCodec(void) = default;
+};
+
+
+/**
+ * Header of a tiled image stream, followed by 'num_tiles' fbo_tile_entry and the payloads in the same order.
+ */
+struct fbo_tile_header {
+    uint32_t codec;
+    uint32_t width;
+    uint32_t height;
+    uint32_t el_size;
+    uint32_t tile_size;
+    /** If non-zero, all tiles are contained and the image does not depend on previous ones */
+    uint32_t key_frame;
+    uint32_t num_tiles;
+};
+
+struct fbo_tile_entry {
+    /** Row-major index of the tile */
+    uint32_t index;
+    /** Size of the compressed payload */
+    uint32_t size;
+};
+
+
+/**
+ * Encodes images as square tiles, of which only those differing from the previous image are compressed and sent.
+ * Tiles are compared and compressed in parallel. All buffers are kept between frames.
+ */
+class FBOTileEncoder {
+public:
+    FBOTileEncoder(void);
+
+    /** Sets the codec, takes effect with the next (key) frame */
+    void SetCodec(fbo_codec_type type);
+
+    /** Sets the edge length of the tiles in pixels, takes effect with the next (key) frame */
+    void SetTileSize(unsigned int tile_size);
+
+    /** Lets the next image be sent completely, e.g. if the receiver has lost track */
+    void RequestKeyFrame(void);
+
+    /**
+     * Encodes an image of 'width' x 'height' elements of 'el_size' bytes each and appends the stream to 'out'.
+     *
+     * @return The number of bytes appended to 'out'.
+     */
+    size_t Encode(char const* image, unsigned int width, unsigned int height, unsigned int el_size,
+        std::vector<char>& out);
+
+    /** Answer the number of tiles contained in the last stream */
+    unsigned int GetLastTileCount(void) const {
+        return last_tile_count_;
+    }
+
+private:
+    fbo_codec_type type_;
+
+    unsigned int tile_size_;
+
+    std::unique_ptr<FBOCodec> codec_;
+
+    fbo_codec_type codec_type_;
+
+    unsigned int codec_el_size_;
+
+    unsigned int codec_tile_size_;
+
+    bool key_frame_;
+
+    unsigned int width_;
+
+    unsigned int height_;
+
+    /** The image as known to the receiver */
+    std::vector<char> previous_;
+
+    /** Compressed payload per tile */
+    std::vector<std::vector<char>> tile_bufs_;
+
+    /** Compressed size per tile, zero for unchanged tiles */
+    std::vector<uint32_t> tile_sizes_;
+
+    unsigned int last_tile_count_;
+};
+
+
+/**
+ * Reconstructs images from the streams of a FBOTileEncoder.
+ */
+class FBOTileDecoder {
+public:
+    FBOTileDecoder(void);
+
+    /**
+     * Applies a stream to the current image. Tiles are uncompressed in parallel.
+     *
+     * @return 'true' on success, 'false' if the stream is malformed or no key frame has been received yet. The image
+     * is discarded on failure, such that a key frame is required to continue.
+     */
+    bool Decode(char const* data, size_t size);
+
+    /** Answer whether an image is available, i.e. a key frame has been decoded */
+    bool HasImage(void) const {
+        return !image_.empty();
+    }
+
+    std::vector<char> const& GetImage(void) const {
+        return image_;
+    }
+
+    unsigned int GetWidth(void) const {
+        return width_;
+    }
+
+    unsigned int GetHeight(void) const {
+        return height_;
+    }
+
+private:
+    std::unique_ptr<FBOCodec> codec_;
+
+    fbo_codec_type codec_type_;
+
+    unsigned int el_size_;
+
+    unsigned int width_;
+
+    unsigned int height_;
+
+    std::vector<char> image_;
+
+    /** Payload offset per tile entry of the current stream */
+    std::vector<size_t> offsets_;
+};
+
+} // end namespace remote
+} // end namespace megamol
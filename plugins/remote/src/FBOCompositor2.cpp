@@ -4,8 +4,7 @@
 #include <fstream>
 #include <sstream>
 
-#include <snappy.h>
-
+#include "FBOCodec.h"
 #include "mmcore/CoreInstance.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/ButtonParam.h"
@@ -397,13 +396,21 @@ bool megamol::remote::FBOCompositor2::initThreads() {
 void megamol::remote::FBOCompositor2::receiverJob(
     FBOCommFabric& comm, core::utility::sys::FutureReset<fbo_msg_t>* fbo_msg_future, std::future<bool>&& close) {
     try {
+        // images of this transmitter, updated by the changed tiles of each message
+        FBOTileDecoder col_decoder;
+        FBOTileDecoder depth_decoder;
+        std::vector<char> buf;
         while (!shutdown_) {
             auto const status = close.wait_for(std::chrono::milliseconds(1));
             if (status == std::future_status::ready)
                 break;
 
-            // send a request for data
-            std::vector<char> buf{'r', 'e', 'q'};
+            // send a request for data, asking for a complete frame as long as there is nothing to update
+            if (col_decoder.HasImage() && depth_decoder.HasImage()) {
+                buf = {'r', 'e', 'q'};
+            } else {
+                buf = {'k', 'e', 'y'};
+            }
             try {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOCompositor2: Sending request\n");
@@ -451,6 +458,9 @@ void megamol::remote::FBOCompositor2::receiverJob(
                     "FBOCompositor2: Exception during recv in 'receiverJob'\n");
             }
 
+            if (buf.size() < sizeof(fbo_msg_header_t)) {
+                continue;
+            }
             fbo_msg_header_t header;
             char* buf_ptr = buf.data();
             std::copy(buf_ptr, buf_ptr + sizeof(fbo_msg_header_t), reinterpret_cast<char*>(&header));
@@ -462,7 +472,8 @@ void megamol::remote::FBOCompositor2::receiverJob(
             fbo_col_size *= static_cast<size_t>(col_buf_el_size_);
             fbo_depth_size *= static_cast<size_t>(depth_buf_el_size_);
 
-            if (header.depth_buf_size <= 1 || header.color_buf_size <= 1) {
+            if (header.depth_buf_size <= 1 || header.color_buf_size <= 1 ||
+                buf.size() < sizeof(fbo_msg_header_t) + header.color_buf_size + header.depth_buf_size) {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteWarn(
                     "FBOCompositor2: Bad size for alloc color/depth; col_buf size: %d; col_comp_buf size: %d; "
@@ -472,23 +483,25 @@ void megamol::remote::FBOCompositor2::receiverJob(
                 continue;
             }
 
-            std::vector<char> col_buf(fbo_col_size);
-            std::vector<char> col_comp_buf(header.color_buf_size);
-            std::copy(buf_ptr, buf_ptr + header.color_buf_size, col_comp_buf.begin());
-            buf_ptr += header.color_buf_size;
-            std::vector<char> depth_buf(fbo_depth_size);
-            std::vector<char> depth_comp_buf(header.depth_buf_size);
-            std::copy(buf_ptr, buf_ptr + header.depth_buf_size, depth_comp_buf.begin());
-
-            // snappy uncompress
-            snappy::RawUncompress(col_comp_buf.data(), col_comp_buf.size(), col_buf.data());
-            snappy::RawUncompress(depth_comp_buf.data(), depth_comp_buf.size(), depth_buf.data());
-
-            /*std::vector<char> col_buf(fbo_col_size);
-            std::copy(buf_ptr, buf_ptr + fbo_col_size, col_buf.begin());
-            buf_ptr += fbo_col_size;
-            std::vector<char> depth_buf(fbo_depth_size);
-            std::copy(buf_ptr, buf_ptr + fbo_depth_size, depth_buf.begin());*/
+            // apply the changed tiles
+            if (!col_decoder.Decode(buf_ptr, header.color_buf_size) ||
+                !depth_decoder.Decode(buf_ptr + header.color_buf_size, header.depth_buf_size)) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "FBOCompositor2: Could not decode frame %d of node %d, requesting a key frame\n", header.frame_id,
+                    header.node_id);
+                col_decoder = FBOTileDecoder{};
+                depth_decoder = FBOTileDecoder{};
+                continue;
+            }
+            if (col_decoder.GetImage().size() != fbo_col_size || depth_decoder.GetImage().size() != fbo_depth_size) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "FBOCompositor2: Frame %d of node %d does not match its viewport\n", header.frame_id,
+                    header.node_id);
+                continue;
+            }
+
+            std::vector<char> col_buf(col_decoder.GetImage());
+            std::vector<char> depth_buf(depth_decoder.GetImage());
 
 #ifdef _DEBUG
             megamol::core::utility::log::Log::DefaultLog.WriteInfo(
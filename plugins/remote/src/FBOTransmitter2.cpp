@@ -1,9 +1,9 @@
 #include "FBOTransmitter2.h"
 
+#include <algorithm>
 #include <array>
 
 #include <glad/glad.h>
-#include <snappy.h>
 
 #include "cluster/mpi/MpiCall.h"
 #include "mmcore/CallerSlot.h"
@@ -36,6 +36,10 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
         , handshake_port_slot_{"handshakePort", "Port for zmq handshake"}
         , reconnect_slot_{"reconnect", "Reconnect comm threads"}
         , tiled_slot_("tiledDisplay", "True if rendering on a tiled display")
+        , color_codec_slot_("colorCodec", "The compression of the color buffer")
+        , depth_codec_slot_("depthCodec", "The compression of the depth buffer")
+        , codec_tile_size_slot_(
+              "codecTileSize", "Edge length of the tiles in pixels, only tiles changed since the last frame are sent")
 #ifdef MEGAMOL_USE_MPI
         , callRequestMpi("requestMpi", "Requests initialisation of MPI and the communicator for the view.")
         , toggle_aggregate_slot_{"aggregate", "Toggle whether to aggregate and composite FBOs prior to transmission"}
@@ -52,6 +56,9 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
         , depth_buf_send_{new std::vector<char>}
         , col_buf_el_size_{4}
         , depth_buf_el_size_{4}
+        , color_codec_{FC_SNAPPY}
+        , depth_codec_{FC_DELTA_SNAPPY}
+        , codec_tile_size_{128}
         , connected_{false}
         , validViewport(false) {
     this->address_slot_ << new megamol::core::param::StringParam{"34242"};
@@ -88,6 +95,21 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
 
     tiled_slot_ << new megamol::core::param::BoolParam(false);
     this->MakeSlotAvailable(&tiled_slot_);
+
+    auto const make_codec_param = [](fbo_codec_type def) {
+        auto codec_ep = new megamol::core::param::EnumParam(def);
+        codec_ep->SetTypePair(FC_RAW, "None");
+        codec_ep->SetTypePair(FC_SNAPPY, "Snappy");
+        codec_ep->SetTypePair(FC_SHUFFLE_SNAPPY, "ByteShuffle+Snappy");
+        codec_ep->SetTypePair(FC_DELTA_SNAPPY, "Delta+ByteShuffle+Snappy");
+        return codec_ep;
+    };
+    color_codec_slot_ << make_codec_param(FC_SNAPPY);
+    this->MakeSlotAvailable(&color_codec_slot_);
+    depth_codec_slot_ << make_codec_param(FC_DELTA_SNAPPY);
+    this->MakeSlotAvailable(&depth_codec_slot_);
+    codec_tile_size_slot_ << new megamol::core::param::IntParam(128, 8, 4096);
+    this->MakeSlotAvailable(&codec_tile_size_slot_);
 }
 
 
@@ -232,6 +254,10 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
 #if _DEBUG
         megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Extracting Meta Data ... Done\n");
 #endif
+        this->color_codec_ = this->color_codec_slot_.Param<core::param::EnumParam>()->Value();
+        this->depth_codec_ = this->depth_codec_slot_.Param<core::param::EnumParam>()->Value();
+        this->codec_tile_size_ = this->codec_tile_size_slot_.Param<core::param::IntParam>()->Value();
+
         // copy data to read buffer, if possible
         {
             std::lock_guard<std::mutex> read_guard{this->buffer_read_guard_}; //< maybe try_lock instead
@@ -285,9 +311,10 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
 
 void megamol::remote::FBOTransmitter2::transmitterJob() {
     try {
+        // reused for requests and answers
+        std::vector<char> buf;
         while (!this->thread_stop_) {
             // transmit only upon request
-            std::vector<char> buf;
             try {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Waiting for request\n");
@@ -338,38 +365,36 @@ void megamol::remote::FBOTransmitter2::transmitterJob() {
                 //            }
                 //#endif
 
-                // snappy compression
-                std::vector<char> col_comp_buf(snappy::MaxCompressedLength(this->color_buf_send_->size()));
-                std::vector<char> depth_comp_buf(snappy::MaxCompressedLength(this->depth_buf_send_->size()));
-                size_t col_comp_size = 0;
-                size_t depth_comp_size = 0;
-
-                // if (aggregate_) {
-                //    snappy::RawCompress(reinterpret_cast<char*>(icet_col_buf), this->color_buf_send_->size(),
-                //        col_comp_buf.data(), &col_comp_size);
-                //    snappy::RawCompress(reinterpret_cast<char*>(icet_depth_buf), this->depth_buf_send_->size(),
-                //        depth_comp_buf.data(), &depth_comp_size);
-                //} else {
-                snappy::RawCompress(
-                    this->color_buf_send_->data(), this->color_buf_send_->size(), col_comp_buf.data(), &col_comp_size);
-                snappy::RawCompress(this->depth_buf_send_->data(), this->depth_buf_send_->size(), depth_comp_buf.data(),
-                    &depth_comp_size);
-                //}
-
-                fbo_msg_send_->color_buf_size = col_comp_size;
-                fbo_msg_send_->depth_buf_size = depth_comp_size;
-                // compose message from header, color_buf, and depth_buf
-                buf.resize(sizeof(fbo_msg_header_t) + col_comp_size + depth_comp_size);
+                // the compositor asks for a key frame if it has no image to apply changed tiles to
+                if (buf.size() == 3 && buf[0] == 'k') {
+                    this->color_encoder_.RequestKeyFrame();
+                    this->depth_encoder_.RequestKeyFrame();
+                }
+
+                // compose message from header and the tiled color and depth streams
+                unsigned int const codec_tile_size = this->codec_tile_size_;
+                this->color_encoder_.SetCodec(static_cast<fbo_codec_type>(this->color_codec_.load()));
+                this->color_encoder_.SetTileSize(codec_tile_size);
+                this->depth_encoder_.SetCodec(static_cast<fbo_codec_type>(this->depth_codec_.load()));
+                this->depth_encoder_.SetTileSize(codec_tile_size);
+
+                auto const width = static_cast<unsigned int>(
+                    std::max(this->fbo_msg_send_->updated_area[2] - this->fbo_msg_send_->updated_area[0], 0));
+                auto const height = static_cast<unsigned int>(
+                    std::max(this->fbo_msg_send_->updated_area[3] - this->fbo_msg_send_->updated_area[1], 0));
+                buf.resize(sizeof(fbo_msg_header_t));
+                if (this->color_buf_send_->size() < static_cast<size_t>(width) * height * col_buf_el_size_ ||
+                    this->depth_buf_send_->size() < static_cast<size_t>(width) * height * depth_buf_el_size_) {
+                    // nothing rendered yet
+                    fbo_msg_send_->color_buf_size = fbo_msg_send_->depth_buf_size = 0;
+                } else {
+                    fbo_msg_send_->color_buf_size = this->color_encoder_.Encode(
+                        this->color_buf_send_->data(), width, height, col_buf_el_size_, buf);
+                    fbo_msg_send_->depth_buf_size = this->depth_encoder_.Encode(
+                        this->depth_buf_send_->data(), width, height, depth_buf_el_size_, buf);
+                }
                 std::copy(reinterpret_cast<char*>(&(*fbo_msg_send_)),
                     reinterpret_cast<char*>(&(*fbo_msg_send_)) + sizeof(fbo_msg_header_t), buf.data());
-                /*std::copy(
-                    this->color_buf_send_->begin(), this->color_buf_send_->end(), buf.data() +
-                sizeof(fbo_msg_header_t)); std::copy(this->depth_buf_send_->begin(), this->depth_buf_send_->end(),
-                    buf.data() + sizeof(fbo_msg_header_t) + this->color_buf_send_->size());*/
-                std::copy(
-                    col_comp_buf.data(), col_comp_buf.data() + col_comp_size, buf.data() + sizeof(fbo_msg_header_t));
-                std::copy(depth_comp_buf.data(), depth_comp_buf.data() + depth_comp_size,
-                    buf.data() + sizeof(fbo_msg_header_t) + col_comp_size);
 
                 // send data
                 try {
@@ -379,6 +404,9 @@ void megamol::remote::FBOTransmitter2::transmitterJob() {
                     if (!this->comm_->Send(buf, send_type::SEND)) {
                         megamol::core::utility::log::Log::DefaultLog.WriteError(
                             "FBOTransmitter2: Error during send in 'transmitterJob'\n");
+                        // the compositor cannot apply the next changed tiles without this frame
+                        this->color_encoder_.RequestKeyFrame();
+                        this->depth_encoder_.RequestKeyFrame();
                     }
 #if _DEBUG
                     else {
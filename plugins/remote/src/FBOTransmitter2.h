@@ -10,6 +10,7 @@
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
 
+#include "FBOCodec.h"
 #include "FBOCommFabric.h"
 #include "FBOProto.h"
 #include "mmcore/CallerSlot.h"
@@ -114,6 +115,12 @@ private:
 
     megamol::core::param::ParamSlot tiled_slot_;
 
+    megamol::core::param::ParamSlot color_codec_slot_;
+
+    megamol::core::param::ParamSlot depth_codec_slot_;
+
+    megamol::core::param::ParamSlot codec_tile_size_slot_;
+
     bool aggregate_;
 
 #ifdef MEGAMOL_USE_MPI
@@ -169,6 +176,17 @@ private:
 
     int depth_buf_el_size_;
 
+    /** Codec settings for the transmitter thread */
+    std::atomic<unsigned int> color_codec_;
+
+    std::atomic<unsigned int> depth_codec_;
+
+    std::atomic<unsigned int> codec_tile_size_;
+
+    FBOTileEncoder color_encoder_;
+
+    FBOTileEncoder depth_encoder_;
+
     bool connected_;
 
     int viewport[6];
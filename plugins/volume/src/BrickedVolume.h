@@ -0,0 +1,140 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace megamol::volume::bricked {
+
+/*
+ * Bricked volume files (*.mmbv) store a volume as bricks of at most
+ * BrickSize^3 grid points for each frame and for a pyramid of levels of
+ * detail, which allows for reading only the bricks intersecting a region
+ * of interest. The file consists of
+ *
+ *  1. the FileHeader,
+ *  2. the minimum and the maximum of each component as double,
+ *  3. the brick table, i.e. the uint64_t file offset of each brick in the
+ *     order given by BrickLayout::BrickIndex plus the end of the last brick,
+ *  4. the bricks, each of which stores its grid points x-fastest with all
+ *     components interleaved. Bricks at the upper border of the volume are
+ *     clipped, i.e. not padded.
+ *
+ * Level l + 1 is obtained from level l by averaging 2^3 grid points.
+ */
+
+/** Identifies bricked volume files. */
+constexpr std::array<char, 4> Magic = {'M', 'M', 'B', 'V'};
+
+/** The current version of the file format. */
+constexpr std::uint32_t Version = 1;
+
+#pragma pack(push, 1)
+/** The header of a bricked volume file. */
+struct FileHeader {
+    std::array<char, 4> magic;
+    std::uint32_t version;
+    std::uint32_t scalarType;
+    std::uint32_t scalarLength;
+    std::uint32_t components;
+    std::uint32_t frames;
+    std::uint64_t resolution[3];
+    float sliceDists[3];
+    float origin[3];
+    float extents[3];
+    std::uint32_t brickSize;
+    std::uint32_t levels;
+};
+#pragma pack(pop)
+
+/**
+ * Computes the arrangement of the bricks of all levels of a volume.
+ */
+class BrickLayout {
+public:
+    BrickLayout() : brickSize(1), levels(0), bricksPerFrame(0) {
+        std::memset(this->resolution, 0, sizeof(this->resolution));
+    }
+
+    BrickLayout(const std::uint64_t resolution[3], const std::uint32_t brickSize, const std::uint32_t levels)
+            : brickSize(std::max<std::uint32_t>(brickSize, 1))
+            , levels(std::min(levels, MaxLevels))
+            , bricksPerFrame(0) {
+        std::copy(resolution, resolution + 3, this->resolution);
+        for (std::uint32_t l = 0; l < this->levels; ++l) {
+            this->levelOffsets[l] = this->bricksPerFrame;
+            this->bricksPerFrame += this->Bricks(l, 0) * this->Bricks(l, 1) * this->Bricks(l, 2);
+        }
+    }
+
+    /**
+     * Answer the number of levels needed until a single brick covers the
+     * whole volume.
+     */
+    static std::uint32_t FullPyramidLevels(const std::uint64_t resolution[3], const std::uint32_t brickSize) {
+        const auto maxRes = std::max({resolution[0], resolution[1], resolution[2]});
+        std::uint32_t levels = 1;
+        while ((levels < MaxLevels) && (maxRes > (static_cast<std::uint64_t>(brickSize) << (levels - 1)))) {
+            ++levels;
+        }
+        return levels;
+    }
+
+    /** Answer the resolution of the given axis at the given level. */
+    inline std::uint64_t Resolution(const std::uint32_t level, const int axis) const {
+        const std::uint64_t scale = static_cast<std::uint64_t>(1) << level;
+        return (this->resolution[axis] > scale) ? (this->resolution[axis] + scale - 1) / scale : 1;
+    }
+
+    /** Answer the number of bricks along the given axis at the given level. */
+    inline std::uint64_t Bricks(const std::uint32_t level, const int axis) const {
+        return (this->Resolution(level, axis) + this->brickSize - 1) / this->brickSize;
+    }
+
+    /** Answer the number of bricks of all levels of a single frame. */
+    inline std::uint64_t BricksPerFrame() const {
+        return this->bricksPerFrame;
+    }
+
+    /** Answer the index of the given brick in the brick table. */
+    inline std::uint64_t BrickIndex(const std::uint32_t frame, const std::uint32_t level, const std::uint64_t bx,
+        const std::uint64_t by, const std::uint64_t bz) const {
+        return frame * this->bricksPerFrame + this->levelOffsets[level] +
+               (bz * this->Bricks(level, 1) + by) * this->Bricks(level, 0) + bx;
+    }
+
+    /** Answer the first grid point and the number of grid points of a brick along the given axis. */
+    inline std::pair<std::uint64_t, std::uint64_t> BrickRange(
+        const std::uint32_t level, const int axis, const std::uint64_t brick) const {
+        const auto begin = brick * this->brickSize;
+        return {begin, std::min<std::uint64_t>(this->brickSize, this->Resolution(level, axis) - begin)};
+    }
+
+    inline std::uint32_t BrickSize() const {
+        return this->brickSize;
+    }
+
+    inline std::uint32_t Levels() const {
+        return this->levels;
+    }
+
+    /** The maximum number of levels supported. */
+    static constexpr std::uint32_t MaxLevels = 32;
+
+private:
+    std::uint64_t resolution[3];
+    std::uint32_t brickSize;
+    std::uint32_t levels;
+    std::uint64_t bricksPerFrame;
+    std::array<std::uint64_t, MaxLevels> levelOffsets = {};
+};
+
+} // namespace megamol::volume::bricked
@@ -0,0 +1,338 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "BrickedVolumeDataSource.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+
+#include "mmcore/param/FilePathParam.h"
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol;
+using namespace megamol::core;
+using namespace megamol::volume;
+
+
+/*
+ * BrickedVolumeDataSource::BrickedVolumeDataSource
+ */
+BrickedVolumeDataSource::BrickedVolumeDataSource()
+        : getDataSlot("getData", "Provides the requested regions of the volume")
+        , filenameSlot("filename", "The path of the bricked volume file (*.mmbv) to be loaded")
+        , header()
+        , sliceDists({0.0f, 0.0f, 0.0f})
+        , dataHash(0)
+        , frame(0)
+        , isDataValid(false) {
+    using geocalls::VolumetricDataCall;
+
+    this->getDataSlot.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_DATA), &BrickedVolumeDataSource::onGetData);
+    this->getDataSlot.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_EXTENTS), &BrickedVolumeDataSource::onGetExtents);
+    this->getDataSlot.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_METADATA),
+        &BrickedVolumeDataSource::onGetMetadata);
+    this->getDataSlot.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_START_ASYNC), &BrickedVolumeDataSource::onDummy);
+    this->getDataSlot.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_STOP_ASYNC), &BrickedVolumeDataSource::onDummy);
+    this->getDataSlot.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_TRY_GET_DATA), &BrickedVolumeDataSource::onDummy);
+    this->MakeSlotAvailable(&this->getDataSlot);
+
+    this->filenameSlot.SetParameter(new param::FilePathParam("", param::FilePathParam::Flag_File, {"mmbv"}));
+    this->filenameSlot.SetUpdateCallback(&BrickedVolumeDataSource::onFileNameChanged);
+    this->MakeSlotAvailable(&this->filenameSlot);
+}
+
+
+/*
+ * BrickedVolumeDataSource::~BrickedVolumeDataSource
+ */
+BrickedVolumeDataSource::~BrickedVolumeDataSource() {
+    this->Release();
+}
+
+
+/*
+ * BrickedVolumeDataSource::create
+ */
+bool BrickedVolumeDataSource::create() {
+    const auto& filepath = this->filenameSlot.Param<param::FilePathParam>()->Value();
+    if (!filepath.empty()) {
+        this->loadFile(filepath);
+    }
+    return true;
+}
+
+
+/*
+ * BrickedVolumeDataSource::release
+ */
+void BrickedVolumeDataSource::release() {
+    this->table.clear();
+    this->data.clear();
+    this->data.shrink_to_fit();
+    this->isDataValid = false;
+}
+
+
+/*
+ * BrickedVolumeDataSource::loadFile
+ */
+bool BrickedVolumeDataSource::loadFile(const std::filesystem::path& path) {
+    using megamol::core::utility::log::Log;
+
+    this->table.clear();
+    this->data.clear();
+    this->isDataValid = false;
+    ++this->dataHash;
+
+    std::ifstream file(path, std::ios_base::binary);
+    if (!file.is_open()) {
+        Log::DefaultLog.WriteError("Bricked volume file \"%s\" could not be opened", path.generic_string().c_str());
+        return false;
+    }
+
+    file.read(reinterpret_cast<char*>(&this->header), sizeof(this->header));
+    if (!file || (this->header.magic != bricked::Magic) || (this->header.version != bricked::Version)) {
+        Log::DefaultLog.WriteError("\"%s\" is not a bricked volume file", path.generic_string().c_str());
+        return false;
+    }
+    if ((this->header.frames == 0) || (this->header.levels == 0)) {
+        Log::DefaultLog.WriteError("Bricked volume file \"%s\" is empty", path.generic_string().c_str());
+        return false;
+    }
+
+    this->minValues.resize(this->header.components);
+    this->maxValues.resize(this->header.components);
+    file.read(reinterpret_cast<char*>(this->minValues.data()), this->minValues.size() * sizeof(double));
+    file.read(reinterpret_cast<char*>(this->maxValues.data()), this->maxValues.size() * sizeof(double));
+
+    this->layout = bricked::BrickLayout(this->header.resolution, this->header.brickSize, this->header.levels);
+    this->table.resize(this->layout.BricksPerFrame() * this->header.frames + 1);
+    file.read(reinterpret_cast<char*>(this->table.data()), this->table.size() * sizeof(std::uint64_t));
+    if (!file) {
+        Log::DefaultLog.WriteError("Bricked volume file \"%s\" is truncated", path.generic_string().c_str());
+        this->table.clear();
+        return false;
+    }
+
+    this->metadata.GridType = geocalls::CARTESIAN;
+    this->metadata.ScalarType = static_cast<geocalls::ScalarType_t>(this->header.scalarType);
+    this->metadata.ScalarLength = this->header.scalarLength;
+    this->metadata.Components = this->header.components;
+    this->metadata.NumberOfFrames = this->header.frames;
+    for (int d = 0; d < 3; ++d) {
+        this->sliceDists[d] = this->header.sliceDists[d];
+        this->metadata.Resolution[d] = this->header.resolution[d];
+        this->metadata.SliceDists[d] = &this->sliceDists[d];
+        this->metadata.IsUniform[d] = true;
+        this->metadata.Origin[d] = this->header.origin[d];
+        this->metadata.Extents[d] = this->header.extents[d];
+    }
+    this->metadata.MinValues = this->minValues.data();
+    this->metadata.MaxValues = this->maxValues.data();
+    this->metadata.MemLoc = geocalls::RAM;
+
+    this->path = path;
+    Log::DefaultLog.WriteInfo("Loaded bricked volume \"%s\" with %u frames and %u levels of detail.",
+        path.generic_string().c_str(), this->header.frames, this->layout.Levels());
+    return true;
+}
+
+
+/*
+ * BrickedVolumeDataSource::readRegion
+ */
+bool BrickedVolumeDataSource::readRegion(const unsigned int frame, const Region& region) {
+    using megamol::core::utility::log::Log;
+
+    const auto level = region.Level;
+    const std::size_t voxelSize = static_cast<std::size_t>(this->header.scalarLength) * this->header.components;
+    const auto brickSize = this->layout.BrickSize();
+
+    // Enumerate the bricks intersecting the region.
+    std::vector<std::array<std::uint64_t, 3>> bricks;
+    for (auto bz = region.Offset[2] / brickSize; bz <= (region.Offset[2] + region.Size[2] - 1) / brickSize; ++bz) {
+        for (auto by = region.Offset[1] / brickSize; by <= (region.Offset[1] + region.Size[1] - 1) / brickSize; ++by) {
+            for (auto bx = region.Offset[0] / brickSize; bx <= (region.Offset[0] + region.Size[0] - 1) / brickSize;
+                 ++bx) {
+                bricks.push_back({bx, by, bz});
+            }
+        }
+    }
+
+    this->data.resize(region.Size[0] * region.Size[1] * region.Size[2] * voxelSize);
+    std::atomic<bool> isValid = true;
+    const auto brickCnt = static_cast<std::int64_t>(bricks.size());
+
+    // Each thread uses its own stream, such that bricks can be read and copied
+    // into the region concurrently.
+#pragma omp parallel
+    {
+        std::ifstream file(this->path, std::ios_base::binary);
+        std::vector<std::uint8_t> brick;
+
+#pragma omp for schedule(dynamic)
+        for (std::int64_t i = 0; i < brickCnt; ++i) {
+            const auto& b = bricks[i];
+            const auto idx = this->layout.BrickIndex(frame, level, b[0], b[1], b[2]);
+            const auto rx = this->layout.BrickRange(level, 0, b[0]);
+            const auto ry = this->layout.BrickRange(level, 1, b[1]);
+            const auto rz = this->layout.BrickRange(level, 2, b[2]);
+
+            brick.resize(this->table[idx + 1] - this->table[idx]);
+            if ((brick.size() != rx.second * ry.second * rz.second * voxelSize) || !file.is_open()) {
+                isValid = false;
+                continue;
+            }
+            file.seekg(this->table[idx]);
+            file.read(reinterpret_cast<char*>(brick.data()), brick.size());
+            if (!file) {
+                isValid = false;
+                file.clear();
+                continue;
+            }
+
+            // Intersect the brick with the region and copy the rows.
+            const auto x0 = std::max<std::uint64_t>(rx.first, region.Offset[0]);
+            const auto x1 = std::min<std::uint64_t>(rx.first + rx.second, region.Offset[0] + region.Size[0]);
+            const auto y0 = std::max<std::uint64_t>(ry.first, region.Offset[1]);
+            const auto y1 = std::min<std::uint64_t>(ry.first + ry.second, region.Offset[1] + region.Size[1]);
+            const auto z0 = std::max<std::uint64_t>(rz.first, region.Offset[2]);
+            const auto z1 = std::min<std::uint64_t>(rz.first + rz.second, region.Offset[2] + region.Size[2]);
+            const auto rowSize = (x1 - x0) * voxelSize;
+
+            for (auto z = z0; z < z1; ++z) {
+                for (auto y = y0; y < y1; ++y) {
+                    const auto src = ((z - rz.first) * ry.second + (y - ry.first)) * rx.second + (x0 - rx.first);
+                    auto dst = (z - region.Offset[2]) * region.Size[1] + (y - region.Offset[1]);
+                    dst = dst * region.Size[0] + (x0 - region.Offset[0]);
+                    std::copy_n(brick.data() + src * voxelSize, rowSize, this->data.data() + dst * voxelSize);
+                }
+            }
+        }
+    }
+
+    if (!isValid) {
+        Log::DefaultLog.WriteError("Reading bricks of frame %u at level %u from \"%s\" failed.", frame, level,
+            this->path.generic_string().c_str());
+        this->isDataValid = false;
+        return false;
+    }
+
+    this->frame = frame;
+    this->region = region;
+    this->isDataValid = true;
+    return true;
+}
+
+
+/*
+ * BrickedVolumeDataSource::onFileNameChanged
+ */
+bool BrickedVolumeDataSource::onFileNameChanged(param::ParamSlot& slot) {
+    this->loadFile(slot.Param<param::FilePathParam>()->Value());
+    return true;
+}
+
+
+/*
+ * BrickedVolumeDataSource::onGetData
+ */
+bool BrickedVolumeDataSource::onGetData(Call& call) {
+    auto* c = dynamic_cast<geocalls::VolumetricDataCall*>(&call);
+    if ((c == nullptr) || this->table.empty()) {
+        return false;
+    }
+
+    const auto frame = std::min<unsigned int>(c->FrameID(), this->header.frames - 1);
+    const auto maxLevel = this->layout.Levels() - 1;
+
+    Region region;
+    if (c->GetRequestedRegion() != nullptr) {
+        region = *c->GetRequestedRegion();
+    } else {
+        std::copy(this->header.resolution, this->header.resolution + 3, region.Size);
+    }
+
+    // Answer levels which are not stored with the coarsest one and clamp the
+    // region to the volume.
+    if (region.Level > maxLevel) {
+        const auto shift = region.Level - maxLevel;
+        for (int d = 0; d < 3; ++d) {
+            const auto end = (region.Offset[d] + region.Size[d] + (1ull << shift) - 1) >> shift;
+            region.Offset[d] >>= shift;
+            region.Size[d] = end - region.Offset[d];
+        }
+        region.Level = maxLevel;
+    }
+    for (int d = 0; d < 3; ++d) {
+        const auto res = this->layout.Resolution(region.Level, d);
+        region.Offset[d] = std::min<std::size_t>(region.Offset[d], res - 1);
+        region.Size[d] = std::clamp<std::size_t>(region.Size[d], 1, res - region.Offset[d]);
+    }
+
+    const auto isCached = this->isDataValid && (this->frame == frame) && (this->region.Level == region.Level) &&
+                          std::equal(region.Offset, region.Offset + 3, this->region.Offset) &&
+                          std::equal(region.Size, region.Size + 3, this->region.Size);
+    if (!isCached && !this->readRegion(frame, region)) {
+        return false;
+    }
+
+    c->SetFrameID(frame);
+    c->SetData(this->data.data());
+    c->SetMetadata(&this->metadata);
+    c->SetLevels(this->layout.Levels());
+    c->SetRegion(this->region);
+    c->SetDataHash(this->dataHash);
+    return true;
+}
+
+
+/*
+ * BrickedVolumeDataSource::onGetExtents
+ */
+bool BrickedVolumeDataSource::onGetExtents(Call& call) {
+    auto* c = dynamic_cast<geocalls::VolumetricDataCall*>(&call);
+    if ((c == nullptr) || this->table.empty()) {
+        return false;
+    }
+
+    const auto& m = this->metadata;
+    c->SetExtent(this->header.frames, m.Origin[0], m.Origin[1], m.Origin[2], m.Origin[0] + m.Extents[0],
+        m.Origin[1] + m.Extents[1], m.Origin[2] + m.Extents[2]);
+    c->SetDataHash(this->dataHash);
+    return true;
+}
+
+
+/*
+ * BrickedVolumeDataSource::onGetMetadata
+ */
+bool BrickedVolumeDataSource::onGetMetadata(Call& call) {
+    auto* c = dynamic_cast<geocalls::VolumetricDataCall*>(&call);
+    if ((c == nullptr) || this->table.empty()) {
+        return false;
+    }
+
+    c->SetMetadata(&this->metadata);
+    c->SetLevels(this->layout.Levels());
+    c->SetDataHash(this->dataHash);
+    return true;
+}
+
+
+/*
+ * BrickedVolumeDataSource::onDummy
+ */
+bool BrickedVolumeDataSource::onDummy(Call& call) {
+    return false;
+}
@@ -0,0 +1,152 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "BrickedVolume.h"
+#include "geometry_calls/VolumetricDataCall.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/Module.h"
+#include "mmcore/param/ParamSlot.h"
+
+namespace megamol::volume {
+
+/**
+ * Provides volumes stored in the bricked multi-resolution format written by
+ * BrickedVolumeWriter (see BrickedVolume.h).
+ *
+ * Requests for a region at a level of detail via the VolumetricDataCall only
+ * read the bricks intersecting this region. Callers which do not request a
+ * region receive the whole frame at full resolution.
+ */
+class BrickedVolumeDataSource : public core::Module {
+public:
+    /**
+     * Answer the name of this module.
+     *
+     * @return The name of this module.
+     */
+    static const char* ClassName() {
+        return "BrickedVolumeDataSource";
+    }
+
+    /**
+     * Answer a human readable description of this module.
+     *
+     * @return A human readable description of this module.
+     */
+    static const char* Description() {
+        return "Provides regions of interest at multiple levels of detail from bricked volume files (*.mmbv)";
+    }
+
+    /**
+     * Answers whether this module is available on the current system.
+     *
+     * @return 'true' if the module is available, 'false' otherwise.
+     */
+    static bool IsAvailable() {
+        return true;
+    }
+
+    /** Ctor. */
+    BrickedVolumeDataSource();
+
+    /** Dtor. */
+    ~BrickedVolumeDataSource() override;
+
+protected:
+    /**
+     * Implementation of 'Create'.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    bool create() override;
+
+    /**
+     * Implementation of 'Release'.
+     */
+    void release() override;
+
+private:
+    typedef geocalls::VolumetricDataCall::Region Region;
+
+    /**
+     * Reads the header and the brick table of the file.
+     *
+     * @param path The path of the bricked volume file.
+     *
+     * @return True on success, false otherwise.
+     */
+    bool loadFile(const std::filesystem::path& path);
+
+    /**
+     * Reads all bricks intersecting 'region' of 'frame' into 'data'.
+     *
+     * @param frame  The frame to be read.
+     * @param region The region, which must be within the volume.
+     *
+     * @return True on success, false otherwise.
+     */
+    bool readRegion(const unsigned int frame, const Region& region);
+
+    bool onFileNameChanged(core::param::ParamSlot& slot);
+
+    bool onGetData(core::Call& call);
+
+    bool onGetExtents(core::Call& call);
+
+    bool onGetMetadata(core::Call& call);
+
+    bool onDummy(core::Call& call);
+
+    /** The slot providing the data */
+    core::CalleeSlot getDataSlot;
+
+    /** The path of the bricked volume file */
+    core::param::ParamSlot filenameSlot;
+
+    /** The path of the file currently loaded */
+    std::filesystem::path path;
+
+    /** The header of the file currently loaded */
+    bricked::FileHeader header;
+
+    /** The arrangement of the bricks */
+    bricked::BrickLayout layout;
+
+    /** The file offsets of all bricks plus the end of the last one */
+    std::vector<std::uint64_t> table;
+
+    /** The storage of the values referenced by 'metadata' */
+    std::array<float, 3> sliceDists;
+    std::vector<double> minValues;
+    std::vector<double> maxValues;
+
+    /** The metadata of the full resolution volume */
+    geocalls::VolumetricDataCall::Metadata metadata;
+
+    /** The hash of the data, which changes when another file is loaded */
+    std::size_t dataHash;
+
+    /** The grid points of 'region' of 'frame' */
+    std::vector<std::uint8_t> data;
+
+    /** The frame in 'data' */
+    unsigned int frame;
+
+    /** The region in 'data' */
+    Region region;
+
+    /** Determines whether 'data' is valid */
+    bool isDataValid;
+};
+
+} // namespace megamol::volume
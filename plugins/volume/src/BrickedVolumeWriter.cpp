@@ -0,0 +1,324 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "BrickedVolumeWriter.h"
+
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+#include "BrickedVolume.h"
+#include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol;
+using namespace megamol::core;
+using namespace megamol::volume;
+
+namespace {
+
+/**
+ * Averages up to 2^3 grid points of 'src' for each grid point of 'dst'.
+ */
+template<class T>
+void downsampleTyped(const T* src, const std::uint64_t srcRes[3], T* dst, const std::uint64_t dstRes[3],
+    const std::size_t components) {
+    const auto depth = static_cast<std::int64_t>(dstRes[2]);
+
+#pragma omp parallel for
+    for (std::int64_t z = 0; z < depth; ++z) {
+        for (std::uint64_t y = 0; y < dstRes[1]; ++y) {
+            for (std::uint64_t x = 0; x < dstRes[0]; ++x) {
+                auto d = dst + ((z * dstRes[1] + y) * dstRes[0] + x) * components;
+
+                for (std::size_t c = 0; c < components; ++c) {
+                    double sum = 0.0;
+                    unsigned int cnt = 0;
+                    for (std::uint64_t sz = 2 * z; sz < std::min<std::uint64_t>(2 * z + 2, srcRes[2]); ++sz) {
+                        for (std::uint64_t sy = 2 * y; sy < std::min<std::uint64_t>(2 * y + 2, srcRes[1]); ++sy) {
+                            for (std::uint64_t sx = 2 * x; sx < std::min<std::uint64_t>(2 * x + 2, srcRes[0]); ++sx) {
+                                sum += static_cast<double>(src[((sz * srcRes[1] + sy) * srcRes[0] + sx) * components + c]);
+                                ++cnt;
+                            }
+                        }
+                    }
+
+                    if constexpr (std::is_integral_v<T>) {
+                        d[c] = static_cast<T>(std::round(sum / cnt));
+                    } else {
+                        d[c] = static_cast<T>(sum / cnt);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+
+/*
+ * BrickedVolumeWriter::BrickedVolumeWriter
+ */
+BrickedVolumeWriter::BrickedVolumeWriter()
+        : AbstractDataWriter()
+        , filenameSlot("filename", "The path of the bricked volume file (*.mmbv) to be written")
+        , brickSizeSlot("brickSize", "The edge length of the bricks in grid points")
+        , levelsSlot("levels", "The number of levels of detail (0 adds levels until a single brick covers the volume)")
+        , dataSlot("data", "The slot requesting the data to be written") {
+
+    this->filenameSlot.SetParameter(
+        new param::FilePathParam("", param::FilePathParam::Flag_File_ToBeCreated, {"mmbv"}));
+    this->MakeSlotAvailable(&this->filenameSlot);
+
+    this->brickSizeSlot.SetParameter(new param::IntParam(64, 8, 1024));
+    this->MakeSlotAvailable(&this->brickSizeSlot);
+
+    this->levelsSlot.SetParameter(
+        new param::IntParam(0, 0, static_cast<int>(bricked::BrickLayout::MaxLevels)));
+    this->MakeSlotAvailable(&this->levelsSlot);
+
+    this->dataSlot.SetCompatibleCall<geocalls::VolumetricDataCallDescription>();
+    this->MakeSlotAvailable(&this->dataSlot);
+}
+
+
+/*
+ * BrickedVolumeWriter::~BrickedVolumeWriter
+ */
+BrickedVolumeWriter::~BrickedVolumeWriter() {
+    this->Release();
+}
+
+
+/*
+ * BrickedVolumeWriter::create
+ */
+bool BrickedVolumeWriter::create() {
+    return true;
+}
+
+
+/*
+ * BrickedVolumeWriter::release
+ */
+void BrickedVolumeWriter::release() {}
+
+
+/*
+ * BrickedVolumeWriter::run
+ */
+bool BrickedVolumeWriter::run() {
+    using geocalls::VolumetricDataCall;
+    using megamol::core::utility::log::Log;
+
+    const auto filepath = this->filenameSlot.Param<param::FilePathParam>()->Value();
+    if (filepath.empty()) {
+        Log::DefaultLog.WriteError("No file path specified. Abort.");
+        return false;
+    }
+
+    auto* vdc = this->dataSlot.CallAs<VolumetricDataCall>();
+    if (vdc == nullptr) {
+        Log::DefaultLog.WriteError("No data source connected. Abort.");
+        return false;
+    }
+
+    vdc->ResetRequestedRegion();
+    vdc->SetFrameID(0, true);
+    if (!(*vdc)(VolumetricDataCall::IDX_GET_EXTENTS)) {
+        Log::DefaultLog.WriteError("Bounding box retrieval failed. Abort");
+        return false;
+    }
+    if (!VolumetricDataCall::GetMetadata(*vdc)) {
+        Log::DefaultLog.WriteError("Metadata retrieval failed. Abort.");
+        return false;
+    }
+
+    const auto& meta = *vdc->GetMetadata();
+    if ((meta.GridType != geocalls::CARTESIAN) || !meta.IsUniform[0] || !meta.IsUniform[1] || !meta.IsUniform[2]) {
+        Log::DefaultLog.WriteError("Only uniform cartesian grids can be bricked. Abort.");
+        return false;
+    }
+    if (meta.MemLoc != geocalls::RAM) {
+        Log::DefaultLog.WriteError("Only volumes in RAM can be bricked. Abort.");
+        return false;
+    }
+
+    bricked::FileHeader header;
+    header.magic = bricked::Magic;
+    header.version = bricked::Version;
+    header.scalarType = static_cast<std::uint32_t>(meta.ScalarType);
+    header.scalarLength = static_cast<std::uint32_t>(meta.ScalarLength);
+    header.components = static_cast<std::uint32_t>(meta.Components);
+    header.frames = static_cast<std::uint32_t>(vdc->FrameCount());
+    for (int d = 0; d < 3; ++d) {
+        header.resolution[d] = meta.Resolution[d];
+        header.sliceDists[d] = meta.SliceDists[d][0];
+        header.origin[d] = meta.Origin[d];
+        header.extents[d] = meta.Extents[d];
+    }
+    header.brickSize = static_cast<std::uint32_t>(this->brickSizeSlot.Param<param::IntParam>()->Value());
+    header.levels = static_cast<std::uint32_t>(this->levelsSlot.Param<param::IntParam>()->Value());
+    if (header.levels == 0) {
+        header.levels = bricked::BrickLayout::FullPyramidLevels(header.resolution, header.brickSize);
+    }
+
+    // The metadata of the source might change while requesting frames.
+    const std::vector<double> minValues(meta.MinValues, meta.MinValues + meta.Components);
+    const std::vector<double> maxValues(meta.MaxValues, meta.MaxValues + meta.Components);
+    const auto scalarMeta = meta;
+
+    const bricked::BrickLayout layout(header.resolution, header.brickSize, header.levels);
+    const std::size_t voxelSize = static_cast<std::size_t>(header.scalarLength) * header.components;
+
+    std::ofstream file(filepath, std::ios_base::binary | std::ios_base::trunc);
+    if (!file.is_open()) {
+        Log::DefaultLog.WriteError("Bricked volume file \"%s\" could not be opened", filepath.generic_string().c_str());
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(minValues.data()), minValues.size() * sizeof(double));
+    file.write(reinterpret_cast<const char*>(maxValues.data()), maxValues.size() * sizeof(double));
+
+    // The table is written once all bricks are known.
+    std::vector<std::uint64_t> table(layout.BricksPerFrame() * header.frames + 1, 0);
+    const auto tableOffset = file.tellp();
+    file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(std::uint64_t));
+
+    std::vector<std::uint8_t> brick, coarse, fine;
+
+    for (std::uint32_t f = 0; f < header.frames; ++f) {
+        vdc->SetFrameID(f, true);
+        if (!(*vdc)(VolumetricDataCall::IDX_GET_DATA) || (vdc->FrameID() != f) || (vdc->GetData() == nullptr)) {
+            Log::DefaultLog.WriteError("Data retrieval of frame %u failed. Abort.", f);
+            return false;
+        }
+
+        const auto* level = static_cast<const std::uint8_t*>(vdc->GetData());
+        std::uint64_t res[3] = {header.resolution[0], header.resolution[1], header.resolution[2]};
+
+        for (std::uint32_t l = 0; l < layout.Levels(); ++l) {
+            if (l > 0) {
+                const std::uint64_t coarseRes[3] = {
+                    layout.Resolution(l, 0), layout.Resolution(l, 1), layout.Resolution(l, 2)};
+                if (!downsample(level, res, coarse, coarseRes, scalarMeta)) {
+                    Log::DefaultLog.WriteError("Scalar type of the volume is not supported. Abort.");
+                    return false;
+                }
+                std::copy(coarseRes, coarseRes + 3, res);
+                coarse.swap(fine);
+                level = fine.data();
+            }
+
+            for (std::uint64_t bz = 0; bz < layout.Bricks(l, 2); ++bz) {
+                for (std::uint64_t by = 0; by < layout.Bricks(l, 1); ++by) {
+                    for (std::uint64_t bx = 0; bx < layout.Bricks(l, 0); ++bx) {
+                        const auto rx = layout.BrickRange(l, 0, bx);
+                        const auto ry = layout.BrickRange(l, 1, by);
+                        const auto rz = layout.BrickRange(l, 2, bz);
+                        const auto rowSize = rx.second * voxelSize;
+
+                        brick.resize(rowSize * ry.second * rz.second);
+                        for (std::uint64_t z = 0; z < rz.second; ++z) {
+                            for (std::uint64_t y = 0; y < ry.second; ++y) {
+                                const auto src = ((rz.first + z) * res[1] + ry.first + y) * res[0] + rx.first;
+                                std::copy_n(level + src * voxelSize, rowSize,
+                                    brick.data() + (z * ry.second + y) * rowSize);
+                            }
+                        }
+
+                        table[layout.BrickIndex(f, l, bx, by, bz)] = static_cast<std::uint64_t>(file.tellp());
+                        file.write(reinterpret_cast<const char*>(brick.data()), brick.size());
+                    }
+                }
+            }
+        }
+
+        Log::DefaultLog.WriteInfo("Bricked frame %u of %u.", f + 1, header.frames);
+    }
+
+    table.back() = static_cast<std::uint64_t>(file.tellp());
+    file.seekp(tableOffset);
+    file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(std::uint64_t));
+    file.close();
+
+    if (!file) {
+        Log::DefaultLog.WriteError("Writing the bricked volume file \"%s\" failed", filepath.generic_string().c_str());
+        return false;
+    }
+
+    Log::DefaultLog.WriteInfo("Bricked volume file successfully written to \"%s\"", filepath.generic_string().c_str());
+    return true;
+}
+
+
+/*
+ * BrickedVolumeWriter::getCapabilities
+ */
+bool BrickedVolumeWriter::getCapabilities(DataWriterCtrlCall& call) {
+    call.SetAbortable(false);
+    return true;
+}
+
+
+/*
+ * BrickedVolumeWriter::downsample
+ */
+bool BrickedVolumeWriter::downsample(const std::uint8_t* src, const std::uint64_t srcRes[3],
+    std::vector<std::uint8_t>& dst, const std::uint64_t dstRes[3], const geocalls::VolumetricDataCall::Metadata& meta) {
+    dst.resize(dstRes[0] * dstRes[1] * dstRes[2] * meta.Components * meta.ScalarLength);
+
+    auto as = [&](auto type) {
+        using T = decltype(type);
+        downsampleTyped(reinterpret_cast<const T*>(src), srcRes, reinterpret_cast<T*>(dst.data()), dstRes,
+            meta.Components);
+        return true;
+    };
+
+    switch (meta.ScalarType) {
+    case geocalls::FLOATING_POINT:
+        switch (meta.ScalarLength) {
+        case 4:
+            return as(float{});
+        case 8:
+            return as(double{});
+        }
+        break;
+    case geocalls::SIGNED_INTEGER:
+        switch (meta.ScalarLength) {
+        case 1:
+            return as(std::int8_t{});
+        case 2:
+            return as(std::int16_t{});
+        case 4:
+            return as(std::int32_t{});
+        case 8:
+            return as(std::int64_t{});
+        }
+        break;
+    case geocalls::UNSIGNED_INTEGER:
+    case geocalls::BITS:
+        switch (meta.ScalarLength) {
+        case 1:
+            return as(std::uint8_t{});
+        case 2:
+            return as(std::uint16_t{});
+        case 4:
+            return as(std::uint32_t{});
+        case 8:
+            return as(std::uint64_t{});
+        }
+        break;
+    default:
+        break;
+    }
+
+    return false;
+}
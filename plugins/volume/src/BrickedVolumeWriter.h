@@ -0,0 +1,119 @@
+/**
+ * MegaMol
+ * Copyright (c) 2023, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry_calls/VolumetricDataCall.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/param/ParamSlot.h"
+#include "mmstd/data/AbstractDataWriter.h"
+#include "mmstd/data/DataWriterCtrlCall.h"
+
+namespace megamol::volume {
+
+/**
+ * Converts volumes, e.g. from dat/raw files, into the bricked multi-resolution
+ * format read by BrickedVolumeDataSource (see BrickedVolume.h).
+ *
+ * Frames are requested one after another, so only a single frame of the input
+ * and its coarser levels must fit into memory.
+ */
+class BrickedVolumeWriter : public core::AbstractDataWriter {
+public:
+    /**
+     * Answer the name of this module.
+     *
+     * @return The name of this module.
+     */
+    static const char* ClassName() {
+        return "BrickedVolumeWriter";
+    }
+
+    /**
+     * Answer a human readable description of this module.
+     *
+     * @return A human readable description of this module.
+     */
+    static const char* Description() {
+        return "Writes volumes as bricked multi-resolution files (*.mmbv)";
+    }
+
+    /**
+     * Answers whether this module is available on the current system.
+     *
+     * @return 'true' if the module is available, 'false' otherwise.
+     */
+    static bool IsAvailable() {
+        return true;
+    }
+
+    /** Ctor. */
+    BrickedVolumeWriter();
+
+    /** Dtor. */
+    ~BrickedVolumeWriter() override;
+
+protected:
+    /**
+     * Implementation of 'Create'.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    bool create() override;
+
+    /**
+     * Implementation of 'Release'.
+     */
+    void release() override;
+
+    /**
+     * The main function
+     *
+     * @return True on success
+     */
+    bool run() override;
+
+    /**
+     * Function querying the writers capabilities
+     *
+     * @param call The call to receive the capabilities
+     *
+     * @return True on success
+     */
+    bool getCapabilities(core::DataWriterCtrlCall& call) override;
+
+private:
+    /**
+     * Computes the next level of detail of 'src' by averaging 2^3 grid points.
+     *
+     * @param src      The grid points of the finer level.
+     * @param srcRes   The resolution of the finer level.
+     * @param dst      Receives the grid points of the coarser level.
+     * @param dstRes   The resolution of the coarser level.
+     * @param meta     The metadata describing the scalars.
+     *
+     * @return True on success, false if the scalar type is not supported.
+     */
+    static bool downsample(const std::uint8_t* src, const std::uint64_t srcRes[3], std::vector<std::uint8_t>& dst,
+        const std::uint64_t dstRes[3], const geocalls::VolumetricDataCall::Metadata& meta);
+
+    /** The file name of the file to be written */
+    core::param::ParamSlot filenameSlot;
+
+    /** The edge length of the bricks */
+    core::param::ParamSlot brickSizeSlot;
+
+    /** The number of levels of detail, 0 for a full pyramid */
+    core::param::ParamSlot levelsSlot;
+
+    /** The slot asking for data */
+    core::CallerSlot dataSlot;
+};
+
+} // namespace megamol::volume
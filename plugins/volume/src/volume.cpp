@@ -7,6 +7,8 @@
 #include "mmcore/factories/AbstractPluginInstance.h"
 #include "mmcore/factories/PluginRegister.h"
 
+#include "BrickedVolumeDataSource.h"
+#include "BrickedVolumeWriter.h"
 #include "BuckyBall.h"
 #include "DatRawWriter.h"
 #include "DifferenceVolume.h"
@@ -26,6 +28,8 @@ public:
     void registerClasses() override {
 
         // register modules
+        this->module_descriptions.RegisterAutoDescription<megamol::volume::BrickedVolumeDataSource>();
+        this->module_descriptions.RegisterAutoDescription<megamol::volume::BrickedVolumeWriter>();
         this->module_descriptions.RegisterAutoDescription<megamol::volume::BuckyBall>();
         this->module_descriptions.RegisterAutoDescription<megamol::volume::DatRawWriter>();
         this->module_descriptions.RegisterAutoDescription<megamol::volume::DifferenceVolume>();